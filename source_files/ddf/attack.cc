@@ -607,7 +607,8 @@ void atkdef_c::Default()
 //
 // atkdef_container_c::atkdef_container_c()
 //
-atkdef_container_c::atkdef_container_c() : epi::array_c(sizeof(atkdef_c*))
+atkdef_container_c::atkdef_container_c() : epi::array_c(sizeof(atkdef_c*)),
+	name_index()
 {
 }
 
@@ -632,25 +633,47 @@ void atkdef_container_c::CleanupObject(void *obj)
 	return;
 }
 
+//
+// atkdef_container_c::Insert()
+//
+int atkdef_container_c::Insert(atkdef_c *a)
+{
+	std::string key;
+	DDF_NormaliseName(a->name.c_str(), key);
+
+	// an earlier entry with the same name takes precedence
+	name_index.emplace(key, a);
+
+	return InsertObject((void*)&a);
+}
+
+//
+// atkdef_container_c::Clear()
+//
+void atkdef_container_c::Clear()
+{
+	name_index.clear();
+
+	epi::array_c::Clear();
+}
+
 //
 // atkdef_c* atkdef_container_c::Lookup()
 //
-// Looks an atkdef by name, returns a fatal error if it does not exist.
+// Looks an atkdef by name, returns NULL if it does not exist.
 //
 atkdef_c* atkdef_container_c::Lookup(const char *refname)
 {
-	epi::array_iterator_c it;
-	atkdef_c *a;
-
 	if (!refname || !refname[0])
 		return NULL;
 
-	for (it = GetIterator(0); it.IsValid(); it++)
-	{
-		a = ITERATOR_TO_TYPE(it, atkdef_c*);
-		if (DDF_CompareName(a->name.c_str(), refname) == 0)
-			return a;
-	}
+	std::string key;
+	DDF_NormaliseName(refname, key);
+
+	auto find = name_index.find(key);
+
+	if (find != name_index.end())
+		return find->second;
 
 	return NULL;
 }
@@ -19,6 +19,9 @@
 #ifndef __DDF_ATK_H__
 #define __DDF_ATK_H__
 
+#include <string>
+#include <unordered_map>
+
 #include "epi.h"
 #include "arrays.h"
 
@@ -154,11 +157,15 @@ public:
 private:
 	void CleanupObject(void *obj);
 
+	// normalised name --> first entry with that name
+	std::unordered_map<std::string, atkdef_c *> name_index;
+
 public:
 	// List Management
 	int GetSize() {	return array_entries; } 
-	int Insert(atkdef_c *a) { return InsertObject((void*)&a); }
+	int Insert(atkdef_c *a);
 	atkdef_c* operator[](int idx) { return *(atkdef_c**)FetchObject(idx); } 
+	void Clear();
 
 	// Search Functions
 	atkdef_c* Lookup(const char* refname);
@@ -266,6 +266,8 @@ void DDF_MobjGetBpArmour (const char *info, void *storage);
 void DDF_MobjGetBpKeys (const char *info, void *storage);
 void DDF_MobjGetBpWeapon (const char *info, void *storage);
 void DDF_MobjGetPlayer (const char *info, void *storage);
+void DDF_MobjStateGetRADTrigger (const char *arg, state_t * cur_state);
+extern const actioncode_t thing_actions[];
 
 void ThingParseField(const char *field, const char *contents,
 		             int index, bool is_last);
@@ -302,6 +304,10 @@ void DDF_StateBeginRange (state_group_t& group);
 void DDF_StateFinishRange(state_group_t& group);
 void DDF_StateCleanUp (void);
 
+// DDF_SNAP Code
+bool DDF_LoadSnapshot (const std::filesystem::path& filename);
+void DDF_SaveSnapshot (const std::filesystem::path& filename);
+
 // DDF_SECT Code
 void DDF_SectorInit (void);
 void DDF_SectGetDestRef (const char *info, void *storage);
@@ -322,7 +328,9 @@ void DDF_SwitchCleanUp (void);
 // DDF_WEAP Code
 void DDF_WeaponInit (void);
 void DDF_WeaponCleanUp (void);
+void DDF_WStateGetRADTrigger (const char *arg, state_t * cur_state);
 extern const specflags_t ammo_types[];
+extern const actioncode_t weapon_actions[];
 
 // DDF_COLM Code -AJA- 1999/07/09.
 void DDF_ColmapInit (void);
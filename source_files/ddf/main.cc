@@ -26,8 +26,13 @@
 
 #include <limits.h>
 
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+
 // EPI
 #include "epi.h"
+#include "math_md5.h"
 #include "path.h"
 #include "str_util.h"
 
@@ -1154,6 +1159,70 @@ void DDF_MainGetString(const char *info, void *storage)
 }
 
 
+//
+// Command table indexes
+//
+// Each command table is hashed the first time it is used, replacing
+// the linear DDF_CompareName scan.  Normal fields are keyed by their
+// normalised name (spaces and underscores removed, upper case), which
+// matches exactly when DDF_CompareName() would return 0.  Sub-field
+// prefixes are keyed verbatim, as they are compared with strncmp.
+// When a name occurs twice the earlier entry wins, as before.
+//
+class command_index_c
+{
+public:
+	std::unordered_map<std::string, const commandlist_t *> fields;
+	std::unordered_map<std::string, const commandlist_t *> subs;
+
+public:
+	command_index_c() : fields(), subs()
+	{ }
+
+	~command_index_c()
+	{ }
+};
+
+static std::unordered_map<const commandlist_t *, std::unique_ptr<command_index_c>> command_indexes;
+
+
+static command_index_c *GetCommandIndex(const commandlist_t *commands)
+{
+	auto find = command_indexes.find(commands);
+
+	if (find != command_indexes.end())
+		return find->second.get();
+
+	command_index_c *index = new command_index_c;
+
+	std::string key;
+
+	for (int i=0; commands[i].name; i++)
+	{
+		const char * name = commands[i].name;
+
+		if (name[0] == '!')
+			name++;
+
+		if (name[0] == '*')
+		{
+			SYS_ASSERT(strlen(name + 1) > 0);
+
+			index->subs.emplace(std::string(name + 1), &commands[i]);
+			continue;
+		}
+
+		DDF_NormaliseName(name, key);
+
+		index->fields.emplace(key, &commands[i]);
+	}
+
+	command_indexes[commands].reset(index);
+
+	return index;
+}
+
+
 //
 // DDF_MainParseField
 //
@@ -1166,44 +1235,55 @@ bool DDF_MainParseField(const commandlist_t *commands,
 {
 	SYS_ASSERT(obj_base);
 
-	for (int i=0; commands[i].name; i++)
-	{
-		const char * name = commands[i].name;
+	std::string key;
 
-		if (name[0] == '!')
-			name++;
-    
-		// handle subfields
-		if (name[0] == '*')
+	command_index_c *index = GetCommandIndex(commands);
+
+	const commandlist_t *best = NULL;
+	int best_len = 0;
+
+	// handle subfields (the prefix may contain a dot itself)
+	if (! index->subs.empty())
+	{
+		for (const char *dot = strchr(field, '.') ; dot ; dot = strchr(dot + 1, '.'))
 		{
-			name++;
+			if (! isalnum(dot[1]))
+				continue;
 
-			int len = strlen(name);
-			SYS_ASSERT(len > 0);
+			key.assign(field, dot - field);
 
-			if (strncmp(field, name, len) == 0 && field[len] == '.' && 
-				isalnum(field[len+1]))
+			auto find = index->subs.find(key);
+
+			if (find != index->subs.end() && (! best || find->second < best))
 			{
-				// recursively parse the sub-field
-				return DDF_MainParseField(commands[i].sub_comms, 
-                        field + len + 1, contents,
-						obj_base + commands[i].offset);
+				best = find->second;
+				best_len = (int)key.size();
 			}
-      
-			continue;
 		}
+	}
 
-		if (DDF_CompareName(field, name) != 0)
-			continue;
+	DDF_NormaliseName(field, key);
+
+	auto find = index->fields.find(key);
 
+	if (find != index->fields.end() && (! best || find->second < best))
+	{
 		// found it, so call parse routine
-		SYS_ASSERT(commands[i].parse_command);
+		SYS_ASSERT(find->second->parse_command);
 
-		(* commands[i].parse_command)(contents, obj_base + commands[i].offset);
+		(* find->second->parse_command)(contents, obj_base + find->second->offset);
 
 		return true;
 	}
 
+	if (best)
+	{
+		// recursively parse the sub-field
+		return DDF_MainParseField(best->sub_comms, 
+				field + best_len + 1, contents,
+				obj_base + best->offset);
+	}
+
 	return false;
 }
 
@@ -2278,7 +2358,57 @@ void DDF_DumpCollection(ddf_collection_c *col)
 }
 
 
-static void DDF_ParseUnreadFile(size_t d)
+//
+// DDF_SnapshotKey
+//
+// An MD5 (as hex digits) of everything waiting to be parsed, which
+// includes converted DEH patches and RTS scripts, so that a snapshot
+// is only used with exactly the same input.
+//
+std::string DDF_SnapshotKey(void)
+{
+	std::vector<byte> buffer;
+
+	for (auto& it : unread_ddf.files)
+	{
+		epi::md5hash_c file_md5((const byte *)it.data.data(), (unsigned int)it.data.size());
+
+		buffer.push_back((byte) it.type);
+		buffer.insert(buffer.end(), file_md5.hash, file_md5.hash + 16);
+	}
+
+	// these change what a bad definition turns into
+	buffer.push_back(strict_errors ? 1 : 0);
+	buffer.push_back(lax_errors ? 1 : 0);
+
+	epi::md5hash_c md5(buffer.data(), (unsigned int)buffer.size());
+
+	std::string key;
+
+	for (int i = 0 ; i < 16 ; i++)
+		key += epi::STR_Format("%02x", md5.hash[i]);
+
+	return key;
+}
+
+
+static bool DDF_IsSnapshotType(ddf_type_e type)
+{
+	return (type == DDF_Attack || type == DDF_Weapon || type == DDF_Thing);
+}
+
+
+static void DDF_SkipUnreadFile(size_t d)
+{
+	for (auto& it : unread_ddf.files)
+	{
+		if (it.type == ddf_readers[d].type)
+			it.data.clear();
+	}
+}
+
+
+static void DDF_ParseUnreadFile(size_t d, size_t& total_bytes, double& total_time)
 {
 	for (auto& it : unread_ddf.files)
 	{
@@ -2292,9 +2422,16 @@ static void DDF_ParseUnreadFile(size_t d)
 			}
 			else
 			{
+				auto start_time = std::chrono::steady_clock::now();
+
 				// FIXME store `source` in cur_ddf_filename (or so)
 
 				(* ddf_readers[d].func)(it.data);
+
+				total_time += std::chrono::duration<double, std::micro>(
+					std::chrono::steady_clock::now() - start_time).count();
+
+				total_bytes += it.data.size();
 			}
 
 			// can free the memory now
@@ -2304,14 +2441,66 @@ static void DDF_ParseUnreadFile(size_t d)
 }
 
 
-void DDF_ParseEverything()
+//
+// When 'benchmark' is true, the total size of the DDF which was
+// parsed, the time taken and the throughput are printed once at the
+// end.  RTS scripts are not counted, as they have their own parser.
+//
+// When 'snapshot' is not empty, the attacks, weapons and things are
+// loaded from that file instead of being parsed, or if it cannot be
+// loaded they are written to it once parsed (see snapshot.cc).
+//
+void DDF_ParseEverything(bool benchmark, const std::filesystem::path& snapshot)
 {
 	// -AJA- Since DDF files have dependencies between them, it makes most
 	//       sense to load all lumps of a certain type together, for example
 	//       all DDFSFX lumps before all the DDFTHING lumps.
 
+	size_t total_bytes = 0;
+	double total_time  = 0;
+
+	bool from_snapshot = false;
+	double snapshot_time = 0;
+
 	for (size_t d = 0 ; d < DDF_NUM_TYPES ; d++)
-		DDF_ParseUnreadFile(d);
+	{
+		ddf_type_e type = ddf_readers[d].type;
+
+		// the snapshot types come one after the other, attacks first
+		if (! snapshot.empty() && type == DDF_Attack)
+		{
+			auto start_time = std::chrono::steady_clock::now();
+
+			from_snapshot = DDF_LoadSnapshot(snapshot);
+
+			snapshot_time = std::chrono::duration<double, std::micro>(
+				std::chrono::steady_clock::now() - start_time).count();
+
+			if (from_snapshot)
+				I_Printf("Loaded attacks, weapons and things from: %s\n", snapshot.u8string().c_str());
+		}
+
+		if (from_snapshot && DDF_IsSnapshotType(type))
+		{
+			DDF_SkipUnreadFile(d);
+			continue;
+		}
+
+		DDF_ParseUnreadFile(d, total_bytes, total_time);
+
+		if (! snapshot.empty() && ! from_snapshot && type == DDF_Thing)
+			DDF_SaveSnapshot(snapshot);
+	}
+
+	if (benchmark)
+	{
+		I_Printf("DDF benchmark: parsed %d bytes in %1.2f ms (%1.1f KB/s)\n",
+			(int)total_bytes, total_time / 1000.0,
+			(total_time > 0) ? (total_bytes * 1000000.0 / 1024.0 / total_time) : 0.0);
+
+		if (from_snapshot)
+			I_Printf("DDF benchmark: snapshot loaded in %1.2f ms\n", snapshot_time / 1000.0);
+	}
 }
 
 
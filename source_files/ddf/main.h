@@ -153,6 +153,7 @@ const char *DDF_MainDecodeList(const char *info, char divider, bool simple);
 void DDF_GetLumpNameForFile(const char *filename, char *lumpname);
 
 int DDF_CompareName(const char *A, const char *B);
+void DDF_NormaliseName(const char *name, std::string& out);
 
 void DDF_MainAddDefine(const char *name, const char *value);
 void DDF_MainAddDefine(const std::string& name, const std::string& value);
@@ -172,7 +173,9 @@ ddf_type_e DDF_FilenameToType(const std::filesystem::path& path);
 
 void DDF_AddFile(ddf_type_e type, std::string& data, const std::string& source);
 void DDF_AddCollection(ddf_collection_c *col, const std::string& source);
-void DDF_ParseEverything();
+std::string DDF_SnapshotKey(void);
+void DDF_ParseEverything(bool benchmark = false,
+	const std::filesystem::path& snapshot = std::filesystem::path());
 
 void DDF_DumpFile(const std::string& data);
 void DDF_DumpCollection(ddf_collection_c *col);
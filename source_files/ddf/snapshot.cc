@@ -0,0 +1,1682 @@
+//----------------------------------------------------------------------------
+//  EDGE Data Definition File Code (Snapshots)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2023  The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+//
+// Most of the DDF parsing time goes on the attacks, weapons and things,
+// and on the states which they create.  Once parsed, those are written
+// here to a binary snapshot, which later runs with the same input read
+// back instead of parsing them again.
+//
+// Pointers between the definitions are stored as indices (into the
+// containers, or into sfxdefs and colourmaps which are parsed first)
+// and turned back into pointers on load.  The snapshot is taken before
+// DDF_CleanUp(), so the references which are only resolved there are
+// simply resolved again.
+//
+// The file is only ever read on the machine which wrote it, so all the
+// values are kept in native order.
+//
+
+#include "local.h"
+
+#include <unordered_map>
+
+#include "endianess.h"
+#include "file.h"
+#include "filesystem.h"
+#include "math_md5.h"
+
+#include "colormap.h"
+
+#define SNAP_MAGIC  "EDGEDDS1"
+
+// header is the magic, the MD5 and the length of the rest
+#define SNAP_HEADER_SIZE  (8 + 16 + 4)
+
+
+//----------------------------------------------------------------------------
+//  WRITING
+//----------------------------------------------------------------------------
+
+static std::string snap_out;
+
+// cleared when something cannot be stored, or cannot be read back
+static bool snap_ok;
+
+// pointer --> index, for the pointers between definitions
+typedef std::unordered_map<const void *, int> snap_index_t;
+
+static snap_index_t snap_mobj_ids;
+static snap_index_t snap_atk_ids;
+static snap_index_t snap_weap_ids;
+static snap_index_t snap_colmap_ids;
+
+// action routine --> index in the action table, -2 if the routine is
+// used with more than one kind of argument
+typedef void (* snap_action_t)(struct mobj_s *mo);
+
+static std::unordered_map<snap_action_t, int> snap_thing_codes;
+static std::unordered_map<snap_action_t, int> snap_weapon_codes;
+
+
+static void SnapWrite(const void *data, size_t len)
+{
+	snap_out.append((const char *)data, len);
+}
+
+template <typename T>
+static void SnapPut(T value)
+{
+	SnapWrite(&value, sizeof(T));
+}
+
+static void SnapPutBool(bool value)
+{
+	SnapPut<byte>(value ? 1 : 0);
+}
+
+static void SnapPutString(const std::string& s)
+{
+	SnapPut<int>((int)s.size());
+	SnapWrite(s.data(), s.size());
+}
+
+// NULL is kept apart from the empty string
+static void SnapPutCString(const char *s)
+{
+	if (! s)
+	{
+		SnapPut<int>(-1);
+		return;
+	}
+
+	int len = (int)strlen(s);
+
+	SnapPut<int>(len);
+	SnapWrite(s, len);
+}
+
+static void SnapPutRef(const snap_index_t& ids, const void *ptr)
+{
+	if (! ptr)
+	{
+		SnapPut<int>(-1);
+		return;
+	}
+
+	auto find = ids.find(ptr);
+
+	if (find == ids.end())
+	{
+		snap_ok = false;
+		SnapPut<int>(-1);
+		return;
+	}
+
+	SnapPut<int>(find->second);
+}
+
+static void SnapPutSound(const sfx_t *sfx)
+{
+	if (! sfx)
+	{
+		SnapPut<int>(0);
+		return;
+	}
+
+	SnapPut<int>(sfx->num);
+
+	for (int i = 0 ; i < sfx->num ; i++)
+	{
+		if (sfx->sounds[i] < 0 || sfx->sounds[i] >= sfxdefs.GetSize())
+			snap_ok = false;
+
+		SnapPut<int>(sfx->sounds[i]);
+	}
+
+	// a single sound is normally the definition's own sfx_t, see
+	// sfxdef_container_c::GetEffect()
+	if (sfx->num == 1 && snap_ok)
+		SnapPutBool(sfx == &sfxdefs[sfx->sounds[0]]->normal);
+}
+
+static void SnapPutStateGroup(const state_group_t& group)
+{
+	SnapPut<int>((int)group.size());
+
+	for (const state_range_t& range : group)
+	{
+		SnapPut<int>(range.first);
+		SnapPut<int>(range.last);
+	}
+}
+
+static void SnapPutLabelOffset(const label_offset_c& lab)
+{
+	SnapPutString(lab.label);
+	SnapPut<int>(lab.offset);
+}
+
+static void SnapPutBenefits(const benefit_t *list)
+{
+	int count = 0;
+
+	for (const benefit_t *be = list ; be ; be = be->next)
+		count++;
+
+	SnapPut<int>(count);
+
+	for (const benefit_t *be = list ; be ; be = be->next)
+	{
+		SnapPut<int>(be->type);
+
+		if (be->type == BENEFIT_Weapon)
+			SnapPutRef(snap_weap_ids, be->sub.weap);
+		else
+			SnapPut<int>(be->sub.type);
+
+		SnapPut<float>(be->amount);
+		SnapPut<float>(be->limit);
+	}
+}
+
+static void SnapPutPickupEffects(const pickup_effect_c *list)
+{
+	int count = 0;
+
+	for (const pickup_effect_c *pe = list ; pe ; pe = pe->next)
+		count++;
+
+	SnapPut<int>(count);
+
+	for (const pickup_effect_c *pe = list ; pe ; pe = pe->next)
+	{
+		SnapPut<int>(pe->type);
+
+		if (pe->type == PUFX_SwitchWeapon)
+			SnapPutRef(snap_weap_ids, pe->sub.weap);
+		else
+			SnapPut<int>(pe->sub.type);
+
+		SnapPut<int>(pe->slot);
+		SnapPut<float>(pe->time);
+	}
+}
+
+static void SnapPutDamage(const damage_c& dm)
+{
+	SnapPut<float>(dm.nominal);
+	SnapPut<float>(dm.linear_max);
+	SnapPut<float>(dm.error);
+	SnapPut<int>(dm.delay);
+
+	SnapPutString(dm.obituary);
+
+	SnapPutLabelOffset(dm.pain);
+	SnapPutLabelOffset(dm.death);
+	SnapPutLabelOffset(dm.overkill);
+
+	SnapPutBool(dm.no_armour);
+	SnapPut<rgbcol_t>(dm.damage_flash_colour);
+	SnapPutBool(dm.bypass_all);
+	SnapPutBool(dm.instakill);
+	SnapPutBool(dm.all_players);
+
+	SnapPutBenefits(dm.damage_unless);
+	SnapPutBenefits(dm.damage_if);
+
+	SnapPutBool(dm.grounded_monsters);
+}
+
+static void SnapPutDLight(const dlight_info_c& dl)
+{
+	// cache_data is only filled in when rendering
+	SnapPut<int>(dl.type);
+	SnapPutString(dl.shape);
+	SnapPut<float>(dl.radius);
+	SnapPut<rgbcol_t>(dl.colour);
+	SnapPut<percent_t>(dl.height);
+	SnapPutBool(dl.leaky);
+}
+
+static void SnapPutWeakness(const weakness_info_c& wk)
+{
+	SnapPut<percent_t>(wk.height[0]);
+	SnapPut<percent_t>(wk.height[1]);
+	SnapPut<angle_t>(wk.angle[0]);
+	SnapPut<angle_t>(wk.angle[1]);
+	SnapPut<bitset_t>(wk.classes);
+	SnapPut<float>(wk.multiply);
+	SnapPut<percent_t>(wk.painchance);
+}
+
+
+static void SnapIndexActions(const actioncode_t *actions, std::unordered_map<snap_action_t, int>& codes)
+{
+	codes.clear();
+
+	for (int i = 0 ; actions[i].actionname ; i++)
+	{
+		snap_action_t fn = actions[i].action;
+
+		if (! fn)
+			continue;
+
+		auto find = codes.find(fn);
+
+		if (find == codes.end())
+			codes[fn] = i;
+		else if (find->second >= 0 && actions[find->second].handle_arg != actions[i].handle_arg)
+			find->second = -2;
+	}
+}
+
+static void SnapPutActionPar(const actioncode_t *code, const void *par)
+{
+	SnapPutBool(par != NULL);
+
+	if (! par)
+		return;
+
+	auto handler = code->handle_arg;
+
+	if (handler == DDF_StateGetAttack)
+	{
+		SnapPutRef(snap_atk_ids, par);
+	}
+	else if (handler == DDF_StateGetMobj)
+	{
+		SnapPutString(((const mobj_strref_c *)par)->GetName());
+	}
+	else if (handler == DDF_StateGetSound)
+	{
+		SnapPutSound((const sfx_t *)par);
+	}
+	else if (handler == DDF_StateGetInteger ||
+	         handler == DDF_MobjStateGetRADTrigger ||
+	         handler == DDF_WStateGetRADTrigger)
+	{
+		SnapPut<int>(*(const int *)par);
+	}
+	else if (handler == DDF_StateGetIntPair)
+	{
+		SnapPut<int>(((const int *)par)[0]);
+		SnapPut<int>(((const int *)par)[1]);
+	}
+	else if (handler == DDF_StateGetFloat ||
+	         handler == DDF_StateGetSlope ||
+	         handler == DDF_StateGetPercent)
+	{
+		SnapPut<float>(*(const float *)par);
+	}
+	else if (handler == DDF_StateGetAngle)
+	{
+		SnapPut<angle_t>(*(const angle_t *)par);
+	}
+	else if (handler == DDF_StateGetRGB)
+	{
+		SnapPut<rgbcol_t>(*(const rgbcol_t *)par);
+	}
+	else if (handler == DDF_StateGetJump)
+	{
+		SnapPut<percent_t>(((const act_jump_info_t *)par)->chance);
+	}
+	else if (handler == DDF_StateGetBecome)
+	{
+		const act_become_info_t *become = (const act_become_info_t *)par;
+
+		SnapPutRef(snap_mobj_ids, become->info);
+		SnapPutString(become->info_ref);
+		SnapPutLabelOffset(become->start);
+	}
+	else if (handler == DDF_StateGetMorph)
+	{
+		const act_morph_info_t *morph = (const act_morph_info_t *)par;
+
+		SnapPutRef(snap_mobj_ids, morph->info);
+		SnapPutString(morph->info_ref);
+		SnapPutLabelOffset(morph->start);
+	}
+	else if (handler == DDF_StateGetBecomeWeapon)
+	{
+		const wep_become_info_t *become = (const wep_become_info_t *)par;
+
+		SnapPutRef(snap_weap_ids, become->info);
+		SnapPutString(become->info_ref);
+		SnapPutLabelOffset(become->start);
+	}
+	else
+	{
+		// an argument we do not know how to store
+		snap_ok = false;
+	}
+}
+
+static void SnapPutState(const state_t *st)
+{
+	SnapPut<short>(st->sprite);
+	SnapPut<short>(st->frame);
+	SnapPut<short>(st->bright);
+	SnapPut<short>(st->flags);
+	SnapPut<int>(st->tics);
+
+	SnapPutCString(st->model_frame);
+	SnapPutCString(st->label);
+
+	SnapPut<int>(st->rts_tag_type);
+	SnapPut<int>(st->nextstate);
+	SnapPut<int>(st->jumpstate);
+
+	if (! st->action)
+	{
+		if (st->action_par)
+			snap_ok = false;
+
+		SnapPut<int>(-1);
+		return;
+	}
+
+	bool is_weapon = (st->flags & SFF_Weapon) ? true : false;
+
+	const actioncode_t *actions = is_weapon ? weapon_actions : thing_actions;
+	const auto& codes = is_weapon ? snap_weapon_codes : snap_thing_codes;
+
+	auto find = codes.find(st->action);
+
+	if (find == codes.end() || find->second < 0)
+	{
+		snap_ok = false;
+		SnapPut<int>(-1);
+		return;
+	}
+
+	SnapPut<int>(find->second);
+
+	SnapPutActionPar(&actions[find->second], st->action_par);
+}
+
+static void SnapPutAttack(const atkdef_c *a)
+{
+	SnapPutString(a->name);
+
+	SnapPut<int>(a->attackstyle);
+	SnapPut<int>(a->flags);
+	SnapPutSound(a->initsound);
+	SnapPutSound(a->sound);
+	SnapPut<float>(a->accuracy_slope);
+	SnapPut<angle_t>(a->accuracy_angle);
+	SnapPut<float>(a->xoffset);
+	SnapPut<float>(a->yoffset);
+	SnapPut<angle_t>(a->angle_offset);
+	SnapPut<float>(a->slope_offset);
+	SnapPut<angle_t>(a->trace_angle);
+	SnapPut<float>(a->assault_speed);
+	SnapPut<float>(a->height);
+	SnapPut<float>(a->range);
+	SnapPut<int>(a->count);
+	SnapPut<int>(a->tooclose);
+	SnapPut<float>(a->berserk_mul);
+
+	SnapPutDamage(a->damage);
+
+	SnapPut<bitset_t>(a->attack_class);
+	SnapPut<int>(a->objinitstate);
+	SnapPutString(a->objinitstate_ref);
+	SnapPut<percent_t>(a->notracechance);
+	SnapPut<percent_t>(a->keepfirechance);
+
+	SnapPutRef(snap_mobj_ids, a->atk_mobj);
+	SnapPutRef(snap_mobj_ids, a->spawnedobj);
+	SnapPutString(a->spawnedobj_ref);
+	SnapPut<int>(a->spawn_limit);
+	SnapPutRef(snap_mobj_ids, a->puff);
+	SnapPutString(a->puff_ref);
+
+	SnapPutRef(snap_atk_ids, a->dualattack1);
+	SnapPutRef(snap_atk_ids, a->dualattack2);
+}
+
+static void SnapPutWeapon(const weapondef_c *w)
+{
+	SnapPutString(w->name);
+
+	for (int k = 0 ; k < 4 ; k++)
+	{
+		SnapPutRef(snap_atk_ids, w->attack[k]);
+		SnapPut<int>(w->ammo[k]);
+		SnapPut<int>(w->ammopershot[k]);
+		SnapPut<int>(w->clip_size[k]);
+		SnapPutBool(w->autofire[k]);
+	}
+
+	SnapPut<float>(w->kick);
+
+	SnapPutStateGroup(w->state_grp);
+
+	SnapPut<int>(w->up_state);
+	SnapPut<int>(w->down_state);
+	SnapPut<int>(w->ready_state);
+	SnapPut<int>(w->empty_state);
+	SnapPut<int>(w->idle_state);
+
+	for (int k = 0 ; k < 4 ; k++)
+	{
+		SnapPut<int>(w->attack_state[k]);
+		SnapPut<int>(w->reload_state[k]);
+		SnapPut<int>(w->discard_state[k]);
+		SnapPut<int>(w->warmup_state[k]);
+		SnapPut<int>(w->flash_state[k]);
+	}
+
+	SnapPut<int>(w->crosshair);
+	SnapPut<int>(w->zoom_state);
+
+	SnapPutBool(w->no_cheat);
+	SnapPutBool(w->autogive);
+	SnapPutBool(w->feedback);
+
+	SnapPutRef(snap_weap_ids, w->upgrade_weap);
+
+	SnapPut<int>(w->priority);
+	SnapPutBool(w->dangerous);
+
+	SnapPutRef(snap_atk_ids, w->eject_attack);
+
+	SnapPutSound(w->idle);
+	SnapPutSound(w->engaged);
+	SnapPutSound(w->hit);
+	SnapPutSound(w->start);
+	SnapPutSound(w->sound1);
+	SnapPutSound(w->sound2);
+	SnapPutSound(w->sound3);
+
+	SnapPutBool(w->nothrust);
+	SnapPut<int>(w->bind_key);
+
+	for (int k = 0 ; k < 4 ; k++)
+		SnapPut<int>(w->specials[k]);
+
+	SnapPut<int>(w->zoom_fov);
+	SnapPut<float>(w->zoom_factor);
+	SnapPutBool(w->refire_inacc);
+	SnapPutBool(w->show_clip);
+	SnapPutBool(w->shared_clip);
+	SnapPut<percent_t>(w->bobbing);
+	SnapPut<percent_t>(w->swaying);
+	SnapPut<int>(w->idle_wait);
+	SnapPut<percent_t>(w->idle_chance);
+
+	SnapPut<int>(w->model_skin);
+	SnapPut<float>(w->model_aspect);
+	SnapPut<float>(w->model_bias);
+	SnapPut<float>(w->model_forward);
+	SnapPut<float>(w->model_side);
+	SnapPut<int>(w->model_rotate);
+
+	SnapPutBool(w->render_invert);
+	SnapPut<float>(w->y_adjust);
+	SnapPutBool(w->ignore_crosshair_scaling);
+}
+
+static void SnapPutMobj(const mobjtype_c *m)
+{
+	SnapPutString(m->name);
+	SnapPut<int>(m->number);
+
+	SnapPutStateGroup(m->state_grp);
+
+	SnapPut<int>(m->spawn_state);
+	SnapPut<int>(m->idle_state);
+	SnapPut<int>(m->chase_state);
+	SnapPut<int>(m->pain_state);
+	SnapPut<int>(m->missile_state);
+	SnapPut<int>(m->melee_state);
+	SnapPut<int>(m->death_state);
+	SnapPut<int>(m->overkill_state);
+	SnapPut<int>(m->raise_state);
+	SnapPut<int>(m->res_state);
+	SnapPut<int>(m->meander_state);
+	SnapPut<int>(m->morph_state);
+	SnapPut<int>(m->bounce_state);
+	SnapPut<int>(m->touch_state);
+	SnapPut<int>(m->gib_state);
+	SnapPut<int>(m->reload_state);
+
+	SnapPut<int>(m->reactiontime);
+	SnapPut<percent_t>(m->painchance);
+	SnapPut<float>(m->spawnhealth);
+	SnapPut<float>(m->speed);
+	SnapPut<float>(m->float_speed);
+	SnapPut<float>(m->radius);
+	SnapPut<float>(m->height);
+	SnapPut<float>(m->step_size);
+	SnapPut<float>(m->mass);
+
+	SnapPut<int>(m->flags);
+	SnapPut<int>(m->extendedflags);
+	SnapPut<int>(m->hyperflags);
+	SnapPut<int>(m->mbf21flags);
+
+	SnapPutDamage(m->explode_damage);
+	SnapPut<float>(m->explode_radius);
+
+	SnapPutBenefits(m->lose_benefits);
+	SnapPutBenefits(m->pickup_benefits);
+	SnapPutBenefits(m->kill_benefits);
+	SnapPutPickupEffects(m->pickup_effects);
+	SnapPutString(m->pickup_message);
+	SnapPutBenefits(m->initial_benefits);
+
+	SnapPut<int>(m->castorder);
+	SnapPutString(m->cast_title);
+	SnapPut<int>(m->respawntime);
+	SnapPut<percent_t>(m->translucency);
+	SnapPut<percent_t>(m->minatkchance);
+	SnapPutRef(snap_colmap_ids, m->palremap);
+
+	SnapPut<int>(m->jump_delay);
+	SnapPut<float>(m->jumpheight);
+	SnapPut<float>(m->crouchheight);
+	SnapPut<percent_t>(m->viewheight);
+	SnapPut<percent_t>(m->shotheight);
+	SnapPut<float>(m->maxfall);
+	SnapPut<float>(m->fast);
+	SnapPut<float>(m->scale);
+	SnapPut<float>(m->aspect);
+	SnapPut<float>(m->bounce_speed);
+	SnapPut<float>(m->bounce_up);
+	SnapPut<float>(m->sight_slope);
+	SnapPut<angle_t>(m->sight_angle);
+	SnapPut<float>(m->ride_friction);
+	SnapPut<percent_t>(m->shadow_trans);
+
+	SnapPutSound(m->seesound);
+	SnapPutSound(m->attacksound);
+	SnapPutSound(m->painsound);
+	SnapPutSound(m->deathsound);
+	SnapPutSound(m->overkill_sound);
+	SnapPutSound(m->activesound);
+	SnapPutSound(m->walksound);
+	SnapPutSound(m->jump_sound);
+	SnapPutSound(m->noway_sound);
+	SnapPutSound(m->oof_sound);
+	SnapPutSound(m->fallpain_sound);
+	SnapPutSound(m->gasp_sound);
+	SnapPutSound(m->secretsound);
+	SnapPutSound(m->falling_sound);
+	SnapPutSound(m->rip_sound);
+
+	SnapPut<int>(m->fuse);
+	SnapPut<int>(m->reload_shots);
+	SnapPut<percent_t>(m->armour_protect);
+	SnapPut<percent_t>(m->armour_deplete);
+	SnapPut<bitset_t>(m->armour_class);
+	SnapPut<bitset_t>(m->side);
+	SnapPut<int>(m->playernum);
+	SnapPut<int>(m->yalign);
+
+	SnapPut<int>(m->model_skin);
+	SnapPut<float>(m->model_scale);
+	SnapPut<float>(m->model_aspect);
+	SnapPut<float>(m->model_bias);
+	SnapPut<int>(m->model_rotate);
+
+	SnapPut<int>(m->lung_capacity);
+	SnapPut<int>(m->gasp_start);
+	SnapPutDamage(m->choke_damage);
+
+	SnapPut<percent_t>(m->bobbing);
+	SnapPut<bitset_t>(m->immunity);
+	SnapPut<bitset_t>(m->resistance);
+	SnapPut<bitset_t>(m->ghost);
+	SnapPut<float>(m->resist_multiply);
+	SnapPut<percent_t>(m->resist_painchance);
+
+	SnapPutRef(snap_atk_ids, m->closecombat);
+	SnapPutRef(snap_atk_ids, m->rangeattack);
+	SnapPutRef(snap_atk_ids, m->spareattack);
+
+	SnapPutDLight(m->dlight[0]);
+	SnapPutDLight(m->dlight[1]);
+	SnapPut<int>(m->glow_type);
+	SnapPutWeakness(m->weak);
+
+	SnapPutRef(snap_mobj_ids, m->dropitem);
+	SnapPutString(m->dropitem_ref);
+	SnapPutRef(snap_mobj_ids, m->blood);
+	SnapPutString(m->blood_ref);
+	SnapPutRef(snap_mobj_ids, m->respawneffect);
+	SnapPutString(m->respawneffect_ref);
+	SnapPutRef(snap_mobj_ids, m->spitspot);
+	SnapPutString(m->spitspot_ref);
+
+	SnapPut<float>(m->sight_distance);
+	SnapPut<float>(m->hear_distance);
+	SnapPut<int>(m->morphtimeout);
+	SnapPut<float>(m->gib_health);
+	SnapPut<int>(m->infight_group);
+	SnapPut<int>(m->proj_group);
+	SnapPut<int>(m->splash_group);
+	SnapPut<int>(m->fast_speed);
+	SnapPut<int>(m->melee_range);
+}
+
+
+//
+// DDF_SaveSnapshot
+//
+// Writes the attacks, weapons, things and states as they are straight
+// after parsing.  Nothing is written if any of them holds something
+// which cannot be stored.
+//
+void DDF_SaveSnapshot(const std::filesystem::path& filename)
+{
+	snap_ok = true;
+	snap_out.clear();
+
+	snap_mobj_ids.clear();
+	snap_atk_ids.clear();
+	snap_weap_ids.clear();
+	snap_colmap_ids.clear();
+
+	// the mobjs of attacks are not in the mobjtypes container, they are
+	// numbered after the ones which are.
+	std::vector<const mobjtype_c *> all_mobjs;
+
+	for (int i = 0 ; i < mobjtypes.GetSize() ; i++)
+	{
+		snap_mobj_ids[mobjtypes[i]] = (int)all_mobjs.size();
+		all_mobjs.push_back(mobjtypes[i]);
+	}
+
+	for (int i = 0 ; i < atkdefs.GetSize() ; i++)
+	{
+		const mobjtype_c *m = atkdefs[i]->atk_mobj;
+
+		snap_atk_ids[atkdefs[i]] = i;
+
+		if (m && snap_mobj_ids.find(m) == snap_mobj_ids.end())
+		{
+			snap_mobj_ids[m] = (int)all_mobjs.size();
+			all_mobjs.push_back(m);
+		}
+	}
+
+	for (int i = 0 ; i < weapondefs.GetSize() ; i++)
+		snap_weap_ids[weapondefs[i]] = i;
+
+	for (int i = 0 ; i < colourmaps.GetSize() ; i++)
+		snap_colmap_ids[colourmaps[i]] = i;
+
+	SnapIndexActions(thing_actions,  snap_thing_codes);
+	SnapIndexActions(weapon_actions, snap_weapon_codes);
+
+	// layout changes must not read old files
+	SnapPut<int>((int)sizeof(state_t));
+	SnapPut<int>((int)sizeof(atkdef_c));
+	SnapPut<int>((int)sizeof(weapondef_c));
+	SnapPut<int>((int)sizeof(mobjtype_c));
+
+	SnapPut<int>(sfxdefs.GetSize());
+	SnapPut<int>(colourmaps.GetSize());
+
+	SnapPut<int>((int)ddf_sprite_names.size());
+
+	for (const std::string& name : ddf_sprite_names)
+		SnapPutString(name);
+
+	SnapPut<int>((int)ddf_model_names.size());
+
+	for (const std::string& name : ddf_model_names)
+		SnapPutString(name);
+
+	SnapPut<int>(num_states);
+	SnapPut<int>(mobjtypes.GetSize());
+	SnapPut<int>((int)all_mobjs.size());
+	SnapPut<int>(atkdefs.GetSize());
+	SnapPut<int>(weapondefs.GetSize());
+
+	// state zero is always the template, see DDF_StateInit()
+	for (int i = 1 ; i < num_states ; i++)
+		SnapPutState(&states[i]);
+
+	for (int i = 0 ; i < atkdefs.GetSize() ; i++)
+		SnapPutAttack(atkdefs[i]);
+
+	for (int i = 0 ; i < weapondefs.GetSize() ; i++)
+		SnapPutWeapon(weapondefs[i]);
+
+	for (const mobjtype_c *m : all_mobjs)
+		SnapPutMobj(m);
+
+	snap_mobj_ids.clear();
+	snap_atk_ids.clear();
+	snap_weap_ids.clear();
+	snap_colmap_ids.clear();
+
+	if (! snap_ok)
+	{
+		I_Debugf("DDF: definitions cannot be put in a snapshot\n");
+
+		snap_out.clear();
+		return;
+	}
+
+	epi::file_c *F = epi::FS_Open(filename, epi::file_c::ACCESS_WRITE | epi::file_c::ACCESS_BINARY);
+	if (F == NULL)
+	{
+		I_Warning("Unable to write DDF snapshot file: %s\n", filename.u8string().c_str());
+
+		snap_out.clear();
+		return;
+	}
+
+	epi::md5hash_c md5((const byte *)snap_out.data(), (unsigned int)snap_out.size());
+
+	s32_t length = EPI_LE_S32((int)snap_out.size());
+
+	F->Write(SNAP_MAGIC, 8);
+	F->Write(md5.hash, 16);
+	F->Write(&length, 4);
+	F->Write(snap_out.data(), (unsigned int)snap_out.size());
+
+	delete F;
+
+	epi::FS_Sync();
+
+	I_Debugf("DDF: wrote snapshot: %s\n", filename.u8string().c_str());
+
+	snap_out.clear();
+	snap_out.shrink_to_fit();
+}
+
+
+//----------------------------------------------------------------------------
+//  READING
+//----------------------------------------------------------------------------
+
+static const byte *snap_pos;
+static const byte *snap_end;
+
+// every object, in the order of their indices
+static std::vector<mobjtype_c *>  snap_mobjs;
+static std::vector<atkdef_c *>    snap_atks;
+static std::vector<weapondef_c *> snap_weaps;
+static std::vector<colourmap_c *> snap_colmaps;
+
+static int snap_num_thing_codes;
+static int snap_num_weapon_codes;
+
+
+static void SnapRead(void *dest, size_t len)
+{
+	if (! snap_ok || (size_t)(snap_end - snap_pos) < len)
+	{
+		snap_ok = false;
+		memset(dest, 0, len);
+		return;
+	}
+
+	memcpy(dest, snap_pos, len);
+	snap_pos += len;
+}
+
+template <typename T>
+static T SnapGet(void)
+{
+	T value;
+	SnapRead(&value, sizeof(T));
+	return value;
+}
+
+static bool SnapGetBool(void)
+{
+	return SnapGet<byte>() != 0;
+}
+
+// checks a count read from the file, each item being at least
+// `item_size' bytes.
+static int SnapGetCount(size_t item_size)
+{
+	int count = SnapGet<int>();
+
+	if (count < 0 || (size_t)count * item_size > (size_t)(snap_end - snap_pos))
+	{
+		snap_ok = false;
+		return 0;
+	}
+
+	return count;
+}
+
+static std::string SnapGetString(void)
+{
+	int len = SnapGetCount(1);
+
+	if (! snap_ok)
+		return std::string();
+
+	std::string s((const char *)snap_pos, len);
+	snap_pos += len;
+
+	return s;
+}
+
+// the result is malloc'd like the strdup() in DDF_StateReadState()
+static const char *SnapGetCString(void)
+{
+	int len = SnapGet<int>();
+
+	if (len == -1)
+		return NULL;
+
+	if (len < 0 || len > snap_end - snap_pos)
+	{
+		snap_ok = false;
+		return NULL;
+	}
+
+	char *s = (char *) malloc(len + 1);
+
+	memcpy(s, snap_pos, len);
+	s[len] = 0;
+
+	snap_pos += len;
+
+	return s;
+}
+
+template <typename T>
+static T *SnapGetRef(const std::vector<T *>& list)
+{
+	int idx = SnapGet<int>();
+
+	if (idx == -1)
+		return NULL;
+
+	if (idx < 0 || idx >= (int)list.size())
+	{
+		snap_ok = false;
+		return NULL;
+	}
+
+	return list[idx];
+}
+
+static sfx_t *SnapGetSound(void)
+{
+	int num = SnapGetCount(sizeof(int));
+
+	if (num == 0)
+		return NULL;
+
+	std::vector<int> ids(num);
+
+	for (int i = 0 ; i < num ; i++)
+	{
+		ids[i] = SnapGet<int>();
+
+		if (ids[i] < 0 || ids[i] >= sfxdefs.GetSize())
+			snap_ok = false;
+	}
+
+	if (! snap_ok)
+		return NULL;
+
+	if (num == 1 && SnapGetBool())
+	{
+		sfxdef_c *def = sfxdefs[ids[0]];
+
+		if (def->normal.num != 1 || def->normal.sounds[0] != ids[0])
+		{
+			snap_ok = false;
+			return NULL;
+		}
+
+		return &def->normal;
+	}
+
+	// same as sfxdef_container_c::GetEffect()
+	sfx_t *r = (sfx_t *) new byte[sizeof(sfx_t) + ((num-1) * sizeof(int))];
+
+	r->num = num;
+
+	for (int i = 0 ; i < num ; i++)
+		r->sounds[i] = ids[i];
+
+	return r;
+}
+
+static void SnapGetStateGroup(state_group_t& group)
+{
+	int count = SnapGetCount(2 * sizeof(int));
+
+	group.clear();
+
+	for (int i = 0 ; i < count ; i++)
+	{
+		state_range_t range;
+
+		range.first = SnapGet<int>();
+		range.last  = SnapGet<int>();
+
+		if (range.first < 0 || range.first > range.last || range.last >= num_states)
+			snap_ok = false;
+
+		group.push_back(range);
+	}
+}
+
+static void SnapGetLabelOffset(label_offset_c& lab)
+{
+	lab.label  = SnapGetString();
+	lab.offset = SnapGet<int>();
+}
+
+static benefit_t *SnapGetBenefits(void)
+{
+	int count = SnapGetCount(4 * sizeof(int));
+
+	benefit_t *list = NULL;
+	benefit_t **tail = &list;
+
+	for (int i = 0 ; i < count && snap_ok ; i++)
+	{
+		benefit_t *be = new benefit_t;
+
+		be->next = NULL;
+		be->type = (benefit_type_e) SnapGet<int>();
+
+		if (be->type == BENEFIT_Weapon)
+			be->sub.weap = SnapGetRef(snap_weaps);
+		else
+			be->sub.type = SnapGet<int>();
+
+		be->amount = SnapGet<float>();
+		be->limit  = SnapGet<float>();
+
+		*tail = be;
+		tail  = &be->next;
+	}
+
+	return list;
+}
+
+static pickup_effect_c *SnapGetPickupEffects(void)
+{
+	int count = SnapGetCount(4 * sizeof(int));
+
+	pickup_effect_c *list = NULL;
+	pickup_effect_c **tail = &list;
+
+	for (int i = 0 ; i < count && snap_ok ; i++)
+	{
+		pickup_effect_type_e type = (pickup_effect_type_e) SnapGet<int>();
+
+		pickup_effect_c *pe;
+
+		if (type == PUFX_SwitchWeapon)
+			pe = new pickup_effect_c(type, SnapGetRef(snap_weaps), 0, 0);
+		else
+			pe = new pickup_effect_c(type, SnapGet<int>(), 0, 0);
+
+		pe->slot = SnapGet<int>();
+		pe->time = SnapGet<float>();
+
+		*tail = pe;
+		tail  = &pe->next;
+	}
+
+	return list;
+}
+
+static void SnapGetDamage(damage_c& dm)
+{
+	dm.nominal    = SnapGet<float>();
+	dm.linear_max = SnapGet<float>();
+	dm.error      = SnapGet<float>();
+	dm.delay      = SnapGet<int>();
+
+	dm.obituary = SnapGetString();
+
+	SnapGetLabelOffset(dm.pain);
+	SnapGetLabelOffset(dm.death);
+	SnapGetLabelOffset(dm.overkill);
+
+	dm.no_armour = SnapGetBool();
+	dm.damage_flash_colour = SnapGet<rgbcol_t>();
+	dm.bypass_all  = SnapGetBool();
+	dm.instakill   = SnapGetBool();
+	dm.all_players = SnapGetBool();
+
+	dm.damage_unless = SnapGetBenefits();
+	dm.damage_if     = SnapGetBenefits();
+
+	dm.grounded_monsters = SnapGetBool();
+}
+
+static void SnapGetDLight(dlight_info_c& dl)
+{
+	dl.type   = (dlight_type_e) SnapGet<int>();
+	dl.shape  = SnapGetString();
+	dl.radius = SnapGet<float>();
+	dl.colour = SnapGet<rgbcol_t>();
+	dl.height = SnapGet<percent_t>();
+	dl.leaky  = SnapGetBool();
+
+	dl.cache_data = NULL;
+}
+
+static void SnapGetWeakness(weakness_info_c& wk)
+{
+	wk.height[0]  = SnapGet<percent_t>();
+	wk.height[1]  = SnapGet<percent_t>();
+	wk.angle[0]   = SnapGet<angle_t>();
+	wk.angle[1]   = SnapGet<angle_t>();
+	wk.classes    = SnapGet<bitset_t>();
+	wk.multiply   = SnapGet<float>();
+	wk.painchance = SnapGet<percent_t>();
+}
+
+static void *SnapGetActionPar(const actioncode_t *code)
+{
+	if (! SnapGetBool())
+		return NULL;
+
+	auto handler = code->handle_arg;
+
+	if (handler == DDF_StateGetAttack)
+	{
+		return SnapGetRef(snap_atks);
+	}
+	else if (handler == DDF_StateGetMobj)
+	{
+		std::string name = SnapGetString();
+
+		return new mobj_strref_c(name.c_str());
+	}
+	else if (handler == DDF_StateGetSound)
+	{
+		return SnapGetSound();
+	}
+	else if (handler == DDF_StateGetInteger ||
+	         handler == DDF_MobjStateGetRADTrigger ||
+	         handler == DDF_WStateGetRADTrigger)
+	{
+		return new int(SnapGet<int>());
+	}
+	else if (handler == DDF_StateGetIntPair)
+	{
+		int *values = new int[2];
+
+		values[0] = SnapGet<int>();
+		values[1] = SnapGet<int>();
+
+		return values;
+	}
+	else if (handler == DDF_StateGetFloat ||
+	         handler == DDF_StateGetSlope ||
+	         handler == DDF_StateGetPercent)
+	{
+		return new float(SnapGet<float>());
+	}
+	else if (handler == DDF_StateGetAngle)
+	{
+		return new angle_t(SnapGet<angle_t>());
+	}
+	else if (handler == DDF_StateGetRGB)
+	{
+		return new rgbcol_t(SnapGet<rgbcol_t>());
+	}
+	else if (handler == DDF_StateGetJump)
+	{
+		act_jump_info_t *jump = new act_jump_info_t;
+
+		jump->chance = SnapGet<percent_t>();
+
+		return jump;
+	}
+	else if (handler == DDF_StateGetBecome)
+	{
+		act_become_info_t *become = new act_become_info_t;
+
+		become->info     = SnapGetRef(snap_mobjs);
+		become->info_ref = SnapGetString();
+		SnapGetLabelOffset(become->start);
+
+		return become;
+	}
+	else if (handler == DDF_StateGetMorph)
+	{
+		act_morph_info_t *morph = new act_morph_info_t;
+
+		morph->info     = SnapGetRef(snap_mobjs);
+		morph->info_ref = SnapGetString();
+		SnapGetLabelOffset(morph->start);
+
+		return morph;
+	}
+	else if (handler == DDF_StateGetBecomeWeapon)
+	{
+		wep_become_info_t *become = new wep_become_info_t;
+
+		become->info     = SnapGetRef(snap_weaps);
+		become->info_ref = SnapGetString();
+		SnapGetLabelOffset(become->start);
+
+		return become;
+	}
+
+	snap_ok = false;
+	return NULL;
+}
+
+static void SnapGetState(state_t *st, int num_sprites, int num_models)
+{
+	st->sprite = SnapGet<short>();
+	st->frame  = SnapGet<short>();
+	st->bright = SnapGet<short>();
+	st->flags  = SnapGet<short>();
+	st->tics   = SnapGet<int>();
+
+	st->model_frame = SnapGetCString();
+	st->label       = SnapGetCString();
+
+	st->rts_tag_type = SnapGet<int>();
+	st->nextstate    = SnapGet<int>();
+	st->jumpstate    = SnapGet<int>();
+
+	int limit = (st->flags & SFF_Model) ? num_models : num_sprites;
+
+	if (st->sprite < 0 || st->sprite >= limit)
+		snap_ok = false;
+
+	st->action     = NULL;
+	st->action_par = NULL;
+
+	int code = SnapGet<int>();
+
+	if (code == -1)
+		return;
+
+	bool is_weapon = (st->flags & SFF_Weapon) ? true : false;
+
+	const actioncode_t *actions = is_weapon ? weapon_actions : thing_actions;
+
+	if (code < 0 || code >= (is_weapon ? snap_num_weapon_codes : snap_num_thing_codes))
+		snap_ok = false;
+
+	if (! snap_ok)
+		return;
+
+	st->action     = actions[code].action;
+	st->action_par = SnapGetActionPar(&actions[code]);
+}
+
+static void SnapGetAttack(atkdef_c *a)
+{
+	a->name = SnapGetString();
+
+	a->attackstyle    = (attackstyle_e) SnapGet<int>();
+	a->flags          = (attackflags_e) SnapGet<int>();
+	a->initsound      = SnapGetSound();
+	a->sound          = SnapGetSound();
+	a->accuracy_slope = SnapGet<float>();
+	a->accuracy_angle = SnapGet<angle_t>();
+	a->xoffset        = SnapGet<float>();
+	a->yoffset        = SnapGet<float>();
+	a->angle_offset   = SnapGet<angle_t>();
+	a->slope_offset   = SnapGet<float>();
+	a->trace_angle    = SnapGet<angle_t>();
+	a->assault_speed  = SnapGet<float>();
+	a->height         = SnapGet<float>();
+	a->range          = SnapGet<float>();
+	a->count          = SnapGet<int>();
+	a->tooclose       = SnapGet<int>();
+	a->berserk_mul    = SnapGet<float>();
+
+	SnapGetDamage(a->damage);
+
+	a->attack_class     = SnapGet<bitset_t>();
+	a->objinitstate     = SnapGet<int>();
+	a->objinitstate_ref = SnapGetString();
+	a->notracechance    = SnapGet<percent_t>();
+	a->keepfirechance   = SnapGet<percent_t>();
+
+	a->atk_mobj       = SnapGetRef(snap_mobjs);
+	a->spawnedobj     = SnapGetRef(snap_mobjs);
+	a->spawnedobj_ref = SnapGetString();
+	a->spawn_limit    = SnapGet<int>();
+	a->puff           = SnapGetRef(snap_mobjs);
+	a->puff_ref       = SnapGetString();
+
+	a->dualattack1 = SnapGetRef(snap_atks);
+	a->dualattack2 = SnapGetRef(snap_atks);
+}
+
+static void SnapGetWeapon(weapondef_c *w)
+{
+	w->name = SnapGetString();
+
+	for (int k = 0 ; k < 4 ; k++)
+	{
+		w->attack[k]      = SnapGetRef(snap_atks);
+		w->ammo[k]        = (ammotype_e) SnapGet<int>();
+		w->ammopershot[k] = SnapGet<int>();
+		w->clip_size[k]   = SnapGet<int>();
+		w->autofire[k]    = SnapGetBool();
+	}
+
+	w->kick = SnapGet<float>();
+
+	SnapGetStateGroup(w->state_grp);
+
+	w->up_state    = SnapGet<int>();
+	w->down_state  = SnapGet<int>();
+	w->ready_state = SnapGet<int>();
+	w->empty_state = SnapGet<int>();
+	w->idle_state  = SnapGet<int>();
+
+	for (int k = 0 ; k < 4 ; k++)
+	{
+		w->attack_state[k]  = SnapGet<int>();
+		w->reload_state[k]  = SnapGet<int>();
+		w->discard_state[k] = SnapGet<int>();
+		w->warmup_state[k]  = SnapGet<int>();
+		w->flash_state[k]   = SnapGet<int>();
+	}
+
+	w->crosshair  = SnapGet<int>();
+	w->zoom_state = SnapGet<int>();
+
+	w->no_cheat = SnapGetBool();
+	w->autogive = SnapGetBool();
+	w->feedback = SnapGetBool();
+
+	w->upgrade_weap = SnapGetRef(snap_weaps);
+
+	w->priority  = SnapGet<int>();
+	w->dangerous = SnapGetBool();
+
+	w->eject_attack = SnapGetRef(snap_atks);
+
+	w->idle    = SnapGetSound();
+	w->engaged = SnapGetSound();
+	w->hit     = SnapGetSound();
+	w->start   = SnapGetSound();
+	w->sound1  = SnapGetSound();
+	w->sound2  = SnapGetSound();
+	w->sound3  = SnapGetSound();
+
+	w->nothrust = SnapGetBool();
+	w->bind_key = SnapGet<int>();
+
+	for (int k = 0 ; k < 4 ; k++)
+		w->specials[k] = (weapon_flag_e) SnapGet<int>();
+
+	w->zoom_fov     = SnapGet<int>();
+	w->zoom_factor  = SnapGet<float>();
+	w->refire_inacc = SnapGetBool();
+	w->show_clip    = SnapGetBool();
+	w->shared_clip  = SnapGetBool();
+	w->bobbing      = SnapGet<percent_t>();
+	w->swaying      = SnapGet<percent_t>();
+	w->idle_wait    = SnapGet<int>();
+	w->idle_chance  = SnapGet<percent_t>();
+
+	w->model_skin    = SnapGet<int>();
+	w->model_aspect  = SnapGet<float>();
+	w->model_bias    = SnapGet<float>();
+	w->model_forward = SnapGet<float>();
+	w->model_side    = SnapGet<float>();
+	w->model_rotate  = SnapGet<int>();
+
+	w->render_invert = SnapGetBool();
+	w->y_adjust      = SnapGet<float>();
+	w->ignore_crosshair_scaling = SnapGetBool();
+}
+
+static void SnapGetMobj(mobjtype_c *m)
+{
+	m->name   = SnapGetString();
+	m->number = SnapGet<int>();
+
+	SnapGetStateGroup(m->state_grp);
+
+	m->spawn_state    = SnapGet<int>();
+	m->idle_state     = SnapGet<int>();
+	m->chase_state    = SnapGet<int>();
+	m->pain_state     = SnapGet<int>();
+	m->missile_state  = SnapGet<int>();
+	m->melee_state    = SnapGet<int>();
+	m->death_state    = SnapGet<int>();
+	m->overkill_state = SnapGet<int>();
+	m->raise_state    = SnapGet<int>();
+	m->res_state      = SnapGet<int>();
+	m->meander_state  = SnapGet<int>();
+	m->morph_state    = SnapGet<int>();
+	m->bounce_state   = SnapGet<int>();
+	m->touch_state    = SnapGet<int>();
+	m->gib_state      = SnapGet<int>();
+	m->reload_state   = SnapGet<int>();
+
+	m->reactiontime = SnapGet<int>();
+	m->painchance   = SnapGet<percent_t>();
+	m->spawnhealth  = SnapGet<float>();
+	m->speed        = SnapGet<float>();
+	m->float_speed  = SnapGet<float>();
+	m->radius       = SnapGet<float>();
+	m->height       = SnapGet<float>();
+	m->step_size    = SnapGet<float>();
+	m->mass         = SnapGet<float>();
+
+	m->flags         = SnapGet<int>();
+	m->extendedflags = SnapGet<int>();
+	m->hyperflags    = SnapGet<int>();
+	m->mbf21flags    = SnapGet<int>();
+
+	SnapGetDamage(m->explode_damage);
+	m->explode_radius = SnapGet<float>();
+
+	m->lose_benefits    = SnapGetBenefits();
+	m->pickup_benefits  = SnapGetBenefits();
+	m->kill_benefits    = SnapGetBenefits();
+	m->pickup_effects   = SnapGetPickupEffects();
+	m->pickup_message   = SnapGetString();
+	m->initial_benefits = SnapGetBenefits();
+
+	m->castorder    = SnapGet<int>();
+	m->cast_title   = SnapGetString();
+	m->respawntime  = SnapGet<int>();
+	m->translucency = SnapGet<percent_t>();
+	m->minatkchance = SnapGet<percent_t>();
+	m->palremap     = SnapGetRef(snap_colmaps);
+
+	m->jump_delay    = SnapGet<int>();
+	m->jumpheight    = SnapGet<float>();
+	m->crouchheight  = SnapGet<float>();
+	m->viewheight    = SnapGet<percent_t>();
+	m->shotheight    = SnapGet<percent_t>();
+	m->maxfall       = SnapGet<float>();
+	m->fast          = SnapGet<float>();
+	m->scale         = SnapGet<float>();
+	m->aspect        = SnapGet<float>();
+	m->bounce_speed  = SnapGet<float>();
+	m->bounce_up     = SnapGet<float>();
+	m->sight_slope   = SnapGet<float>();
+	m->sight_angle   = SnapGet<angle_t>();
+	m->ride_friction = SnapGet<float>();
+	m->shadow_trans  = SnapGet<percent_t>();
+
+	m->seesound       = SnapGetSound();
+	m->attacksound    = SnapGetSound();
+	m->painsound      = SnapGetSound();
+	m->deathsound     = SnapGetSound();
+	m->overkill_sound = SnapGetSound();
+	m->activesound    = SnapGetSound();
+	m->walksound      = SnapGetSound();
+	m->jump_sound     = SnapGetSound();
+	m->noway_sound    = SnapGetSound();
+	m->oof_sound      = SnapGetSound();
+	m->fallpain_sound = SnapGetSound();
+	m->gasp_sound     = SnapGetSound();
+	m->secretsound    = SnapGetSound();
+	m->falling_sound  = SnapGetSound();
+	m->rip_sound      = SnapGetSound();
+
+	m->fuse           = SnapGet<int>();
+	m->reload_shots   = SnapGet<int>();
+	m->armour_protect = SnapGet<percent_t>();
+	m->armour_deplete = SnapGet<percent_t>();
+	m->armour_class   = SnapGet<bitset_t>();
+	m->side           = SnapGet<bitset_t>();
+	m->playernum      = SnapGet<int>();
+	m->yalign         = SnapGet<int>();
+
+	m->model_skin   = SnapGet<int>();
+	m->model_scale  = SnapGet<float>();
+	m->model_aspect = SnapGet<float>();
+	m->model_bias   = SnapGet<float>();
+	m->model_rotate = SnapGet<int>();
+
+	m->lung_capacity = SnapGet<int>();
+	m->gasp_start    = SnapGet<int>();
+	SnapGetDamage(m->choke_damage);
+
+	m->bobbing           = SnapGet<percent_t>();
+	m->immunity          = SnapGet<bitset_t>();
+	m->resistance        = SnapGet<bitset_t>();
+	m->ghost             = SnapGet<bitset_t>();
+	m->resist_multiply   = SnapGet<float>();
+	m->resist_painchance = SnapGet<percent_t>();
+
+	m->closecombat = SnapGetRef(snap_atks);
+	m->rangeattack = SnapGetRef(snap_atks);
+	m->spareattack = SnapGetRef(snap_atks);
+
+	SnapGetDLight(m->dlight[0]);
+	SnapGetDLight(m->dlight[1]);
+	m->glow_type = SnapGet<int>();
+	SnapGetWeakness(m->weak);
+
+	m->dropitem          = SnapGetRef(snap_mobjs);
+	m->dropitem_ref      = SnapGetString();
+	m->blood             = SnapGetRef(snap_mobjs);
+	m->blood_ref         = SnapGetString();
+	m->respawneffect     = SnapGetRef(snap_mobjs);
+	m->respawneffect_ref = SnapGetString();
+	m->spitspot          = SnapGetRef(snap_mobjs);
+	m->spitspot_ref      = SnapGetString();
+
+	m->sight_distance = SnapGet<float>();
+	m->hear_distance  = SnapGet<float>();
+	m->morphtimeout   = SnapGet<int>();
+	m->gib_health     = SnapGet<float>();
+	m->infight_group  = SnapGet<int>();
+	m->proj_group     = SnapGet<int>();
+	m->splash_group   = SnapGet<int>();
+	m->fast_speed     = SnapGet<int>();
+	m->melee_range    = SnapGet<int>();
+}
+
+
+static bool SnapReadBody(const byte *data, int length)
+{
+	snap_ok  = true;
+	snap_pos = data;
+	snap_end = data + length;
+
+	snap_ok = (SnapGet<int>() == (int)sizeof(state_t))   &&
+	          (SnapGet<int>() == (int)sizeof(atkdef_c))  &&
+	          (SnapGet<int>() == (int)sizeof(weapondef_c)) &&
+	          (SnapGet<int>() == (int)sizeof(mobjtype_c));
+
+	// the things refer to these by index
+	snap_ok = snap_ok && (SnapGet<int>() == sfxdefs.GetSize());
+	snap_ok = snap_ok && (SnapGet<int>() == colourmaps.GetSize());
+
+	std::vector<std::string> sprite_names(SnapGetCount(sizeof(int)));
+
+	for (std::string& name : sprite_names)
+		name = SnapGetString();
+
+	std::vector<std::string> model_names(SnapGetCount(sizeof(int)));
+
+	for (std::string& name : model_names)
+		name = SnapGetString();
+
+	int total_states = SnapGet<int>();
+	int total_mobjs  = SnapGetCount(1);  // entries in mobjtypes
+	int all_mobjs    = SnapGetCount(1);  // plus the attack ones
+	int total_atks   = SnapGetCount(1);
+	int total_weaps  = SnapGetCount(1);
+
+	if (! snap_ok || total_states < 1 || total_mobjs > all_mobjs ||
+		sprite_names.empty() || model_names.empty() ||
+		(size_t)(total_states - 1) > (size_t)(snap_end - snap_pos) / 32)
+	{
+		return false;
+	}
+
+	for (int i = 0 ; i < colourmaps.GetSize() ; i++)
+		snap_colmaps.push_back(colourmaps[i]);
+
+	for (snap_num_thing_codes = 0 ; thing_actions[snap_num_thing_codes].actionname ; )
+		snap_num_thing_codes++;
+
+	for (snap_num_weapon_codes = 0 ; weapon_actions[snap_num_weapon_codes].actionname ; )
+		snap_num_weapon_codes++;
+
+	// create everything first, so that references can be resolved
+	for (int i = 0 ; i < all_mobjs ; i++)
+		snap_mobjs.push_back(new mobjtype_c);
+
+	for (int i = 0 ; i < total_atks ; i++)
+		snap_atks.push_back(new atkdef_c);
+
+	for (int i = 0 ; i < total_weaps ; i++)
+		snap_weaps.push_back(new weapondef_c);
+
+	state_t *new_states = (state_t *) malloc(total_states * sizeof(state_t));
+	if (new_states == NULL)
+		I_Error("could not allocate states\n");
+
+	new_states[0] = states[0];
+
+	// the state groups are checked against this
+	int old_num_states = num_states;
+	num_states = total_states;
+
+	for (int i = 1 ; i < total_states && snap_ok ; i++)
+		SnapGetState(&new_states[i], (int)sprite_names.size(), (int)model_names.size());
+
+	for (int i = 0 ; i < total_atks && snap_ok ; i++)
+		SnapGetAttack(snap_atks[i]);
+
+	for (int i = 0 ; i < total_weaps && snap_ok ; i++)
+		SnapGetWeapon(snap_weaps[i]);
+
+	for (int i = 0 ; i < all_mobjs && snap_ok ; i++)
+		SnapGetMobj(snap_mobjs[i]);
+
+	if (snap_ok && snap_pos != snap_end)
+		snap_ok = false;
+
+	if (! snap_ok)
+	{
+		num_states = old_num_states;
+
+		free(new_states);
+
+		for (mobjtype_c *m : snap_mobjs)
+			delete m;
+
+		for (atkdef_c *a : snap_atks)
+			delete a;
+
+		for (weapondef_c *w : snap_weaps)
+			delete w;
+
+		return false;
+	}
+
+	free(states);
+	states = new_states;
+
+	ddf_sprite_names.swap(sprite_names);
+	ddf_model_names.swap(model_names);
+
+	for (int i = 0 ; i < total_atks ; i++)
+		atkdefs.Insert(snap_atks[i]);
+
+	for (int i = 0 ; i < total_weaps ; i++)
+		weapondefs.Insert(snap_weaps[i]);
+
+	for (int i = 0 ; i < total_mobjs ; i++)
+		mobjtypes.Insert(snap_mobjs[i]);
+
+	return true;
+}
+
+
+//
+// DDF_LoadSnapshot
+//
+// Returns false when the file is missing or damaged, or when the
+// containers are not empty, in which case nothing has been changed
+// and the definitions must be parsed as usual.
+//
+bool DDF_LoadSnapshot(const std::filesystem::path& filename)
+{
+	if (num_states != 1 || atkdefs.GetSize() > 0 ||
+		weapondefs.GetSize() > 0 || mobjtypes.GetSize() > 0)
+	{
+		return false;
+	}
+
+	if (! epi::FS_Access(filename, epi::file_c::ACCESS_READ))
+		return false;
+
+	epi::file_c *F = epi::FS_Open(filename, epi::file_c::ACCESS_READ | epi::file_c::ACCESS_BINARY);
+	if (F == NULL)
+		return false;
+
+	int file_len = F->GetLength();
+
+	byte *data = NULL;
+
+	if (file_len >= SNAP_HEADER_SIZE)
+		data = F->LoadIntoMemory();
+
+	delete F;
+
+	if (data == NULL)
+		return false;
+
+	s32_t length;
+	memcpy(&length, data + 24, 4);
+	length = EPI_LE_S32(length);
+
+	bool ok = (memcmp(data, SNAP_MAGIC, 8) == 0) &&
+		length == file_len - SNAP_HEADER_SIZE;
+
+	if (ok)
+	{
+		epi::md5hash_c md5(data + SNAP_HEADER_SIZE, (unsigned int)length);
+
+		ok = (memcmp(md5.hash, data + 8, 16) == 0);
+	}
+
+	if (ok)
+		ok = SnapReadBody(data + SNAP_HEADER_SIZE, length);
+
+	snap_mobjs.clear();
+	snap_atks.clear();
+	snap_weaps.clear();
+	snap_colmaps.clear();
+
+	delete[] data;
+
+	if (! ok)
+		I_Debugf("DDF: snapshot is damaged or out of date: %s\n", filename.u8string().c_str());
+
+	return ok;
+}
+
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -37,8 +37,6 @@
 #undef  DF
 #define DF  DDF_FIELD
 
-#define DDF_MobjHashFunc(x)  (((x) + LOOKUP_CACHESIZE) % LOOKUP_CACHESIZE)
-
 const char *TemplateThing = NULL; //Lobo 2022: TEMPLATE inheritance fix
 
 mobjtype_container_c mobjtypes;
@@ -54,7 +52,6 @@ static void DDF_MobjGetGlowType(const char *info, void *storage);
 static void DDF_MobjGetYAlign(const char *info, void *storage);
 static void DDF_MobjGetPercentRange(const char *info, void *storage);
 static void DDF_MobjGetAngleRange(const char *info, void *storage);
-static void DDF_MobjStateGetRADTrigger(const char *arg, state_t * cur_state);
 
 static void AddPickupEffect(pickup_effect_c **list, pickup_effect_c *cur);
 
@@ -685,6 +682,21 @@ int DDF_CompareName(const char *A, const char *B)
 	}
 }
 
+//
+// DDF_NormaliseName
+//
+// Produces a key for hashing names: two names compare equal with
+// DDF_CompareName() exactly when their normalised forms are equal.
+//
+void DDF_NormaliseName(const char *name, std::string& out)
+{
+	out.clear();
+
+	for (; *name ; name++)
+		if (*name != ' ' && *name != '_')
+			out.push_back(toupper(*name));
+}
+
 
 //
 //  DDF PARSE ROUTINES
@@ -1740,6 +1752,7 @@ static specflags_t hyper_specials[] =
 	{"SPLASH", HF_NOSPLASH, 1}, //Lobo: causes no splash on liquids
 	{"DEHACKED_COMPAT", HF_DEHACKED_COMPAT, 0},
 	{"IMMOVABLE", HF_IMMOVABLE, 0},
+	{"PARTICLE", HF_PARTICLE, 0},
 	{NULL, 0, 0}
 };
 
@@ -1978,7 +1991,7 @@ static void DDF_MobjGetAngleRange(const char *info, void *storage)
 //
 // DDF_MobjStateGetRADTrigger
 //
-static void DDF_MobjStateGetRADTrigger(const char *arg, state_t * cur_state)
+void DDF_MobjStateGetRADTrigger(const char *arg, state_t * cur_state)
 {
 	if (!arg || !arg[0])
 		return;
@@ -2604,9 +2617,9 @@ void mobjtype_c::DLightCompatibility(void)
 
 // --> mobjtype_container_c class
 
-mobjtype_container_c::mobjtype_container_c() : epi::array_c(sizeof(mobjtype_c*))
+mobjtype_container_c::mobjtype_container_c() : epi::array_c(sizeof(mobjtype_c*)),
+	name_index(), number_index(), number_index_dirty(false)
 {
-	memset(lookup_cache, 0, sizeof(mobjtype_c*) * LOOKUP_CACHESIZE);
 }
 
 
@@ -2627,11 +2640,64 @@ void mobjtype_container_c::CleanupObject(void *obj)
 }
 
 
+void mobjtype_container_c::IndexName(mobjtype_c *m)
+{
+	std::string key;
+	DDF_NormaliseName(m->name.c_str(), key);
+
+	name_index[key] = m;
+}
+
+
+void mobjtype_container_c::RebuildNumberIndex()
+{
+	number_index.clear();
+
+	// later entries override earlier ones with the same number
+	for (int i = 0 ; i < array_entries ; i++)
+	{
+		mobjtype_c *m = (*this)[i];
+
+		number_index[m->number] = m;
+	}
+
+	number_index_dirty = false;
+}
+
+
+int mobjtype_container_c::Insert(mobjtype_c *m)
+{
+	int pos = InsertObject((void*)&m);
+
+	IndexName(m);
+	number_index_dirty = true;
+
+	return pos;
+}
+
+
+void mobjtype_container_c::Clear()
+{
+	name_index.clear();
+	number_index.clear();
+	number_index_dirty = false;
+
+	epi::array_c::Clear();
+}
+
+
 int mobjtype_container_c::FindFirst(const char *name, int startpos)
 {
 	epi::array_iterator_c it;
 	mobjtype_c *m;
 
+	std::string key;
+	DDF_NormaliseName(name, key);
+
+	// not present at all?
+	if (name_index.find(key) == name_index.end())
+		return -1;
+
 	if (startpos>0)
 		it = GetIterator(startpos);
 	else
@@ -2657,6 +2723,13 @@ int mobjtype_container_c::FindLast(const char *name, int startpos)
 	epi::array_iterator_c it;
 	mobjtype_c *m;
 
+	std::string key;
+	DDF_NormaliseName(name, key);
+
+	// not present at all?
+	if (name_index.find(key) == name_index.end())
+		return -1;
+
 	if (startpos>=0 && startpos<array_entries)
 		it = GetIterator(startpos);
 	else
@@ -2697,6 +2770,10 @@ bool mobjtype_container_c::MoveToEnd(int idx)
 		(array_entries-(idx+1))*array_objsize);
 
 	memcpy(&array[(array_entries-1)*array_block_objsize], (void*)&m, sizeof(mobjtype_c*));
+
+	IndexName(m);
+	number_index_dirty = true;
+
 	return true;
 }
 
@@ -2706,10 +2783,13 @@ const mobjtype_c *mobjtype_container_c::Lookup(const char *refname)
 	// Looks an mobjdef by name.
 	// Fatal error if it does not exist.
 
-	int idx = FindLast(refname);
+	std::string key;
+	DDF_NormaliseName(refname, key);
 
-	if (idx >= 0)
-		return (*this)[idx];
+	auto find = name_index.find(key);
+
+	if (find != name_index.end())
+		return find->second;
 
 	if (lax_errors)
 		return default_mobjtype;
@@ -2727,28 +2807,13 @@ const mobjtype_c *mobjtype_container_c::Lookup(int id)
 	// Looks an mobjdef by number.
 	// Fatal error if it does not exist.
 
-	int slot = DDF_MobjHashFunc(id);
+	if (number_index_dirty)
+		RebuildNumberIndex();
 
-	// check the cache
-	if (lookup_cache[slot] &&
-		lookup_cache[slot]->number == id)
-	{
-		return lookup_cache[slot];
-	}
+	auto find = number_index.find(id);
 
-	epi::array_iterator_c it;
-
-	for (it = GetTailIterator(); it.IsValid(); it--)
-	{
-		mobjtype_c *m = ITERATOR_TO_TYPE(it, mobjtype_c*);
-
-		if (m->number == id)
-		{
-			// update the cache
-			lookup_cache[slot] = m;
-			return m;
-		}
-	}
+	if (find != number_index.end())
+		return find->second;
 
 	return NULL;
 }
@@ -19,6 +19,9 @@
 #ifndef __DDF_MOBJ_H__
 #define __DDF_MOBJ_H__
 
+#include <string>
+#include <unordered_map>
+
 #include "epi.h"
 #include "arrays.h"
 
@@ -316,6 +319,10 @@ typedef enum
 
 	// -Lobo- 2023/10/19: this thing will not be affected by thrust forces
 	HF_IMMOVABLE = (1 << 22),
+
+	// puffs / blood / splashes of this type are lightweight particles
+	// instead of full objects (see p_particle.h)
+	HF_PARTICLE = (1 << 23),
 	
 }
 mobjhyperflag_t;
@@ -1077,14 +1084,26 @@ public:
 private:
 	void CleanupObject(void *obj);
 
-	mobjtype_c* lookup_cache[LOOKUP_CACHESIZE];
+	// normalised name --> last entry with that name.  Kept up to date
+	// by Insert() and MoveToEnd(), since both make an entry the last.
+	std::unordered_map<std::string, mobjtype_c *> name_index;
+
+	// editor number --> last entry with that number.  Numbers can be
+	// changed by DDF after insertion, so this is rebuilt on demand
+	// whenever the list has been modified.
+	std::unordered_map<int, mobjtype_c *> number_index;
+	bool number_index_dirty;
+
+	void IndexName(mobjtype_c *m);
+	void RebuildNumberIndex();
 
 public:
 	// List Management
 	int GetSize() {	return array_entries; } 
-	int Insert(mobjtype_c *m) { return InsertObject((void*)&m); }
+	int Insert(mobjtype_c *m);
 	mobjtype_c* operator[](int idx) { return *(mobjtype_c**)FetchObject(idx); } 
 	bool MoveToEnd(int idx);
+	void Clear();
 
 	// Search Functions
 	int FindFirst(const char *name, int startpos = -1);
@@ -42,7 +42,6 @@ weapondef_container_c weapondefs;
 static void DDF_WGetAmmo(const char *info, void *storage);
 static void DDF_WGetUpgrade(const char *info, void *storage);
 static void DDF_WGetSpecialFlags(const char *info, void *storage);
-static void DDF_WStateGetRADTrigger(const char *arg, state_t * cur_state);
 
 #undef  DDF_CMD_BASE
 #define DDF_CMD_BASE  dummy_weapon
@@ -174,7 +173,7 @@ static const state_starter_t weapon_starters[] =
 };
 
 
-static const actioncode_t weapon_actions[] =
+const actioncode_t weapon_actions[] =
 {
 	{"NOTHING", NULL, NULL},
 
@@ -683,7 +682,7 @@ static specflags_t weapon_specials[] =
 //
 // DDF_WStateGetRADTrigger
 //
-static void DDF_WStateGetRADTrigger(const char *arg, state_t * cur_state)
+void DDF_WStateGetRADTrigger(const char *arg, state_t * cur_state)
 {
 	if (!arg || !arg[0])
 		return;
@@ -959,7 +958,7 @@ void weapondef_c::Default(void)
 // weapondef_container_c Constructor
 //
 weapondef_container_c::weapondef_container_c() 
-	: epi::array_c(sizeof(weapondef_c*))
+	: epi::array_c(sizeof(weapondef_c*)), name_index()
 {
 }
 
@@ -984,6 +983,30 @@ void weapondef_container_c::CleanupObject(void *obj)
 	return;
 }
 
+//
+// weapondef_container_c::Insert()
+//
+int weapondef_container_c::Insert(weapondef_c *w)
+{
+	std::string key;
+	DDF_NormaliseName(w->name.c_str(), key);
+
+	// an earlier entry with the same name takes precedence
+	name_index.emplace(key, w);
+
+	return InsertObject((void*)&w);
+}
+
+//
+// weapondef_container_c::Clear()
+//
+void weapondef_container_c::Clear()
+{
+	name_index.clear();
+
+	epi::array_c::Clear();
+}
+
 //
 // weapondef_container_c::FindFirst()
 //
@@ -992,6 +1015,13 @@ int weapondef_container_c::FindFirst(const char *name, int startpos)
 	epi::array_iterator_c it;
 	weapondef_c *w;
 
+	std::string key;
+	DDF_NormaliseName(name, key);
+
+	// not present at all?
+	if (name_index.find(key) == name_index.end())
+		return -1;
+
 	if (startpos>0)
 		it = GetIterator(startpos);
 	else
@@ -1016,9 +1046,13 @@ int weapondef_container_c::FindFirst(const char *name, int startpos)
 //
 weapondef_c* weapondef_container_c::Lookup(const char* refname)
 {
-	int idx = FindFirst(refname, 0);
-	if (idx >= 0)
-		return (*this)[idx];
+	std::string key;
+	DDF_NormaliseName(refname, key);
+
+	auto find = name_index.find(key);
+
+	if (find != name_index.end())
+		return find->second;
 
 	return NULL;
 }
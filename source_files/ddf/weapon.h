@@ -19,6 +19,9 @@
 #ifndef __DDF_WEAPON_H__
 #define __DDF_WEAPON_H__
 
+#include <string>
+#include <unordered_map>
+
 #include "epi.h"
 #include "arrays.h"
 
@@ -205,10 +208,14 @@ public:
 private:
 	void CleanupObject(void *obj);
 
+	// normalised name --> first entry with that name
+	std::unordered_map<std::string, weapondef_c *> name_index;
+
 public:
 	// List Management
 	int GetSize() {	return array_entries; } 
-	int Insert(weapondef_c *w) { return InsertObject((void*)&w); }
+	int Insert(weapondef_c *w);
+	void Clear();
 	
 	weapondef_c* operator[](int idx) 
 	{ 
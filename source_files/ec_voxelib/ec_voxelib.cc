@@ -62,7 +62,8 @@ void (*voxlib_fatal) (const char *msg) = nullptr;
 
 
 #define VABUF_SIZE  (4096)
-static char vabuf[VABUF_SIZE];
+// per thread, as models may be converted on several threads at once
+static thread_local char vabuf[VABUF_SIZE];
 
 
 // default palette for Magica Voxel files
@@ -138,8 +139,8 @@ void vox_fatal (const char *msg) {
 
 #define VOX_COMATOZE_BUF_SIZE   (128)
 #define VOX_COMATOZE_BUF_COUNT  (8)
-static char vox_comatozebufs[VOX_COMATOZE_BUF_SIZE][VOX_COMATOZE_BUF_COUNT];
-static unsigned vox_comatozebufidx = 0;
+static thread_local char vox_comatozebufs[VOX_COMATOZE_BUF_SIZE][VOX_COMATOZE_BUF_COUNT];
+static thread_local unsigned vox_comatozebufidx = 0;
 
 
 //==========================================================================
@@ -568,7 +569,7 @@ uint32_t VoxelData::allocVox () {
   vassert(data.length());
   ++voxpixtotal;
   if (!freelist) {
-    if (data.length() >= 0x3fffffff) voxlib_fatal("too many voxels");
+    if (data.length() >= 0x3fffffff) vox_fatal("too many voxels");
     const uint32_t lastel = (uint32_t)data.length();
     data.setLength((int)lastel+1024);
     freelist = (uint32_t)data.length()-1;
@@ -1047,7 +1048,7 @@ void VoxelDataSmall::checkValidity (VoxelData &vox) {
     for (uint32_t x = 0; x < xsize; ++x) {
       for (uint32_t z = 0; z < zsize; ++z) {
         const uint32_t vd = vox.query(x, y, z);
-        if (vd != queryVox(x, y, z)) voxlib_fatal("internal error in compressed voxel data");
+        if (vd != queryVox(x, y, z)) vox_fatal("internal error in compressed voxel data");
       }
     }
   }
@@ -41,9 +41,11 @@
 #include "hu_stuff.h"
 #include "hu_style.h"
 #include "m_argv.h"
+#include "r_glstate.h"
 #include "r_draw.h"
 #include "r_image.h"
 #include "r_modes.h"
+#include "r_occlude.h"
 #include "r_wipe.h"
 #include "w_files.h"
 #include "w_wad.h"
@@ -56,6 +58,9 @@
 
 DEF_CVAR(debug_fps, "0", CVAR_ARCHIVE)
 DEF_CVAR(debug_pos, "0", CVAR_ARCHIVE)
+DEF_CVAR(debug_occlusion, "0", 0)
+DEF_CVAR(debug_glstate, "0", 0)
+DEF_CVAR(debug_thinkers, "0", 0)
 
 static visible_t con_visible;
 
@@ -601,8 +606,11 @@ static void CalcSizes()
 
 static void SolidBox(int x, int y, int w, int h, rgbcol_t col, float alpha)
 {
+	// the console draws directly, so anything batched must go first
+	HUD_FlushBatch();
+
 	if (alpha < 0.99f)
-		glEnable(GL_BLEND);
+		RGL_Enable(GL_BLEND);
 
 	glColor4f(RGB_RED(col)/255.0, RGB_GRN(col)/255.0, RGB_BLU(col)/255.0, alpha);
 
@@ -615,7 +623,7 @@ static void SolidBox(int x, int y, int w, int h, rgbcol_t col, float alpha)
 
 	glEnd();
 
-	glDisable(GL_BLEND);
+	RGL_Disable(GL_BLEND);
 }
 
 static void HorizontalLine(int y, rgbcol_t col)
@@ -643,22 +651,22 @@ static void DrawChar(int x, int y, char ch, rgbcol_t col)
 		float y_adjust = con_font->ttf_glyph_map.at(static_cast<u8_t>(ch)).y_shift * FNSZ_ratio;
 		float height = con_font->ttf_glyph_map.at(static_cast<u8_t>(ch)).height * FNSZ_ratio;
 		stbtt_aligned_quad *q = con_font->ttf_glyph_map.at(static_cast<u8_t>(ch)).char_quad;
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glEnable(GL_TEXTURE_2D);
+		RGL_Enable(GL_BLEND);
+		RGL_BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		RGL_Enable(GL_TEXTURE_2D);
 		if ((var_smoothing && con_font->def->ttf_smoothing == con_font->def->TTF_SMOOTH_ON_DEMAND) ||
 			con_font->def->ttf_smoothing == con_font->def->TTF_SMOOTH_ALWAYS)
-			glBindTexture(GL_TEXTURE_2D, con_font->ttf_smoothed_tex_id);
+			RGL_BindTexture(GL_TEXTURE_2D, con_font->ttf_smoothed_tex_id);
 		else
-			glBindTexture(GL_TEXTURE_2D, con_font->ttf_tex_id);
+			RGL_BindTexture(GL_TEXTURE_2D, con_font->ttf_tex_id);
 		glBegin(GL_POLYGON);
 		glTexCoord2f(q->s0,q->t0); glVertex2f(x + x_adjust,y - y_adjust);
         glTexCoord2f(q->s1,q->t0); glVertex2f(x + x_adjust + width,y - y_adjust);
         glTexCoord2f(q->s1,q->t1); glVertex2f(x + x_adjust + width,y - y_adjust - height);
         glTexCoord2f(q->s0,q->t1); glVertex2f(x + x_adjust,y - y_adjust - height);
 		glEnd();
-		glDisable(GL_TEXTURE_2D);
-		glDisable(GL_BLEND);
+		RGL_Disable(GL_TEXTURE_2D);
+		RGL_Disable(GL_BLEND);
 		return;
 	}
 
@@ -695,7 +703,7 @@ static void DrawEndoomChar(int x, int y, char ch, rgbcol_t col, rgbcol_t col2, b
 
 	float alpha = 1.0f;
 
-	glDisable(GL_TEXTURE_2D);
+	RGL_Disable(GL_TEXTURE_2D);
 
 	glColor4f(RGB_RED(col2)/255.0f, RGB_GRN(col2)/255.0f, 
 						RGB_BLU(col2)/255.0f, alpha);
@@ -713,7 +721,7 @@ static void DrawEndoomChar(int x, int y, char ch, rgbcol_t col, rgbcol_t col2, b
 
 	glEnd();
 
-	glEnable(GL_TEXTURE_2D);
+	RGL_Enable(GL_TEXTURE_2D);
 
 	glColor4f(RGB_RED(col)/255.0f, RGB_GRN(col)/255.0f, 
 				RGB_BLU(col)/255.0f, alpha);
@@ -751,17 +759,19 @@ static void DrawEndoomChar(int x, int y, char ch, rgbcol_t col, rgbcol_t col2, b
 // writes the text on coords (x,y) of the console
 static void DrawText(int x, int y, const char *s, rgbcol_t col)
 {
+	HUD_FlushBatch();
+
 	if (con_font->def->type == FNTYP_Image)
 	{
 		// Always whiten the font when used with console output
 		GLuint tex_id = W_ImageCache(con_font->font_image, true, (const colourmap_c *)0, true);
 
-		glEnable(GL_TEXTURE_2D);
-		glBindTexture(GL_TEXTURE_2D, tex_id);
+		RGL_Enable(GL_TEXTURE_2D);
+		RGL_BindTexture(GL_TEXTURE_2D, tex_id);
 	
-		glEnable(GL_BLEND);
-		glEnable(GL_ALPHA_TEST);
-		glAlphaFunc(GL_GREATER, 0);
+		RGL_Enable(GL_BLEND);
+		RGL_Enable(GL_ALPHA_TEST);
+		RGL_AlphaFunc(GL_GREATER, 0);
 	}
 
 	bool draw_cursor = false;
@@ -792,23 +802,25 @@ static void DrawText(int x, int y, const char *s, rgbcol_t col)
 	if (draw_cursor)
 		DrawChar(x, y, 95, col);
 
-	glDisable(GL_TEXTURE_2D);
-	glDisable(GL_ALPHA_TEST);
-	glDisable(GL_BLEND);
+	RGL_Disable(GL_TEXTURE_2D);
+	RGL_Disable(GL_ALPHA_TEST);
+	RGL_Disable(GL_BLEND);
 }
 
 
 static void EndoomDrawText(int x, int y, console_line_c *endoom_line)
 {
+	HUD_FlushBatch();
+
 	// Always whiten the font when used with console output
 	GLuint tex_id = W_ImageCache(endoom_font->font_image, true, (const colourmap_c *)0, true);
 
-	glEnable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, tex_id);
+	RGL_Enable(GL_TEXTURE_2D);
+	RGL_BindTexture(GL_TEXTURE_2D, tex_id);
  
-	glEnable(GL_BLEND);
-	glEnable(GL_ALPHA_TEST);
-	glAlphaFunc(GL_GREATER, 0);
+	RGL_Enable(GL_BLEND);
+	RGL_Enable(GL_ALPHA_TEST);
+	RGL_AlphaFunc(GL_GREATER, 0);
 
 	for (int i=0; i < 80; i++)
 	{
@@ -823,9 +835,9 @@ static void EndoomDrawText(int x, int y, console_line_c *endoom_line)
 			break;
 	}
 
-	glDisable(GL_TEXTURE_2D);
-	glDisable(GL_ALPHA_TEST);
-	glDisable(GL_BLEND);
+	RGL_Disable(GL_TEXTURE_2D);
+	RGL_Disable(GL_ALPHA_TEST);
+	RGL_Disable(GL_BLEND);
 }
 
 void CON_SetupFont(void)
@@ -1752,6 +1764,145 @@ void CON_ShowPosition(void)
 }
 
 
+void CON_ShowOcclusion(void)
+{
+	if (debug_occlusion.d <= 0)
+		return;
+
+	CON_SetupFont();
+
+	char textbuf[128];
+
+	int x = 0;
+	int y = SCREENHEIGHT - FNSZ * 5;
+
+	SolidBox(x, y - FNSZ * 4, XMUL * 18, FNSZ * 4 + 2, RGB_MAKE(0,0,0), 0.5);
+
+	x += XMUL;
+	y -= FNSZ * (con_font->def->type == FNTYP_TrueType ? 0.25 : 1.25);
+	sprintf(textbuf, " nodes: %d", occ_stats.nodes_checked);
+	DrawText(x, y, textbuf, T_GREY176);
+
+	y -= FNSZ;
+	sprintf(textbuf, "culled: %d", occ_stats.nodes_culled);
+	DrawText(x, y, textbuf, T_GREY176);
+
+	y -= FNSZ;
+	sprintf(textbuf, "  subs: %d", occ_stats.subs_visited);
+	DrawText(x, y, textbuf, T_GREY176);
+
+	y -= FNSZ;
+	sprintf(textbuf, "  segs: %d hidden", occ_stats.segs_culled);
+	DrawText(x, y, textbuf, T_GREY176);
+}
+
+
+void CON_ShowGLState(void)
+{
+	if (debug_glstate.d <= 0)
+		return;
+
+	CON_SetupFont();
+
+	char textbuf[128];
+
+	int x = 0;
+	int y = SCREENHEIGHT - FNSZ * 10;
+
+	SolidBox(x, y - FNSZ * 6, XMUL * 18, FNSZ * 6 + 2, RGB_MAKE(0,0,0), 0.5);
+
+	x += XMUL;
+	y -= FNSZ * (con_font->def->type == FNTYP_TrueType ? 0.25 : 1.25);
+	sprintf(textbuf, "  draws: %d", gl_last_stats.draw_calls);
+	DrawText(x, y, textbuf, T_GREY176);
+
+	y -= FNSZ;
+	sprintf(textbuf, "  verts: %d", gl_last_stats.vertices);
+	DrawText(x, y, textbuf, T_GREY176);
+
+	y -= FNSZ;
+	sprintf(textbuf, "  units: %d", gl_last_stats.units);
+	DrawText(x, y, textbuf, T_GREY176);
+
+	y -= FNSZ;
+	sprintf(textbuf, "  binds: %d", gl_last_stats.binds);
+	DrawText(x, y, textbuf, T_GREY176);
+
+	y -= FNSZ;
+	sprintf(textbuf, "changes: %d", gl_last_stats.state_changes);
+	DrawText(x, y, textbuf, T_GREY176);
+
+	y -= FNSZ;
+	sprintf(textbuf, "skipped: %d", gl_last_stats.redundant);
+	DrawText(x, y, textbuf, T_GREY176);
+}
+
+
+// size of the hot part of mobj_t (everything before vertangle).
+// mobj_t is not "standard layout" (both it and position_c have data
+// members), but there are no virtual bases, so offsetof still works.
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+#endif
+static constexpr int mobj_hot_size = (int) offsetof(mobj_t, vertangle);
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+
+// keep it within six cache lines
+static_assert(mobj_hot_size <= 384, "the hot part of mobj_t has grown too big");
+
+
+void CON_ShowThinkers(void)
+{
+	if (debug_thinkers.d <= 0)
+		return;
+
+	CON_SetupFont();
+
+	char textbuf[128];
+
+	const thinker_stats_t& ts = thinker_last_stats;
+
+	int tics = MAX(1, ts.tics);
+
+	int x = 0;
+	int y = SCREENHEIGHT - FNSZ * 17;
+
+	SolidBox(x, y - FNSZ * 7, XMUL * 18, FNSZ * 7 + 2, RGB_MAKE(0,0,0), 0.5);
+
+	x += XMUL;
+	y -= FNSZ * (con_font->def->type == FNTYP_TrueType ? 0.25 : 1.25);
+	sprintf(textbuf, " objects: %d", ts.objects / tics);
+	DrawText(x, y, textbuf, T_GREY176);
+
+	y -= FNSZ;
+	sprintf(textbuf, " dormant: %d", ts.dormant);
+	DrawText(x, y, textbuf, T_GREY176);
+
+	y -= FNSZ;
+	sprintf(textbuf, "  thinks: %d", ts.thinks / tics);
+	DrawText(x, y, textbuf, T_GREY176);
+
+	y -= FNSZ;
+	sprintf(textbuf, "usec/tic: %d", (int)(ts.micros / tics));
+	DrawText(x, y, textbuf, T_GREY176);
+
+	y -= FNSZ;
+	sprintf(textbuf, "ns/think: %d", ts.thinks > 0 ? (int)(ts.micros * 1000.0 / ts.thinks) : 0);
+	DrawText(x, y, textbuf, T_GREY176);
+
+	y -= FNSZ;
+	sprintf(textbuf, "    mobj: %d bytes", (int)sizeof(mobj_t));
+	DrawText(x, y, textbuf, T_GREY176);
+
+	y -= FNSZ;
+	sprintf(textbuf, "     hot: %d bytes", mobj_hot_size);
+	DrawText(x, y, textbuf, T_GREY176);
+}
+
+
 void CON_PrintEndoom()
 {
 	int length = 0;
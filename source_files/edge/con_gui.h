@@ -35,6 +35,9 @@ void CON_Drawer(void);
 
 void CON_ShowFPS(void);
 void CON_ShowPosition(void);
+void CON_ShowOcclusion(void);
+void CON_ShowGLState(void);
+void CON_ShowThinkers(void);
 
 // Initialises the console
 void CON_InitConsole(void);
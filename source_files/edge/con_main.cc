@@ -30,9 +30,13 @@
 #include "con_var.h"
 #include "dm_state.h"
 #include "e_input.h"
+#include "e_player.h"
 #include "g_game.h"
 #include "m_menu.h"
 #include "m_misc.h"
+#include "p_local.h"
+#include "r_misc.h"
+#include "r_modes.h"
 #include "s_sound.h"
 #include "w_files.h"
 #include "w_wad.h"
@@ -496,6 +500,76 @@ int CMD_Map(char **argv, int argc)
 	return 0;
 }
 
+//
+// Times the BSP walk (scene collection) from the console player's
+// view on its own, without any GL submission.
+//
+int CMD_BenchScene(char **argv, int argc)
+{
+	if (gamestate != GS_LEVEL || ! players[consoleplayer] || ! players[consoleplayer]->mo)
+	{
+		CON_Printf("benchscene: no level is active\n");
+		return 1;
+	}
+
+	int count = (argc >= 2) ? atoi(argv[1]) : 100;
+
+	if (count < 1)
+		count = 1;
+
+	mobj_t *camera = players[consoleplayer]->mo;
+
+	int num_subs = 0;
+
+	u32_t start = I_GetMicros();
+
+	for (int i = 0; i < count; i++)
+		num_subs = R_CollectScene(0, 0, SCREENWIDTH, SCREENHEIGHT, camera, false, 1.0f);
+
+	u32_t elapsed = I_GetMicros() - start;
+
+	CON_Printf("Scene: %d subsectors, %1.1f usec per walk (%d walks)\n",
+		num_subs, elapsed / (double)count, count);
+
+	return 0;
+}
+
+//
+// Times the thing thinkers on their own.  The level really runs on
+// for those tics (without the players, sectors or scripts), so use
+// it from the same starting point when comparing builds.
+//
+int CMD_BenchThinkers(char **argv, int argc)
+{
+	if (gamestate != GS_LEVEL)
+	{
+		CON_Printf("benchthinkers: no level is active\n");
+		return 1;
+	}
+
+	int count = (argc >= 2) ? atoi(argv[1]) : 350;
+
+	if (count < 1)
+		count = 1;
+
+	int num_mobjs = 0;
+
+	for (mobj_t *mo = mobjlisthead; mo; mo = mo->next)
+		num_mobjs++;
+
+	u32_t start = I_GetMicros();
+
+	for (int i = 0; i < count; i++)
+		P_RunMobjThinkers(false);
+
+	u32_t elapsed = I_GetMicros() - start;
+
+	CON_Printf("Thinkers: %d objects, %1.1f usec per tic (%d tics)\n",
+		num_mobjs, elapsed / (double)count, count);
+
+	return 0;
+}
+
 int CMD_Endoom(char **argv, int argc)
 {
 	CON_PrintEndoom();
@@ -578,6 +652,8 @@ static void KillArgs(char **argv, int argc)
 const con_cmd_t builtin_commands[] =
 {
 	{ "args",           CMD_ArgList },
+	{ "benchscene",     CMD_BenchScene },
+	{ "benchthinkers",  CMD_BenchThinkers },
 	{ "cat",            CMD_Type },
 	{ "cls",            CMD_Clear },
 	{ "clear",          CMD_Clear },
@@ -75,6 +75,7 @@
 #include "r_local.h"
 #include "rad_trig.h"
 #include "r_gldefs.h"
+#include "r_glstate.h"
 #include "r_wipe.h"
 #include "s_sound.h"
 #include "s_music.h"
@@ -93,6 +94,7 @@
 #include "vm_coal.h"
 
 extern cvar_c r_doubleframes;
+extern cvar_c r_uncapped;
 
 extern cvar_c v_gamma;
 
@@ -191,6 +193,9 @@ DEF_CVAR(ddf_strict, "0", CVAR_ARCHIVE)
 DEF_CVAR(ddf_lax,    "0", CVAR_ARCHIVE)
 DEF_CVAR(ddf_quiet,  "0", CVAR_ARCHIVE)
 
+// parsed attacks, weapons and things are kept in the cache directory
+DEF_CVAR(ddf_cache,  "1", CVAR_ARCHIVE)
+
 static const image_c *loading_image = NULL;
 
 static void E_TitleDrawer(void);
@@ -215,6 +220,7 @@ public:
 	void drawIt()
 	{
 		I_StartFrame();
+		RGL_StartFrameState();
 		HUD_FrameSetup();
 		if (loading_image)
 		{
@@ -256,22 +262,28 @@ public:
 	if (v_gamma.f < 0)
 	{
 		int col = (1.0f + v_gamma.f) * 255;
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_ZERO, GL_SRC_COLOR);
+		HUD_FlushBatch();
+		RGL_Enable(GL_BLEND);
+		RGL_BlendFunc(GL_ZERO, GL_SRC_COLOR);
 		HUD_SolidBox(hud_x_left, 0, hud_x_right, 200, RGB_MAKE(col, col, col));
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glDisable(GL_BLEND);
+		HUD_FlushBatch();
+		RGL_BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		RGL_Disable(GL_BLEND);
 	}
 	else if (v_gamma.f > 0)
 	{
 		int col = v_gamma.f * 255;
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_DST_COLOR, GL_ONE);
+		HUD_FlushBatch();
+		RGL_Enable(GL_BLEND);
+		RGL_BlendFunc(GL_DST_COLOR, GL_ONE);
 		HUD_SolidBox(hud_x_left, 0, hud_x_right, 200, RGB_MAKE(col, col, col));
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glDisable(GL_BLEND);
+		HUD_FlushBatch();
+		RGL_BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		RGL_Disable(GL_BLEND);
 	}
 
+		HUD_FlushBatch();
+
 		I_FinishFrame();
 	}
 };
@@ -577,6 +589,7 @@ void E_Display(void)
 
 	// Start the frame - should we need to.
 	I_StartFrame();
+	RGL_StartFrameState();
 
 	HUD_FrameSetup();
 
@@ -593,6 +606,7 @@ void E_Display(void)
 
 			if (need_save_screenshot)
 			{
+				HUD_FlushBatch();
 				M_MakeSaveScreenShot();
 				need_save_screenshot = false;
 			}
@@ -617,6 +631,9 @@ void E_Display(void)
 			break;
 	}
 
+	// the wipe draws with the GL directly, and may read the screen
+	HUD_FlushBatch();
+
 	if (wipe_gl_active)
 	{
 		// -AJA- Wipe code for GL.  Sorry for all this ugliness, but it just
@@ -660,22 +677,28 @@ void E_Display(void)
 	if (v_gamma.f < 0)
 	{
 		int col = (1.0f + v_gamma.f) * 255;
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_ZERO, GL_SRC_COLOR);
+		HUD_FlushBatch();
+		RGL_Enable(GL_BLEND);
+		RGL_BlendFunc(GL_ZERO, GL_SRC_COLOR);
 		HUD_SolidBox(hud_x_left, 0, hud_x_right, 200, RGB_MAKE(col, col, col));
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glDisable(GL_BLEND);
+		HUD_FlushBatch();
+		RGL_BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		RGL_Disable(GL_BLEND);
 	}
 	else if (v_gamma.f > 0)
 	{
 		int col = v_gamma.f * 255;
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_DST_COLOR, GL_ONE);
+		HUD_FlushBatch();
+		RGL_Enable(GL_BLEND);
+		RGL_BlendFunc(GL_DST_COLOR, GL_ONE);
 		HUD_SolidBox(hud_x_left, 0, hud_x_right, 200, RGB_MAKE(col, col, col));
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glDisable(GL_BLEND);
+		HUD_FlushBatch();
+		RGL_BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		RGL_Disable(GL_BLEND);
 	}
 
+	HUD_FlushBatch();
+
 	if (m_screenshot_required)
 	{
 		m_screenshot_required = false;
@@ -963,7 +986,7 @@ void InitDirectories(void)
         epi::FS_MakeDir(shot_dir);
 }
 
-// Get rid of legacy GWA/HWA files or XWA files older than 6 months
+// Get rid of legacy GWA/HWA files or XWA/DHC/VXM files older than 6 months
 
 static void PurgeCache(void)
 {
@@ -985,7 +1008,10 @@ static void PurgeCache(void)
 					epi::FS_Delete(fsd[i].name);
 				else if (fsd[i].name.extension().compare(".hwa") == 0)
 					epi::FS_Delete(fsd[i].name);
-				else if (fsd[i].name.extension().compare(".xwa") == 0)
+				else if (fsd[i].name.extension().compare(".xwa") == 0 ||
+				         fsd[i].name.extension().compare(".dhc") == 0 ||
+				         fsd[i].name.extension().compare(".dds") == 0 ||
+				         fsd[i].name.extension().compare(".vxm") == 0)
 				{
 					if(std::filesystem::last_write_time(fsd[i].name) < expiry)
 					{
@@ -1639,6 +1665,26 @@ static void InitDDF(void)
 }
 
 
+//
+// The name incorporates the engine version as well as the DDF, DEH
+// and RTS input, since the definitions change between versions.
+//
+static std::filesystem::path DDFSnapshotFilename(void)
+{
+	if (! ddf_cache.d || cache_dir.empty())
+		return std::filesystem::path();
+
+	std::string name = "ddf-";
+
+	name += DDF_SnapshotKey();
+	name += "-";
+	name += edgeversion.s;
+	name += ".dds";
+
+	return epi::PATH_Join(cache_dir, name);
+}
+
+
 void E_EngineShutdown(void)
 {
 	N_QuitNetGame();
@@ -1702,7 +1748,7 @@ static void E_Startup(void)
 
 	RAD_Init();
 	W_ProcessMultipleFiles();
-	DDF_ParseEverything();
+	DDF_ParseEverything(argv::Find("ddfbench") > 0, DDFSnapshotFilename());
 	// Must be done after WAD and DDF loading to check for potential
 	// overrides of lump-specific image/sound/DDF defines
 	W_DoPackSubstitutions();
@@ -1940,9 +1986,10 @@ void E_Tick(void)
 
 	// ignore this assertion if in a menu; switching between 35/70FPS
 	// in Video Options can occasionally produce a 'valid'
-	// zero count for N_TryRunTics()
+	// zero count for N_TryRunTics().  With an uncapped frame rate,
+	// zero simply means no tic is due yet.
 
-	if (!menuactive)
+	if (!menuactive && !r_uncapped.d)
 		SYS_ASSERT(counts > 0);
 
 	// run the tics
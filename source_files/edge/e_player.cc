@@ -591,7 +591,7 @@ void G_SpawnHelper(int pnum)
 	mobj_t *mo = P_MobjCreateObject(point->x, point->y, point->z, info);
 
 	mo->angle = point->angle;
-	mo->spawnpoint = *point;
+	mo->cold->spawnpoint = *point;
 
 	mo->side = ~0;
 }
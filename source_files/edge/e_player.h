@@ -185,6 +185,9 @@ typedef struct player_s
 	// will be FLO_UNUSED until the first think.
 	float viewz;
 
+	// viewz at the start of the current tic (for interpolation)
+	float prev_viewz;
+
 	// Base height above floor for viewz.  Tracks `std_viewheight' but
 	// is different when squatting (i.e. after a fall).
 	float viewheight;
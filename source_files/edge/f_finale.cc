@@ -54,6 +54,7 @@
 #include "r_modes.h"
 #include "r_state.h"
 #include "r_gldefs.h"
+#include "r_glstate.h"
 #include "s_sound.h"
 #include "s_music.h"
 #include "w_wad.h"
@@ -801,8 +802,10 @@ static void CastDrawer(void)
 		if (! skin_img)
 			skin_img = W_ImageForDummySkin();
 
+		HUD_FlushBatch();
+
 		glClear(GL_DEPTH_BUFFER_BIT);
-		glEnable(GL_DEPTH_TEST);
+		RGL_Enable(GL_DEPTH_TEST);
 
 		if (md->md2_model)
 			MD2_RenderModel_2D(md->md2_model, skin_img, caststate->frame,
@@ -814,7 +817,7 @@ static void CastDrawer(void)
 			VXL_RenderModel_2D(md->vxl_model, pos_x, pos_y,
 							scale_x, scale_y, castorder);
 
-		glDisable(GL_DEPTH_TEST);
+		RGL_Disable(GL_DEPTH_TEST);
 		return;
 	}
 
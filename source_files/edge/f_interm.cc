@@ -2056,12 +2056,12 @@ void WI_Start(void)
 
 	if (gd->bg_camera != "")
 	{
-		for (mobj_t *mo = mobjlisthead; mo != NULL; mo = mo->next)
+		for (auto& it : P_AllMobjTypes())
 		{
-			if (DDF_CompareName(mo->info->name.c_str(), gd->bg_camera.c_str()) != 0)
+			if (DDF_CompareName(it.first->name.c_str(), gd->bg_camera.c_str()) != 0)
 				continue;
 
-			background_camera_mo = mo;
+			background_camera_mo = it.second;
 
 			// we don't want to see players
 			for (int pnum = 0; pnum < MAXPLAYERS; pnum++)
@@ -857,6 +857,8 @@ static bool G_LoadGameFromFile(std::filesystem::path filename, bool is_hub)
 	SV_FinishLoad();
 	SV_CloseReadFile();
 
+	P_ResetInterpolation();
+
 	return true; //OK
 }
 
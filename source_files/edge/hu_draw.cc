@@ -19,20 +19,25 @@
 #include "i_defs.h"
 #include "i_defs_gl.h"
 
+#include <vector>
+
 #include "font.h"
 
 #include "con_main.h"
 
 #include "am_map.h"
+#include "dm_state.h"
 #include "g_game.h"
 #include "r_misc.h"
 #include "r_gldefs.h"
+#include "r_glstate.h"
 #include "r_units.h"
 #include "r_colormap.h"
 #include "hu_draw.h"
 #include "r_modes.h"
 #include "r_image.h"
 #include "r_misc.h"     //  R_Render
+#include "p_tick.h"
 
 #include "str_compare.h"
 
@@ -51,6 +56,7 @@ extern font_c *endoom_font;
 extern cvar_c r_overlay;
 extern cvar_c r_doubleframes;
 extern cvar_c r_titlescaling;
+extern cvar_c r_uncapped;
 
 static font_c *default_font;
 
@@ -262,9 +268,11 @@ void HUD_PushScissor(float x1, float y1, float x2, float y2, bool expand)
 	int sx1 = I_ROUND(x1); int sy1 = I_ROUND(y1);
 	int sx2 = I_ROUND(x2); int sy2 = I_ROUND(y2);
 
+	HUD_FlushBatch();
+
 	if (sci_stack_top == 0)
 	{
-		glEnable(GL_SCISSOR_TEST);
+		RGL_Enable(GL_SCISSOR_TEST);
 
 		sx1 = MAX(sx1, 0);
 		sy1 = MAX(sy1, 0);
@@ -303,11 +311,13 @@ void HUD_PopScissor()
 {
 	SYS_ASSERT(sci_stack_top > 0);
 
+	HUD_FlushBatch();
+
 	sci_stack_top--;
 
 	if (sci_stack_top == 0)
 	{
-		glDisable(GL_SCISSOR_TEST);
+		RGL_Disable(GL_SCISSOR_TEST);
 	}
 	else
 	{
@@ -389,6 +399,174 @@ void HUD_CalcTurbulentTexCoords( float *tx, float *ty, float x, float y )
 	}
 }
 
+//----------------------------------------------------------------------------
+//  HUD quad batching
+//----------------------------------------------------------------------------
+//
+// Quads which share a texture and alpha/blend state are collected and
+// drawn together with a single call, instead of one glBegin/glEnd
+// (and texture bind) each.  Anything which draws with other state or
+// changes the scissor must call HUD_FlushBatch() first, so that the
+// order of drawing is kept.
+//
+
+typedef struct
+{
+	GLfloat pos[2];
+	GLfloat texc[2];
+	GLfloat rgba[4];
+}
+hud_vert_t;
+
+typedef struct
+{
+	GLuint tex_id;  // zero for untextured quads
+
+	bool alpha_test;
+	float alpha_ref;
+
+	bool blend;
+}
+hud_batch_state_t;
+
+static std::vector<hud_vert_t> hud_batch_verts;
+
+static hud_batch_state_t hud_batch_state;
+
+
+void HUD_FlushBatch(void)
+{
+	if (hud_batch_verts.empty())
+		return;
+
+	const hud_batch_state_t& st = hud_batch_state;
+
+	if (st.tex_id != 0)
+	{
+		RGL_Enable(GL_TEXTURE_2D);
+		RGL_BindTexture(GL_TEXTURE_2D, st.tex_id);
+	}
+	else
+		RGL_Disable(GL_TEXTURE_2D);
+
+	if (st.alpha_test)
+	{
+		RGL_Enable(GL_ALPHA_TEST);
+		RGL_AlphaFunc(GL_GREATER, st.alpha_ref);
+	}
+	else
+		RGL_Disable(GL_ALPHA_TEST);
+
+	// like the immediate code this replaces, blending is left alone
+	// when not needed, so a caller may enable it with its own function.
+	if (st.blend)
+		RGL_Enable(GL_BLEND);
+
+	const hud_vert_t *base = hud_batch_verts.data();
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glVertexPointer(2, GL_FLOAT, sizeof(hud_vert_t), base->pos);
+	glColorPointer (4, GL_FLOAT, sizeof(hud_vert_t), base->rgba);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+
+	if (st.tex_id != 0)
+	{
+		glClientActiveTexture(GL_TEXTURE0);
+		glTexCoordPointer(2, GL_FLOAT, sizeof(hud_vert_t), base->texc);
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	}
+
+	glDrawArrays(GL_QUADS, 0, (GLsizei)hud_batch_verts.size());
+
+	gl_stats.draw_calls++;
+	gl_stats.vertices += (int)hud_batch_verts.size();
+
+	if (st.tex_id != 0)
+		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+
+	// the current colour is undefined after using a colour array
+	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+
+	RGL_Disable(GL_TEXTURE_2D);
+	RGL_Disable(GL_ALPHA_TEST);
+	RGL_Disable(GL_BLEND);
+
+	RGL_AlphaFunc(GL_GREATER, 0);
+
+	hud_batch_verts.clear();
+}
+
+static void SetBatchState(GLuint tex_id, bool alpha_test, float alpha_ref, bool blend)
+{
+	hud_batch_state_t& st = hud_batch_state;
+
+	if (! alpha_test)
+		alpha_ref = 0;
+
+	if (! hud_batch_verts.empty() &&
+		(st.tex_id != tex_id || st.alpha_test != alpha_test ||
+		 st.alpha_ref != alpha_ref || st.blend != blend))
+	{
+		HUD_FlushBatch();
+	}
+
+	st.tex_id     = tex_id;
+	st.alpha_test = alpha_test;
+	st.alpha_ref  = alpha_ref;
+	st.blend      = blend;
+}
+
+static inline void AddBatchVert(float x, float y, float tx, float ty, const GLfloat *rgba)
+{
+	hud_vert_t v;
+
+	v.pos[0]  = x;  v.pos[1]  = y;
+	v.texc[0] = tx; v.texc[1] = ty;
+
+	v.rgba[0] = rgba[0]; v.rgba[1] = rgba[1];
+	v.rgba[2] = rgba[2]; v.rgba[3] = rgba[3];
+
+	hud_batch_verts.push_back(v);
+}
+
+// adds a quad with (s1,t1) at (x1,y1) and (s2,t2) at (x2,y2)
+static void AddBatchQuad(float x1, float y1, float x2, float y2,
+						 float s1, float t1, float s2, float t2,
+						 const GLfloat *rgba)
+{
+	AddBatchVert(x1, y1, s1, t1, rgba);
+	AddBatchVert(x2, y1, s2, t1, rgba);
+	AddBatchVert(x2, y2, s2, t2, rgba);
+	AddBatchVert(x1, y2, s1, t2, rgba);
+}
+
+// the alpha test / blending used for a textured image
+static void SetImageBatchState(GLuint tex_id, int opacity, float alpha)
+{
+	bool alpha_test = ! (alpha >= 0.99f && opacity == OPAC_Solid);
+	float alpha_ref = 0;
+
+	if (alpha_test && ! (alpha < 0.11f || opacity == OPAC_Complex))
+		alpha_ref = alpha * 0.66f;
+
+	bool blend = (opacity == OPAC_Complex || alpha < 0.99f);
+
+	SetBatchState(tex_id, alpha_test, alpha_ref, blend);
+}
+
+static inline void MakeRGBA(GLfloat *rgba, rgbcol_t col, float alpha)
+{
+	rgba[0] = RGB_RED(col) / 255.0f;
+	rgba[1] = RGB_GRN(col) / 255.0f;
+	rgba[2] = RGB_BLU(col) / 255.0f;
+	rgba[3] = alpha;
+}
+
 //----------------------------------------------------------------------------
 
 void HUD_RawImage(float hx1, float hy1, float hx2, float hy2,
@@ -421,46 +599,53 @@ void HUD_RawImage(float hx1, float hy1, float hx2, float hy2,
 		do_whiten = true;
 	}
 
+	GLfloat rgba[4] = { r, g, b, alpha };
+
 	if (epi::strcmp(image->name, "TTF_DUMMY_IMAGE") == 0)
 	{
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glEnable(GL_TEXTURE_2D);
+		GLuint tex_id;
 		if ((var_smoothing && cur_font->def->ttf_smoothing == cur_font->def->TTF_SMOOTH_ON_DEMAND) ||
 			cur_font->def->ttf_smoothing == cur_font->def->TTF_SMOOTH_ALWAYS)
-			glBindTexture(GL_TEXTURE_2D, cur_font->ttf_smoothed_tex_id);
+			tex_id = cur_font->ttf_smoothed_tex_id;
 		else
-			glBindTexture(GL_TEXTURE_2D, cur_font->ttf_tex_id);
-		glColor4f(r, g, b, alpha);
-		glBegin(GL_QUADS);
-		glTexCoord2f(tx1,ty2); glVertex2f(hx1,hy1);
-        glTexCoord2f(tx2,ty2); glVertex2f(hx2,hy1);
-        glTexCoord2f(tx2,ty1); glVertex2f(hx2,hy2);
-        glTexCoord2f(tx1,ty1); glVertex2f(hx1,hy2);
-		glEnd();
-		glDisable(GL_TEXTURE_2D);
-		glDisable(GL_BLEND);
+			tex_id = cur_font->ttf_tex_id;
+
+		SetBatchState(tex_id, false, 0, true);
+		AddBatchQuad(hx1, hy1, hx2, hy2, tx1, ty2, tx2, ty1, rgba);
 		return;
 	}
 
 	//GLuint tex_id = W_ImageCache(image, true, palremap, do_whiten);
 	GLuint tex_id = W_ImageCache(image, true, nullptr, do_whiten);
 
-	glEnable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, tex_id);
+	bool hud_swirl = (image->liquid_type > LIQ_None && swirling_flats > SWIRL_SMMU);
+
+	// the common case: no scrolling, wrapping or swirling
+	if (sx == 0.0 && sy == 0.0 && ! hud_swirl &&
+		epi::strcmp(image->name, hud_overlays.at(r_overlay.d)) != 0)
+	{
+		SetImageBatchState(tex_id, image->opacity, alpha);
+		AddBatchQuad(x1, y1, x2, y2, tx1, ty1, tx2, ty2, rgba);
+		return;
+	}
+
+	HUD_FlushBatch();
+
+	RGL_Enable(GL_TEXTURE_2D);
+	RGL_BindTexture(GL_TEXTURE_2D, tex_id);
  
 	if (alpha >= 0.99f && image->opacity == OPAC_Solid)
-		glDisable(GL_ALPHA_TEST);
+		RGL_Disable(GL_ALPHA_TEST);
 	else
 	{
-		glEnable(GL_ALPHA_TEST);
+		RGL_Enable(GL_ALPHA_TEST);
 
 		if (! (alpha < 0.11f || image->opacity == OPAC_Complex))
-			glAlphaFunc(GL_GREATER, alpha * 0.66f);
+			RGL_AlphaFunc(GL_GREATER, alpha * 0.66f);
 	}
 
 	if (image->opacity == OPAC_Complex || alpha < 0.99f)
-		glEnable(GL_BLEND);
+		RGL_Enable(GL_BLEND);
 
 	GLint old_s_clamp = DUMMY_CLAMP;
 	GLint old_t_clamp = DUMMY_CLAMP;
@@ -486,13 +671,8 @@ void HUD_RawImage(float hx1, float hy1, float hx2, float hy2,
 				GL_REPEAT);
 	}
 
-	bool hud_swirl = false;
-
-	if (image->liquid_type > LIQ_None && swirling_flats > SWIRL_SMMU)
-	{
+	if (hud_swirl)
 		hud_swirl_pass = 1;
-		hud_swirl = true;
-	}
 
 	if (image->liquid_type == LIQ_Thick)
 		hud_thick_liquid = true;
@@ -520,6 +700,8 @@ void HUD_RawImage(float hx1, float hy1, float hx2, float hy2,
 	glVertex2i(x1, y2);
 
 	glEnd();
+	gl_stats.draw_calls++;
+	gl_stats.vertices += 4;
 
 	if (hud_swirl && swirling_flats == SWIRL_PARALLAX)
 	{
@@ -531,11 +713,11 @@ void HUD_RawImage(float hx1, float hy1, float hx2, float hy2,
 		HUD_CalcTurbulentTexCoords(&tx1, &ty1, x1, y1);
 		HUD_CalcTurbulentTexCoords(&tx2, &ty2, x2, y2);
 		alpha /= 2;
-		glEnable(GL_ALPHA_TEST);
+		RGL_Enable(GL_ALPHA_TEST);
 
 		glColor4f(r, g, b, alpha);
 
-		glEnable(GL_BLEND);
+		RGL_Enable(GL_BLEND);
 		glBegin(GL_QUADS);
 		glTexCoord2f(tx1, ty1);
 		glVertex2i(x1, y1);
@@ -549,6 +731,8 @@ void HUD_RawImage(float hx1, float hy1, float hx2, float hy2,
 		glTexCoord2f(tx1, ty2);
 		glVertex2i(x1, y2);
 		glEnd();
+		gl_stats.draw_calls++;
+		gl_stats.vertices += 4;
 	}
 
 	hud_swirl_pass = 0;
@@ -563,11 +747,11 @@ void HUD_RawImage(float hx1, float hy1, float hx2, float hy2,
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,
 				old_t_clamp);
 
-	glDisable(GL_TEXTURE_2D);
-	glDisable(GL_ALPHA_TEST);
-	glDisable(GL_BLEND);
+	RGL_Disable(GL_TEXTURE_2D);
+	RGL_Disable(GL_ALPHA_TEST);
+	RGL_Disable(GL_BLEND);
 
-	glAlphaFunc(GL_GREATER, 0);
+	RGL_AlphaFunc(GL_GREATER, 0);
 }
 
 void HUD_RawFromTexID(float hx1, float hy1, float hx2, float hy2,
@@ -587,47 +771,10 @@ void HUD_RawFromTexID(float hx1, float hy1, float hx2, float hy2,
 		y2 < 0 || y1 > SCREENHEIGHT)
 		return;
 
-	float r = 1.0f, g = 1.0f, b = 1.0f;
-
-	glEnable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, tex_id);
- 
-	if (alpha >= 0.99f && opacity == OPAC_Solid)
-		glDisable(GL_ALPHA_TEST);
-	else
-	{
-		glEnable(GL_ALPHA_TEST);
-
-		if (! (alpha < 0.11f || opacity == OPAC_Complex))
-			glAlphaFunc(GL_GREATER, alpha * 0.66f);
-	}
-
-	if (opacity == OPAC_Complex || alpha < 0.99f)
-		glEnable(GL_BLEND);
-
-	glColor4f(r, g, b, alpha);
-
-	glBegin(GL_QUADS);
-
-	glTexCoord2f(tx1, ty1);
-	glVertex2i(x1, y1);
-
-	glTexCoord2f(tx2, ty1); 
-	glVertex2i(x2, y1);
-
-	glTexCoord2f(tx2, ty2);
-	glVertex2i(x2, y2);
-
-	glTexCoord2f(tx1, ty2);
-	glVertex2i(x1, y2);
-
-	glEnd();
-
-	glDisable(GL_TEXTURE_2D);
-	glDisable(GL_ALPHA_TEST);
-	glDisable(GL_BLEND);
+	GLfloat rgba[4] = { 1.0f, 1.0f, 1.0f, alpha };
 
-	glAlphaFunc(GL_GREATER, 0);
+	SetImageBatchState(tex_id, opacity, alpha);
+	AddBatchQuad(x1, y1, x2, y2, tx1, ty1, tx2, ty2, rgba);
 }
 
 void HUD_StretchFromImageData(float x, float y, float w, float h, const epi::image_data_c *img, unsigned int tex_id, image_opacity_e opacity)
@@ -823,21 +970,11 @@ void HUD_SolidBox(float x1, float y1, float x2, float y2, rgbcol_t col)
 		x2 = COORD_X(x2); y2 = COORD_Y(y2);
 	}
 
-	if (cur_alpha < 0.99f)
-		glEnable(GL_BLEND);
-
- 	glColor4f(RGB_RED(col)/255.0, RGB_GRN(col)/255.0, RGB_BLU(col)/255.0, cur_alpha);
-
-	glBegin(GL_QUADS);
-
-	glVertex2f(x1, y1);
-	glVertex2f(x1, y2);
-	glVertex2f(x2, y2);
-	glVertex2f(x2, y1);
-
-	glEnd();
+	GLfloat rgba[4];
+	MakeRGBA(rgba, col, cur_alpha);
 
-	glDisable(GL_BLEND);
+	SetBatchState(0, false, 0, cur_alpha < 0.99f);
+	AddBatchQuad(x1, y1, x2, y2, 0, 0, 0, 0, rgba);
 }
 
 
@@ -850,13 +987,15 @@ void HUD_SolidLine(float x1, float y1, float x2, float y2, rgbcol_t col,
 	dx = COORD_X(dx) - COORD_X(0);
 	dy = COORD_Y( 0) - COORD_Y(dy);
 
+	HUD_FlushBatch();
+
 	glLineWidth(thickness);
 
 	if (smooth)
-		glEnable(GL_LINE_SMOOTH);
+		RGL_Enable(GL_LINE_SMOOTH);
 
 	if (smooth || cur_alpha < 0.99f)
-		glEnable(GL_BLEND);
+		RGL_Enable(GL_BLEND);
 
 	glColor4f(RGB_RED(col)/255.0, RGB_GRN(col)/255.0, RGB_BLU(col)/255.0, cur_alpha);
 
@@ -867,8 +1006,8 @@ void HUD_SolidLine(float x1, float y1, float x2, float y2, rgbcol_t col,
 
 	glEnd();
 
-	glDisable(GL_BLEND);
-	glDisable(GL_LINE_SMOOTH);
+	RGL_Disable(GL_BLEND);
+	RGL_Disable(GL_LINE_SMOOTH);
 	glLineWidth(1.0f);
 }
 
@@ -880,32 +1019,15 @@ void HUD_ThinBox(float x1, float y1, float x2, float y2, rgbcol_t col, float thi
 	x1 = COORD_X(x1); y1 = COORD_Y(y1);
 	x2 = COORD_X(x2); y2 = COORD_Y(y2);
 
-	if (cur_alpha < 0.99f)
-		glEnable(GL_BLEND);
-
-	glColor4f(RGB_RED(col)/255.0, RGB_GRN(col)/255.0, RGB_BLU(col)/255.0, cur_alpha);
+	GLfloat rgba[4];
+	MakeRGBA(rgba, col, cur_alpha);
 
-	glBegin(GL_QUADS);
-	glVertex2f(x1,   y1); glVertex2f(x1,   y2);
-	glVertex2f(x1+2+thickness, y2); glVertex2f(x1+2+thickness, y1);
-	glEnd();
+	SetBatchState(0, false, 0, cur_alpha < 0.99f);
 
-	glBegin(GL_QUADS);
-	glVertex2f(x2-2-thickness, y1); glVertex2f(x2-2-thickness, y2);
-	glVertex2f(x2,   y2); glVertex2f(x2,   y1);
-	glEnd();
-
-	glBegin(GL_QUADS);
-	glVertex2f(x1+2+thickness, y1);   glVertex2f(x1+2+thickness, y1+2+thickness);
-	glVertex2f(x2-2-thickness, y1+2+thickness); glVertex2f(x2-2-thickness, y1);
-	glEnd();
-
-	glBegin(GL_QUADS);
-	glVertex2f(x1+2+thickness,  y2-2-thickness); glVertex2f(x1+2+thickness, y2);
-	glVertex2f(x2-2-thickness,  y2);   glVertex2f(x2-2-thickness, y2-2-thickness);
-	glEnd();
-
-	glDisable(GL_BLEND);
+	AddBatchQuad(x1, y1, x1+2+thickness, y2, 0, 0, 0, 0, rgba);
+	AddBatchQuad(x2-2-thickness, y1, x2, y2, 0, 0, 0, 0, rgba);
+	AddBatchQuad(x1+2+thickness, y1, x2-2-thickness, y1+2+thickness, 0, 0, 0, 0, rgba);
+	AddBatchQuad(x1+2+thickness, y2-2-thickness, x2-2-thickness, y2, 0, 0, 0, 0, rgba);
 }
 
 
@@ -916,30 +1038,21 @@ void HUD_GradientBox(float x1, float y1, float x2, float y2, rgbcol_t *cols)
 	x1 = COORD_X(x1); y1 = COORD_Y(y1);
 	x2 = COORD_X(x2); y2 = COORD_Y(y2);
 
-	if (cur_alpha < 0.99f)
-		glEnable(GL_BLEND);
-
-	glBegin(GL_QUADS);
+	SetBatchState(0, false, 0, cur_alpha < 0.99f);
 
-	glColor4f(RGB_RED(cols[1])/255.0, RGB_GRN(cols[1])/255.0,
-	          RGB_BLU(cols[1])/255.0, cur_alpha);
-	glVertex2f(x1, y1);
+	GLfloat rgba[4];
 
-	glColor4f(RGB_RED(cols[0])/255.0, RGB_GRN(cols[0])/255.0,
-	          RGB_BLU(cols[0])/255.0, cur_alpha);
-	glVertex2f(x1, y2);
+	MakeRGBA(rgba, cols[1], cur_alpha);
+	AddBatchVert(x1, y1, 0, 0, rgba);
 
-	glColor4f(RGB_RED(cols[2])/255.0, RGB_GRN(cols[2])/255.0,
-	          RGB_BLU(cols[2])/255.0, cur_alpha);
-	glVertex2f(x2, y2);
+	MakeRGBA(rgba, cols[0], cur_alpha);
+	AddBatchVert(x1, y2, 0, 0, rgba);
 
-	glColor4f(RGB_RED(cols[3])/255.0, RGB_GRN(cols[3])/255.0,
-	          RGB_BLU(cols[3])/255.0, cur_alpha);
-	glVertex2f(x2, y1);
+	MakeRGBA(rgba, cols[2], cur_alpha);
+	AddBatchVert(x2, y2, 0, 0, rgba);
 
-	glEnd();
-
-	glDisable(GL_BLEND);
+	MakeRGBA(rgba, cols[3], cur_alpha);
+	AddBatchVert(x2, y1, 0, 0, rgba);
 }
 
 
@@ -966,6 +1079,41 @@ float HUD_StringHeight(const char *str)
 	return slines * HUD_FontHeight() + (slines - 1) * VERT_SPACING;
 }
 
+//
+// Like HUD_RawImage(), for a glyph in a patch font's atlas texture,
+// so a run of text keeps to one texture and stays in one batch.
+//
+static void RawAtlasGlyph(float hx1, float hy1, float hx2, float hy2,
+						  GLuint tex_id, int opacity, const image_atlas_rect_t& R,
+						  float alpha, rgbcol_t text_col)
+{
+	int x1 = I_ROUND(hx1);
+	int y1 = I_ROUND(hy1);
+	int x2 = I_ROUND(hx2+0.25f);
+	int y2 = I_ROUND(hy2+0.25f);
+
+	if (x1 >= x2 || y1 >= y2)
+		return;
+	
+	if (x2 < 0 || x1 > SCREENWIDTH ||
+		y2 < 0 || y1 > SCREENHEIGHT)
+		return;
+
+	float r = 1.0f, g = 1.0f, b = 1.0f;
+
+	if (text_col != RGB_NO_VALUE)
+	{
+		r = RGB_RED(text_col) / 255.0;
+		g = RGB_GRN(text_col) / 255.0;
+		b = RGB_BLU(text_col) / 255.0;
+	}
+
+	GLfloat rgba[4] = { r, g, b, alpha };
+
+	SetImageBatchState(tex_id, opacity, alpha);
+	AddBatchQuad(x1, y1, x2, y2, R.s1, R.t1, R.s2, R.t2, rgba);
+}
+
 void HUD_DrawChar(float left_x, float top_y, const image_c *img, char ch, float size)
 {
 	float sc_x = cur_scale; // TODO * aspect;
@@ -1006,6 +1154,18 @@ void HUD_DrawChar(float left_x, float top_y, const image_c *img, char ch, float
 	{
 		w = (size > 0 ? (size * cur_font->p_cache.ratio) : cur_font->CharWidth(ch)) * sc_x;
 		h = (size > 0 ? size : (cur_font->def->default_size > 0.0 ? cur_font->def->default_size : IM_HEIGHT(img))) * sc_y;
+
+		GLuint tex_id;
+		int opacity;
+		image_atlas_rect_t R;
+
+		if (cur_font->PatchGlyph(ch, cur_color != RGB_NO_VALUE, &tex_id, &R, &opacity))
+		{
+			RawAtlasGlyph(COORD_X(x), COORD_Y(y+h), COORD_X(x+w), COORD_Y(y),
+						  tex_id, opacity, R, cur_alpha, cur_color);
+			return;
+		}
+
 		tx1 = 0;
 		ty1 = 0;
 		tx2 = IM_RIGHT(img);
@@ -1052,7 +1212,11 @@ void HUD_DrawEndoomChar(float left_x, float top_y, float FNX, const image_c *img
 	g = RGB_GRN(color2) / 255.0;
 	b = RGB_BLU(color2) / 255.0;
 
-	glDisable(GL_TEXTURE_2D);
+	// the glyph overlaps its neighbours' backgrounds, so this
+	// has to keep its order and can't be batched.
+	HUD_FlushBatch();
+
+	RGL_Disable(GL_TEXTURE_2D);
 
 	glColor4f(r, g, b, cur_alpha);
 	
@@ -1072,19 +1236,19 @@ void HUD_DrawEndoomChar(float left_x, float top_y, float FNX, const image_c *img
 	g = RGB_GRN(color1) / 255.0;
 	b = RGB_BLU(color1) / 255.0;
 
-	glEnable(GL_TEXTURE_2D);
+	RGL_Enable(GL_TEXTURE_2D);
 
 	GLuint tex_id = W_ImageCache(img, true, (const colourmap_c *)0, true);
-	glBindTexture(GL_TEXTURE_2D, tex_id);
+	RGL_BindTexture(GL_TEXTURE_2D, tex_id);
 
 	if (cur_alpha >= 0.99f && img->opacity == OPAC_Solid)
-		glDisable(GL_ALPHA_TEST);
+		RGL_Disable(GL_ALPHA_TEST);
 	else
 	{
-		glEnable(GL_ALPHA_TEST);
+		RGL_Enable(GL_ALPHA_TEST);
 
 		if (! (cur_alpha < 0.11f || img->opacity == OPAC_Complex))
-			glAlphaFunc(GL_GREATER, cur_alpha * 0.66f);
+			RGL_AlphaFunc(GL_GREATER, cur_alpha * 0.66f);
 	}
 
 	glColor4f(r, g, b, cur_alpha);
@@ -1107,11 +1271,11 @@ void HUD_DrawEndoomChar(float left_x, float top_y, float FNX, const image_c *img
 
 	glEnd();
 
-	glDisable(GL_TEXTURE_2D);
-	glDisable(GL_ALPHA_TEST);
-	glDisable(GL_BLEND);
+	RGL_Disable(GL_TEXTURE_2D);
+	RGL_Disable(GL_ALPHA_TEST);
+	RGL_Disable(GL_BLEND);
 
-	glAlphaFunc(GL_GREATER, 0);
+	RGL_AlphaFunc(GL_GREATER, 0);
 
 	cur_alpha = old_alpha;
 }
@@ -1278,8 +1442,15 @@ void HUD_RenderWorld(float x, float y, float w, float h, mobj_t *camera, int fla
 	float x2 = xy[2]; // COORD_X(x+w);
 	float y2 = xy[3]; // COORD_Y(y+h);
 
+	// draw the world as it was part way through the last tic.  Only
+	// the view is interpolated, COAL and RTS always see the real state.
+	if (r_uncapped.d && gamestate == GS_LEVEL)
+		P_BeginInterpolation(I_GetFracTime());
+
 	R_Render(x1, y1, x2-x1, y2-y1, camera, full_height, expand_w);
 
+	P_EndInterpolation();
+
 	HUD_PopScissor();
 }
 
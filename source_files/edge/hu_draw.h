@@ -71,6 +71,10 @@ void HUD_FrameSetup(void);
 void HUD_PushScissor(float x1, float y1, float x2, float y2, bool expand=false);
 void HUD_PopScissor();
 
+// draw any quads still waiting in the HUD batch.  Must be called
+// before drawing with the GL directly, and at the end of the frame.
+void HUD_FlushBatch(void);
+
 
 void HUD_RawImage(float hx1, float hy1, float hx2, float hy2,
                   const image_c *image, 
@@ -26,6 +26,7 @@
 #include "dm_defs.h"
 #include "dm_state.h"
 #include "hu_font.h"
+#include "r_glstate.h"
 #include "r_local.h"
 #include "r_colormap.h"
 #include "r_draw.h"
@@ -54,9 +55,19 @@ font_c::font_c(fontdef_c *_def) : def(_def)
 	p_cache.images = nullptr;
 	p_cache.missing = nullptr;
 
+	for (int w = 0; w < 2; w++)
+	{
+		p_cache.atlas_tex_id[w] = 0;
+		p_cache.atlas_opacity[w] = OPAC_Unknown;
+		p_cache.atlas_rects[w] = nullptr;
+	}
+
 	font_image = nullptr;
 	ttf_buffer = nullptr;
 	ttf_info = nullptr;
+	ttf_atlas = nullptr;
+	ttf_tex_id = 0;
+	ttf_smoothed_tex_id = 0;
 	ttf_kern_scale = 0;
 	ttf_ref_yshift = 0;
 	ttf_ref_height = 0;
@@ -64,6 +75,8 @@ font_c::font_c(fontdef_c *_def) : def(_def)
 
 font_c::~font_c()
 {
+	DeletePatchAtlas();
+
 	if (p_cache.images)
 		delete[] p_cache.images;
 }
@@ -172,6 +185,79 @@ void font_c::LoadPatches()
 		p_cache.ratio = IM_WIDTH(Nom) / IM_HEIGHT(Nom);
 	}
 	spacing = def->spacing;
+
+	BuildPatchAtlas(0);
+	BuildPatchAtlas(1);
+}
+
+//
+// Packs the glyphs into one texture (see W_ImageCacheAtlas), so
+// text in a patch font doesn't need a texture bind per character.
+//
+void font_c::BuildPatchAtlas(int whiten)
+{
+	int total = p_cache.last - p_cache.first + 1;
+
+	std::vector<const image_c *> images(p_cache.images, p_cache.images + total);
+
+	images.push_back(p_cache.missing);
+
+	if (! p_cache.atlas_rects[whiten])
+		p_cache.atlas_rects[whiten] = new image_atlas_rect_t[total + 1];
+
+	p_cache.atlas_tex_id[whiten] = W_ImageCacheAtlas(images.data(), total + 1,
+		whiten != 0, p_cache.atlas_rects[whiten], &p_cache.atlas_opacity[whiten]);
+
+	// don't keep trying when it would not fit
+	if (p_cache.atlas_tex_id[whiten] == 0)
+		p_cache.atlas_opacity[whiten] = -1;
+}
+
+void font_c::DeletePatchAtlas()
+{
+	for (int w = 0; w < 2; w++)
+	{
+		if (p_cache.atlas_tex_id[w] != 0)
+			RGL_DeleteTextures(1, &p_cache.atlas_tex_id[w]);
+
+		p_cache.atlas_tex_id[w] = 0;
+		p_cache.atlas_opacity[w] = OPAC_Unknown;
+
+		delete[] p_cache.atlas_rects[w];
+		p_cache.atlas_rects[w] = nullptr;
+	}
+}
+
+bool font_c::PatchGlyph(char ch, bool whiten, unsigned int *tex_id,
+						image_atlas_rect_t *rect, int *opacity)
+{
+	SYS_ASSERT(def->type == FNTYP_Patch);
+
+	int w = whiten ? 1 : 0;
+
+	// rebuilt after W_DeleteAllImages()
+	if (p_cache.atlas_tex_id[w] == 0 && p_cache.atlas_opacity[w] >= 0 && p_cache.images)
+		BuildPatchAtlas(w);
+
+	if (p_cache.atlas_tex_id[w] == 0)
+		return false;
+
+	int slot = PatchSlot(ch);
+
+	if (slot < 0)
+		return false;
+
+	*tex_id  = p_cache.atlas_tex_id[w];
+	*rect    = p_cache.atlas_rects[w][slot];
+	*opacity = p_cache.atlas_opacity[w];
+
+	return true;
+}
+
+void HU_DeleteFontAtlases(void)
+{
+	for (int i = 0; i < hu_fonts.GetSize(); i++)
+		hu_fonts[i]->DeletePatchAtlas();
 }
 
 void font_c::LoadFontImage()
@@ -226,6 +312,15 @@ void font_c::LoadFontTTF()
 					ttf_buffer = hu_fonts[i]->ttf_buffer;
 				if (hu_fonts[i]->ttf_info)
 					ttf_info = hu_fonts[i]->ttf_info;
+
+				// the glyphs are always packed at the same size, so fonts
+				// using the same file can share the one atlas (and texture)
+				if (hu_fonts[i]->ttf_atlas)
+				{
+					ttf_atlas = hu_fonts[i]->ttf_atlas;
+					ttf_tex_id = hu_fonts[i]->ttf_tex_id;
+					ttf_smoothed_tex_id = hu_fonts[i]->ttf_smoothed_tex_id;
+				}
 			}
 		}
 
@@ -290,36 +385,40 @@ void font_c::LoadFontTTF()
 		if (ref.glyph_index == 0)
 			I_Error("LoadFontTTF: No suitable characters in font %s.\n", def->name.c_str());
 
-		ttf_atlas = new stbtt_pack_range;
-		ttf_atlas->first_unicode_codepoint_in_range = 0;
-		ttf_atlas->array_of_unicode_codepoints = (int *)cp437_unicode_values;
-		ttf_atlas->font_size = 48.0f;
-		ttf_atlas->num_chars = 256;
-		ttf_atlas->chardata_for_range = new stbtt_packedchar[256];
-
 		if (def->default_size == 0.0)
 			def->default_size = 7.0f;
 
 		ttf_kern_scale = stbtt_ScaleForPixelHeight(ttf_info, def->default_size);
 
-		unsigned char *temp_bitmap = new unsigned char [1024*1024];
-
-		stbtt_pack_context *spc = new stbtt_pack_context;
-		stbtt_PackBegin(spc, temp_bitmap, 1024, 1024, 0, 1, NULL);
-		stbtt_PackSetOversampling(spc, 1, 1);
-		stbtt_PackFontRanges(spc, ttf_buffer, 0, ttf_atlas, 1);
-		stbtt_PackEnd(spc);
-		glGenTextures(1, &ttf_tex_id);
-		glBindTexture(GL_TEXTURE_2D, ttf_tex_id);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, 1024, 1024, 0, GL_ALPHA, GL_UNSIGNED_BYTE, temp_bitmap);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-		glGenTextures(1, &ttf_smoothed_tex_id);
-		glBindTexture(GL_TEXTURE_2D, ttf_smoothed_tex_id);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, 1024, 1024, 0, GL_ALPHA, GL_UNSIGNED_BYTE, temp_bitmap);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		delete[] temp_bitmap;
+		if (!ttf_atlas)
+		{
+			ttf_atlas = new stbtt_pack_range;
+			ttf_atlas->first_unicode_codepoint_in_range = 0;
+			ttf_atlas->array_of_unicode_codepoints = (int *)cp437_unicode_values;
+			ttf_atlas->font_size = 48.0f;
+			ttf_atlas->num_chars = 256;
+			ttf_atlas->chardata_for_range = new stbtt_packedchar[256];
+
+			unsigned char *temp_bitmap = new unsigned char [1024*1024];
+
+			stbtt_pack_context *spc = new stbtt_pack_context;
+			stbtt_PackBegin(spc, temp_bitmap, 1024, 1024, 0, 1, NULL);
+			stbtt_PackSetOversampling(spc, 1, 1);
+			stbtt_PackFontRanges(spc, ttf_buffer, 0, ttf_atlas, 1);
+			stbtt_PackEnd(spc);
+			glGenTextures(1, &ttf_tex_id);
+			RGL_BindTexture(GL_TEXTURE_2D, ttf_tex_id);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, 1024, 1024, 0, GL_ALPHA, GL_UNSIGNED_BYTE, temp_bitmap);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glGenTextures(1, &ttf_smoothed_tex_id);
+			RGL_BindTexture(GL_TEXTURE_2D, ttf_smoothed_tex_id);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, 1024, 1024, 0, GL_ALPHA, GL_UNSIGNED_BYTE, temp_bitmap);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			delete[] temp_bitmap;
+		}
+
 		float x = 0.0f;
 		float y = 0.0f;
 		float ascent = 0.0f;
@@ -423,21 +522,38 @@ const image_c *font_c::CharImage(char ch) const
 
 	SYS_ASSERT(def->type == FNTYP_Patch);
 
+	int slot = PatchSlot(ch);
+
+	if (slot < 0)
+		return NULL;
+
+	if (slot == p_cache.last - p_cache.first + 1)
+		return p_cache.missing;
+
+	return p_cache.images[slot];
+}
+
+//
+// Index of the character's glyph in p_cache.images (one past the
+// end for the missing glyph), or -1 for none.
+//
+int font_c::PatchSlot(char ch) const
+{
 	if (! HasChar(ch))
 	{
 		if ('a' <= ch && ch <= 'z' && HasChar(toupper(ch)))
 			ch = toupper(ch);
 		else if (ch == ' ')
-			return NULL;
+			return -1;
 		else
-			return p_cache.missing;
+			return p_cache.missing ? (p_cache.last - p_cache.first + 1) : -1;
 	}
 
 	int idx = int(ch) & 0x00FF;
 
 	SYS_ASSERT(p_cache.first <= idx && idx <= p_cache.last);
 	
-	return p_cache.images[idx - p_cache.first];
+	return idx - p_cache.first;
 }
 
 float font_c::CharRatio(char ch)
@@ -84,6 +84,13 @@ typedef struct
 	// purposes.  Only valid once font has been loaded.
 	float width, height;
 	float ratio;
+
+	// every glyph (and the missing one, at the end) packed into one
+	// texture, plain and whitened, so that a line of text can be
+	// drawn with one texture.  Zero when not built yet.
+	unsigned int atlas_tex_id[2];
+	int atlas_opacity[2];
+	image_atlas_rect_t *atlas_rects[2];
 }
 patchcache_t;
 
@@ -118,6 +125,13 @@ public:
 	// FIXME: maybe shouldn't be public (assumes FNTYP_Patch !!)
 	const image_c *CharImage(char ch) const;
 
+	// For PATCH type: where the glyph is in the atlas texture.
+	// Returns false when there is no atlas, then draw CharImage().
+	bool PatchGlyph(char ch, bool whiten, unsigned int *tex_id,
+					image_atlas_rect_t *rect, int *opacity);
+
+	void DeletePatchAtlas();
+
 	patchcache_t p_cache;
 
 	fontdef_c *def;
@@ -148,6 +162,8 @@ public:
 
 private:
 	void BumpPatchName(char *name);
+	int  PatchSlot(char ch) const;
+	void BuildPatchAtlas(int whiten);
 	void LoadPatches();
 	void LoadFontImage();
 	void LoadFontTTF();
@@ -173,6 +189,9 @@ public:
 
 extern font_container_c hu_fonts;
 
+// the GL textures are gone, e.g. after a mode change
+void HU_DeleteFontAtlases(void);
+
 #endif  // __HU_FONT__
 
 //--- editor settings ---
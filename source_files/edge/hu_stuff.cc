@@ -137,6 +137,9 @@ void HU_Drawer(void)
 {
 	CON_ShowFPS();
 	CON_ShowPosition();
+	CON_ShowOcclusion();
+	CON_ShowGLState();
+	CON_ShowThinkers();
 
 
 	short tempY;
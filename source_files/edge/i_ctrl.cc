@@ -784,6 +784,17 @@ int I_GetTime(void)
 }
 
 
+float I_GetFracTime(void)
+{
+    Uint32 t = SDL_GetTicks();
+
+	int factor = (r_doubleframes.d ? 70 : 35);
+
+	// same split as I_GetTime, keeping the remainder
+	return (float)((t % 1000) * factor % 1000) / 1000.0f;
+}
+
+
 int I_GetMillies(void)
 {
     return SDL_GetTicks();
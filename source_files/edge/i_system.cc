@@ -22,6 +22,7 @@
 
 #include <chrono>
 #include <thread>
+#include <vector>
 
 #include "con_main.h"
 #include "dm_defs.h"
@@ -41,9 +42,14 @@ extern FILE* logfile;
 #define MSGBUFSIZE 4096
 static char msgbuf[MSGBUFSIZE];
 
+// keeps the messages from I_RunParallel workers apart
+static SDL_mutex *print_lock = NULL;
+
 
 void I_SystemStartup(void)
 {
+	print_lock = SDL_CreateMutex();
+
 	I_StartupGraphics(); // SDL requires this to be called first
 	I_StartupControl();
 	I_StartupSound();
@@ -61,11 +67,13 @@ void I_Warning(const char *warning,...)
 {
 	va_list argptr;
 
+	char warnbuf[MSGBUFSIZE];
+
 	va_start(argptr, warning);
-	vsprintf(msgbuf, warning, argptr);
+	vsnprintf(warnbuf, sizeof(warnbuf), warning, argptr);
 	va_end(argptr);
 
-	I_Printf("WARNING: %s", msgbuf);
+	I_Printf("WARNING: %s", warnbuf);
 }
 
 
@@ -107,6 +115,9 @@ void I_Printf(const char *message, ...)
 	vsnprintf(printbuf, sizeof(printbuf), message, argptr);
 	va_end(argptr);
 
+	if (print_lock)
+		SDL_LockMutex(print_lock);
+
 	I_Logf("%s", printbuf);
 
 	// If debuging enabled, print to the debugfile
@@ -119,6 +130,9 @@ void I_Printf(const char *message, ...)
 	// Send to debug console in browser
 	printf("%s", printbuf);
 #endif	
+
+	if (print_lock)
+		SDL_UnlockMutex(print_lock);
 }
 
 
@@ -149,6 +163,74 @@ void I_Sleep(int millisecs)
 }
 
 
+// more than this hardly helps, the jobs are usually few and large
+#define MAX_WORKER_THREADS  8
+
+typedef struct
+{
+	void (* func)(int index, void *data);
+	void *data;
+
+	int count;
+
+	// the next index to hand out
+	SDL_atomic_t next;
+}
+parallel_job_t;
+
+static int ParallelWorker(void *ptr)
+{
+	parallel_job_t *job = (parallel_job_t *) ptr;
+
+	for (;;)
+	{
+		int index = SDL_AtomicAdd(&job->next, 1);
+
+		if (index >= job->count)
+			break;
+
+		job->func(index, job->data);
+	}
+
+	return 0;
+}
+
+void I_RunParallel(int count, void (* func)(int index, void *data), void *data)
+{
+	if (count <= 0)
+		return;
+
+	parallel_job_t job;
+
+	job.func  = func;
+	job.data  = data;
+	job.count = count;
+
+	SDL_AtomicSet(&job.next, 0);
+
+	// the calling thread does its share too
+	int num_threads = MIN(SDL_GetCPUCount(), MIN(count, MAX_WORKER_THREADS)) - 1;
+
+	std::vector<SDL_Thread *> threads;
+
+	for (int i = 0; i < num_threads; i++)
+	{
+		SDL_Thread *thread = SDL_CreateThread(ParallelWorker, "edge_worker", &job);
+
+		// no threads is fine, this thread does all the work
+		if (! thread)
+			break;
+
+		threads.push_back(thread);
+	}
+
+	ParallelWorker(&job);
+
+	for (SDL_Thread *thread : threads)
+		SDL_WaitThread(thread, NULL);
+}
+
+
 void I_SystemShutdown(void)
 {
 	// make sure audio is unlocked (e.g. I_Error occurred)
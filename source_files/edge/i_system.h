@@ -90,6 +90,13 @@ void I_CloseProgram(int exitnum) GCCATTR((noreturn));
 // -AJA- 2005/01/21: sleep for the given number of milliseconds.
 void I_Sleep(int millisecs);
 
+// Calls func(index, data) for every index from 0 to count-1, spread
+// over several threads, and returns when they are all done.  The order
+// of the calls is not defined, and func must not call any engine code
+// which is not thread safe (I_Error, GL, WAD access).  I_Printf and
+// I_Warning are fine, as the console is not drawn meanwhile.
+void I_RunParallel(int count, void (* func)(int index, void *data), void *data);
+
 // -AJA- 2007/04/13: display a system message box with the
 // given message (typically a serious error message).
 void I_MessageBox(const char *message, const char *title);
@@ -133,6 +140,10 @@ int I_PureRandom(void);
 // The starting value should be close to zero.
 int I_GetTime(void);
 
+// Returns how far the time is into the current tic (as counted by
+// I_GetTime), from 0.0 up to (but not including) 1.0.
+float I_GetFracTime(void);
+
 // Returns a value that increases by 1000 every second (i.e. each unit is
 // a single millisecond).  This timer begins at zero when the application
 // is first begun, hence it won't normally overflow (unless the engine
@@ -27,8 +27,12 @@
 #include "l_deh.h"
 
 // EPI
+#include "endianess.h"
 #include "file.h"
 #include "filesystem.h"
+#include "math_md5.h"
+#include "path.h"
+#include "str_util.h"
 
 // DDF
 #include "main.h"
@@ -36,9 +40,19 @@
 // DEH_EDGE
 #include "deh_edge.h"
 
+#include "dm_state.h"
+#include "version.h"
+
 
 DEF_CVAR(debug_dehacked, "0", CVAR_ARCHIVE)
 
+// converted DDF is stored in the cache directory, keyed by an MD5
+// of the patch data, so unchanged patches skip the conversion.
+DEF_CVAR(deh_cache, "1", CVAR_ARCHIVE)
+
+#define DEH_CACHE_MAGIC    "EDGEDHC1"
+#define DEH_CACHE_MAXSIZE  (64 << 20)
+
 
 static char dh_message[1024];
 
@@ -82,8 +96,154 @@ static const dehconvfuncs_t edge_dehconv_funcs =
 };
 
 
+//
+// DH_CacheFilename
+//
+// The name incorporates the engine version, so that changes to the
+// converter invalidate any old results.
+//
+static std::filesystem::path DH_CacheFilename(const byte *data, int length)
+{
+	epi::md5hash_c data_md5;
+	data_md5.Compute(data, length);
+
+	std::string name = "deh-";
+
+	for (int i = 0 ; i < 16 ; i++)
+		name += epi::STR_Format("%02x", data_md5.hash[i]);
+
+	name += "-";
+	name += edgeversion.s;
+	name += ".dhc";
+
+	return epi::PATH_Join(cache_dir, name);
+}
+
+
+static bool DH_ReadS32(epi::file_c *F, int *value)
+{
+	s32_t raw;
+
+	if (F->Read(&raw, 4) != 4)
+		return false;
+
+	*value = EPI_LE_S32(raw);
+	return true;
+}
+
+
+static void DH_WriteS32(epi::file_c *F, int value)
+{
+	s32_t raw = EPI_LE_S32(value);
+
+	F->Write(&raw, 4);
+}
+
+
+//
+// DH_LoadCache
+//
+// Returns false if the file is missing or damaged, in which case
+// the collection may be partially filled and must be discarded.
+//
+static bool DH_LoadCache(const std::filesystem::path& filename, ddf_collection_c *col)
+{
+	if (! epi::FS_Access(filename, epi::file_c::ACCESS_READ))
+		return false;
+
+	epi::file_c *F = epi::FS_Open(filename, epi::file_c::ACCESS_READ | epi::file_c::ACCESS_BINARY);
+	if (F == NULL)
+		return false;
+
+	char magic[8];
+	int  count;
+
+	bool ok = (F->Read(magic, 8) == 8) &&
+		(memcmp(magic, DEH_CACHE_MAGIC, 8) == 0) &&
+		DH_ReadS32(F, &count) && count >= 0;
+
+	for (int i = 0 ; ok && i < count ; i++)
+	{
+		int type, size;
+
+		if (! (DH_ReadS32(F, &type) && DH_ReadS32(F, &size)))
+		{
+			ok = false;
+			break;
+		}
+
+		if (type < 0 || type >= DDF_NUM_TYPES || size < 0 || size > DEH_CACHE_MAXSIZE)
+		{
+			ok = false;
+			break;
+		}
+
+		std::string data(size, 0);
+
+		if (size > 0 && F->Read(&data[0], size) != (unsigned int)size)
+		{
+			ok = false;
+			break;
+		}
+
+		col->files.push_back(ddf_file_c((ddf_type_e)type, "", data));
+	}
+
+	delete F;
+
+	return ok;
+}
+
+
+static void DH_SaveCache(const std::filesystem::path& filename, ddf_collection_c *col)
+{
+	epi::file_c *F = epi::FS_Open(filename, epi::file_c::ACCESS_WRITE | epi::file_c::ACCESS_BINARY);
+	if (F == NULL)
+	{
+		I_Warning("Unable to write DEH cache file: %s\n", filename.u8string().c_str());
+		return;
+	}
+
+	F->Write(DEH_CACHE_MAGIC, 8);
+
+	DH_WriteS32(F, (int)col->files.size());
+
+	for (auto& it : col->files)
+	{
+		DH_WriteS32(F, (int)it.type);
+		DH_WriteS32(F, (int)it.data.size());
+
+		F->Write(it.data.data(), (unsigned int)it.data.size());
+	}
+
+	delete F;
+
+	epi::FS_Sync();
+}
+
+
 void DEH_Convert(const byte *data, int length, const std::string& source)
 {
+	std::filesystem::path cache_name;
+
+	if (deh_cache.d && ! cache_dir.empty())
+	{
+		cache_name = DH_CacheFilename(data, length);
+
+		ddf_collection_c cached;
+
+		if (DH_LoadCache(cache_name, &cached))
+		{
+			I_Debugf("DEH_EDGE: using cached conversion: %s\n", cache_name.u8string().c_str());
+
+			if (debug_dehacked.d > 0)
+				DDF_DumpCollection(&cached);
+
+			DDF_AddCollection(&cached, source);
+			return;
+		}
+	}
+
 	DehEdgeStartup(&edge_dehconv_funcs);
 
 	dehret_e ret = DehEdgeAddLump((const char *)data, length);
@@ -112,6 +272,9 @@ void DEH_Convert(const byte *data, int length, const std::string& source)
 	if (debug_dehacked.d > 0)
 		DDF_DumpCollection(&col);
 
+	if (! cache_name.empty())
+		DH_SaveCache(cache_name, &col);
+
 	DDF_AddCollection(&col, source);
 }
 
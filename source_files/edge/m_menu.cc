@@ -56,6 +56,7 @@
 #include "n_network.h"
 #include "p_setup.h"
 #include "am_map.h"
+#include "r_glstate.h"
 #include "r_local.h"
 #include "r_draw.h"
 #include "r_modes.h"
@@ -617,7 +618,7 @@ void M_ReadSaveStrings(void)
 			delete ex_slots[i].save_imdata;
 			ex_slots[i].save_imdata = nullptr;
 			if (ex_slots[i].save_texid)
-				glDeleteTextures(1, &ex_slots[i].save_texid);
+				RGL_DeleteTextures(1, &ex_slots[i].save_texid);
 			ex_slots[i].save_texid = 0;
 			ex_slots[i].save_impage = save_page;
 			epi::FS_Delete(fn);
@@ -630,7 +631,7 @@ void M_ReadSaveStrings(void)
 		{
 			delete ex_slots[i].save_imdata;
 			if (ex_slots[i].save_texid)
-				glDeleteTextures(1, &ex_slots[i].save_texid);
+				RGL_DeleteTextures(1, &ex_slots[i].save_texid);
 			epi::file_c *svimg_file = epi::FS_Open(fn, epi::file_c::ACCESS_READ | epi::file_c::ACCESS_BINARY);
 			if (svimg_file)
 			{
@@ -2494,6 +2495,7 @@ static void DrawMessage(void)
 
 	if (message_key_routine == QuitResponse && !exit_style->bg_image) // Respect dialog styles with custom backgrounds
 	{
+		HUD_FlushBatch();
 		I_StartFrame(); // To clear and ensure solid black background regardless of style
 		
 		if (exit_style->def->text[styledef_c::T_TEXT].colmap)
@@ -620,8 +620,8 @@ static optmenuitem_t perfoptions[] =
      &r_culldist.f, M_UpdateCVARFromFloat, "Only effective when Draw Distance Culling is On", &r_culldist, 200.0f, 1000.0f, 8000.0f, "%g Units"},
 	{OPT_Switch, "Outdoor Culling Fog Color", "Match Sky/White/Grey/Black", 4, 
      &r_cullfog.d, M_UpdateCVARFromInt, "Only effective when Draw Distance Culling is On", &r_cullfog},
-	{OPT_Boolean, "Slow Thinkers Over Distance", YesNo, 2, 
-     &g_cullthinkers.d, M_UpdateCVARFromInt, "Only recommended for extreme monster/projectile counts", &g_cullthinkers},
+	{OPT_Boolean, "Sleeping Thinkers", YesNo, 2, 
+     &g_cullthinkers.d, M_UpdateCVARFromInt, "Lets idle things skip thinking until needed", &g_cullthinkers},
 	{OPT_Switch, "Maximum Dynamic Lights", DLightMax, 6, 
      &r_maxdlights.d, M_UpdateCVARFromInt, "Control how many dynamic lights are rendered per tick", &r_maxdlights},
 };
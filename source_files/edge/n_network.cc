@@ -57,6 +57,9 @@ DEF_CVAR(m_busywait, "1", CVAR_ARCHIVE)
 // 70Hz
 DEF_CVAR(r_doubleframes, "1", CVAR_ARCHIVE)
 
+// draw frames between tics (with interpolation)
+DEF_CVAR(r_uncapped, "0", CVAR_ARCHIVE)
+
 
 // gametic is the tic about to (or currently being) run.
 // maketic is the tic that hasn't had control made for it yet.
@@ -297,6 +300,11 @@ int N_TryRunTics()
 		maketic, gametic, realtics, tics);
 #endif
 
+	// with an uncapped frame rate, draw another frame rather than
+	// waiting for the next tic.
+	if (r_uncapped.d && maketic < gametic + tics)
+		return 0;
+
 	// wait for new tics if needed
 	while (maketic < gametic + tics)
 	{
@@ -462,7 +462,7 @@ void P_BringCorpseToLife(mobj_t * corpse)
 	corpse->extendedflags = info->extendedflags;
 	corpse->hyperflags = info->hyperflags;
 	corpse->vis_target = PERCENT_2_FLOAT(info->translucency);
-	corpse->tag = corpse->spawnpoint.tag;
+	corpse->tag = corpse->cold->spawnpoint.tag;
 
 	corpse->flags &= ~MF_COUNTKILL; //Lobo 2023: don't add to killcount
 
@@ -683,7 +683,7 @@ void P_ActSetSkin(mobj_t * mo)
 			I_Error("Thing [%s]: Bad skin number %d in SET_SKIN action.\n",
 					mo->info->name.c_str(), skin);
 
-		mo->model_skin = skin;
+		mo->cold->model_skin = skin;
 	}
 }
 
@@ -2163,6 +2163,8 @@ void P_ActEffectTracker(mobj_t * object)
 					 tracker->info->name.c_str());
 #endif
 
+	P_WakeMobj(target);
+
 	// -ACB- 2000/03/11 Check for zero mass
 	if (target->info->mass)
 		target->mom.z = 1000 / target->info->mass;
@@ -2634,13 +2636,13 @@ void P_ActDropItem(mobj_t * mo)
 	item->angle = mo->angle;
 
 	// allow respawning
-	item->spawnpoint.x = item->x;
-	item->spawnpoint.y = item->y;
-	item->spawnpoint.z = item->z;
-	item->spawnpoint.angle = item->angle;
-	item->spawnpoint.vertangle = item->vertangle;
-	item->spawnpoint.info  = info;
-	item->spawnpoint.flags = 0;
+	item->cold->spawnpoint.x = item->x;
+	item->cold->spawnpoint.y = item->y;
+	item->cold->spawnpoint.z = item->z;
+	item->cold->spawnpoint.angle = item->angle;
+	item->cold->spawnpoint.vertangle = item->vertangle;
+	item->cold->spawnpoint.info  = info;
+	item->cold->spawnpoint.flags = 0;
 }
 
 void P_ActSpawn(mobj_t * mo)
@@ -3843,11 +3845,11 @@ void P_ActBecome(struct mobj_s *mo)
 	}
 
 	// DO THE DEED !!
-	mo->preBecome = mo->info; //store what we used to be
+	mo->cold->preBecome = mo->info; //store what we used to be
 
 	P_UnsetThingPosition(mo);
 	{
-		mo->info = become->info;
+		P_SetMobjInfo(mo, become->info);
 		
 		mo->morphtimeout = mo->info->morphtimeout;
 
@@ -3873,8 +3875,8 @@ void P_ActBecome(struct mobj_s *mo)
 
 		mo->vis_target    = PERCENT_2_FLOAT(mo->info->translucency);
 		mo->currentattack = NULL;
-		mo->model_skin    = mo->info->model_skin;
-		mo->model_last_frame = -1;
+		mo->cold->model_skin    = mo->info->model_skin;
+		mo->cold->model_last_frame = -1;
 
 		mo->painchance    = PERCENT_2_FLOAT(mo->info->painchance);
 
@@ -3912,20 +3914,20 @@ void P_ActBecome(struct mobj_s *mo)
 void P_ActUnBecome(struct mobj_s *mo)
 {
 
-	if (! mo->preBecome)
+	if (! mo->cold->preBecome)
 	{
 		return;
 	}
 
 	const mobjtype_c *preBecome = nullptr;
-	preBecome = mo->preBecome;
+	preBecome = mo->cold->preBecome;
 
 	// DO THE DEED !!
-	mo->preBecome = nullptr; //remove old reference
+	mo->cold->preBecome = nullptr; //remove old reference
 
 	P_UnsetThingPosition(mo);
 	{
-		mo->info = preBecome;
+		P_SetMobjInfo(mo, preBecome);
 
 		mo->morphtimeout = mo->info->morphtimeout;
 
@@ -3951,8 +3953,8 @@ void P_ActUnBecome(struct mobj_s *mo)
 
 		mo->vis_target    = PERCENT_2_FLOAT(mo->info->translucency);
 		mo->currentattack = NULL;
-		mo->model_skin    = mo->info->model_skin;
-		mo->model_last_frame = -1;
+		mo->cold->model_skin    = mo->info->model_skin;
+		mo->cold->model_last_frame = -1;
 
 		mo->painchance    = PERCENT_2_FLOAT(mo->info->painchance);
 
@@ -4003,11 +4005,11 @@ void P_ActMorph(struct mobj_s *mo)
 	}
 
 	// DO THE DEED !!
-	mo->preBecome = mo->info; //store what we used to be
+	mo->cold->preBecome = mo->info; //store what we used to be
 
 	P_UnsetThingPosition(mo);
 	{
-		mo->info = morph->info;
+		P_SetMobjInfo(mo, morph->info);
 		mo->health = mo->info->spawnhealth; // Set health to full again
 
 		mo->morphtimeout = mo->info->morphtimeout;
@@ -4033,8 +4035,8 @@ void P_ActMorph(struct mobj_s *mo)
 
 		mo->vis_target    = PERCENT_2_FLOAT(mo->info->translucency);
 		mo->currentattack = NULL;
-		mo->model_skin    = mo->info->model_skin;
-		mo->model_last_frame = -1;
+		mo->cold->model_skin    = mo->info->model_skin;
+		mo->cold->model_last_frame = -1;
 
 		mo->painchance    = PERCENT_2_FLOAT(mo->info->painchance);
 
@@ -4072,20 +4074,20 @@ void P_ActMorph(struct mobj_s *mo)
 void P_ActUnMorph(struct mobj_s *mo)
 {
 
-	if (! mo->preBecome)
+	if (! mo->cold->preBecome)
 	{
 		return;
 	}
 
 	const mobjtype_c *preBecome = nullptr;
-	preBecome = mo->preBecome;
+	preBecome = mo->cold->preBecome;
 
 	// DO THE DEED !!
-	mo->preBecome = nullptr; //remove old reference
+	mo->cold->preBecome = nullptr; //remove old reference
 
 	P_UnsetThingPosition(mo);
 	{
-		mo->info = preBecome;
+		P_SetMobjInfo(mo, preBecome);
 
 		mo->health = mo->info->spawnhealth; //Set health to max again
 
@@ -4114,8 +4116,8 @@ void P_ActUnMorph(struct mobj_s *mo)
 
 		mo->vis_target    = PERCENT_2_FLOAT(mo->info->translucency);
 		mo->currentattack = NULL;
-		mo->model_skin    = mo->info->model_skin;
-		mo->model_last_frame = -1;
+		mo->cold->model_skin    = mo->info->model_skin;
+		mo->cold->model_last_frame = -1;
 
 		mo->painchance    = PERCENT_2_FLOAT(mo->info->painchance);
 
@@ -30,13 +30,13 @@
 
 #include <vector>
 #include <algorithm>
-#include <unordered_set>
 
 #include "dm_data.h"
 #include "dm_defs.h"
 #include "dm_state.h"
 #include "m_bbox.h"
 #include "p_local.h"
+#include "p_pool.h"
 #include "p_spec.h"
 #include "r_shader.h"
 #include "r_state.h"
@@ -81,11 +81,18 @@ int dlmap_height;
 
 mobj_t **dlmap_things = NULL;
 
-extern std::unordered_set<abstract_shader_c *> seen_dlights;
+extern int seen_dlight_count;
 extern cvar_c r_culling;
 
 DEF_CVAR(r_maxdlights, "0", CVAR_ARCHIVE)
 
+// maximum number of dynamic lights applied to a single surface,
+// the nearest ones are kept.  Zero means no limit.
+DEF_CVAR(r_surfacedlights, "8", CVAR_ARCHIVE)
+
+// lights touching the current query, reused between calls
+static std::vector<mobj_t *> dlight_hits;
+
 void P_CreateThingBlockMap(void)
 {
 	bmap_things  = new mobj_t* [bmap_width * bmap_height];
@@ -140,29 +147,17 @@ int touchstat_alloc;
 int touchstat_free;
 #endif
 
-// quick-alloc list
-// FIXME: incorporate into FlushCaches
-touch_node_t *free_touch_nodes;
+// the nodes come from touch_node_pool, which is emptied in one go
+// when the level ends (see P_ReleaseLevelPools).
 
 static inline touch_node_t *TouchNodeAlloc(void)
 {
-	touch_node_t *tn;
-
 #ifdef DEVELOPERS
 	touchstat_alloc++;
 #endif
 
-	if (free_touch_nodes)
-	{
-		tn = free_touch_nodes;
-		free_touch_nodes = tn->mo_next;
-	}
-	else
-	{
-		tn = new touch_node_t;
-	}
-
-	return tn;
+	// every field is set when the node is linked in
+	return (touch_node_t *) touch_node_pool.Alloc(sizeof(touch_node_t));
 }
 
 static inline void TouchNodeFree(touch_node_t *tn)
@@ -171,9 +166,7 @@ static inline void TouchNodeFree(touch_node_t *tn)
 	touchstat_free++;
 #endif
 
-	// PREV field is ignored in quick-alloc list
-	tn->mo_next = free_touch_nodes;
-	free_touch_nodes = tn;
+	touch_node_pool.Free(tn, sizeof(touch_node_t));
 }
 
 static inline void TouchNodeLinkIntoSector(touch_node_t *tn, sector_t *sec)
@@ -563,6 +556,9 @@ void P_SetThingPosition(mobj_t * mo)
 
 	SYS_ASSERT(! (mo->dlnext || mo->dlprev));
 
+	// a sleeping thing needs to notice its new surroundings
+	P_WakeMobj(mo);
+
 	// link into subsector
 	ss = R_PointInSubsector(mo->x, mo->y);
 	mo->subsector = ss;
@@ -842,6 +838,54 @@ bool P_BlockThingsIterator(float x1, float y1, float x2, float y2,
 }
 
 
+//
+// DLightInView
+//
+// Whether the light is switched on and within the far clip.
+// The result is computed once per frame and cached in the mobj,
+// since a single light gets queried by many walls, planes and
+// things which would otherwise redo the distance check each time.
+//
+static bool DLightInView(mobj_t *mo)
+{
+	if (mo->dlight.vis_frame == framecount)
+		return mo->dlight.in_view;
+
+	SYS_ASSERT(mo->state);
+
+	mo->dlight.vis_frame = framecount;
+	mo->dlight.in_view   = true;
+
+	// skip "off" lights
+	if (mo->state->bright <= 0 || mo->dlight.r <= 0)
+		mo->dlight.in_view = false;
+	else if (r_culling.d && R_PointToDist(viewx, viewy, mo->x, mo->y) > r_farclip.f)
+		mo->dlight.in_view = false;
+
+	return mo->dlight.in_view;
+}
+
+
+//
+// DLightWithinLimit
+//
+// Applies the r_maxdlights cap, counting each light once per frame.
+//
+static bool DLightWithinLimit(mobj_t *mo)
+{
+	if (r_maxdlights.d <= 0 || mo->dlight.seen_frame == framecount)
+		return true;
+
+	if (seen_dlight_count >= r_maxdlights.d * 20)
+		return false;
+
+	mo->dlight.seen_frame = framecount;
+	seen_dlight_count++;
+
+	return true;
+}
+
+
 void P_DynamicLightIterator(float x1, float y1, float z1,
 		                    float x2, float y2, float z2,
 		                    void (*func)(mobj_t *, void *), void *data)
@@ -854,18 +898,14 @@ void P_DynamicLightIterator(float x1, float y1, float z1,
 	lx = MAX(0, lx);  hx = MIN(dlmap_width-1,  hx);
 	ly = MAX(0, ly);  hy = MIN(dlmap_height-1, hy);
 
+	dlight_hits.clear();
+
 	for (int by = ly; by <= hy; by++)
 	for (int bx = lx; bx <= hx; bx++)
 	{
 		for (mobj_t *mo = dlmap_things[by * dlmap_width + bx]; mo; mo = mo->dlnext)
 		{
-			SYS_ASSERT(mo->state);
-
-			// skip "off" lights
-			if (mo->state->bright <= 0 || mo->dlight.r <= 0)
-				continue;
-
-			if (r_culling.d && R_PointToDist(viewx, viewy, mo->x, mo->y) > r_farclip.f)
+			if (! DLightInView(mo))
 				continue;
 
 			// check whether radius touches the given bbox
@@ -875,25 +915,52 @@ void P_DynamicLightIterator(float x1, float y1, float z1,
 			    mo->y + r <= y1 || mo->y - r >= y2 ||
 				mo->z + r <= z1 || mo->z - r >= z2)
 				continue;
-			
-			// create shader if necessary
-			if (! mo->dlight.shader)
-				  mo->dlight.shader = MakeDLightShader(mo);
 
-			if (r_maxdlights.d > 0 && seen_dlights.count(mo->dlight.shader) == 0)
+			dlight_hits.push_back(mo);
+		}
+	}
+
+	if (dlight_hits.empty())
+		return;
+
+	// too many lights on this surface?  keep the ones whose radius
+	// reaches furthest past the middle of the bbox.
+	size_t total = dlight_hits.size();
+
+	if (r_surfacedlights.d > 0 && total > (size_t)r_surfacedlights.d)
+	{
+		float mx = (x1 + x2) * 0.5f;
+		float my = (y1 + y2) * 0.5f;
+		float mz = (z1 + z2) * 0.5f;
+
+		total = r_surfacedlights.d;
+
+		std::partial_sort(dlight_hits.begin(), dlight_hits.begin() + total, dlight_hits.end(),
+			[mx, my, mz](const mobj_t *A, const mobj_t *B)
 			{
-				if (seen_dlights.size() >= r_maxdlights.d * 20)
-					continue;
-				else
-				{
-					seen_dlights.insert(mo->dlight.shader);
-				}
-			}
+				float a_dist = sqrt((A->x - mx) * (A->x - mx) + (A->y - my) * (A->y - my) +
+										 (A->z - mz) * (A->z - mz));
+				float b_dist = sqrt((B->x - mx) * (B->x - mx) + (B->y - my) * (B->y - my) +
+										 (B->z - mz) * (B->z - mz));
 
-//			mo->dlight.shader->CheckReset();
+				return (a_dist - A->dlight.r) < (b_dist - B->dlight.r);
+			});
+	}
 
-			func(mo, data);
-		}
+	for (size_t i = 0; i < total; i++)
+	{
+		mobj_t *mo = dlight_hits[i];
+
+		// create shader if necessary
+		if (! mo->dlight.shader)
+			  mo->dlight.shader = MakeDLightShader(mo);
+
+		if (! DLightWithinLimit(mo))
+			continue;
+
+//		mo->dlight.shader->CheckReset();
+
+		func(mo, data);
 	}
 }
 
@@ -905,13 +972,7 @@ void P_SectorGlowIterator(sector_t *sec,
 {
 	for (mobj_t *mo = sec->glow_things; mo; mo = mo->dlnext)
 	{
-		SYS_ASSERT(mo->state);
-
-		// skip "off" lights
-		if (mo->state->bright <= 0 || mo->dlight.r <= 0)
-			continue;
-
-		if (r_culling.d && R_PointToDist(viewx, viewy, mo->x, mo->y) > r_farclip.f)
+		if (! DLightInView(mo))
 			continue;
 
 		// check whether radius touches the given bbox
@@ -83,119 +83,23 @@ float yspeed[8] = {0.0f, SQ2, 1.0f, SQ2, 0.0f, -SQ2, -1.0f, -SQ2};
 //
 
 //
-// Called by P_NoiseAlert.
-// Recursively traverse adjacent sectors,
-// sound blocking lines cut off traversal.
+// Wakes up the monsters which can hear the player, see P_SoundAlert.
 //
-static void RecursiveSound(sector_t * sec, int soundblocks, int player)
-{
-	int i;
-	line_t *check;
-	sector_t *other;
-
-	// has the sound flooded this sector
-	if (sec->validcount == validcount && sec->soundtraversed <= (soundblocks + 1))
-		return;
-
-	// wake up all monsters in this sector
-	sec->validcount = validcount;
-	sec->soundtraversed = soundblocks + 1;
-	sec->sound_player = player;
-
-/*
-	for (mobj_t *mo = sec->subsectors->thinglist; mo != NULL; mo = mo->snext)
-	{
-		mo->lastheard=player;
-	}
-
-
-	mobj_t *mo;
-	int index = 0;
-	for (mo=sec->subsectors->thinglist; mo; mo=mo->snext, index++)
-	{
-		if(mo != NULL && !mo->player)
-			mo->lastheard=player;
-	}
-*/
-
-	// Set any nearby monsters to have heard the player
-	touch_node_t *nd;
-	for (nd = sec->touch_things; nd; nd = nd->sec_next)
-	{
-		if(nd->mo != NULL)
-		{
-			if (!AlmostEquals(nd->mo->info->hear_distance, -1.0f)) //if we have hear_distance set
-			{
-				float distance;
-				distance = P_ApproxDistance(players[player]->mo->x - nd->mo->x, players[player]->mo->y - nd->mo->y);
-				distance = P_ApproxDistance(players[player]->mo->z - nd->mo->z, distance);
-				if (distance < nd->mo->info->hear_distance)
-				{
-					nd->mo->lastheard=player;
-				}
-			}
-			else ///by default he heard
-			{
-				nd->mo->lastheard=player;
-			}
-		}	
-	}
-
-
-	for (i = 0; i < sec->linecount; i++)
-	{
-		check = sec->lines[i];
-
-		if (!(check->flags & MLF_TwoSided))
-			continue;
-
-		// -AJA- 1999/07/19: Gaps are now stored in line_t.
-		if (check->gap_num == 0)
-			continue;  // closed door
-
-		// -AJA- 2001/11/11: handle closed Sliding doors
-		if (check->slide_door && ! check->slide_door->s.see_through &&
-			! check->slider_move)
-		{
-			continue;
-		}
-
-		if (check->frontsector == sec)
-			other = check->backsector;
-		else
-			other = check->frontsector;
-
-		if (check->flags & MLF_SoundBlock)
-		{
-			if (!soundblocks)
-				RecursiveSound(other, 1, player);
-		}
-		else
-		{
-			RecursiveSound(other, soundblocks, player);
-		}
-	}
-}
-
 void P_NoiseAlert(player_t *p)
 {
-	validcount++;
-
-	RecursiveSound(p->mo->subsector->sector, 0, p->pnum);
+	P_SoundAlert(p->mo->subsector->sector, p->pnum);
 }
 
 
 // Called by new NOISE_ALERT ddf action 
 void P_ActNoiseAlert(mobj_t * actor)
 {
-	validcount++;
-
 	int WhatPlayer = 0;
 
 	if (actor->lastheard !=-1)
 		WhatPlayer = actor->lastheard;
 
-	RecursiveSound(actor->subsector->sector, 0, WhatPlayer);
+	P_SoundAlert(actor->subsector->sector, WhatPlayer);
 }
 
 
@@ -553,8 +457,8 @@ mobj_t * P_LookForShootSpot(const mobjtype_c *spot_type)
 
 	std::vector<mobj_t *> spots;
 
-	for (mobj_t *cur = mobjlisthead ; cur != NULL ; cur=cur->next)
-		if (cur->info == spot_type && ! cur->isRemoved())
+	for (mobj_t *cur = P_MobjsOfType(spot_type) ; cur != NULL ; cur=cur->typenext)
+		if (! cur->isRemoved())
 			spots.push_back(cur);
 
 	if (spots.empty())
@@ -82,6 +82,8 @@ static void WindCurrentForce(force_t *f, mobj_t *mo)
 			qty = 1.0f;
 	}
 
+	P_WakeMobj(mo);
+
 	mo->mom.x += qty * f->mag.x;
 	mo->mom.y += qty * f->mag.y;
 }
@@ -118,6 +120,8 @@ static bool PIT_PushThing(mobj_t *mo, void *dataptr)
 	// NOTE: magnitude is negative for PULL mode.
 	speed = tm_force->magnitude * speed * speed;
 
+	P_WakeMobj(mo);
+
 	mo->mom.x += speed * (dx / d_unit);
 	mo->mom.y += speed * (dy / d_unit);
 
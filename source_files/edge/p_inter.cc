@@ -1249,6 +1249,8 @@ void P_ThrustMobj(mobj_t * target, mobj_t * inflictor, float thrust)
 	if (push < -40.0f) push = -40.0f;
 	if (push >  40.0f) push =  40.0f;
 
+	P_WakeMobj(target);
+
 	target->mom.x += push * M_Cos(angle);
 	target->mom.y += push * M_Sin(angle);
 
@@ -1301,6 +1303,8 @@ void P_PushMobj(mobj_t * target, mobj_t * inflictor, float thrust)
 	if (push < -40.0f) push = -40.0f;
 	if (push >  40.0f) push =  40.0f;
 
+	P_WakeMobj(target);
+
 	target->mom.x += push * M_Cos(angle);
 	target->mom.y += push * M_Sin(angle);
 
@@ -1359,6 +1363,8 @@ void P_DamageMobj(mobj_t * target, mobj_t * inflictor, mobj_t * source,
 	if (inflictor && inflictor->isRemoved()) inflictor = NULL;
 	if (source    &&    source->isRemoved())    source = NULL;
 
+	P_WakeMobj(target);
+
 	// check for immortality
 	if (target->hyperflags & HF_IMMORTAL)
 		damage = 0.0f; //do no damage
@@ -169,6 +169,23 @@ void P_RemoveAllMobjs(bool loading);
 void P_RemoveItemsInQue(void);
 void P_ClearAllStaleRefs(void);
 
+// Per-type lists of the things in mobjlisthead, linked via typenext.
+// P_SetMobjInfo() must be used to change the type of a live thing.
+mobj_t *P_MobjsOfType(const mobjtype_c *info);
+int  P_CountAliveMobjsOfType(const mobjtype_c *info);
+void P_SetMobjInfo(mobj_t *mo, const mobjtype_c *info);
+void P_LinkAllMobjTypes(void);
+void P_ClearMobjTypes(void);
+
+// Thinker scheduling: objects which are asleep (g_cullthinkers) are
+// kept out of the thinker list until P_WakeMobj() is called on them.
+void P_WakeMobj(mobj_t *mo);
+void P_WakeSectorMobjs(sector_t *sec);
+void P_WakeAllMobjs(void);
+void P_LinkAllThinkers(void);
+void P_ClearThinkers(void);
+const std::unordered_map<const mobjtype_c *, mobj_t *>& P_AllMobjTypes(void);
+
 
 //
 // P_ENEMY
@@ -189,6 +206,13 @@ bool P_Move(mobj_t * actor, bool path);
 bool P_LookForPlayers(mobj_t * actor, angle_t range);
 mobj_t * P_LookForShootSpot(const mobjtype_c *spot_type);
 
+//
+// P_NOISE
+//
+void P_SoundAlert(sector_t *sec, int player);
+void P_UpdateSoundLine(line_t *ld);
+void P_ClearSoundZones(void);
+
 //
 // P_MAPUTL
 //
@@ -248,6 +248,9 @@ bool P_TeleportMove(mobj_t * thing, float x, float y, float z)
 
 	P_ChangeThingPosition(thing, x, y, z);
 
+	// don't interpolate from the old position
+	thing->interp_serial = -1;
+
 	return true;
 }
 
@@ -2744,6 +2747,9 @@ static bool PIT_ChangeSector(mobj_t * thing, bool widening)
 {
 	mobj_t *mo;
 
+	// it may need to fall now
+	P_WakeMobj(thing);
+
 	if (P_ThingHeightClip(thing))
 	{
 		// keep checking
@@ -613,7 +613,7 @@ float P_ComputeThingGap(mobj_t * thing, sector_t * sec, float z,
 //
 // -AJA- 1999/07/19: This replaces P_LineOpening.
 //
-void P_ComputeGaps(line_t * ld)
+static void ComputeGaps(line_t * ld)
 {
 	sector_t *front = ld->frontsector;
 	sector_t *back  = ld->backsector;
@@ -677,6 +677,14 @@ void P_ComputeGaps(line_t * ld)
 	ld->gap_num = GAP_Restrict(ld->gaps, ld->gap_num, temp_gaps, temp_num);
 }
 
+void P_ComputeGaps(line_t * ld)
+{
+	ComputeGaps(ld);
+
+	// a door may have opened or closed
+	P_UpdateSoundLine(ld);
+}
+
 //
 // P_DumpExtraFloors
 //
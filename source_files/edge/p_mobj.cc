@@ -61,6 +61,8 @@
 #include "m_argv.h"
 #include "m_random.h"
 #include "p_local.h"
+#include "p_particle.h"
+#include "p_pool.h"
 #include "r_misc.h"
 #include "r_shader.h"
 #include "s_sound.h"
@@ -76,7 +78,10 @@
 #define DEBUG_MOBJ  0
 
 extern cvar_c r_doubleframes;
+extern cvar_c debug_thinkers;
 
+// lets still things sleep, see THINKER SCHEDULING below.
+// Demos are not compatible between the 0 and 1 settings.
 DEF_CVAR(g_cullthinkers, "0", CVAR_ARCHIVE)
 
 DEF_CVAR(g_gravity, "1.0", CVAR_ARCHIVE)
@@ -89,8 +94,15 @@ iteminque_t *itemquehead;
 
 std::unordered_set<const mobjtype_c *> seen_monsters;
 
+// Heads of the per-type lists.  Types without any things in the
+// level have no entry at all.
+static std::unordered_map<const mobjtype_c *, mobj_t *> mobj_type_heads;
+
 bool time_stop_active = false;
 
+static thinker_stats_t thinker_stats;
+thinker_stats_t thinker_last_stats;
+
 static void P_AddItemToQueue(const mobj_t *mo)
 {
 	// only respawn items in deathmatch or forced by level flags
@@ -99,7 +111,7 @@ static void P_AddItemToQueue(const mobj_t *mo)
 
 	iteminque_t *newbie = new iteminque_t;
 
-	newbie->spawnpoint = mo->spawnpoint;
+	newbie->spawnpoint = mo->cold->spawnpoint;
 	newbie->time = mo->info->respawntime;
 
 	// add to end of list
@@ -126,6 +138,38 @@ static void P_AddItemToQueue(const mobj_t *mo)
 }
 
 
+void *iteminque_t::operator new(size_t size)
+{
+	return itemque_pool.Alloc(size);
+}
+
+void iteminque_t::operator delete(void *ptr, size_t size)
+{
+	itemque_pool.Free(ptr, size);
+}
+
+
+void *mobj_t::operator new(size_t size)
+{
+	return mobj_pool.Alloc(size);
+}
+
+void mobj_t::operator delete(void *ptr, size_t size)
+{
+	mobj_pool.Free(ptr, size);
+}
+
+void *mobj_cold_t::operator new(size_t size)
+{
+	return mobj_cold_pool.Alloc(size);
+}
+
+void mobj_cold_t::operator delete(void *ptr, size_t size)
+{
+	mobj_cold_pool.Free(ptr, size);
+}
+
+
 bool mobj_t::isRemoved() const
 {
 	return state == NULL;
@@ -326,16 +370,16 @@ static bool CorpseShouldSlide(mobj_t * mo)
 static void TeleportRespawn(mobj_t * mobj)
 {
 	float x, y, z, oldradius, oldheight;
-	const mobjtype_c *info = mobj->spawnpoint.info;
+	const mobjtype_c *info = mobj->cold->spawnpoint.info;
 	mobj_t *new_mo;
 	int oldflags;
 
 	if (!info)
 		return;
 
-	x = mobj->spawnpoint.x;
-	y = mobj->spawnpoint.y;
-	z = mobj->spawnpoint.z;
+	x = mobj->cold->spawnpoint.x;
+	y = mobj->cold->spawnpoint.y;
+	z = mobj->cold->spawnpoint.z;
 
 	// something is occupying it's position?
 
@@ -347,8 +391,8 @@ static void TeleportRespawn(mobj_t * mobj)
 	oldheight = mobj->height;
 	oldflags = mobj->flags;
 
-	mobj->radius = mobj->spawnpoint.info->radius;
-	mobj->height = mobj->spawnpoint.info->height;
+	mobj->radius = mobj->cold->spawnpoint.info->radius;
+	mobj->height = mobj->cold->spawnpoint.info->height;
 
 	if (info->flags & MF_SOLID)						// Should it be solid?
 		mobj->flags |= MF_SOLID;
@@ -378,12 +422,12 @@ static void TeleportRespawn(mobj_t * mobj)
 	// -ACB- 1998/08/06 Create Object
 	new_mo = P_MobjCreateObject(x, y, z, info);
 
-	new_mo->spawnpoint = mobj->spawnpoint;
-	new_mo->angle = mobj->spawnpoint.angle;
-	new_mo->vertangle = mobj->spawnpoint.vertangle;
-	new_mo->tag = mobj->spawnpoint.tag;
+	new_mo->cold->spawnpoint = mobj->cold->spawnpoint;
+	new_mo->angle = mobj->cold->spawnpoint.angle;
+	new_mo->vertangle = mobj->cold->spawnpoint.vertangle;
+	new_mo->tag = mobj->cold->spawnpoint.tag;
 
-	if (mobj->spawnpoint.flags & MF_AMBUSH)
+	if (mobj->cold->spawnpoint.flags & MF_AMBUSH)
 		new_mo->flags |= MF_AMBUSH;
 
 	new_mo->reactiontime = RESPAWN_DELAY;
@@ -464,9 +508,9 @@ static void ResurrectRespawn(mobj_t * mobj)
 	mobj->SetSource(NULL);
 	mobj->SetTarget(NULL);
 
-	mobj->tag = mobj->spawnpoint.tag;
+	mobj->tag = mobj->cold->spawnpoint.tag;
 
-	if (mobj->spawnpoint.flags & MF_AMBUSH)
+	if (mobj->cold->spawnpoint.flags & MF_AMBUSH)
 		mobj->flags |= MF_AMBUSH;
 
 	mobj->reactiontime = RESPAWN_DELAY;
@@ -485,6 +529,8 @@ bool P_SetMobjState(mobj_t * mobj, statenum_t state)
 	if (mobj->isRemoved())
 		return false;
 
+	P_WakeMobj(mobj);
+
 	if (state == S_NULL)
 	{
 		P_RemoveMobj(mobj);
@@ -497,10 +543,10 @@ bool P_SetMobjState(mobj_t * mobj, statenum_t state)
 	if ((st->flags & SFF_Model) && (mobj->state->flags & SFF_Model) &&
 		(st->sprite == mobj->state->sprite) && st->tics > 1)
 	{
-		mobj->model_last_frame = mobj->state->frame;
+		mobj->cold->model_last_frame = mobj->state->frame;
 	}
 	else
-		mobj->model_last_frame = -1;
+		mobj->cold->model_last_frame = -1;
 
 	mobj->state  = st;
 	mobj->tics   = st->tics;
@@ -563,6 +609,8 @@ bool P_SetMobjStateDeferred(mobj_t * mo, statenum_t stnum, int tic_skip)
 	if (mo->isRemoved() || !mo->next_state)
 		return false;
 
+	P_WakeMobj(mo);
+
 ///???	if (stnum == S_NULL)
 ///???	{
 ///???		P_RemoveMobj(mo);
@@ -591,6 +639,22 @@ statenum_t P_MobjFindLabel(mobj_t * mobj, const char *label)
 //
 // P_SetMobjDirAndSpeed
 //
+// the momentum P_SetMobjDirAndSpeed would give
+static vec3_t DirAndSpeed(angle_t angle, float slope, float speed)
+{
+	angle_t vertangle = M_ATan(slope);
+
+	vec3_t mom;
+
+	mom.z  = M_Sin(vertangle) * speed;
+	speed *= M_Cos(vertangle);
+
+	mom.x = M_Cos(angle) * speed;
+	mom.y = M_Sin(angle) * speed;
+
+	return mom;
+}
+
 void P_SetMobjDirAndSpeed(mobj_t * mo, angle_t angle, float slope, float speed)
 {
 	mo->angle = angle;
@@ -1352,6 +1416,8 @@ static void P_MobjThinker(mobj_t * mobj, bool extra_tic)
 	if (mobj->isRemoved())
 		return;
 
+	thinker_stats.thinks++;
+
 	const region_properties_t *props;
 	region_properties_t player_props;
 
@@ -1611,6 +1677,8 @@ static void DeleteMobj(mobj_t * mo)
 	if (mo->dlight.shader)
 		delete mo->dlight.shader;
 
+	delete mo->cold;
+
 	mo->next = (mobj_t *) -1;
 	mo->prev = (mobj_t *) -1;
 
@@ -1694,6 +1762,472 @@ void P_ClearAllStaleRefs(void)
 }
 
 
+static void LinkToTypeList(mobj_t *mo)
+{
+	mobj_t *& head = mobj_type_heads[mo->info];
+
+	mo->typeprev = NULL;
+	mo->typenext = head;
+
+	if (head != NULL)
+	{
+		SYS_ASSERT(head->typeprev == NULL);
+		head->typeprev = mo;
+	}
+
+	head = mo;
+}
+
+
+static void UnlinkFromTypeList(mobj_t *mo)
+{
+	if (mo->typeprev != NULL)
+	{
+		SYS_ASSERT(mo->typeprev->typenext == mo);
+		mo->typeprev->typenext = mo->typenext;
+	}
+	else // no previous, must be first item
+	{
+		auto find = mobj_type_heads.find(mo->info);
+
+		SYS_ASSERT(find != mobj_type_heads.end() && find->second == mo);
+
+		if (mo->typenext != NULL)
+			find->second = mo->typenext;
+		else
+			mobj_type_heads.erase(find);
+	}
+
+	if (mo->typenext != NULL)
+	{
+		SYS_ASSERT(mo->typenext->typeprev == mo);
+		mo->typenext->typeprev = mo->typeprev;
+	}
+
+	mo->typenext = mo->typeprev = NULL;
+}
+
+
+mobj_t *P_MobjsOfType(const mobjtype_c *info)
+{
+	auto find = mobj_type_heads.find(info);
+
+	if (find == mobj_type_heads.end())
+		return NULL;
+
+	return find->second;
+}
+
+
+int P_CountAliveMobjsOfType(const mobjtype_c *info)
+{
+	int count = 0;
+
+	for (mobj_t *mo = P_MobjsOfType(info) ; mo != NULL ; mo = mo->typenext)
+		if (mo->health > 0)
+			count++;
+
+	return count;
+}
+
+
+const std::unordered_map<const mobjtype_c *, mobj_t *>& P_AllMobjTypes(void)
+{
+	return mobj_type_heads;
+}
+
+
+void P_SetMobjInfo(mobj_t *mo, const mobjtype_c *info)
+{
+	if (mo->info == info)
+		return;
+
+	UnlinkFromTypeList(mo);
+
+	mo->info = info;
+
+	LinkToTypeList(mo);
+
+	if (seen_monsters.count(mo->info) == 0)
+		seen_monsters.insert(mo->info);
+}
+
+
+//
+// P_LinkAllMobjTypes
+//
+// Rebuilds the per-type lists from mobjlisthead, e.g. after loading
+// a savegame.  The list is walked backwards so that each type list
+// ends up in the same order as mobjlisthead.
+//
+void P_LinkAllMobjTypes(void)
+{
+	P_ClearMobjTypes();
+
+	mobj_t *tail = mobjlisthead;
+
+	while (tail && tail->next)
+		tail = tail->next;
+
+	for (mobj_t *mo = tail ; mo != NULL ; mo = mo->prev)
+		LinkToTypeList(mo);
+}
+
+
+void P_ClearMobjTypes(void)
+{
+	mobj_type_heads.clear();
+}
+
+
+//
+//  THINKER SCHEDULING
+//
+// The things which think are kept in their own list, in the same
+// order as mobjlisthead (a woken thing goes back to its place in
+// that order).  With g_cullthinkers on, a thing which
+// would only be counting down its state for the next tics (not
+// moving, no fuse, not fading, etc) is taken out of that list after
+// it thinks.  When the state has a length the thing sleeps until the
+// tic where it runs out, otherwise (corpses, decorations) it sleeps
+// until something happens to it.  Anything which could change that --
+// a new state, damage, thrust, being moved, a moving floor -- wakes
+// the thing up again via P_WakeMobj().
+//
+// Tics are counted in "runs": thinker passes where things really
+// think, i.e. not during a time stop or the extra 70Hz tic.  A thing
+// catches up on the runs it missed when it wakes, so an idle monster
+// still looks around on the same tics as before.
+//
+// Thinking is still not exactly the same as with g_cullthinkers off
+// (e.g. nearly finished fades are cut short when a thing goes to
+// sleep), so demos recorded with one setting will go out of sync
+// when played back with the other.
+//
+
+// must be a power of two
+#define WAKE_WHEEL_SIZE  256
+
+static mobj_t *think_head;
+static mobj_t *think_tail;
+
+// things asleep until a certain run, hashed on that run
+static mobj_t *wake_wheel[WAKE_WHEEL_SIZE];
+
+// the thing P_RunMobjThinkers will do after the current one
+static mobj_t *think_next_mo;
+
+static int  think_run;
+static bool think_in_run;
+
+static int num_dormant;
+
+
+static void LinkThinkerHead(mobj_t *mo)
+{
+	mo->think_prev = NULL;
+	mo->think_next = think_head;
+
+	if (think_head)
+		think_head->think_prev = mo;
+	else
+		think_tail = mo;
+
+	think_head = mo;
+}
+
+
+static void LinkThinkerTail(mobj_t *mo)
+{
+	mo->think_next = NULL;
+	mo->think_prev = think_tail;
+
+	if (think_tail)
+		think_tail->think_next = mo;
+	else
+		think_head = mo;
+
+	think_tail = mo;
+}
+
+
+//
+// Links the thing in front of 'next', or at the end of the list
+// when 'next' is NULL.
+//
+static void LinkThinkerBefore(mobj_t *mo, mobj_t *next)
+{
+	if (! next)
+	{
+		LinkThinkerTail(mo);
+	}
+	else
+	{
+		mo->think_next = next;
+		mo->think_prev = next->think_prev;
+
+		if (next->think_prev)
+			next->think_prev->think_next = mo;
+		else
+			think_head = mo;
+
+		next->think_prev = mo;
+	}
+
+	// make sure the running thinker loop doesn't skip over it
+	if (think_next_mo == next)
+		think_next_mo = mo;
+}
+
+
+static void UnlinkThinker(mobj_t *mo)
+{
+	if (mo->think_prev)
+		mo->think_prev->think_next = mo->think_next;
+	else
+		think_head = mo->think_next;
+
+	if (mo->think_next)
+		mo->think_next->think_prev = mo->think_prev;
+	else
+		think_tail = mo->think_prev;
+
+	mo->think_next = mo->think_prev = NULL;
+}
+
+
+static void LinkWake(mobj_t *mo)
+{
+	mobj_t *& head = wake_wheel[mo->wake_run & (WAKE_WHEEL_SIZE - 1)];
+
+	mo->think_prev = NULL;
+	mo->think_next = head;
+
+	if (head)
+		head->think_prev = mo;
+
+	head = mo;
+}
+
+
+static void UnlinkWake(mobj_t *mo)
+{
+	if (mo->think_prev)
+		mo->think_prev->think_next = mo->think_next;
+	else
+		wake_wheel[mo->wake_run & (WAKE_WHEEL_SIZE - 1)] = mo->think_next;
+
+	if (mo->think_next)
+		mo->think_next->think_prev = mo->think_prev;
+
+	mo->think_next = mo->think_prev = NULL;
+}
+
+
+//
+// Returns true if the next tics of P_MobjThinker would do nothing
+// for this thing except count down its state.
+//
+static bool MobjCanSleep(const mobj_t *mo)
+{
+	if (mo->player || mo->isRemoved())
+		return false;
+
+	if (mo->flags & (MF_MISSILE | MF_SKULLFLY))
+		return false;
+
+	if (mo->tics == 0 || mo->tic_skip != 0)
+		return false;
+
+	if (mo->fuse >= 0 || mo->lerp_num > 1 || mo->below_mo)
+		return false;
+
+	if (mo->health > 0 && mo->morphtimeout >= 0)
+		return false;
+
+	// corpses counting down to a nightmare respawn
+	if (mo->tics < 0 && (mo->extendedflags & EF_MONSTER) && level_flags.respawn)
+		return false;
+
+	if (!AlmostEquals(mo->visibility, mo->vis_target) ||
+		!AlmostEquals(mo->dlight.r, mo->dlight.target))
+		return false;
+
+	if (!AlmostEquals(mo->mom.x, 0.0f) || !AlmostEquals(mo->mom.y, 0.0f) ||
+		!AlmostEquals(mo->mom.z, 0.0f))
+		return false;
+
+	// resting on the floor, or hanging in the air
+	if (!AlmostEquals(mo->z, mo->floorz))
+	{
+		if ((mo->flags & (MF_NOGRAVITY | MF_FLOAT)) != MF_NOGRAVITY)
+			return false;
+
+		if (mo->z < mo->floorz || mo->z + mo->height > mo->ceilingz)
+			return false;
+	}
+
+	const region_properties_t *props = mo->props;
+
+	if (props->push.x || props->push.y || props->push.z)
+		return false;
+
+	if (props->special && props->special->damage.grounded_monsters)
+		return false;
+
+	return true;
+}
+
+
+static void MobjTrySleep(mobj_t *mo)
+{
+	// not worth it when the state runs out next tic
+	if (mo->tics == 1 || ! MobjCanSleep(mo))
+		return;
+
+	// finish off any fades which are nearly done
+	mo->visibility = mo->vis_target;
+	mo->dlight.r   = mo->dlight.target;
+
+	UnlinkThinker(mo);
+
+	num_dormant++;
+
+	if (mo->tics < 0)
+	{
+		mo->dormant = DORMANT_Inert;
+		return;
+	}
+
+	mo->dormant  = DORMANT_Timed;
+	mo->wake_run = think_run + mo->tics;
+
+	LinkWake(mo);
+}
+
+
+void P_WakeMobj(mobj_t *mo)
+{
+	if (mo->dormant == DORMANT_None)
+		return;
+
+	if (mo->dormant == DORMANT_Timed)
+		UnlinkWake(mo);
+
+	mo->dormant = DORMANT_None;
+
+	num_dormant--;
+
+	// back to its place in mobjlisthead order: in front of the next
+	// thing which is awake.
+	mobj_t *next = mo->next;
+
+	while (next && next->dormant != DORMANT_None)
+		next = next->next;
+
+	// the thinker loop has not got to that place yet when the next
+	// thing has not thought in the current run (or there is none).
+	bool this_run = think_in_run && (! next || next->last_run < think_run);
+
+	int next_run = this_run ? think_run : think_run + 1;
+
+	// count down the tics it missed
+	if (mo->tics > 0)
+		mo->tics = MAX(1, mo->tics - (next_run - 1 - mo->last_run));
+
+	LinkThinkerBefore(mo, next);
+}
+
+
+void P_WakeSectorMobjs(sector_t *sec)
+{
+	if (num_dormant == 0)
+		return;
+
+	for (touch_node_t *nd = sec->touch_things; nd; nd = nd->sec_next)
+		P_WakeMobj(nd->mo);
+}
+
+
+//
+// The list is walked backwards, so the next awake thing is always
+// found straight away.
+//
+void P_WakeAllMobjs(void)
+{
+	if (num_dormant == 0)
+		return;
+
+	mobj_t *tail = mobjlisthead;
+
+	while (tail && tail->next)
+		tail = tail->next;
+
+	for (mobj_t *mo = tail; mo && num_dormant > 0; mo = mo->prev)
+		P_WakeMobj(mo);
+}
+
+
+static void WakeTimedMobjs(void)
+{
+	mobj_t *mo = wake_wheel[think_run & (WAKE_WHEEL_SIZE - 1)];
+
+	while (mo)
+	{
+		mobj_t *next = mo->think_next;
+
+		if (mo->wake_run == think_run)
+			P_WakeMobj(mo);
+
+		mo = next;
+	}
+}
+
+
+//
+// Sleeping things don't drop their references to removed things,
+// so look over them now and then while removed things are waiting
+// for their references to go away.
+//
+static void ClearDormantRefs(void)
+{
+	for (mobj_t *mo = mobjlisthead; mo; mo = mo->next)
+		if (mo->dormant != DORMANT_None)
+			mo->ClearStaleRefs();
+}
+
+
+void P_ClearThinkers(void)
+{
+	think_head = think_tail = NULL;
+	think_next_mo = NULL;
+
+	memset(wake_wheel, 0, sizeof(wake_wheel));
+
+	think_run = 0;
+	think_in_run = false;
+
+	num_dormant = 0;
+}
+
+
+//
+// Rebuilds the thinker list from mobjlisthead, e.g. after loading
+// a savegame.  Everything starts off awake.
+//
+void P_LinkAllThinkers(void)
+{
+	P_ClearThinkers();
+
+	for (mobj_t *mo = mobjlisthead; mo != NULL; mo = mo->next)
+	{
+		mo->dormant = DORMANT_None;
+
+		LinkThinkerTail(mo);
+	}
+}
+
+
 static void AddMobjToList(mobj_t *mo)
 {
 	mo->prev = NULL;
@@ -1707,6 +2241,9 @@ static void AddMobjToList(mobj_t *mo)
 
 	mobjlisthead = mo;
 
+	LinkThinkerHead(mo);
+	LinkToTypeList(mo);
+
 	if (seen_monsters.count(mo->info) == 0)
 		seen_monsters.insert(mo->info);
 
@@ -1740,6 +2277,9 @@ static void RemoveMobjFromList(mobj_t *mo)
 		SYS_ASSERT(mo->next->prev == mo);
 		mo->next->prev = mo->prev;
 	}
+
+	UnlinkThinker(mo);
+	UnlinkFromTypeList(mo);
 }
 
 
@@ -1766,10 +2306,13 @@ void P_RemoveMobj(mobj_t *mo)
 		return;
 	}
 
+	// it must be in the thinker list to be deleted
+	P_WakeMobj(mo);
+
 	if ((mo->info->flags & MF_SPECIAL) && 
 		0 == (mo->extendedflags & EF_NORESPAWN) &&
 	    0 == (mo->flags & (MF_MISSILE | MF_DROPPED)) &&
-		mo->spawnpoint.info)
+		mo->cold->spawnpoint.info)
 	{
 		P_AddItemToQueue(mo);
 	}
@@ -1787,7 +2330,7 @@ void P_RemoveMobj(mobj_t *mo)
 	mo->health = 0;
 	mo->tag = 0;
 	mo->tics = -1;
-	mo->wud_tags.clear();
+	mo->cold->wud_tags.clear();
 
 	// Clear all references to other mobjs
 	mo->SetTarget(NULL);
@@ -1810,6 +2353,9 @@ void P_RemoveMobj(mobj_t *mo)
 
 void P_RemoveAllMobjs(bool loading)
 {
+	P_ClearMobjTypes();
+	P_ClearThinkers();
+
 	while (mobjlisthead != NULL)
 	{
 		mobj_t *mo = mobjlisthead;
@@ -1825,6 +2371,9 @@ void P_RemoveAllMobjs(bool loading)
 		mo->refcount = 0;
 		DeleteMobj(mo);
 	}
+
+	P_RemoveAllParticles();
+	P_ReleaseLevelPools();
 }
 
 
@@ -1837,19 +2386,27 @@ void P_RemoveItemsInQue(void)
 
 		delete tmp;
 	}
+
+	itemque_pool.ReleaseAll();
 }
 
 
 //
 // P_RunMobjThinkers
 //
-// Cycle through all mobjs and let them think.
+// Cycle through all mobjs in the thinker list and let them think.
 // Also handles removed objects which have no more references.
 //
 void P_RunMobjThinkers(bool extra_tic)
 {
 	mobj_t *mo;
-	mobj_t *next;
+
+	bool timing = (debug_thinkers.d > 0);
+
+	u32_t start_time = timing ? I_GetMicros() : 0;
+	int objects = 0;
+
+	bool stale_refs = false;
 
 	time_stop_active = false;
 
@@ -1862,9 +2419,26 @@ void P_RunMobjThinkers(bool extra_tic)
 		}
 	}
 
-	for (mo = mobjlisthead ; mo != NULL ; mo = next)
+	if (!g_cullthinkers.d && num_dormant > 0)
+		P_WakeAllMobjs();
+
+	// is this a run where things (besides players) really think?
+	bool real_run = !time_stop_active && !(extra_tic && r_doubleframes.d);
+
+	if (real_run)
+	{
+		think_run++;
+		think_in_run = true;
+
+		WakeTimedMobjs();
+	}
+
+	for (mo = think_head ; mo != NULL ; mo = think_next_mo, objects++)
 	{
-		next = mo->next;
+		think_next_mo = mo->think_next;
+
+		if (real_run)
+			mo->last_run = think_run;
 
 		if (mo->isRemoved())
 		{
@@ -1877,38 +2451,56 @@ void P_RunMobjThinkers(bool extra_tic)
 				RemoveMobjFromList(mo);
 				DeleteMobj(mo);
 			}
+			else
+			{
+				stale_refs = true;
+			}
 
 			continue;
 		}
 
 		if (mo->player)
 			P_MobjThinker(mo, extra_tic);
+		else if (time_stop_active)
+			continue;
+		else if (extra_tic && r_doubleframes.d)
+		{
+			if (mo->flags & MF_MISSILE)
+				P_MobjThinker(mo, extra_tic);
+		}
 		else
 		{
-			if (time_stop_active)
-				continue;
-			if (!r_doubleframes.d)
-			{
-				if (!g_cullthinkers.d ||
-					(gametic/2 % I_ROUND(1 + R_PointToDist(players[consoleplayer]->mo->x, players[consoleplayer]->mo->y, mo->x, mo->y) / 1500) == 0))
-					P_MobjThinker(mo, extra_tic);
-			}
-			else
-			{
-				if (extra_tic)
-				{	
-					if (!(mo->flags & MF_MISSILE))
-						continue;
-					else if (!g_cullthinkers.d ||
-						((gametic/4) % I_ROUND(1 + R_PointToDist(players[consoleplayer]->mo->x, players[consoleplayer]->mo->y, mo->x, mo->y) / 1500) == 0))
-						P_MobjThinker(mo, extra_tic);
-				}
-				else if (!g_cullthinkers.d ||
-					((gametic/4) % I_ROUND(1 + R_PointToDist(players[consoleplayer]->mo->x, players[consoleplayer]->mo->y, mo->x, mo->y) / 1500) == 0))
-					P_MobjThinker(mo, extra_tic);
-			}
+			P_MobjThinker(mo, extra_tic);
+
+			if (g_cullthinkers.d)
+				MobjTrySleep(mo);
 		}
 	}
+
+	think_next_mo = NULL;
+	think_in_run  = false;
+
+	if (real_run && stale_refs && num_dormant > 0 && (think_run % TICRATE) == 0)
+		ClearDormantRefs();
+
+	if (! timing)
+	{
+		thinker_stats.thinks = 0;
+		return;
+	}
+
+	thinker_stats.tics++;
+	thinker_stats.objects += objects;
+	thinker_stats.micros  += I_GetMicros() - start_time;
+
+	if (thinker_stats.tics >= TICRATE)
+	{
+		thinker_stats.dormant = num_dormant;
+
+		thinker_last_stats = thinker_stats;
+
+		memset(&thinker_stats, 0, sizeof(thinker_stats));
+	}
 }
 
 //---------------------------------------------------------------------------
@@ -1930,6 +2522,22 @@ void P_SpawnSplash(float x, float y, float z, const mobjtype_c * splash, angle_t
 
 	z += (float) P_RandomNegPos() / 16.0f;
 
+	if (P_IsParticle(splash))
+	{
+		angle += (angle_t) (M_RandomNegPos() * (int)(ANG1 / 2));
+
+		vec3_t mom = DirAndSpeed(angle, 2.0f, 0.25f);
+
+		// keep the random numbers in step with a normal object:
+		// P_MobjCreateObject uses one for `lastlook', and the tic
+		// jitter always leaves one tic before the first state.
+		P_Random();
+		M_Random();
+
+		P_SpawnParticle(splash, x, y, z, mom.x, mom.y, mom.z, 1);
+		return;
+	}
+
 	// -ACB- 1998/08/06 Specials table for non-negotiables....
 	th = P_MobjCreateObject(x, y, z, splash);
 
@@ -1956,6 +2564,18 @@ void P_SpawnPuff(float x, float y, float z, const mobjtype_c * puff, angle_t ang
 
 	z += (float) P_RandomNegPos() / 80.0f;
 
+	if (P_IsParticle(puff))
+	{
+		// keep the random numbers in step with a normal object:
+		// P_MobjCreateObject uses one for `lastlook', and the tic
+		// jitter always leaves one tic before the first state.
+		P_Random();
+		P_Random();
+
+		P_SpawnParticle(puff, x, y, z, 0, 0, puff->float_speed, 1);
+		return;
+	}
+
 	// -ACB- 1998/08/06 Specials table for non-negotiables....
 	th = P_MobjCreateObject(x, y, z, puff);
 
@@ -1994,6 +2614,22 @@ void P_SpawnBlood(float x, float y, float z, float damage,
 
 		angle += (angle_t) (P_RandomNegPos() * (int)(ANG1 / 2));
 
+		if (P_IsParticle(blood))
+		{
+			vec3_t mom = DirAndSpeed(angle, ((float)num + 12.0f) / 6.0f,
+				(float)num / 4.0f);
+
+			// keep the random numbers in step with a normal object
+			// (`lastlook' and the tic jitter), and match the state
+			// changes made for it below.
+			P_Random();
+			P_Random();
+
+			P_SpawnParticle(blood, x, y, z, mom.x, mom.y, mom.z,
+				(damage <= 12) ? 0 : 1, (damage <= 8) ? 1 : 0);
+			continue;
+		}
+
 		th = P_MobjCreateObject(x, y, z, blood);
 
 		P_SetMobjDirAndSpeed(th, angle, ((float)num + 12.0f) / 6.0f, 
@@ -2150,7 +2786,7 @@ void P_MobjItemRespawn(void)
 
 		mo->angle = cur->spawnpoint.angle;
 		mo->vertangle = cur->spawnpoint.vertangle;
-		mo->spawnpoint = cur->spawnpoint;
+		mo->cold->spawnpoint = cur->spawnpoint;
 
 		// Taking this item-in-que out of the que, remove
 		// any references by the previous and next items to
@@ -2206,6 +2842,8 @@ mobj_t *P_MobjCreateObject(float x, float y, float z, const mobjtype_c *info)
 {
 	mobj_t *mobj = new mobj_t;
 
+	mobj->cold = new mobj_cold_t;
+
 #if (DEBUG_MOBJ > 0)
 	L_WriteDebug("tics=%05d  CREATE %p [%s]  AT %1.0f,%1.0f,%1.0f\n", 
 		leveltime, mobj, info->name.c_str(), x, y, z);
@@ -2221,9 +2859,7 @@ mobj_t *P_MobjCreateObject(float x, float y, float z, const mobjtype_c *info)
 	mobj->speed = info->speed;
 	mobj->fuse = info->fuse;
 	mobj->side = info->side;
-	mobj->model_skin = info->model_skin;
-	mobj->model_last_frame = -1;
-	mobj->wud_tags.clear();
+	mobj->cold->model_skin = info->model_skin;
 
 	mobj->painchance = PERCENT_2_FLOAT(info->painchance);
 
@@ -35,6 +35,7 @@
 #include "types.h"
 #include "m_math.h"
 
+#include <unordered_map>
 #include <unordered_set>
 
 // forward decl.
@@ -148,6 +149,15 @@ typedef enum
 }
 dirtype_e;
 
+// thinker scheduling, see P_RunMobjThinkers
+typedef enum
+{
+	DORMANT_None = 0,  // in the thinker list
+	DORMANT_Timed,     // asleep until its current state runs out
+	DORMANT_Inert      // asleep until something happens to it
+}
+dormant_e;
+
 typedef struct
 {
 	// location on the map.  `z' can take the special values ONFLOORZ
@@ -185,6 +195,11 @@ typedef struct dlight_state_s
 	abstract_shader_c *shader;
 	line_s *glow_wall = nullptr;
 	bool bad_wall_glow = false;
+
+	// per-frame visibility cache (see P_DynamicLightIterator)
+	int vis_frame  = -1;
+	int seen_frame = -1;
+	bool in_view   = false;
 }
 dlight_state_t;
 
@@ -192,109 +207,106 @@ dlight_state_t;
 // Map Object definition.
 typedef struct mobj_s mobj_t;
 
-struct mobj_s : public position_c
+// The rarely used parts of a map object, kept out of line so they
+// don't take up room in the cache lines the thinkers walk over.
+typedef struct mobj_cold_s
 {
-	const mobjtype_c *info = nullptr;
-
-	angle_t angle = 0;      // orientation
-	angle_t vertangle = 0;  // looking up or down
+	// Stores what this mobj was before being MORPHed/BECOMEing
+	const mobjtype_c *preBecome = nullptr;
 
-	// For movement checking.
-	float radius = 0;
-	float height = 0;
+	int model_skin = 1;
+	int model_last_frame = -1;
 
-	// Momentum, used to update position.
-	vec3_t mom = {0,0,0};
+	// string tags (for special operations)
+	std::string wud_tags = "";
 
-	// Track hover phase for time stop shenanigans
-	float phase = 0.0f;
+	// For respawning.
+	spawnpoint_t spawnpoint = {0,0,0,0,0,nullptr,0,0};
 
-	// current subsector
-	struct subsector_s *subsector = nullptr;
+	// these come from mobj_cold_pool, see p_pool.h
+	static void *operator new(size_t size);
+	static void operator delete(void *ptr, size_t size);
+}
+mobj_cold_t;
 
-	// properties from extrafloor the thing is in
-	struct region_properties_s *props = nullptr;
+struct mobj_s : public position_c
+{
+	//
+	// NOTE: the fields are grouped by how often they are used.
+	//
+	// The first group is touched for (nearly) every object on every
+	// tic: by the thinker loop, movement, and the blockmap / subsector
+	// scans.  Keep it together at the front, so walking the object
+	// lists only pulls in the first few cache lines of each object.
+	// Rarely used data goes at the end, or into the mobj_cold_t.
+	// Use "debug_thinkers 1" to see the sizes, and "benchthinkers"
+	// to time the thinkers.
+	//
 
-	// Vert slope stuff maybe
-	float old_z = 0;
-	float old_floorz = 0;
-	bool on_slope = false;
+	const mobjtype_c *info = nullptr;
 
-	// The closest interval over all contacted Sectors.
-	float floorz = 0;
-	float ceilingz = 0;
-	float dropoffz = 0;
+	// linked list (mobjlisthead)
+	mobj_t *next = nullptr;
+	mobj_t *prev = nullptr;
 
-	// This is the current speed of the object.
-	// if fastparm, it is already calculated.
-	float speed = 0;
-	int fuse = 0;
+	// list of things which think.  While asleep: the wake-up list.
+	mobj_t *think_next = nullptr;
+	mobj_t *think_prev = nullptr;
 
-	// When this times out we go to "MORPH" state
-	int morphtimeout = 0;
+	dormant_e dormant = DORMANT_None;
 
-	// Thing's health level
-	float health = 0;
+	const struct state_s *state = nullptr;
+	const struct state_s *next_state = nullptr;
 
 	// state tic counter
 	int tics = 0;
 	int tic_skip = 0;
 
-	const struct state_s *state = nullptr;
-	const struct state_s *next_state = nullptr;
-
 	// flags (Old and New)
 	int flags = 0;
 	int extendedflags = 0;
 	int hyperflags = 0;
 	int mbf21flags = 0;
 
-	int model_skin = 0;
-	int model_last_frame = 0;
-
-	// tag ID (for special operations)
-	int tag = 0;
-	std::string wud_tags = "";
-
-	// Movement direction, movement generation (zig-zagging).
-	dirtype_e movedir = DI_EAST;  // 0-7
-
-	// when 0, select a new dir
-	int movecount = 0;
+	// For movement checking.
+	float radius = 0;
+	float height = 0;
 
-	// Reaction time: if non 0, don't attack yet.
-	// Used by player to freeze a bit after teleporting.
-	int reactiontime = 0;
+	// Momentum, used to update position.
+	vec3_t mom = {0,0,0};
 
-	// If >0, the target will be chased
-	// no matter what (even if shot)
-	int threshold = 0;
+	angle_t angle = 0;      // orientation
 
-	// Additional info record for player avatars only.
-	struct player_s *player = nullptr;
+	// The closest interval over all contacted Sectors.
+	float floorz = 0;
+	float ceilingz = 0;
+	float dropoffz = 0;
 
-	// Player number last looked for.
-	int lastlook = 0;
+	// Thing's health level
+	float health = 0;
 
-	// For respawning.
-	spawnpoint_t spawnpoint = {0,0,0,0,0,nullptr,0,0};
+	// current subsector
+	struct subsector_s *subsector = nullptr;
 
-	float origheight = 0;
+	// properties from extrafloor the thing is in
+	struct region_properties_s *props = nullptr;
 
-	// current visibility and target visibility
-	float visibility = 0;
-	float vis_target = 0;
+	// Interaction info, by BLOCKMAP.
+	// Links in blocks (if needed).
+	mobj_t *bnext = nullptr;
+	mobj_t *bprev = nullptr;
 
-	float painchance = 0;
+	// More list: links in subsector (if needed)
+	mobj_t *snext = nullptr;
+	mobj_t *sprev = nullptr;
 
-	// current attack to be made
-	const atkdef_c *currentattack = nullptr;
+	// Additional info record for player avatars only.
+	struct player_s *player = nullptr;
 
-	// spread count for Ordered spreaders
-	int spreadcount = 0;
+	int fuse = 0;
 
-	// If == validcount, already checked.
-	int validcount = 0;
+	// When this times out we go to "MORPH" state
+	int morphtimeout = 0;
 
 	// -ES- 1999/10/25 Reference Count.
 	// All the following mobj references should be set *only* via the
@@ -303,6 +315,9 @@ struct mobj_s : public position_c
 	// us from a crash.
 	int refcount = 0;
 
+	// If == validcount, already checked.
+	int validcount = 0;
+
 	// source of the mobj, used for projectiles (i.e. the shooter)
 	mobj_t * source = nullptr;
 
@@ -314,7 +329,6 @@ struct mobj_s : public position_c
 
 	// if exists, we are supporting/helping this object
 	mobj_t * supportobj = nullptr;
-	int side = 0;
 
 	// objects that is above and below this one.  If there were several,
 	// then the closest one (in Z) is chosen.  We are riding the below
@@ -324,51 +338,112 @@ struct mobj_s : public position_c
 	mobj_t * above_mo = nullptr;
 	mobj_t * below_mo = nullptr;
 
-	// these delta values give what position from the ride_em thing's
-	// center that we are sitting on.
-	float ride_dx = 0;
-	float ride_dy = 0;
+	// current visibility and target visibility
+	float visibility = 0;
+	float vis_target = 0;
 
-	// -AJA- 1999/09/25: Path support.
-	struct rad_script_s *path_trigger = nullptr;
+	// Vert slope stuff maybe
+	float old_z = 0;
+	float old_floorz = 0;
+	bool on_slope = false;
 
-	// if we're on a ladder, this is the linedef #, otherwise -1.
-	int on_ladder = -1;
+	// position interpolation (disabled when lerp_num <= 1)
+	short lerp_num = 0;
+	short lerp_pos = 0;
+
+	// the last thinker run it was in, and (when in a timed sleep)
+	// the run in which it wakes up again.
+	int last_run = 0;
+	int wake_run = 0;
+
+	// position and angle at the start of the current tic, for
+	// interpolating between tics with an uncapped frame rate.
+	// Only valid when interp_serial matches the current snapshot.
+	float prev_x = 0, prev_y = 0, prev_z = 0;
+	angle_t prev_angle = 0;
+	int interp_serial = -1;
 
 	dlight_state_t dlight = {0,0,0,nullptr};
 
-	// monster reload support: count the number of shots
-	int shot_count = 0;
+	//
+	// Used by the AI and the action functions, every few tics.
+	//
 
-	// hash values for TUNNEL missiles
-	u32_t tunnel_hash[2] = {0,0};
+	angle_t vertangle = 0;  // looking up or down
 
-	// position interpolation (disabled when lerp_num <= 1)
-	short lerp_num = 0;
-	short lerp_pos = 0;
+	// This is the current speed of the object.
+	// if fastparm, it is already calculated.
+	float speed = 0;
 
-	vec3_t lerp_from = {0,0,0};
+	// Movement direction, movement generation (zig-zagging).
+	dirtype_e movedir = DI_EAST;  // 0-7
+
+	// when 0, select a new dir
+	int movecount = 0;
+
+	// Reaction time: if non 0, don't attack yet.
+	// Used by player to freeze a bit after teleporting.
+	int reactiontime = 0;
+
+	// If >0, the target will be chased
+	// no matter what (even if shot)
+	int threshold = 0;
+
+	int side = 0;
+
+	// Player number last looked for.
+	int lastlook = 0;
+
+	// these delta values give what position from the ride_em thing's
+	// center that we are sitting on.
+	float ride_dx = 0;
+	float ride_dy = 0;
+
+	float painchance = 0;
+
+	// current attack to be made
+	const atkdef_c *currentattack = nullptr;
+
+	// spread count for Ordered spreaders
+	int spreadcount = 0;
+
+	// if we're on a ladder, this is the linedef #, otherwise -1.
+	int on_ladder = -1;
 
 	// touch list: sectors this thing is in or touches
 	struct touch_node_s *touch_sectors = nullptr;
 
-	// linked list (mobjlisthead)
-	mobj_t *next = nullptr;
-	mobj_t *prev = nullptr;
+	vec3_t lerp_from = {0,0,0};
 
-	// Interaction info, by BLOCKMAP.
-	// Links in blocks (if needed).
-	mobj_t *bnext = nullptr;
-	mobj_t *bprev = nullptr;
+	// Track hover phase for time stop shenanigans
+	float phase = 0.0f;
 
-	// More list: links in subsector (if needed)
-	mobj_t *snext = nullptr;
-	mobj_t *sprev = nullptr;
+	//
+	// Rarely used: scripting, respawning, morphing, models, etc.
+	//
+
+	// linked list of things with the same info (P_MobjsOfType)
+	mobj_t *typenext = nullptr;
+	mobj_t *typeprev = nullptr;
 
 	// One more: link in dynamic light blockmap
 	mobj_t *dlnext = nullptr;
 	mobj_t *dlprev = nullptr;
 
+	// tag ID (for special operations)
+	int tag = 0;
+
+	// -AJA- 1999/09/25: Path support.
+	struct rad_script_s *path_trigger = nullptr;
+
+	float origheight = 0;
+
+	// monster reload support: count the number of shots
+	int shot_count = 0;
+
+	// hash values for TUNNEL missiles
+	u32_t tunnel_hash[2] = {0,0};
+
 	// Player number last heard.
 	int lastheard = 0;
 
@@ -378,6 +453,9 @@ struct mobj_s : public position_c
 
 	int teleport_tic = 0;
 
+	// morphing, models, WUD tags and the spawn point
+	mobj_cold_t *cold = nullptr;
+
 
 public:
 	bool isRemoved() const;
@@ -392,9 +470,9 @@ public:
 
 	void ClearStaleRefs();
 
-	// Stores what this mobj was before being MORPHed/BECOMEing
-	const mobjtype_c *preBecome = nullptr; 
-
+	// these come from mobj_pool, see p_pool.h
+	static void *operator new(size_t size);
+	static void operator delete(void *ptr, size_t size);
 };
 
 // Item-in-Respawn-que Structure -ACB- 1998/07/30
@@ -404,9 +482,27 @@ typedef struct iteminque_s
 	int time = 0;
 	struct iteminque_s *next = nullptr;
 	struct iteminque_s *prev = nullptr;
+
+	// these come from itemque_pool, see p_pool.h
+	static void *operator new(size_t size);
+	static void operator delete(void *ptr, size_t size);
 }
 iteminque_t;
 
+// Thinker timing for "debug_thinkers", added up over a second
+// of tics and then copied into thinker_last_stats.
+typedef struct
+{
+	int tics;
+	int objects;   // objects visited
+	int thinks;    // calls to P_MobjThinker
+	u32_t micros;  // time spent in P_RunMobjThinkers
+	int dormant;   // objects asleep (at the end)
+}
+thinker_stats_t;
+
+extern thinker_stats_t thinker_last_stats;
+
 // useful macro for the vertical center of an object
 #define MO_MIDZ(mo)  ((mo)->z + (mo)->height / 2)
 
@@ -0,0 +1,314 @@
+//----------------------------------------------------------------------------
+//  EDGE Sound Zones (noise alerts)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 1999-2023  The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+//
+// A noise floods through every open two-sided line, and through at
+// most one sound-blocking line.  So the sectors are grouped into
+// "zones": sectors joined by open lines which don't block sound.
+// A noise reaches the whole zone it starts in, plus every zone on
+// the other side of an open sound-blocking line of that zone.
+//
+// The zones are built when first needed.  Opening a line just joins
+// two zones, closing one may split a zone, so the zones are rebuilt
+// on the next noise.
+//
+
+#include "i_defs.h"
+
+#include "dm_state.h"
+#include "p_local.h"
+#include "r_state.h"
+
+#include "AlmostEquals.h"
+
+#include <vector>
+
+
+typedef struct
+{
+	std::vector<sector_t *> sectors;
+
+	// sound-blocking lines on the edge of the zone
+	std::vector<line_t *> block_lines;
+
+	// last noise which reached this zone
+	int alert;
+}
+sound_zone_t;
+
+static std::vector<sound_zone_t> zones;
+
+// zone number of each sector
+static std::vector<int> sector_zone;
+
+// whether each line lets sound through (ignoring MLF_SoundBlock)
+static std::vector<byte> line_open;
+
+static bool zones_valid = false;
+
+static int alert_count = 0;
+
+
+static bool LineCarriesSound(const line_t *ld)
+{
+	if (!(ld->flags & MLF_TwoSided) || !ld->frontsector || !ld->backsector)
+		return false;
+
+	// -AJA- 1999/07/19: Gaps are now stored in line_t.
+	if (ld->gap_num == 0)
+		return false;  // closed door
+
+	// -AJA- 2001/11/11: handle closed Sliding doors
+	if (ld->slide_door && ! ld->slide_door->s.see_through && ! ld->slider_move)
+		return false;
+
+	return true;
+}
+
+
+static void AddBlockLine(int zone, line_t *ld)
+{
+	std::vector<line_t *>& list = zones[zone].block_lines;
+
+	for (line_t *other : list)
+		if (other == ld)
+			return;
+
+	list.push_back(ld);
+}
+
+
+static void BuildZones(void)
+{
+	zones.clear();
+
+	sector_zone.assign(numsectors, -1);
+	line_open.resize(numlines);
+
+	for (int i = 0; i < numlines; i++)
+		line_open[i] = LineCarriesSound(&lines[i]) ? 1 : 0;
+
+	std::vector<sector_t *> stack;
+
+	for (int s = 0; s < numsectors; s++)
+	{
+		if (sector_zone[s] >= 0)
+			continue;
+
+		int zone = (int)zones.size();
+
+		zones.push_back(sound_zone_t());
+		zones.back().alert = 0;
+
+		sector_zone[s] = zone;
+		stack.push_back(&sectors[s]);
+
+		while (! stack.empty())
+		{
+			sector_t *sec = stack.back();
+			stack.pop_back();
+
+			zones[zone].sectors.push_back(sec);
+
+			for (int i = 0; i < sec->linecount; i++)
+			{
+				line_t *ld = sec->lines[i];
+
+				if (! line_open[ld - lines] || (ld->flags & MLF_SoundBlock))
+					continue;
+
+				sector_t *other = (ld->frontsector == sec) ? ld->backsector : ld->frontsector;
+
+				if (sector_zone[other - sectors] < 0)
+				{
+					sector_zone[other - sectors] = zone;
+					stack.push_back(other);
+				}
+			}
+		}
+	}
+
+	// the sound-blocking lines between zones
+	for (int i = 0; i < numlines; i++)
+	{
+		line_t *ld = &lines[i];
+
+		if (!(ld->flags & MLF_SoundBlock) || !(ld->flags & MLF_TwoSided) ||
+			!ld->frontsector || !ld->backsector)
+			continue;
+
+		int front = sector_zone[ld->frontsector - sectors];
+		int back  = sector_zone[ld->backsector  - sectors];
+
+		if (front != back)
+		{
+			AddBlockLine(front, ld);
+			AddBlockLine(back,  ld);
+		}
+	}
+
+	zones_valid = true;
+
+	I_Debugf("Sound zones: %d for %d sectors\n", (int)zones.size(), numsectors);
+}
+
+
+//
+// Moves everything in zone b into zone a.  Zone b is left empty.
+//
+static void JoinZones(int a, int b)
+{
+	// keep the bigger one
+	if (zones[a].sectors.size() < zones[b].sectors.size())
+		std::swap(a, b);
+
+	for (sector_t *sec : zones[b].sectors)
+	{
+		sector_zone[sec - sectors] = a;
+		zones[a].sectors.push_back(sec);
+	}
+
+	for (line_t *ld : zones[b].block_lines)
+		AddBlockLine(a, ld);
+
+	zones[b].sectors.clear();
+	zones[b].block_lines.clear();
+}
+
+
+void P_ClearSoundZones(void)
+{
+	zones.clear();
+	sector_zone.clear();
+	line_open.clear();
+
+	zones_valid = false;
+}
+
+
+//
+// Called whenever a line's gaps or sliding door change.
+//
+void P_UpdateSoundLine(line_t *ld)
+{
+	// they will be built from scratch anyway
+	if (! zones_valid)
+		return;
+
+	byte now = LineCarriesSound(ld) ? 1 : 0;
+
+	if (line_open[ld - lines] == now)
+		return;
+
+	line_open[ld - lines] = now;
+
+	// only matters when the noise gets there
+	if (ld->flags & MLF_SoundBlock)
+		return;
+
+	if (! now)
+	{
+		// the zone might be split in two
+		zones_valid = false;
+		return;
+	}
+
+	int front = sector_zone[ld->frontsector - sectors];
+	int back  = sector_zone[ld->backsector  - sectors];
+
+	if (front != back)
+		JoinZones(front, back);
+}
+
+
+static void AlertZone(int zone, int soundblocks, int player)
+{
+	mobj_t *pmo = players[player]->mo;
+
+	for (sector_t *sec : zones[zone].sectors)
+	{
+		sec->validcount = validcount;
+		sec->soundtraversed = soundblocks + 1;
+		sec->sound_player = player;
+
+		// Set any nearby monsters to have heard the player
+		for (touch_node_t *nd = sec->touch_things; nd; nd = nd->sec_next)
+		{
+			mobj_t *mo = nd->mo;
+
+			if (mo == NULL)
+				continue;
+
+			if (!AlmostEquals(mo->info->hear_distance, -1.0f)) //if we have hear_distance set
+			{
+				float distance;
+				distance = P_ApproxDistance(pmo->x - mo->x, pmo->y - mo->y);
+				distance = P_ApproxDistance(pmo->z - mo->z, distance);
+				if (distance < mo->info->hear_distance)
+				{
+					mo->lastheard = player;
+				}
+			}
+			else ///by default he heard
+			{
+				mo->lastheard = player;
+			}
+		}
+	}
+}
+
+
+//
+// Makes a noise in the given sector, which all the monsters that
+// can hear it will remember as coming from the given player.
+//
+void P_SoundAlert(sector_t *sec, int player)
+{
+	if (! zones_valid)
+		BuildZones();
+
+	validcount++;
+	alert_count++;
+
+	int zone = sector_zone[sec - sectors];
+
+	zones[zone].alert = alert_count;
+
+	AlertZone(zone, 0, player);
+
+	// the noise can get through one sound-blocking line
+	for (line_t *ld : zones[zone].block_lines)
+	{
+		if (! line_open[ld - lines])
+			continue;
+
+		int other = sector_zone[ld->frontsector - sectors];
+
+		if (other == zone)
+			other = sector_zone[ld->backsector - sectors];
+
+		if (other == zone || zones[other].alert == alert_count)
+			continue;
+
+		zones[other].alert = alert_count;
+
+		AlertZone(other, 1, player);
+	}
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -0,0 +1,339 @@
+//----------------------------------------------------------------------------
+//  EDGE Particles (puffs, blood, splashes)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 1999-2023  The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#include "i_defs.h"
+
+#include "con_var.h"
+#include "dm_state.h"
+#include "p_local.h"
+#include "p_particle.h"
+#include "r_misc.h"
+#include "r_state.h"
+
+
+// zero turns particles off, the things are spawned as normal objects
+DEF_CVAR(g_maxparticles, "4096", CVAR_ARCHIVE)
+
+particle_list_t particles;
+
+float particle_lerp = 1.0f;
+
+
+// particles can fall down (or climb up) steps no higher than this,
+// anything else is treated as a wall.
+#define PARTICLE_STEP  24.0f
+
+// limit on zero-tic states followed in one go
+#define MAX_STATE_HOPS  16
+
+
+static void ResizeParticles(int size)
+{
+	particle_list_t& P = particles;
+
+	P.x.resize(size);
+	P.y.resize(size);
+	P.z.resize(size);
+
+	P.mom_x.resize(size);
+	P.mom_y.resize(size);
+	P.mom_z.resize(size);
+
+	P.gravity.resize(size);
+	P.floor_h.resize(size);
+	P.ceil_h.resize(size);
+
+	P.state.resize(size);
+	P.tics.resize(size);
+
+	P.info.resize(size);
+	P.subsector.resize(size);
+}
+
+
+static void RemoveParticle(int i)
+{
+	particle_list_t& P = particles;
+
+	// move the last one into the hole
+	int last = --P.count;
+
+	if (i == last)
+		return;
+
+	P.x[i] = P.x[last];
+	P.y[i] = P.y[last];
+	P.z[i] = P.z[last];
+
+	P.mom_x[i] = P.mom_x[last];
+	P.mom_y[i] = P.mom_y[last];
+	P.mom_z[i] = P.mom_z[last];
+
+	P.gravity[i] = P.gravity[last];
+	P.floor_h[i] = P.floor_h[last];
+	P.ceil_h[i]  = P.ceil_h[last];
+
+	P.state[i] = P.state[last];
+	P.tics[i]  = P.tics[last];
+
+	P.info[i] = P.info[last];
+	P.subsector[i] = P.subsector[last];
+}
+
+
+//
+// Enters the given state, skipping any zero-tic ones (those are only
+// used for actions, which particles don't run).  Returns false when
+// the particle should be removed.
+//
+static bool SetParticleState(int i, int st)
+{
+	for (int hop = 0; hop < MAX_STATE_HOPS; hop++)
+	{
+		if (st == S_NULL)
+			return false;
+
+		const state_t *s = &states[st];
+
+		if (s->tics != 0)
+		{
+			particles.state[i] = st;
+			particles.tics[i]  = s->tics;
+			return true;
+		}
+
+		st = s->nextstate;
+	}
+
+	return false;
+}
+
+
+static inline float ParticleGravity(const mobjtype_c *info, const sector_t *sec)
+{
+	if (info->flags & MF_NOGRAVITY)
+		return 0;
+
+	// same as P_ZMovement
+	float gravity = sec->p->gravity / 8.0f *
+		(float)level_flags.menu_grav / GRAVITY * g_gravity.f;
+
+	if (info->mbf21flags & MBF21_LOGRAV)
+		gravity /= 8;
+
+	return gravity;
+}
+
+
+//
+// Finds the floor and ceiling around the particle's height in the
+// given subsector, allowing for solid extrafloors.
+//
+static void ParticleGap(const sector_t *sec, float z, float height,
+						float *floor_h, float *ceil_h)
+{
+	float f = sec->f_h;
+	float c = sec->c_h;
+
+	for (const extrafloor_t *ef = sec->bottom_ef; ef; ef = ef->higher)
+	{
+		if (ef->top_h <= z + PARTICLE_STEP)
+			f = MAX(f, ef->top_h);
+		else
+			c = MIN(c, ef->bottom_h);
+	}
+
+	*floor_h = f;
+	*ceil_h  = MAX(f, c - height);
+}
+
+
+static inline int FirstState(const mobjtype_c *info)
+{
+	// same choice as P_MobjCreateObject
+	if (info->spawn_state)
+		return info->spawn_state;
+
+	if (info->meander_state)
+		return info->meander_state;
+
+	return info->idle_state;
+}
+
+
+bool P_IsParticle(const mobjtype_c *info)
+{
+	if (! (info->hyperflags & HF_PARTICLE) || g_maxparticles.d <= 0)
+		return false;
+
+	int first = FirstState(info);
+
+	return (first != S_NULL && ! (states[first].flags & SFF_Model));
+}
+
+
+void P_SpawnParticle(const mobjtype_c *info, float x, float y, float z,
+					 float mom_x, float mom_y, float mom_z,
+					 int delay, int skip_states)
+{
+	particle_list_t& P = particles;
+
+	if (P.count >= g_maxparticles.d)
+		return;
+
+	if (P.count >= (int)P.x.size())
+		ResizeParticles(MIN(MAX(256, P.count * 2), g_maxparticles.d));
+
+	int i = P.count;
+
+	if (! SetParticleState(i, FirstState(info)))
+		return;
+
+	// like P_SetMobjState on a new object, never skip into S_NULL
+	for (; skip_states > 0; skip_states--)
+	{
+		if (states[P.state[i]].nextstate == S_NULL)
+			break;
+
+		if (! SetParticleState(i, states[P.state[i]].nextstate))
+			return;
+	}
+
+	P.count++;
+
+	// the tics spent waiting before the first state is entered
+	if (P.tics[i] > 0)
+		P.tics[i] += delay;
+
+	subsector_t *sub = R_PointInSubsector(x, y);
+
+	P.x[i] = x;
+	P.y[i] = y;
+	P.z[i] = z;
+
+	P.mom_x[i] = mom_x;
+	P.mom_y[i] = mom_y;
+	P.mom_z[i] = mom_z;
+
+	P.info[i] = info;
+	P.subsector[i] = sub;
+	P.gravity[i] = ParticleGravity(info, sub->sector);
+
+	ParticleGap(sub->sector, z, info->height, &P.floor_h[i], &P.ceil_h[i]);
+}
+
+
+void P_RunParticles(void)
+{
+	particle_list_t& P = particles;
+
+	if (P.count == 0 || time_stop_active)
+		return;
+
+	int n = P.count;
+
+	float *px = P.x.data();
+	float *py = P.y.data();
+	float *pz = P.z.data();
+
+	float *mx = P.mom_x.data();
+	float *my = P.mom_y.data();
+	float *mz = P.mom_z.data();
+
+	const float *grav = P.gravity.data();
+
+	// movement: a plain loop over the arrays, which the compiler
+	// is free to vectorise.
+	for (int i = 0; i < n; i++)
+	{
+		mz[i] -= grav[i];
+
+		px[i] += mx[i];
+		py[i] += my[i];
+		pz[i] += mz[i];
+	}
+
+	// collisions and animation
+	for (int i = 0; i < P.count; )
+	{
+		if (mx[i] != 0 || my[i] != 0)
+		{
+			subsector_t *sub = R_PointInSubsector(px[i], py[i]);
+
+			if (sub != P.subsector[i])
+			{
+				float f, c;
+
+				ParticleGap(sub->sector, pz[i], P.info[i]->height, &f, &c);
+
+				if (f > pz[i] + PARTICLE_STEP || c < pz[i])
+				{
+					// hit a wall, so stay put and drop straight down
+					px[i] -= mx[i];
+					py[i] -= my[i];
+
+					mx[i] = my[i] = 0;
+				}
+				else
+				{
+					P.subsector[i] = sub;
+					P.gravity[i] = ParticleGravity(P.info[i], sub->sector);
+
+					P.floor_h[i] = f;
+					P.ceil_h[i]  = c;
+				}
+			}
+		}
+
+		if (pz[i] <= P.floor_h[i])
+		{
+			// landed
+			pz[i] = P.floor_h[i];
+
+			mx[i] = my[i] = mz[i] = 0;
+		}
+		else if (pz[i] > P.ceil_h[i])
+		{
+			pz[i] = P.ceil_h[i];
+
+			if (mz[i] > 0)
+				mz[i] = 0;
+		}
+
+		// negative tics means the state lasts forever
+		if (P.tics[i] > 0 && --P.tics[i] == 0)
+		{
+			if (! SetParticleState(i, states[P.state[i]].nextstate))
+			{
+				RemoveParticle(i);
+				continue;
+			}
+		}
+
+		i++;
+	}
+}
+
+
+void P_RemoveAllParticles(void)
+{
+	particles.count = 0;
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
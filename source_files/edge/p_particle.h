@@ -0,0 +1,77 @@
+//----------------------------------------------------------------------------
+//  EDGE Particles (puffs, blood, splashes)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 1999-2023  The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+//
+// Things with the PARTICLE special which are spawned as puffs, blood
+// or splashes do not become map objects.  They are kept here instead,
+// in flat arrays, and only move, fall, land and animate through their
+// states.  State actions are NOT run, and particles are not saved.
+//
+
+#ifndef __P_PARTICLE_H__
+#define __P_PARTICLE_H__
+
+#include <vector>
+
+class mobjtype_c;
+struct subsector_s;
+
+typedef struct
+{
+	int count;
+
+	std::vector<float> x, y, z;
+	std::vector<float> mom_x, mom_y, mom_z;
+
+	// per-tic fall speed, zero for NOGRAVITY things
+	std::vector<float> gravity;
+
+	// limits for the current subsector (ceiling includes the height)
+	std::vector<float> floor_h, ceil_h;
+
+	std::vector<int> state;
+	std::vector<int> tics;
+
+	std::vector<const mobjtype_c *> info;
+	std::vector<struct subsector_s *> subsector;
+}
+particle_list_t;
+
+extern particle_list_t particles;
+
+// where the renderer is between the last tic and the current one
+extern float particle_lerp;
+
+// true if the type has the PARTICLE special, can be drawn as one,
+// and particles are not turned off.  Otherwise the caller should
+// spawn a normal object.
+bool P_IsParticle(const mobjtype_c *info);
+
+// when the list is full, the particle is silently dropped.
+// 'delay' is the number of tics spent before entering the first
+// state, and 'skip_states' the number of states skipped over.
+void P_SpawnParticle(const mobjtype_c *info, float x, float y, float z,
+					 float mom_x, float mom_y, float mom_z,
+					 int delay = 0, int skip_states = 0);
+
+void P_RunParticles(void);
+void P_RemoveAllParticles(void);
+
+#endif /* __P_PARTICLE_H__ */
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
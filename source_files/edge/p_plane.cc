@@ -29,6 +29,7 @@
 #include "dm_state.h"
 #include "m_random.h"
 #include "p_local.h"
+#include "r_gldefs.h"
 #include "r_sky.h"
 #include "r_state.h"
 #include "s_sound.h"
@@ -285,6 +286,9 @@ static move_result_e AttemptMovePlane(sector_t * sector,
     // move the actual sector, including all things in it
     //
     nofit = P_SolidSectorMove(sector, is_ceiling, speed, crush, false);
+
+    // the walls around it have changed shape
+    RGL_InvalidateSectorWalls(sector);
     
     if (! nofit)
         return past ? RES_PastDest : RES_Ok;
@@ -1452,6 +1456,8 @@ bool EV_DoSlider(line_t * door, line_t *act_line, mobj_t * thing,
 	door->slide_door  = special;
     door->slider_move = smov;
 
+	P_UpdateSoundLine(door);
+
 	// work-around for RTS-triggered doors, which cannot setup
 	// the 'slide_door' field at level load and hence the code
 	// which normally blocks the door does not kick in.
@@ -1695,6 +1701,8 @@ void P_RunActiveSliders(void)
 		{
             smov->line->slider_move = NULL;
 
+			P_UpdateSoundLine(smov->line);
+
 			*SMI = NULL;
 			delete smov;
 
@@ -0,0 +1,135 @@
+//----------------------------------------------------------------------------
+//  EDGE Level Object Pools
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 1999-2023  The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#include "i_defs.h"
+
+#include "p_local.h"
+#include "p_pool.h"
+
+
+struct free_block_s
+{
+	struct free_block_s *next;
+};
+
+// keep every block aligned like the result of a plain new
+#define POOL_ALIGN  (sizeof(double) * 2)
+
+
+slab_pool_c mobj_pool("mobj", sizeof(mobj_t), 128);
+slab_pool_c mobj_cold_pool("mobj_cold", sizeof(mobj_cold_t), 128);
+slab_pool_c touch_node_pool("touch_node", sizeof(touch_node_t), 512);
+slab_pool_c itemque_pool("itemque", sizeof(iteminque_t), 64);
+
+// dlight_shader_pool lives in r_shader.cc, which knows the sizes
+
+
+slab_pool_c::slab_pool_c(const char *_name, size_t _block_size, int _per_slab) :
+	name(_name), per_slab(_per_slab), slabs(), fresh(0), free_list(NULL),
+	allocs(0), frees(0), live(0), peak(0)
+{
+	if (_block_size < sizeof(free_block_s))
+		_block_size = sizeof(free_block_s);
+
+	block_size = (_block_size + POOL_ALIGN - 1) & ~(POOL_ALIGN - 1);
+}
+
+
+void *slab_pool_c::Alloc(size_t size)
+{
+	if (size > block_size)
+		return ::operator new(size);
+
+	allocs++;
+	live++;
+
+	if (live > peak)
+		peak = live;
+
+	if (free_list)
+	{
+		free_block_s *blk = free_list;
+		free_list = blk->next;
+
+		return blk;
+	}
+
+	if (fresh == 0)
+	{
+		slabs.push_back(new char[block_size * per_slab]);
+		fresh = per_slab;
+	}
+
+	// hand out the blocks of a new slab in address order
+	char *slab = slabs.back();
+
+	return slab + block_size * (per_slab - fresh--);
+}
+
+
+void slab_pool_c::Free(void *block, size_t size)
+{
+	if (! block)
+		return;
+
+	if (size > block_size)
+	{
+		::operator delete(block);
+		return;
+	}
+
+	frees++;
+	live--;
+
+	free_block_s *blk = (free_block_s *) block;
+
+	blk->next = free_list;
+	free_list = blk;
+}
+
+
+void slab_pool_c::ReleaseAll()
+{
+	if (allocs > 0)
+		I_Debugf("Pool %s: %d allocs, %d frees, peak %d, %d slabs\n",
+				 name, allocs, frees, peak, (int)slabs.size());
+
+	for (char *slab : slabs)
+		delete[] slab;
+
+	slabs.clear();
+
+	fresh = 0;
+	free_list = NULL;
+
+	allocs = frees = live = peak = 0;
+}
+
+
+void P_ReleaseLevelPools(void)
+{
+	// the sectors are gone, so any touch nodes left are unreachable
+	touch_node_pool.ReleaseAll();
+
+	mobj_pool.ReleaseAll();
+	mobj_cold_pool.ReleaseAll();
+	dlight_shader_pool.ReleaseAll();
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -0,0 +1,82 @@
+//----------------------------------------------------------------------------
+//  EDGE Level Object Pools
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 1999-2023  The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#ifndef __P_POOL_H__
+#define __P_POOL_H__
+
+#include <vector>
+
+//
+// A pool of fixed-size blocks, carved out of large slabs.
+//
+// Freed blocks go onto a free list and are handed out again (most
+// recently freed first) before any new space is used, so the order
+// of reuse only depends on the order of the calls.  The slabs live
+// until ReleaseAll(), which is called when the level is torn down.
+//
+// The pool only deals with memory: the users are expected to give
+// their class an operator new / delete which calls Alloc / Free.
+// Requests larger than the block size go to the normal heap.
+//
+class slab_pool_c
+{
+public:
+	slab_pool_c(const char *_name, size_t _block_size, int _per_slab = 256);
+
+	void *Alloc(size_t size);
+	void Free(void *block, size_t size);
+
+	// give back every slab at once.  Any blocks still in use are
+	// simply dropped, their destructors are NOT called.
+	void ReleaseAll();
+
+private:
+	const char *name;
+
+	size_t block_size;
+	int per_slab;
+
+	std::vector<char *> slabs;
+
+	// unused blocks at the end of the newest slab
+	int fresh;
+
+	struct free_block_s *free_list;
+
+public:
+	// counters, since the last ReleaseAll()
+	int allocs;
+	int frees;
+	int live;
+	int peak;
+};
+
+
+extern slab_pool_c mobj_pool;
+extern slab_pool_c mobj_cold_pool;
+extern slab_pool_c touch_node_pool;
+extern slab_pool_c itemque_pool;
+extern slab_pool_c dlight_shader_pool;
+
+// drops all the level objects, see P_RemoveAllMobjs()
+void P_ReleaseLevelPools(void);
+
+#endif /* __P_POOL_H__ */
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
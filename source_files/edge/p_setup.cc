@@ -48,6 +48,7 @@
 #include "m_random.h"
 #include "p_local.h"
 #include "p_setup.h"
+#include "p_tick.h"
 #include "am_map.h"
 #include "r_gldefs.h"
 #include "r_sky.h"
@@ -586,7 +587,7 @@ static mobj_t *SpawnMapThing(const mobjtype_c *info,
 	mobj_t * mo = P_MobjCreateObject(x, y, z, info);
 
 	mo->angle = angle;
-	mo->spawnpoint = point;
+	mo->cold->spawnpoint = point;
 
 	if (mo->state && mo->state->tics > 1)
 		mo->tics = 1 + (P_Random() % mo->state->tics);
@@ -594,7 +595,7 @@ static mobj_t *SpawnMapThing(const mobjtype_c *info,
 	if (options & MTF_AMBUSH)
 	{
 		mo->flags |= MF_AMBUSH;
-		mo->spawnpoint.flags |= MF_AMBUSH;
+		mo->cold->spawnpoint.flags |= MF_AMBUSH;
 	}
 
 	// -AJA- 2000/09/22: MBF compatibility flag
@@ -3365,6 +3366,11 @@ void P_SetupLevel(void)
 	itemquehead = NULL;
 	mobjlisthead = NULL;
 	seen_monsters.clear();
+	P_ClearMobjTypes();
+	P_ClearThinkers();
+	P_ClearSoundZones();
+	RGL_ClearLevelGeometry();
+	P_ResetInterpolation();
 
 	// get lump for map header e.g. MAP01
 	int lumpnum = W_CheckNumForName_MAP(currmap->lump.c_str());
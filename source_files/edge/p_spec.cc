@@ -48,6 +48,7 @@
 
 #include "str_util.h"
 
+#include "r_gldefs.h"
 #include "r_sky.h" //Lobo 2022: added for our Sky Transfer special
 
 #include "AlmostEquals.h"
@@ -634,6 +635,8 @@ static void P_LineEffect(line_t *target, line_t *source,
 	float length = R_PointToDist(0, 0, source->dx, source->dy);
 	float factor = 64.0 / length;
 
+	RGL_InvalidateLineWalls(target);
+
 	if ((special->line_effect & LINEFX_Translucency) && (target->flags & MLF_TwoSided))
 	{
 		target->side[0]->middle.translucency = 0.5f;
@@ -837,6 +840,8 @@ static void P_SectorEffect(sector_t *target, line_t *source, const linetype_c *s
 	if (! target)
 		return;
 
+	RGL_InvalidateSectorWalls(target);
+
 	float length  = R_PointToDist( 0, 0,  source->dx,  source->dy);
 	angle_t angle = ANG360 - R_PointToAngle(0, 0, -source->dx, -source->dy);
 	bool is_vert  = fabs(source->dy) > fabs(source->dx);
@@ -2355,6 +2360,8 @@ void P_UpdateSpecials(bool extra_tic)
 				ld->side[1]->bottom.net_scroll = {0,0};
 			}
 		}
+
+		RGL_InvalidateLineWalls(ld);
 	}
 
 	if (active_sector_anims.size() > 0)
@@ -2450,6 +2457,9 @@ void P_UpdateSpecials(bool extra_tic)
 		sec->props.push.x = sec->props.push.x + sec->props.net_push.x;
 		sec->props.push.y = sec->props.push.y + sec->props.net_push.y;
 
+		if (sec->props.push.x || sec->props.push.y || sec->props.push.z)
+			P_WakeSectorMobjs(sec);
+
 		// Reset dynamic stuff
 		sec->props.net_push = {0,0,0};
 		sec->floor.net_scroll = {0,0};
@@ -36,9 +36,13 @@
 #include "g_game.h"
 #include "n_network.h"
 #include "p_local.h"
+#include "p_particle.h"
 #include "p_spec.h"
+#include "r_gldefs.h"
 #include "rad_trig.h"
 
+#include <vector>
+
 #include "AlmostEquals.h"
 
 int leveltime;
@@ -50,11 +54,257 @@ bool erraticism_active = false;
 extern cvar_c g_erraticism;
 extern cvar_c r_doubleframes;
 
+
+//----------------------------------------------------------------------------
+//  INTERPOLATION
+//----------------------------------------------------------------------------
+//
+// With an uncapped frame rate, frames are drawn between tics.  At the
+// start of every tic the positions of things, the heights of sectors
+// and the player's view and weapon offsets are remembered, and while
+// drawing a frame they are temporarily replaced by values between the
+// remembered ones and the current ones.
+//
+
+// things moving further than this in one tic (teleports, RTS and
+// COAL repositioning) are not interpolated.
+#define MAX_INTERP_DIST  128.0f
+
+// bumped for each snapshot, zero means "none taken this level"
+static int interp_serial = 0;
+
+static bool interp_active = false;
+
+typedef struct
+{
+	mobj_t *mo;
+	float x, y, z;
+	angle_t angle;
+}
+interp_mobj_t;
+
+typedef struct
+{
+	sector_t *sec;
+	float f_h, c_h;
+}
+interp_sector_t;
+
+static std::vector<interp_mobj_t>   interp_mobjs;
+static std::vector<interp_sector_t> interp_sectors;
+
+static float interp_viewz[MAXPLAYERS];
+static vec2_t interp_psprites[MAXPLAYERS][NUMPSPRITES];
+
+
+static void P_SaveInterpolation(void)
+{
+	SYS_ASSERT(! interp_active);
+
+	interp_serial++;
+
+	for (mobj_t *mo = mobjlisthead; mo; mo = mo->next)
+	{
+		mo->prev_x = mo->x;
+		mo->prev_y = mo->y;
+		mo->prev_z = mo->z;
+		mo->prev_angle = mo->angle;
+
+		mo->interp_serial = interp_serial;
+	}
+
+	for (int i = 0; i < numsectors; i++)
+	{
+		sectors[i].prev_f_h = sectors[i].f_h;
+		sectors[i].prev_c_h = sectors[i].c_h;
+	}
+
+	for (int pnum = 0; pnum < MAXPLAYERS; pnum++)
+	{
+		player_t *p = players[pnum];
+		if (! p) continue;
+
+		p->prev_viewz = p->viewz;
+
+		for (int k = 0; k < NUMPSPRITES; k++)
+		{
+			p->psprites[k].prev_sx = p->psprites[k].sx;
+			p->psprites[k].prev_sy = p->psprites[k].sy;
+		}
+	}
+}
+
+
+//
+// P_ResetInterpolation
+//
+// Forget the last snapshot, must be called whenever the level
+// is set up or loaded from a savegame.
+//
+void P_ResetInterpolation(void)
+{
+	SYS_ASSERT(! interp_active);
+
+	interp_serial = 0;
+}
+
+
+static inline float InterpFloat(float prev, float cur, float frac)
+{
+	return prev + (cur - prev) * frac;
+}
+
+
+//
+// P_BeginInterpolation
+//
+// Moves everything to where it was `frac' (0.0 to 1.0) of the way
+// through the last tic.  Must be paired with P_EndInterpolation.
+//
+void P_BeginInterpolation(float frac)
+{
+	SYS_ASSERT(! interp_active);
+
+	if (interp_serial == 0 || frac >= 1.0f)
+		return;
+
+	frac = MAX(0.0f, frac);
+
+	interp_active = true;
+
+	// particles are moved back along their momentum when drawn
+	particle_lerp = frac;
+
+	interp_mobjs.clear();
+	interp_sectors.clear();
+
+	for (mobj_t *mo = mobjlisthead; mo; mo = mo->next)
+	{
+		// spawned (or teleported) since the snapshot?
+		if (mo->interp_serial != interp_serial)
+			continue;
+
+		if (AlmostEquals(mo->x, mo->prev_x) && AlmostEquals(mo->y, mo->prev_y) &&
+			AlmostEquals(mo->z, mo->prev_z) && mo->angle == mo->prev_angle)
+			continue;
+
+		if (fabs(mo->x - mo->prev_x) > MAX_INTERP_DIST ||
+			fabs(mo->y - mo->prev_y) > MAX_INTERP_DIST ||
+			fabs(mo->z - mo->prev_z) > MAX_INTERP_DIST)
+			continue;
+
+		interp_mobj_t saved = { mo, mo->x, mo->y, mo->z, mo->angle };
+		interp_mobjs.push_back(saved);
+
+		mo->x = InterpFloat(mo->prev_x, mo->x, frac);
+		mo->y = InterpFloat(mo->prev_y, mo->y, frac);
+		mo->z = InterpFloat(mo->prev_z, mo->z, frac);
+
+		// the console player turns straight away, as lerping would
+		// delay the mouse by up to a tic.
+		if (mo->player && mo->player == players[consoleplayer])
+			continue;
+
+		// take the shortest way around
+		int delta = (int)(mo->angle - mo->prev_angle);
+
+		mo->angle = mo->prev_angle + (angle_t)(int)(delta * frac);
+	}
+
+	for (int i = 0; i < numsectors; i++)
+	{
+		sector_t *sec = &sectors[i];
+
+		if (AlmostEquals(sec->f_h, sec->prev_f_h) && AlmostEquals(sec->c_h, sec->prev_c_h))
+			continue;
+
+		interp_sector_t saved = { sec, sec->f_h, sec->c_h };
+		interp_sectors.push_back(saved);
+
+		sec->f_h = InterpFloat(sec->prev_f_h, sec->f_h, frac);
+		sec->c_h = InterpFloat(sec->prev_c_h, sec->c_h, frac);
+
+		RGL_InvalidateSectorWalls(sec);
+	}
+
+	for (int pnum = 0; pnum < MAXPLAYERS; pnum++)
+	{
+		player_t *p = players[pnum];
+		if (! p) continue;
+
+		interp_viewz[pnum] = p->viewz;
+
+		if (! AlmostEquals(p->viewz, FLO_UNUSED) && ! AlmostEquals(p->prev_viewz, FLO_UNUSED))
+			p->viewz = InterpFloat(p->prev_viewz, p->viewz, frac);
+
+		for (int k = 0; k < NUMPSPRITES; k++)
+		{
+			pspdef_t *psp = &p->psprites[k];
+
+			interp_psprites[pnum][k].Set(psp->sx, psp->sy);
+
+			psp->sx = InterpFloat(psp->prev_sx, psp->sx, frac);
+			psp->sy = InterpFloat(psp->prev_sy, psp->sy, frac);
+		}
+	}
+}
+
+
+//
+// P_EndInterpolation
+//
+// Puts everything back to the state of the current tic.
+//
+void P_EndInterpolation(void)
+{
+	if (! interp_active)
+		return;
+
+	particle_lerp = 1.0f;
+
+	for (const interp_mobj_t& saved : interp_mobjs)
+	{
+		saved.mo->x = saved.x;
+		saved.mo->y = saved.y;
+		saved.mo->z = saved.z;
+		saved.mo->angle = saved.angle;
+	}
+
+	for (const interp_sector_t& saved : interp_sectors)
+	{
+		saved.sec->f_h = saved.f_h;
+		saved.sec->c_h = saved.c_h;
+
+		RGL_InvalidateSectorWalls(saved.sec);
+	}
+
+	for (int pnum = 0; pnum < MAXPLAYERS; pnum++)
+	{
+		player_t *p = players[pnum];
+		if (! p) continue;
+
+		p->viewz = interp_viewz[pnum];
+
+		for (int k = 0; k < NUMPSPRITES; k++)
+		{
+			p->psprites[k].sx = interp_psprites[pnum][k].x;
+			p->psprites[k].sy = interp_psprites[pnum][k].y;
+		}
+	}
+
+	interp_active = false;
+}
+
+
 //
 // P_Ticker
 //
 void P_Ticker(bool extra_tic)
 {
+	// remember where everything was, even when nothing will move
+	// (paused, in a menu), so that nothing gets interpolated then.
+	P_SaveInterpolation();
+
 	if (paused)
 		return;
 
@@ -96,6 +346,9 @@ void P_Ticker(bool extra_tic)
 	P_RunForces(extra_tic);
 	P_RunMobjThinkers(extra_tic);
 
+	if (!extra_tic || !r_doubleframes.d)
+		P_RunParticles();
+
 	if (!extra_tic || !r_doubleframes.d)
 		P_RunLights();
 
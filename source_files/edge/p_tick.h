@@ -33,6 +33,11 @@ void P_Ticker(bool extra_tic);
 
 void P_HubFastForward(void);
 
+// Interpolation of the rendered world between tics
+void P_ResetInterpolation(void);
+void P_BeginInterpolation(float frac);
+void P_EndInterpolation(void);
+
 // Needed to pause flat anims, etc when not moving or firing in Erraticism - Dasho
 extern bool erraticism_active;
 
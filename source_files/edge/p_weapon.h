@@ -62,6 +62,9 @@ typedef struct
 	// screen position values (0 is normal)
 	float sx, sy;
 
+	// values at the start of the current tic (for interpolation)
+	float prev_sx, prev_sy;
+
 	// translucency values
 	float visibility;
 	float vis_target;
@@ -39,6 +39,7 @@
 #include "m_argv.h"
 #include "r_misc.h"
 #include "r_gldefs.h"
+#include "r_glstate.h"
 #include "r_modes.h"
 #include "r_image.h"
 #include "r_shader.h"
@@ -917,7 +918,7 @@ public:
 		{
 			if (fade_tex != 0)
 			{
-				glDeleteTextures(1, &fade_tex);
+				RGL_DeleteTextures(1, &fade_tex);
 			}
 
 			if (r_forceflatlighting.d)
@@ -933,7 +934,7 @@ public:
 	{
 		if (fade_tex != 0)
 		{
-			glDeleteTextures(1, &fade_tex);
+			RGL_DeleteTextures(1, &fade_tex);
 			fade_tex = 0;
 		}
 	}
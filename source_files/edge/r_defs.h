@@ -254,6 +254,9 @@ typedef struct sector_s
 	// floor and ceiling heights
 	float f_h, c_h;
 
+	// heights at the start of the current tic (for interpolation)
+	float prev_f_h, prev_c_h;
+
 	surface_t floor, ceil;
 
 	region_properties_t props;
@@ -79,6 +79,10 @@ typedef post_t column_t;
 #define TRANS_REPLACE  pal_black
 
 
+epi::file_c *OpenEncodedImage(image_c *rim);
+epi::image_data_c *DecodeEncodedImage(image_c *rim, epi::file_c *f);
+
+
 // Dummy image, for when texture/flat/graphic is unknown.  Row major
 // order.  Could be packed, but why bother ?
 static byte dummy_graphic[DUMMY_X * DUMMY_Y] =
@@ -329,14 +333,9 @@ static epi::image_data_c *ReadPatchAsEpiBlock(image_c *rim)
 	// handle PNG/JPEG/TGA images
 	if (! rim->source.graphic.is_patch)
 	{
-		epi::file_c *f;
-
-		if (packfile_name)
-			f = W_OpenPackFile(packfile_name);
-		else
-			f = W_OpenLump(lump);
+		epi::file_c *f = OpenEncodedImage(rim);
 
-		epi::image_data_c *img = epi::Image_Load(f);
+		epi::image_data_c *img = DecodeEncodedImage(rim, f);
 
 		// close it
 		delete f;
@@ -504,12 +503,9 @@ epi::file_c *OpenUserFileOrLump(imagedef_c *def)
 
 static epi::image_data_c *CreateUserFileImage(image_c *rim, imagedef_c *def)
 {
-	epi::file_c *f = OpenUserFileOrLump(def);
-
-	if (! f)
-		I_Error("Missing image file: %s\n", def->info.c_str());
+	epi::file_c *f = OpenEncodedImage(rim);
 
-	epi::image_data_c *img = epi::Image_Load(f);
+	epi::image_data_c *img = DecodeEncodedImage(rim, f);
 
 	// close it
 	delete f;
@@ -518,6 +514,67 @@ static epi::image_data_c *CreateUserFileImage(image_c *rim, imagedef_c *def)
 		I_Error("Error occurred loading image file: %s\n",
 			def->info.c_str());
 
+	return img;
+}
+
+
+bool IsEncodedImage(const image_c *rim)
+{
+	switch (rim->source_type)
+	{
+		case IMSRC_Graphic:
+		case IMSRC_Sprite:
+		case IMSRC_TX_HI:
+			return ! rim->source.graphic.is_patch;
+
+		case IMSRC_User:
+			return rim->source.user.def->type != IMGDT_Colour;
+
+		default:
+			return false;
+	}
+}
+
+
+//
+// Opens the PNG/JPEG/TGA (etc) file of an image for which
+// IsEncodedImage() is true.
+//
+epi::file_c *OpenEncodedImage(image_c *rim)
+{
+	if (rim->source_type == IMSRC_User)
+	{
+		imagedef_c *def = rim->source.user.def;
+
+		epi::file_c *f = OpenUserFileOrLump(def);
+
+		if (! f)
+			I_Error("Missing image file: %s\n", def->info.c_str());
+
+		return f;
+	}
+
+	if (rim->source.graphic.packfile_name)
+		return W_OpenPackFile(rim->source.graphic.packfile_name);
+
+	return W_OpenLump(rim->source.graphic.lump);
+}
+
+
+//
+// Decodes an image opened by OpenEncodedImage().  Only the image itself
+// is touched, so this can run on a worker thread.  Returns NULL if the
+// file could not be decoded, it is up to the caller to complain.
+//
+epi::image_data_c *DecodeEncodedImage(image_c *rim, epi::file_c *f)
+{
+	epi::image_data_c *img = epi::Image_Load(f);
+
+	if (! img || rim->source_type != IMSRC_User)
+		return img;
+
+	imagedef_c *def = rim->source.user.def;
+
 /* Lobo 2022: info overload. Shut up.	
 #if 1  // DEBUGGING
 	L_WriteDebug("CREATE IMAGE [%s] %dx%d < %dx%d opac=%d --> %p %dx%d bpp %d\n",
@@ -20,8 +20,10 @@
 #include "i_defs_gl.h"
 
 #include "g_game.h"
+#include "hu_draw.h"
 #include "r_misc.h"
 #include "r_gldefs.h"
+#include "r_glstate.h"
 #include "r_units.h"
 #include "r_colormap.h"
 #include "r_draw.h"
@@ -46,6 +48,8 @@ void RGL_DrawImage(float x, float y, float w, float h, const image_c *image,
 				   const colourmap_c *textmap, float alpha,
 				   const colourmap_c *palremap)
 {
+	HUD_FlushBatch();
+
 	int x1 = I_ROUND(x);
 	int y1 = I_ROUND(y);
 	int x2 = I_ROUND(x+w+0.25f);
@@ -59,21 +63,21 @@ void RGL_DrawImage(float x, float y, float w, float h, const image_c *image,
 	GLuint tex_id = W_ImageCache(image, true,
 		(textmap && (textmap->special & COLSP_Whiten)) ? NULL : palremap, (textmap && (textmap->special & COLSP_Whiten)) ? true : false);
 
-	glEnable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, tex_id);
+	RGL_Enable(GL_TEXTURE_2D);
+	RGL_BindTexture(GL_TEXTURE_2D, tex_id);
  
 	if (alpha >= 0.99f && image->opacity == OPAC_Solid)
-		glDisable(GL_ALPHA_TEST);
+		RGL_Disable(GL_ALPHA_TEST);
 	else
 	{
-		glEnable(GL_ALPHA_TEST);
+		RGL_Enable(GL_ALPHA_TEST);
 
 		if (! (alpha < 0.11f || image->opacity == OPAC_Complex))
-			glAlphaFunc(GL_GREATER, alpha * 0.66f);
+			RGL_AlphaFunc(GL_GREATER, alpha * 0.66f);
 	}
 
 	if (image->opacity == OPAC_Complex || alpha < 0.99f)
-		glEnable(GL_BLEND);
+		RGL_Enable(GL_BLEND);
 
 	if (textmap)
 	{
@@ -102,11 +106,11 @@ void RGL_DrawImage(float x, float y, float w, float h, const image_c *image,
 
 	glEnd();
 
-	glDisable(GL_TEXTURE_2D);
-	glDisable(GL_ALPHA_TEST);
-	glDisable(GL_BLEND);
+	RGL_Disable(GL_TEXTURE_2D);
+	RGL_Disable(GL_ALPHA_TEST);
+	RGL_Disable(GL_BLEND);
 
-	glAlphaFunc(GL_GREATER, 0);
+	RGL_AlphaFunc(GL_GREATER, 0);
 }
 
 
@@ -23,6 +23,7 @@
 #include "e_player.h"
 #include "hu_draw.h" // HUD_* functions
 #include "m_misc.h"
+#include "r_glstate.h"
 #include "r_misc.h"
 #include "r_colormap.h"
 #include "r_image.h"
@@ -170,13 +171,13 @@ void RGL_ColourmapEffect(player_t *player)
 		if (var_invul_fx == INVULFX_Textured && !reduce_flash)
 			return;
 
-		glBlendFunc(GL_ONE_MINUS_DST_COLOR, GL_ZERO);
+		RGL_BlendFunc(GL_ONE_MINUS_DST_COLOR, GL_ZERO);
 
 		if (!reduce_flash)
 		{
 			glColor4f(1.0f, 1.0f, 1.0f, 0.0f);
 
-			glEnable(GL_BLEND);
+			RGL_Enable(GL_BLEND);
 	
 			glBegin(GL_QUADS);
 
@@ -193,7 +194,7 @@ void RGL_ColourmapEffect(player_t *player)
 
 			glEnd();
 	
-			glDisable(GL_BLEND);
+			RGL_Disable(GL_BLEND);
 		}
 		else
 		{
@@ -203,7 +204,7 @@ void RGL_ColourmapEffect(player_t *player)
 			HUD_ThinBox(hud_x_left, hud_visible_top, hud_x_right, hud_visible_bottom, RGB_MAKE(I_ROUND(s*255),I_ROUND(s*255),I_ROUND(s*255)), 25.0f);
 			HUD_SetAlpha(old_alpha);
 		}
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		RGL_BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	}
 }
 
@@ -266,7 +267,7 @@ void RGL_PaletteEffect(player_t *player)
 
 	if (!reduce_flash)
 	{
-		glEnable(GL_BLEND);
+		RGL_Enable(GL_BLEND);
 
 		glBegin(GL_QUADS);
 
@@ -277,7 +278,7 @@ void RGL_PaletteEffect(player_t *player)
 
 		glEnd();
 	
-		glDisable(GL_BLEND);
+		RGL_Disable(GL_BLEND);
 	}
 }
 
@@ -151,9 +151,6 @@ public:
 	float right_dx, right_dy;
 	float orig_top, orig_bottom;
 
-	// Rendering order
-	struct drawthing_s *rd_l, *rd_r, *rd_prev, *rd_next; 
-
 public:
 	void Clear()
 	{
@@ -161,7 +158,6 @@ public:
 		mo = NULL;
 		image = NULL;
 		props = NULL;
-		rd_l = rd_r = rd_prev = rd_next = NULL;
 	}
 }
 drawthing_t;
@@ -310,6 +306,10 @@ drawmirror_c *R_GetDrawMirror();
 
 void R2_Init(void);
 
+void RGL_ClearLevelGeometry(void);
+void RGL_InvalidateSectorWalls(const sector_t *sec);
+void RGL_InvalidateLineWalls(const line_t *ld);
+
 
 //
 //  MIRRORS
@@ -0,0 +1,375 @@
+//----------------------------------------------------------------------------
+//  EDGE OpenGL Rendering (State cache)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 1999-2023  The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#include "i_defs.h"
+#include "i_defs_gl.h"
+
+#include "r_glstate.h"
+
+
+gl_frame_stats_t gl_stats;
+gl_frame_stats_t gl_last_stats;
+
+
+// only the first few texture units are tracked, anything
+// beyond them is passed straight through.
+#define MAX_CACHED_TEX_UNITS  4
+
+// capabilities tracked by RGL_Enable / RGL_Disable
+static const GLenum cached_caps[] =
+{
+	GL_BLEND, GL_ALPHA_TEST, GL_FOG, GL_CULL_FACE, GL_DEPTH_TEST,
+	GL_LIGHTING, GL_COLOR_MATERIAL, GL_NORMALIZE,
+	GL_SCISSOR_TEST, GL_STENCIL_TEST,
+};
+
+#define NUM_CACHED_CAPS  (int)(sizeof(cached_caps) / sizeof(GLenum))
+
+// values for the capability slots
+#define CAP_UNKNOWN  0
+#define CAP_OFF      1
+#define CAP_ON       2
+
+// everything zero means nothing is known, which is how it starts
+typedef struct
+{
+	signed char caps[NUM_CACHED_CAPS];
+
+	// the active texture unit, -1 if not tracked
+	bool unit_known;
+	int  unit;
+
+	signed char tex_2d[MAX_CACHED_TEX_UNITS];
+	bool   tex_known[MAX_CACHED_TEX_UNITS];
+	GLuint tex[MAX_CACHED_TEX_UNITS];
+	bool   env_known[MAX_CACHED_TEX_UNITS];
+	GLint  env[MAX_CACHED_TEX_UNITS];
+
+	bool blend_known;
+	GLenum blend_src, blend_dst;
+
+	bool alpha_known;
+	GLenum alpha_func;
+	GLfloat alpha_ref;
+
+	bool depth_mask_known;
+	GLboolean depth_mask;
+
+	bool cull_known;
+	GLenum cull_mode;
+
+	bool offset_known;
+	GLfloat offset_factor, offset_units;
+
+	bool fog_mode_known;
+	GLint fog_mode;
+
+	bool fog_density_known, fog_start_known, fog_end_known;
+	GLfloat fog_density, fog_start, fog_end;
+
+	bool fog_color_known;
+	GLfloat fog_color[4];
+}
+gl_state_cache_t;
+
+static gl_state_cache_t cache;
+
+
+void RGL_InvalidateState(void)
+{
+	memset(&cache, 0, sizeof(cache));
+}
+
+
+void RGL_StartFrameState(void)
+{
+	gl_last_stats = gl_stats;
+
+	memset(&gl_stats, 0, sizeof(gl_stats));
+
+	RGL_InvalidateState();
+}
+
+
+static inline bool CacheSkip(bool same)
+{
+	if (same)
+	{
+		gl_stats.redundant++;
+		return true;
+	}
+
+	gl_stats.state_changes++;
+	return false;
+}
+
+
+static signed char *CapSlot(GLenum cap)
+{
+	if (cap == GL_TEXTURE_2D)
+	{
+		if (! cache.unit_known || cache.unit < 0)
+			return NULL;
+
+		return &cache.tex_2d[cache.unit];
+	}
+
+	for (int i = 0; i < NUM_CACHED_CAPS; i++)
+		if (cached_caps[i] == cap)
+			return &cache.caps[i];
+
+	return NULL;
+}
+
+
+void RGL_Enable(GLenum cap)
+{
+	signed char *slot = CapSlot(cap);
+
+	if (CacheSkip(slot && *slot == CAP_ON))
+		return;
+
+	if (slot)
+		*slot = CAP_ON;
+
+	glEnable(cap);
+}
+
+
+void RGL_Disable(GLenum cap)
+{
+	signed char *slot = CapSlot(cap);
+
+	if (CacheSkip(slot && *slot == CAP_OFF))
+		return;
+
+	if (slot)
+		*slot = CAP_OFF;
+
+	glDisable(cap);
+}
+
+
+void RGL_ActiveTexture(GLenum texture)
+{
+	int unit = (int)(texture - GL_TEXTURE0);
+
+	if (unit < 0 || unit >= MAX_CACHED_TEX_UNITS)
+		unit = -1;
+
+	if (CacheSkip(unit >= 0 && cache.unit_known && cache.unit == unit))
+		return;
+
+	cache.unit_known = true;
+	cache.unit = unit;
+
+	glActiveTexture(texture);
+}
+
+
+void RGL_BindTexture(GLenum target, GLuint texture)
+{
+	int unit = cache.unit_known ? cache.unit : -1;
+
+	if (target != GL_TEXTURE_2D || unit < 0)
+	{
+		gl_stats.binds++;
+		glBindTexture(target, texture);
+		return;
+	}
+
+	if (cache.tex_known[unit] && cache.tex[unit] == texture)
+	{
+		gl_stats.redundant++;
+		return;
+	}
+
+	cache.tex_known[unit] = true;
+	cache.tex[unit] = texture;
+
+	gl_stats.binds++;
+	glBindTexture(target, texture);
+}
+
+
+void RGL_DeleteTextures(GLsizei n, const GLuint *textures)
+{
+	// GL reverts a deleted texture's bindings back to zero
+	for (GLsizei i = 0; i < n; i++)
+		for (int t = 0; t < MAX_CACHED_TEX_UNITS; t++)
+			if (cache.tex_known[t] && cache.tex[t] == textures[i])
+				cache.tex[t] = 0;
+
+	glDeleteTextures(n, textures);
+}
+
+
+void RGL_TexEnvi(GLenum target, GLenum pname, GLint param)
+{
+	int unit = cache.unit_known ? cache.unit : -1;
+
+	// only the environment mode is tracked
+	if (target != GL_TEXTURE_ENV || pname != GL_TEXTURE_ENV_MODE || unit < 0)
+	{
+		gl_stats.state_changes++;
+		glTexEnvi(target, pname, param);
+		return;
+	}
+
+	if (CacheSkip(cache.env_known[unit] && cache.env[unit] == param))
+		return;
+
+	cache.env_known[unit] = true;
+	cache.env[unit] = param;
+
+	glTexEnvi(target, pname, param);
+}
+
+
+void RGL_BlendFunc(GLenum sfactor, GLenum dfactor)
+{
+	if (CacheSkip(cache.blend_known && cache.blend_src == sfactor &&
+				  cache.blend_dst == dfactor))
+		return;
+
+	cache.blend_known = true;
+	cache.blend_src = sfactor;
+	cache.blend_dst = dfactor;
+
+	glBlendFunc(sfactor, dfactor);
+}
+
+
+void RGL_AlphaFunc(GLenum func, GLfloat ref)
+{
+	if (CacheSkip(cache.alpha_known && cache.alpha_func == func &&
+				  cache.alpha_ref == ref))
+		return;
+
+	cache.alpha_known = true;
+	cache.alpha_func = func;
+	cache.alpha_ref = ref;
+
+	glAlphaFunc(func, ref);
+}
+
+
+void RGL_DepthMask(GLboolean flag)
+{
+	if (CacheSkip(cache.depth_mask_known && cache.depth_mask == flag))
+		return;
+
+	cache.depth_mask_known = true;
+	cache.depth_mask = flag;
+
+	glDepthMask(flag);
+}
+
+
+void RGL_CullFace(GLenum mode)
+{
+	if (CacheSkip(cache.cull_known && cache.cull_mode == mode))
+		return;
+
+	cache.cull_known = true;
+	cache.cull_mode = mode;
+
+	glCullFace(mode);
+}
+
+
+void RGL_PolygonOffset(GLfloat factor, GLfloat units)
+{
+	if (CacheSkip(cache.offset_known && cache.offset_factor == factor &&
+				  cache.offset_units == units))
+		return;
+
+	cache.offset_known = true;
+	cache.offset_factor = factor;
+	cache.offset_units = units;
+
+	glPolygonOffset(factor, units);
+}
+
+
+void RGL_Fogi(GLenum pname, GLint param)
+{
+	if (pname != GL_FOG_MODE)
+	{
+		gl_stats.state_changes++;
+		glFogi(pname, param);
+		return;
+	}
+
+	if (CacheSkip(cache.fog_mode_known && cache.fog_mode == param))
+		return;
+
+	cache.fog_mode_known = true;
+	cache.fog_mode = param;
+
+	glFogi(pname, param);
+}
+
+
+void RGL_Fogf(GLenum pname, GLfloat param)
+{
+	bool    *known;
+	GLfloat *value;
+
+	switch (pname)
+	{
+		case GL_FOG_DENSITY: known = &cache.fog_density_known; value = &cache.fog_density; break;
+		case GL_FOG_START:   known = &cache.fog_start_known;   value = &cache.fog_start;   break;
+		case GL_FOG_END:     known = &cache.fog_end_known;     value = &cache.fog_end;     break;
+
+		default:
+			gl_stats.state_changes++;
+			glFogf(pname, param);
+			return;
+	}
+
+	if (CacheSkip(*known && *value == param))
+		return;
+
+	*known = true;
+	*value = param;
+
+	glFogf(pname, param);
+}
+
+
+void RGL_Fogfv(GLenum pname, const GLfloat *params)
+{
+	if (pname != GL_FOG_COLOR)
+	{
+		gl_stats.state_changes++;
+		glFogfv(pname, params);
+		return;
+	}
+
+	if (CacheSkip(cache.fog_color_known && memcmp(cache.fog_color, params, sizeof(cache.fog_color)) == 0))
+		return;
+
+	cache.fog_color_known = true;
+	memcpy(cache.fog_color, params, sizeof(cache.fog_color));
+
+	glFogfv(pname, params);
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
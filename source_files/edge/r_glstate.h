@@ -0,0 +1,72 @@
+//----------------------------------------------------------------------------
+//  EDGE OpenGL Rendering (State cache)
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 1999-2023  The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#ifndef __RGL_GLSTATE_H__
+#define __RGL_GLSTATE_H__
+
+// These mirror the GL calls of the same name, but remember the
+// current state and drop calls which would not change it.  All
+// engine code must go through them (instead of calling GL directly)
+// for the cached state to stay correct.
+
+void RGL_Enable(GLenum cap);
+void RGL_Disable(GLenum cap);
+
+void RGL_ActiveTexture(GLenum texture);
+void RGL_BindTexture(GLenum target, GLuint texture);
+void RGL_DeleteTextures(GLsizei n, const GLuint *textures);
+void RGL_TexEnvi(GLenum target, GLenum pname, GLint param);
+
+void RGL_BlendFunc(GLenum sfactor, GLenum dfactor);
+void RGL_AlphaFunc(GLenum func, GLfloat ref);
+void RGL_DepthMask(GLboolean flag);
+void RGL_CullFace(GLenum mode);
+void RGL_PolygonOffset(GLfloat factor, GLfloat units);
+
+void RGL_Fogi(GLenum pname, GLint param);
+void RGL_Fogf(GLenum pname, GLfloat param);
+void RGL_Fogfv(GLenum pname, const GLfloat *params);
+
+// forget the cached state, so the next call of each kind always
+// reaches GL.  Called at the start of every frame.
+void RGL_InvalidateState(void);
+
+
+// per-frame counters
+typedef struct
+{
+	int draw_calls;
+	int vertices;
+	int units;          // units flushed by RGL_DrawUnits
+	int binds;          // texture binds passed to GL
+	int state_changes;  // other state calls passed to GL
+	int redundant;      // calls dropped by the cache
+}
+gl_frame_stats_t;
+
+// the frame being drawn, and the last complete one
+extern gl_frame_stats_t gl_stats;
+extern gl_frame_stats_t gl_last_stats;
+
+// called once at the start of each frame
+void RGL_StartFrameState(void);
+
+#endif /* __RGL_GLSTATE_H__ */
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -35,10 +35,12 @@
 #include "i_defs_gl.h"
 
 #include <limits.h>
+#include <algorithm>
 #include <list>
 
 #include "endianess.h"
 #include "file.h"
+#include "file_memory.h"
 #include "filesystem.h"
 #include "flat.h"
 
@@ -48,6 +50,7 @@
 #include "image_funcs.h"
 #include "path.h"
 #include "str_util.h"
+#include "stb_rect_pack.h"
 
 #include "dm_data.h"
 #include "dm_defs.h"
@@ -55,11 +58,13 @@
 #include "e_search.h"
 #include "e_main.h"
 #include "hu_draw.h" // hudtic
+#include "hu_font.h"
 #include "m_argv.h"
 #include "m_misc.h"
 #include "p_local.h"
 #include "r_defs.h"
 #include "r_gldefs.h"
+#include "r_glstate.h"
 #include "r_image.h"
 #include "r_sky.h"
 #include "r_texgl.h"
@@ -77,6 +82,10 @@ swirl_type_e swirling_flats = SWIRL_Vanilla;
 
 extern epi::image_data_c *ReadAsEpiBlock(image_c *rim);
 
+extern bool IsEncodedImage(const image_c *rim);
+extern epi::file_c *OpenEncodedImage(image_c *rim);
+extern epi::image_data_c *DecodeEncodedImage(image_c *rim, epi::file_c *f);
+
 extern epi::file_c *OpenUserFileOrLump(imagedef_c *def);
 
 extern cvar_c r_doubleframes;
@@ -1258,8 +1267,43 @@ static int IM_PixelLimit(image_c *rim)
 }
 
 
-static GLuint LoadImageOGL(image_c *rim, const colourmap_c *trans, bool do_whiten)
+//
+// An image on its way to becoming a GL texture.  Loading is split in
+// three steps so that W_ImagePreCacheList() can do the middle one on
+// worker threads:
+//
+//   ReadImageOGL    : reads the files (main thread only)
+//   ConvertImageOGL : decodes and converts the pixels
+//   UploadImageOGL  : hands the result to GL (main thread only)
+//
+typedef struct
+{
+	image_c *rim;
+
+	const colourmap_c *trans;
+	bool do_whiten;
+
+	bool clamp, mip, smooth;
+	int max_pix;
+
+	const byte *what_palette;
+	bool what_pal_cached;
+
+	byte trans_pal[256 * 3];
+
+	// for PNG/JPEG/TGA images when decoding is left to ConvertImageOGL
+	byte *file_data;
+	int file_length;
+
+	epi::image_data_c *img;
+}
+image_load_t;
+
+
+static void ReadImageOGL(image_load_t *L, bool defer_decode)
 {
+	image_c *rim = L->rim;
+
 	bool clamp  = IM_ShouldClamp(rim);
 	bool mip    = IM_ShouldMipmap(rim);
 	bool smooth = IM_ShouldSmooth(rim);
@@ -1297,28 +1341,77 @@ static GLuint LoadImageOGL(image_c *rim, const colourmap_c *trans, bool do_white
 			smooth = false;
 	}
 
+	L->clamp   = clamp;
+	L->mip     = mip;
+	L->smooth  = smooth;
+	L->max_pix = max_pix;
 
-	const byte *what_palette = (const byte *) &playpal_data[0];
-	bool what_pal_cached = false;
-
-	static byte trans_pal[256 * 3];
+	L->what_palette = (const byte *) &playpal_data[0];
+	L->what_pal_cached = false;
 
-	if (trans != NULL)
+	if (L->trans != NULL)
 	{
 		// Note: we don't care about source_palette here. It's likely that
 		// the translation table itself would not match the other palette,
 		// and so we would still end up with messed up colours.
 
-		R_TranslatePalette(trans_pal, what_palette, trans);
-		what_palette = trans_pal;
+		R_TranslatePalette(L->trans_pal, L->what_palette, L->trans);
+		L->what_palette = L->trans_pal;
 	}
 	else if (rim->source_palette >= 0)
 	{
-		what_palette = (const byte *) W_LoadLump(rim->source_palette);
-		what_pal_cached = true;
+		L->what_palette = (const byte *) W_LoadLump(rim->source_palette);
+		L->what_pal_cached = true;
+	}
+
+	L->file_data = NULL;
+	L->file_length = 0;
+	L->img = NULL;
+
+	if (defer_decode && IsEncodedImage(rim))
+	{
+		epi::file_c *f = OpenEncodedImage(rim);
+
+		if (f)
+		{
+			L->file_length = f->GetLength();
+			L->file_data = f->LoadIntoMemory();
+
+			delete f;
+		}
+	}
+
+	// anything else is decoded right here
+	if (! L->file_data)
+		L->img = ReadAsEpiBlock(rim);
+}
+
+
+//
+// Only touches the image being loaded, so it is safe to run on any
+// thread, EXCEPT when IM_ShouldHQ2X() is true (the scaler has global
+// tables).  Returns false if a deferred file could not be decoded.
+//
+static bool ConvertImageOGL(image_load_t *L)
+{
+	image_c *rim = L->rim;
+
+	if (L->file_data)
+	{
+		epi::mem_file_c mem(L->file_data, L->file_length, false);
+
+		L->img = DecodeEncodedImage(rim, &mem);
+
+		delete[] L->file_data;
+		L->file_data = NULL;
+
+		if (! L->img)
+			return false;
 	}
 
-	epi::image_data_c *tmp_img = ReadAsEpiBlock(rim);
+	epi::image_data_c *tmp_img = L->img;
+
+	const byte *what_palette = L->what_palette;
 
 	if (rim->liquid_type > LIQ_None && (swirling_flats == SWIRL_SMMU || swirling_flats == SWIRL_SMMUSWIRL))
 	{
@@ -1388,38 +1481,67 @@ static GLuint LoadImageOGL(image_c *rim, const colourmap_c *trans, bool do_white
 			delete tmp_img;
 			tmp_img = blurred_img;
 		}
-		if (trans != NULL)
+		if (L->trans != NULL)
 			R_PaletteRemapRGBA(tmp_img, what_palette, (const byte *) &playpal_data[0]);
 	}
 
 	if (rim->hsv_rotation || rim->hsv_saturation > -1 || rim->hsv_value > -1)
 		tmp_img->SetHSV(rim->hsv_rotation, rim->hsv_saturation, rim->hsv_value);
 	
-	if (do_whiten)
+	if (L->do_whiten)
 		tmp_img->Whiten();
 
-	GLuint tex_id = R_UploadTexture(tmp_img,
-		(clamp  ? UPL_Clamp  : 0) |
-		(mip    ? UPL_MipMap : 0) |
-		(smooth ? UPL_Smooth : 0) |
-		((rim->opacity == OPAC_Masked) ? UPL_Thresh : 0), max_pix);
+	L->img = tmp_img;
 
-	delete tmp_img;
+	return true;
+}
+
+
+static GLuint UploadImageOGL(image_load_t *L)
+{
+	image_c *rim = L->rim;
+
+	GLuint tex_id = R_UploadTexture(L->img,
+		(L->clamp  ? UPL_Clamp  : 0) |
+		(L->mip    ? UPL_MipMap : 0) |
+		(L->smooth ? UPL_Smooth : 0) |
+		((rim->opacity == OPAC_Masked) ? UPL_Thresh : 0), L->max_pix);
+
+	delete L->img;
+	L->img = NULL;
+
+	if (L->what_pal_cached)
+		delete[] L->what_palette;
+
+	L->what_palette = NULL;
+	L->what_pal_cached = false;
 
-	if (what_pal_cached)
-		delete[] what_palette;
-	
 	return tex_id;
 }
 
 
+static GLuint LoadImageOGL(image_c *rim, const colourmap_c *trans, bool do_whiten)
+{
+	image_load_t L;
+
+	L.rim = rim;
+	L.trans = trans;
+	L.do_whiten = do_whiten;
+
+	ReadImageOGL(&L, false);
+	ConvertImageOGL(&L);
+
+	return UploadImageOGL(&L);
+}
+
+
 
 
 #if 0
 static
 void UnloadImageOGL(cached_image_t *rc, image_c *rim)
 {
-	glDeleteTextures(1, &rc->tex_id);
+	RGL_DeleteTextures(1, &rc->tex_id);
 
 	for (unsigned int i = 0; i < rim->cache.size(); i++)
 	{
@@ -1811,7 +1933,11 @@ const char *W_ImageGetName(const image_c *image)
 //  IMAGE USAGE
 //
 
-static cached_image_t *ImageCacheOGL(image_c *rim,
+//
+// Finds the cache entry for the image + translation, creating an
+// empty one (tex_id == 0) if it is not there.
+//
+static cached_image_t *FindCachedImage(image_c *rim,
 	const colourmap_c *trans, bool do_whiten)
 {
 	// check if image + translation is already cached
@@ -1868,13 +1994,22 @@ static cached_image_t *ImageCacheOGL(image_c *rim,
 
 	SYS_ASSERT(rc);
 
+	return rc;
+}
+
+
+static cached_image_t *ImageCacheOGL(image_c *rim,
+	const colourmap_c *trans, bool do_whiten)
+{
+	cached_image_t *rc = FindCachedImage(rim, trans, do_whiten);
+
 	if (rim->liquid_type > LIQ_None && (swirling_flats == SWIRL_SMMU || swirling_flats == SWIRL_SMMUSWIRL))
 	{
 		if (!erraticism_active && !time_stop_active && rim->swirled_gametic != hudtic / (r_doubleframes.d ? 2 : 1))
 		{
 			if (rc->tex_id != 0)
 			{
-				glDeleteTextures(1, &rc->tex_id);
+				RGL_DeleteTextures(1, &rc->tex_id);
 				rc->tex_id = 0;
 			}
 		}
@@ -1917,6 +2052,133 @@ GLuint W_ImageCache(const image_c *image, bool anim,
 }
 
 
+//
+// Packs a set of images (NULL entries are skipped) into a single
+// texture, each one converted just like W_ImageCache() would do it,
+// and with a one pixel border copied from its edges so that smoothing
+// doesn't bleed between neighbours.  The place of each image is
+// stored in 'rects' (zero for skipped ones), and the worst opacity
+// in 'opacity'.  The caller owns the texture.  Returns zero when
+// nothing could be packed, or it would not fit in one texture.
+//
+GLuint W_ImageCacheAtlas(const image_c **images, int count, bool do_whiten,
+						 image_atlas_rect_t *rects, int *opacity)
+{
+	std::vector<epi::image_data_c *> pixels(count, nullptr);
+	std::vector<stbrp_rect> boxes;
+
+	bool smooth = false;
+
+	*opacity = OPAC_Solid;
+
+	for (int i = 0; i < count; i++)
+	{
+		rects[i].s1 = rects[i].t1 = rects[i].s2 = rects[i].t2 = 0;
+
+		if (! images[i])
+			continue;
+
+		image_load_t L;
+
+		L.rim = (image_c *) images[i];
+		L.trans = NULL;
+		L.do_whiten = do_whiten || L.rim->grayscale;
+
+		ReadImageOGL(&L, false);
+
+		if (ConvertImageOGL(&L))
+			pixels[i] = L.img;
+
+		if (L.what_pal_cached)
+			delete[] L.what_palette;
+
+		if (! pixels[i])
+			continue;
+
+		SYS_ASSERT(pixels[i]->bpp >= 3);
+
+		smooth   = smooth || L.smooth;
+		*opacity = MAX(*opacity, L.rim->opacity);
+
+		stbrp_rect box;
+
+		box.id = i;
+		box.w  = pixels[i]->used_w + 2;
+		box.h  = pixels[i]->used_h + 2;
+
+		boxes.push_back(box);
+	}
+
+	int size = 0;
+
+	if (! boxes.empty())
+	{
+		for (int try_size = 64; try_size <= glmax_tex_size; try_size *= 2)
+		{
+			std::vector<stbrp_node> nodes(try_size);
+
+			stbrp_context ctx;
+			stbrp_init_target(&ctx, try_size, try_size, nodes.data(), try_size);
+
+			if (stbrp_pack_rects(&ctx, boxes.data(), (int)boxes.size()))
+			{
+				size = try_size;
+				break;
+			}
+		}
+	}
+
+	GLuint tex_id = 0;
+
+	if (size > 0)
+	{
+		epi::image_data_c atlas(size, size, 4);
+
+		atlas.Clear(0);
+
+		for (const stbrp_rect& box : boxes)
+		{
+			const epi::image_data_c *src = pixels[box.id];
+
+			for (int y = -1; y <= src->used_h; y++)
+			for (int x = -1; x <= src->used_w; x++)
+			{
+				const u8_t *sp = src->PixelAt(CLAMP(0, x, src->used_w - 1),
+											  CLAMP(0, y, src->used_h - 1));
+
+				u8_t *dp = atlas.PixelAt(box.x + 1 + x, box.y + 1 + y);
+
+				dp[0] = sp[0];
+				dp[1] = sp[1];
+				dp[2] = sp[2];
+				dp[3] = (src->bpp == 4) ? sp[3] : 255;
+			}
+
+			image_atlas_rect_t& R = rects[box.id];
+
+			R.s1 = (box.x + 1) / (float)size;
+			R.t1 = (box.y + 1) / (float)size;
+			R.s2 = (box.x + 1 + src->used_w) / (float)size;
+			R.t2 = (box.y + 1 + src->used_h) / (float)size;
+		}
+
+		tex_id = R_UploadTexture(&atlas, UPL_Clamp |
+			(smooth ? UPL_Smooth : 0) |
+			((*opacity == OPAC_Masked) ? UPL_Thresh : 0));
+	}
+	else if (! boxes.empty())
+	{
+		I_Warning("W_ImageCacheAtlas: %d images will not fit in one texture\n",
+			(int)boxes.size());
+	}
+
+	for (epi::image_data_c *img : pixels)
+		delete img;
+
+	return tex_id;
+}
+
+
 #if 0
 rgbcol_t W_ImageGetHue(const image_c *img)
 {
@@ -1932,26 +2194,146 @@ rgbcol_t W_ImageGetHue(const image_c *img)
 #endif
 
 
+//
+// Returns the other half of a switch texture, or NULL.
+//
+static const image_c *SwitchAlternate(const image_c *image)
+{
+	if (image->name.size() < 4 ||
+		(epi::prefix_case_cmp(image->name, "SW1") != 0 &&
+		 epi::prefix_case_cmp(image->name, "SW2") != 0))
+		return NULL;
+
+	std::string alt_name = image->name;
+
+	alt_name[2] = (alt_name[2] == '1') ? '2' : '1';
+
+	return W_ImageDoLookup(real_textures, alt_name.c_str());
+}
+
+
 void W_ImagePreCache(const image_c *image)
 {
 	W_ImageCache(image, false);
 
-	// Intentional Const Override
-	image_c *rim = (image_c *) image;
-
 	// pre-cache alternative images for switches too
-	if (rim->name.size() >= 4 &&
-		(epi::prefix_case_cmp(rim->name, "SW1") == 0 ||
-		 epi::prefix_case_cmp(rim->name, "SW2") == 0 ))
+	const image_c *alt = SwitchAlternate(image);
+
+	if (alt) W_ImageCache(alt, false);
+}
+
+
+typedef struct
+{
+	std::vector<image_load_t> loads;
+
+	// 1 = converted, 0 = decoding failed, -1 = left for the main thread
+	std::vector<int> result;
+}
+image_precache_job_t;
+
+static void PreCacheWorker(int index, void *data)
+{
+	image_precache_job_t *job = (image_precache_job_t *) data;
+
+	if (job->result[index] < 0)
+		return;
+
+	job->result[index] = ConvertImageOGL(&job->loads[index]) ? 1 : 0;
+}
+
+
+// images read into memory at once by W_ImagePreCacheList()
+#define PRECACHE_BATCH  64
+
+//
+// Same as calling W_ImagePreCache() on each image, but the pixels
+// are decoded and converted on several threads.  The file reads and
+// the GL uploads still happen here, in order.  The list is done in
+// batches so only a few images are held in memory at a time.
+// Returns how many images were not already cached.
+//
+int W_ImagePreCacheList(std::vector<const image_c *>& images)
+{
+	size_t count = images.size();
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const image_c *alt = SwitchAlternate(images[i]);
+
+		if (alt) images.push_back(alt);
+	}
+
+	std::sort(images.begin(), images.end());
+	images.erase(std::unique(images.begin(), images.end()), images.end());
+
+	int total = 0;
+
+	size_t pos = 0;
+
+	while (pos < images.size())
 	{
-		std::string alt_name = rim->name;
+		image_precache_job_t job;
 
-		alt_name[2] = (alt_name[2] == '1') ? '2' : '1';
+		std::vector<cached_image_t *> slots;
 
-		image_c *alt = W_ImageDoLookup(real_textures, alt_name.c_str());
+		for (; pos < images.size() && job.loads.size() < PRECACHE_BATCH; pos++)
+		{
+			// Intentional Const Override
+			image_c *rim = (image_c *) images[pos];
+
+			bool do_whiten = rim->grayscale;
+
+			cached_image_t *rc = FindCachedImage(rim, NULL, do_whiten);
+
+			if (rc->tex_id != 0)
+				continue;
+
+			image_load_t L;
+
+			L.rim = rim;
+			L.trans = NULL;
+			L.do_whiten = do_whiten;
+
+			ReadImageOGL(&L, true);
+
+			bool hq2x = (L.img && L.img->bpp == 1 && IM_ShouldHQ2X(rim));
+
+			job.loads.push_back(L);
+			job.result.push_back(hq2x ? -1 : 1);
+
+			slots.push_back(rc);
+		}
 
-		if (alt) W_ImageCache(alt, false);
+		int num = (int)job.loads.size();
+
+		I_RunParallel(num, PreCacheWorker, &job);
+
+		// uploading also frees the pixels
+		for (int i = 0; i < num; i++)
+		{
+			image_load_t *L = &job.loads[i];
+
+			if (job.result[i] < 0)
+				job.result[i] = ConvertImageOGL(L) ? 1 : 0;
+
+			if (job.result[i] == 0)
+			{
+				// go the long way, which reports the error
+				if (L->what_pal_cached)
+					delete[] L->what_palette;
+
+				slots[i]->tex_id = LoadImageOGL(L->rim, NULL, L->do_whiten);
+				continue;
+			}
+
+			slots[i]->tex_id = UploadImageOGL(L);
+		}
+
+		total += num;
 	}
+
+	return total;
 }
 
 
@@ -2024,13 +2406,14 @@ void W_DeleteAllImages(void)
 
 		if (rc->tex_id != 0)
 		{
-			glDeleteTextures(1, &rc->tex_id);
+			RGL_DeleteTextures(1, &rc->tex_id);
 			rc->tex_id = 0;
 		}
 	}
 
 	DeleteSkyTextures();
 	DeleteColourmapTextures();
+	HU_DeleteFontAtlases();
 }
 
 
@@ -267,6 +267,22 @@ GLuint W_ImageCache(const image_c *image, bool anim = true,
 #endif
 void W_ImagePreCache(const image_c *image);
 
+// where W_ImageCacheAtlas() put an image, as texture coords
+typedef struct
+{
+	float s1, t1, s2, t2;
+}
+image_atlas_rect_t;
+
+#ifdef USING_GL_TYPES
+GLuint W_ImageCacheAtlas(const image_c **images, int count, bool do_whiten,
+						 image_atlas_rect_t *rects, int *opacity);
+#endif
+
+// loads a whole set of images, decoding them on several threads.
+// The list is sorted and switch partners are added to it.
+int W_ImagePreCacheList(std::vector<const image_c *>& images);
+
 
 // -AJA- planned....
 // rgbcol_t W_ImageGetHue(const image_c *c);
@@ -22,6 +22,7 @@
 #include "g_game.h"
 #include "r_misc.h"
 #include "r_gldefs.h"
+#include "r_glstate.h"
 #include "r_units.h"
 #include "r_colormap.h"
 #include "r_draw.h"
@@ -61,10 +62,10 @@ void RGL_SetupMatrices2D(void)
 	glLoadIdentity();
 
 	// turn off lighting stuff
-	glDisable(GL_LIGHTING);
-	glDisable(GL_COLOR_MATERIAL);
+	RGL_Disable(GL_LIGHTING);
+	RGL_Disable(GL_COLOR_MATERIAL);
 
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	RGL_BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
 
 //
@@ -85,10 +86,10 @@ void RGL_SetupMatricesWorld2D(void)
 	glLoadIdentity();
 
 	// turn off lighting stuff
-	glDisable(GL_LIGHTING);
-	glDisable(GL_COLOR_MATERIAL);
+	RGL_Disable(GL_LIGHTING);
+	RGL_Disable(GL_COLOR_MATERIAL);
 
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	RGL_BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
 
 //
@@ -125,21 +126,21 @@ void RGL_SetupMatrices3D(void)
 	// without it.
 	if (r_colorlighting.d)
 	{
-		glEnable(GL_LIGHTING);
+		RGL_Enable(GL_LIGHTING);
 		glLightModelfv(GL_LIGHT_MODEL_AMBIENT, ambient);
 	}
 	else
-		glDisable(GL_LIGHTING);
+		RGL_Disable(GL_LIGHTING);
 
 	if (r_colormaterial.d)
 	{
-		glEnable(GL_COLOR_MATERIAL);
+		RGL_Enable(GL_COLOR_MATERIAL);
 		glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
 	}
 	else
-		glDisable(GL_COLOR_MATERIAL);
+		RGL_Disable(GL_COLOR_MATERIAL);
 
-	/* glBlendFunc(GL_SRC_ALPHA, GL_ONE);  // Additive lighting */
+	/* RGL_BlendFunc(GL_SRC_ALPHA, GL_ONE);  // Additive lighting */
 }
 
 static inline const char *SafeStr(const void *s)
@@ -187,28 +188,31 @@ void RGL_CheckExtensions(void)
 // 
 void RGL_SoftInit(void)
 {
-	glDisable(GL_BLEND);
-	glDisable(GL_LIGHTING);
-	glDisable(GL_CULL_FACE);
-	glDisable(GL_DEPTH_TEST);
-	glDisable(GL_SCISSOR_TEST);
-	glDisable(GL_STENCIL_TEST);
+	// the context may be new, nothing cached is valid
+	RGL_InvalidateState();
 
-	glDisable(GL_LINE_SMOOTH);
+	RGL_Disable(GL_BLEND);
+	RGL_Disable(GL_LIGHTING);
+	RGL_Disable(GL_CULL_FACE);
+	RGL_Disable(GL_DEPTH_TEST);
+	RGL_Disable(GL_SCISSOR_TEST);
+	RGL_Disable(GL_STENCIL_TEST);
+
+	RGL_Disable(GL_LINE_SMOOTH);
 
 #ifndef EDGE_GL_ES2
-	glDisable(GL_POLYGON_SMOOTH);
+	RGL_Disable(GL_POLYGON_SMOOTH);
 #endif
 
-	glEnable(GL_NORMALIZE);
+	RGL_Enable(GL_NORMALIZE);
 
 	glShadeModel(GL_SMOOTH);
 	glDepthFunc(GL_LEQUAL);
-	glAlphaFunc(GL_GREATER, 0);
+	RGL_AlphaFunc(GL_GREATER, 0);
 
 	glFrontFace(GL_CW);
-	glCullFace(GL_BACK);
-	glDisable(GL_CULL_FACE);
+	RGL_CullFace(GL_BACK);
+	RGL_Disable(GL_CULL_FACE);
 
 	glHint(GL_FOG_HINT, GL_NICEST);
 	glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);
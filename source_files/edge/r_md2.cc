@@ -34,6 +34,7 @@
 #include "r_mdcommon.h"
 #include "r_md2.h"
 #include "r_gldefs.h"
+#include "r_glstate.h"
 #include "r_colormap.h"
 #include "r_effects.h"
 #include "r_image.h"
@@ -209,16 +210,9 @@ raw_md3_frame_t;
 
 /*============== EDGE REPRESENTATION ====================*/
 
-struct md2_vertex_c
-{
-	float x, y, z;
-
-	short normal_idx;
-};
-
 struct md2_frame_c
 {
-	md2_vertex_c *vertices;
+	md_vertex_c *vertices;
 
 	const char *name;
 
@@ -226,14 +220,6 @@ struct md2_frame_c
 	short *used_normals;
 };
 
-struct md2_point_c
-{
-	float skin_s, skin_t;
-
-	// index into frame's vertex array (md2_frame_c::verts)
-	int vert_idx;
-};
-
 struct md2_triangle_c
 {
 	// index to the first point (within md2_model_c::points).
@@ -249,7 +235,7 @@ public:
 	int num_tris;
 
 	md2_frame_c *frames;
-	md2_point_c *points;
+	md_point_c *points;
 	md2_triangle_c *tris;
 
 	int verts_per_frame;
@@ -264,7 +250,7 @@ public:
 		num_tris(_ntris), verts_per_frame(0), vbo(0), gl_verts(nullptr)
 	{
 		frames = new md2_frame_c[num_frames];
-		points = new md2_point_c[num_points];
+		points = new md_point_c[num_points];
 		tris = new md2_triangle_c[num_tris];
 		gl_verts = new local_gl_vert_t[num_tris * 3];
 	}
@@ -399,7 +385,7 @@ md2_model_c *MD2_LoadModel(epi::file_c *f)
 
 	// convert raw tris
 	md2_triangle_c *tri = md->tris;
-	md2_point_c *point = md->points;
+	md_point_c *point = md->points;
 
 	for (i = 0; i < num_tris; i++)
 	{
@@ -472,14 +458,14 @@ md2_model_c *MD2_LoadModel(epi::file_c *f)
 
 		f->Read(raw_verts, md->verts_per_frame * sizeof(raw_md2_vertex_t));
 
-		md->frames[i].vertices = new md2_vertex_c[md->verts_per_frame];
+		md->frames[i].vertices = new md_vertex_c[md->verts_per_frame];
 
 		memset(which_normals, 0, sizeof(which_normals));
 
 		for (int v = 0; v < md->verts_per_frame; v++)
 		{
 			raw_md2_vertex_t *raw_V  = raw_verts + v;
-			md2_vertex_c     *good_V = md->frames[i].vertices + v;
+			md_vertex_c     *good_V = md->frames[i].vertices + v;
 
 			good_V->x = (int)raw_V->x * scale[0] + translate[0];
 			good_V->y = (int)raw_V->y * scale[1] + translate[1];
@@ -659,7 +645,7 @@ md2_model_c *MD3_LoadModel(epi::file_c *f)
 
 	/* PARSE TEXCOORD */
 
-	md2_point_c * temp_TEXC = new md2_point_c[num_verts];
+	md_point_c * temp_TEXC = new md_point_c[num_verts];
 
 	f->Seek(mesh_base + EPI_LE_S32(mesh.ofs_texcoords), epi::file_c::SEEKPOINT_START);
 
@@ -699,7 +685,7 @@ md2_model_c *MD3_LoadModel(epi::file_c *f)
 
 		md->tris[i].first = i * 3;
 
-		md2_point_c *point = md->points + i * 3;
+		md_point_c *point = md->points + i * 3;
 
 		point[0] = temp_TEXC[a];
 		point[1] = temp_TEXC[b];
@@ -717,11 +703,11 @@ md2_model_c *MD3_LoadModel(epi::file_c *f)
 
 	for (i = 0; i < num_frames; i++)
 	{
-		md->frames[i].vertices = new md2_vertex_c[num_verts];
+		md->frames[i].vertices = new md_vertex_c[num_verts];
 
 		memset(which_normals, 0, sizeof(which_normals));
 
-		md2_vertex_c *good_V = md->frames[i].vertices;
+		md_vertex_c *good_V = md->frames[i].vertices;
 
 		for (int v = 0; v < num_verts; v++, good_V++)
 		{
@@ -777,73 +763,26 @@ typedef struct model_coord_data_s
 
 	const md2_frame_c *frame1;
 	const md2_frame_c *frame2;
-	const md2_triangle_c *tri;
 
 	float lerp;
-	float x, y, z;
 
 	bool is_weapon;
 	bool is_fuzzy;
 
-	// scaling
-	float xy_scale;
-	float  z_scale;
-	float bias;
-
-	// image size
-	float im_right;
-	float im_top;
-
-	// fuzzy info
-	float  fuzz_mul;
-	vec2_t fuzz_add;
+	md_transform_t xf;
 
-	// mlook vectors
-	vec2_t kx_mat;
-	vec2_t kz_mat;
-
-	// rotation vectors
-	vec2_t rx_mat;
-	vec2_t ry_mat;
+	// texture coordinate scaling (image size, or fuzzy info)
+	vec2_t tex_mul;
+	vec2_t tex_add;
 
 	multi_color_c nm_colors[MD_NUM_NORMALS];
 
 	short * used_normals;
 
-	bool is_additive;
-
-public:
-	void CalcPos(vec3_t *pos, float x1, float y1, float z1) const
-	{
-		x1 *= xy_scale;
-		y1 *= xy_scale;
-		z1 *=  z_scale;
-
-		float x2 = x1 * kx_mat.x + z1 * kx_mat.y;
-		float z2 = x1 * kz_mat.x + z1 * kz_mat.y;
-		float y2 = y1;
-
-		pos->x = x + x2 * rx_mat.x + y2 * rx_mat.y;
-		pos->y = y + x2 * ry_mat.x + y2 * ry_mat.y;
-		pos->z = z + z2;
-	}
-
-	void CalcNormal(vec3_t *normal, const md2_vertex_c *vert) const
-	{
-		short n = vert->normal_idx;
-
-		float nx1 = md_normals[n].x;
-		float ny1 = md_normals[n].y;
-		float nz1 = md_normals[n].z;
-
-		float nx2 = nx1 * kx_mat.x + nz1 * kx_mat.y;
-		float nz2 = nx1 * kz_mat.x + nz1 * kz_mat.y;
-		float ny2 = ny1;
+	// rotated normals, only the used ones are valid
+	const vec3_t *normals;
 
-		normal->x = nx2 * rx_mat.x + ny2 * rx_mat.y;
-		normal->y = nx2 * ry_mat.x + ny2 * ry_mat.y;
-		normal->z = nz2;
-	}
+	bool is_additive;
 }
 model_coord_data_t;
 
@@ -872,17 +811,9 @@ static void ShadeNormals(abstract_shader_c *shader,
 
 		if (!skip_calc)
 		{
-			float nx1 = md_normals[n].x;
-			float ny1 = md_normals[n].y;
-			float nz1 = md_normals[n].z;
-
-			float nx2 = nx1 * data->kx_mat.x + nz1 * data->kx_mat.y;
-			float nz2 = nx1 * data->kz_mat.x + nz1 * data->kz_mat.y;
-			float ny2 = ny1;
-
-			nx = nx2 * data->rx_mat.x + ny2 * data->rx_mat.y;
-			ny = nx2 * data->ry_mat.x + ny2 * data->ry_mat.y;
-			nz = nz2;
+			nx = data->normals[n].x;
+			ny = data->normals[n].y;
+			nz = data->normals[n].z;
 		}
 
 		shader->Corner(data->nm_colors + n, nx, ny, nz, data->mo, data->is_weapon);
@@ -934,79 +865,6 @@ static void UpdateMulticols(model_coord_data_t *data)
 	}
 }
 
-static inline float LerpIt(float v1, float v2, float lerp)
-{
-	return v1 * (1.0f - lerp) + v2 * lerp;
-}
-
-
-static inline void ModelCoordFunc(model_coord_data_t *data,
-					 int v_idx, vec3_t *pos,
-					 float *rgb, vec2_t *texc, vec3_t *normal)
-{
-	const md2_model_c *md = data->model;
-
-	const md2_frame_c *frame1 = data->frame1;
-	const md2_frame_c *frame2 = data->frame2;
-	const md2_triangle_c *tri  = data->tri;
-
-	SYS_ASSERT(tri->first + v_idx >= 0);
-	SYS_ASSERT(tri->first + v_idx < md->num_points);
-
-	const md2_point_c *point = &md->points[tri->first + v_idx];
-
-	const md2_vertex_c *vert1 = &frame1->vertices[point->vert_idx];
-	const md2_vertex_c *vert2 = &frame2->vertices[point->vert_idx];
-
-	
-	float x1 = LerpIt(vert1->x, vert2->x, data->lerp);
-	float y1 = LerpIt(vert1->y, vert2->y, data->lerp);
-	float z1 = LerpIt(vert1->z, vert2->z, data->lerp) + data->bias;
-
-	if (MIR_Reflective())
-		y1 = -y1;
-
-	data->CalcPos(pos, x1, y1, z1);
-
-
-	const md2_vertex_c *n_vert = (data->lerp < 0.5) ? vert1 : vert2;
-
-	data->CalcNormal(normal, n_vert);
-
-
-	if (data->is_fuzzy)
-	{
-		texc->x = point->skin_s * data->fuzz_mul + data->fuzz_add.x;
-		texc->y = point->skin_t * data->fuzz_mul + data->fuzz_add.y;
-
-		rgb[0] = rgb[1] = rgb[2] = 0;
-		return;
-	}
-
-	texc->Set(point->skin_s * data->im_right, point->skin_t * data->im_top);
-
-
-	multi_color_c *col = &data->nm_colors[n_vert->normal_idx];
-
-	if (! data->is_additive)
-	{
-		rgb[0] = col->mod_R / 255.0;
-		rgb[1] = col->mod_G / 255.0;
-		rgb[2] = col->mod_B / 255.0;
-	}
-	else
-	{
-		rgb[0] = col->add_R / 255.0;
-		rgb[1] = col->add_G / 255.0;
-		rgb[2] = col->add_B / 255.0;
-	}
-
-	rgb[0] *= ren_red_mul;
-	rgb[1] *= ren_grn_mul;
-	rgb[2] *= ren_blu_mul;
-}
-
-
 void MD2_RenderModel(md2_model_c *md, const image_c *skin_img, bool is_weapon,
 		             int frame1, int frame2, float lerp,
 		             float x, float y, float z, mobj_t *mo,
@@ -1065,29 +923,33 @@ I_Debugf("Render model: bad frame %d\n", frame1);
 
 	data.lerp = lerp;
 
-	data.x = x;
-	data.y = y;
-	data.z = z;
+	data.xf.x = x;
+	data.xf.y = y;
+	data.xf.z = z;
 
 	data.is_weapon = is_weapon;
 
-	data.xy_scale = scale * aspect * MIR_XYScale();
-	data. z_scale = scale * MIR_ZScale();
-	data.bias = bias;
+	data.xf.xy_scale = scale * aspect * MIR_XYScale();
+	data.xf. z_scale = scale * MIR_ZScale();
+	data.xf.bias = bias;
+
+	data.xf.mirror = MIR_Reflective();
 
 	bool tilt = is_weapon || (mo->flags & MF_MISSILE) || (mo->hyperflags & HF_TILT);
 
-	M_Angle2Matrix(tilt ? ~mo->vertangle : 0, &data.kx_mat, &data.kz_mat);
+	M_Angle2Matrix(tilt ? ~mo->vertangle : 0, &data.xf.kx_mat, &data.xf.kz_mat);
 
 	angle_t ang = mo->angle + rotation;
 
 	MIR_Angle(ang);
 
-	M_Angle2Matrix(~ ang, &data.rx_mat, &data.ry_mat);
+	M_Angle2Matrix(~ ang, &data.xf.rx_mat, &data.xf.ry_mat);
 
 
 	data.used_normals = (lerp < 0.5) ? data.frame1->used_normals : data.frame2->used_normals;
 
+	data.normals = MD_RotateNormals(&data.xf, data.used_normals);
+
 	InitNormalColors(&data);
 
 
@@ -1097,20 +959,19 @@ I_Debugf("Render model: bad frame %d\n", frame1);
 	{
 		skin_tex = W_ImageCache(fuzz_image, false);
 
-		data.fuzz_mul = 0.8;
-		data.fuzz_add.Set(0, 0);
-
-		data.im_right = 1.0;
-		data.im_top   = 1.0;
+		float fuzz_mul = 0.8;
 
 		if (! data.is_weapon && ! viewiszoomed)
 		{
 			float dist = P_ApproxDistance(mo->x - viewx, mo->y - viewy, mo->z - viewz);
 
-			data.fuzz_mul = 70.0 / CLAMP(35, dist, 700);
+			fuzz_mul = 70.0 / CLAMP(35, dist, 700);
 		}
 
-		FUZZ_Adjust(&data.fuzz_add, mo);
+		data.tex_mul.Set(fuzz_mul, fuzz_mul);
+		data.tex_add.Set(0, 0);
+
+		FUZZ_Adjust(&data.tex_add, mo);
 
 		trans = 1.0f;
 
@@ -1123,8 +984,8 @@ I_Debugf("Render model: bad frame %d\n", frame1);
 			ren_fx_colmap ? ren_fx_colmap :
 			is_weapon ? NULL : mo->info->palremap);
 
-		data.im_right = IM_RIGHT(skin_img);
-		data.im_top   = IM_TOP(skin_img);
+		data.tex_mul.Set(IM_RIGHT(skin_img), IM_TOP(skin_img));
+		data.tex_add.Set(0, 0);
 
 
 		abstract_shader_c *shader = R_GetColormapShader(props, mo->state->bright, mo->subsector->sector);
@@ -1176,14 +1037,14 @@ I_Debugf("Render model: bad frame %d\n", frame1);
 		fc[2] = (float)RGB_BLU(fc_to_use)/255.0f;
 		fc[3] = 1.0f;
 		glClearColor(fc[0], fc[1], fc[2], 1.0f);
-		glFogi(GL_FOG_MODE, GL_EXP);
-		glFogfv(GL_FOG_COLOR, fc);
-		glFogf(GL_FOG_DENSITY, std::log1p(fd_to_use));
-		glEnable(GL_FOG);
+		RGL_Fogi(GL_FOG_MODE, GL_EXP);
+		RGL_Fogfv(GL_FOG_COLOR, fc);
+		RGL_Fogf(GL_FOG_DENSITY, std::log1p(fd_to_use));
+		RGL_Enable(GL_FOG);
 	}
 	else if (r_culling.d)
 	{
-		GLfloat fogColor[3];
+		GLfloat fogColor[4] = { 0, 0, 0, 1.0f };
 		if (need_to_draw_sky)
 		{
 			switch (r_cullfog.d)
@@ -1223,14 +1084,19 @@ I_Debugf("Render model: bad frame %d\n", frame1);
 			fogColor[2] = 0;
 		}
 		glClearColor(fogColor[0],fogColor[1],fogColor[2],1.0f);
-		glFogi(GL_FOG_MODE, GL_LINEAR);
-		glFogfv(GL_FOG_COLOR, fogColor);
-		glFogf(GL_FOG_START, r_farclip.f - 750.0f);
-		glFogf(GL_FOG_END, r_farclip.f - 250.0f);
-		glEnable(GL_FOG);
+		RGL_Fogi(GL_FOG_MODE, GL_LINEAR);
+		RGL_Fogfv(GL_FOG_COLOR, fogColor);
+		RGL_Fogf(GL_FOG_START, r_farclip.f - 750.0f);
+		RGL_Fogf(GL_FOG_END, r_farclip.f - 250.0f);
+		RGL_Enable(GL_FOG);
 	}
 	else
-		glDisable(GL_FOG);
+		RGL_Disable(GL_FOG);
+
+	MD_LerpFrames(&data.xf, data.frame1->vertices, data.frame2->vertices,
+				  md->verts_per_frame, lerp);
+
+	bool emitted = false;
 
 	for (int pass = 0; pass < num_pass; pass++)
 	{
@@ -1238,7 +1104,7 @@ I_Debugf("Render model: bad frame %d\n", frame1);
 		{
 			blending &= ~BL_Alpha;
 			blending |=  BL_Add;
-			glDisable(GL_FOG);
+			RGL_Disable(GL_FOG);
 		}
 
 		data.is_additive = (pass > 0 && pass == num_pass-1);
@@ -1255,78 +1121,78 @@ I_Debugf("Render model: bad frame %d\n", frame1);
 				continue;
 		}
 
-		glPolygonOffset(0, -pass);
+		RGL_PolygonOffset(0, -pass);
 
 		if (blending & (BL_Masked | BL_Less))
 		{
 			if (blending & BL_Less)
 			{
-				glEnable(GL_ALPHA_TEST);
+				RGL_Enable(GL_ALPHA_TEST);
 			}
 			else if (blending & BL_Masked)
 			{
-				glEnable(GL_ALPHA_TEST);
-				glAlphaFunc(GL_GREATER, 0);
+				RGL_Enable(GL_ALPHA_TEST);
+				RGL_AlphaFunc(GL_GREATER, 0);
 			}
 			else
-				glDisable(GL_ALPHA_TEST);
+				RGL_Disable(GL_ALPHA_TEST);
 		}
 
 		if (blending & (BL_Alpha | BL_Add))
 		{
 			if (blending & BL_Add)
 			{
-				glEnable(GL_BLEND);
-				glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+				RGL_Enable(GL_BLEND);
+				RGL_BlendFunc(GL_SRC_ALPHA, GL_ONE);
 			}
 			else if (blending & BL_Alpha)
 			{
-				glEnable(GL_BLEND);
-				glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+				RGL_Enable(GL_BLEND);
+				RGL_BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 			}
 			else
-				glDisable(GL_BLEND);
+				RGL_Disable(GL_BLEND);
 		}
 
 		if (blending & BL_CULL_BOTH)
 		{
 			if (blending & BL_CULL_BOTH)
 			{
-				glEnable(GL_CULL_FACE);
-				glCullFace((blending & BL_CullFront) ? GL_FRONT : GL_BACK);
+				RGL_Enable(GL_CULL_FACE);
+				RGL_CullFace((blending & BL_CullFront) ? GL_FRONT : GL_BACK);
 			}
 			else
-				glDisable(GL_CULL_FACE);
+				RGL_Disable(GL_CULL_FACE);
 		}
 
 		if (blending & BL_NoZBuf)
 		{
-			glDepthMask((blending & BL_NoZBuf) ? GL_FALSE : GL_TRUE);
+			RGL_DepthMask((blending & BL_NoZBuf) ? GL_FALSE : GL_TRUE);
 		}
 
 		if (blending & BL_Less)
 		{
 			// NOTE: assumes alpha is constant over whole model
-			glAlphaFunc(GL_GREATER, trans * 0.66f);
+			RGL_AlphaFunc(GL_GREATER, trans * 0.66f);
 		}
 
-		glActiveTexture(GL_TEXTURE1);
-		glDisable(GL_TEXTURE_2D);
-		glActiveTexture(GL_TEXTURE0);
-		glEnable(GL_TEXTURE_2D);
-		glBindTexture(GL_TEXTURE_2D, skin_tex);
+		RGL_ActiveTexture(GL_TEXTURE1);
+		RGL_Disable(GL_TEXTURE_2D);
+		RGL_ActiveTexture(GL_TEXTURE0);
+		RGL_Enable(GL_TEXTURE_2D);
+		RGL_BindTexture(GL_TEXTURE_2D, skin_tex);
 
 		if (data.is_additive)
 		{
-			glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
-			glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_REPLACE);
-			glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_PREVIOUS);
+			RGL_TexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
+			RGL_TexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_REPLACE);
+			RGL_TexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_PREVIOUS);
 		}
 		else
 		{
-			glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-			glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
-			glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE);
+			RGL_TexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+			RGL_TexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
+			RGL_TexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE);
 		}
 
 		GLint old_clamp = 789;
@@ -1339,22 +1205,17 @@ I_Debugf("Render model: bad frame %d\n", frame1);
 				r_dumbclamp.d ? GL_CLAMP : GL_CLAMP_TO_EDGE);
 		}
 
-		local_gl_vert_t *start = md->gl_verts;
-
-		for (int i = 0; i < md->num_tris; i++)
-		{
-			data.tri = & md->tris[i];
-
-			for (int v_idx=0; v_idx < 3; v_idx++)
-			{
-				local_gl_vert_t *dest = start + (i*3) + v_idx;
+		MD_ColorNormals(data.used_normals, data.is_fuzzy ? NULL : data.nm_colors,
+						data.is_additive);
 
-				ModelCoordFunc(&data, v_idx, &dest->pos, dest->rgba,
-						&dest->texc[0], &dest->normal);
+		// positions and texture coords are the same for every pass
+		if (! emitted)
+			MD_EmitVertices(md->gl_verts, md->points, md->num_points,
+							data.tex_mul, data.tex_add, trans);
+		else
+			MD_EmitColors(md->gl_verts, md->points, md->num_points, trans);
 
-				dest->rgba[3] = trans;
-			}
-		}
+		emitted = true;
 
 		// setup client state
 		glBindBuffer(GL_ARRAY_BUFFER, md->vbo);
@@ -1371,23 +1232,26 @@ I_Debugf("Render model: bad frame %d\n", frame1);
 
 		glDrawArrays(GL_TRIANGLES, 0, md->num_tris * 3);
 
+		gl_stats.draw_calls++;
+		gl_stats.vertices += md->num_tris * 3;
+
 		// restore the clamping mode
 		if (old_clamp != 789)
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, old_clamp);
 	}
-	glPolygonOffset(0, 0);
+	RGL_PolygonOffset(0, 0);
 
-	glDisable(GL_TEXTURE_2D);
+	RGL_Disable(GL_TEXTURE_2D);
 
-	glDepthMask(GL_TRUE);
-	glCullFace(GL_BACK);
+	RGL_DepthMask(GL_TRUE);
+	RGL_CullFace(GL_BACK);
 
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glAlphaFunc(GL_GREATER, 0);
+	RGL_BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	RGL_AlphaFunc(GL_GREATER, 0);
 
-	glDisable(GL_ALPHA_TEST);
-	glDisable(GL_BLEND);
-	glDisable(GL_CULL_FACE);
+	RGL_Disable(GL_ALPHA_TEST);
+	RGL_Disable(GL_BLEND);
+	RGL_Disable(GL_CULL_FACE);
 }
 
 
@@ -1407,11 +1271,11 @@ void MD2_RenderModel_2D(md2_model_c *md, const image_c *skin_img, int frame,
 	xscale = yscale * info->model_scale * info->model_aspect;
 	yscale = yscale * info->model_scale;
 
-	glEnable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, skin_tex);
+	RGL_Enable(GL_TEXTURE_2D);
+	RGL_BindTexture(GL_TEXTURE_2D, skin_tex);
  
-	glEnable(GL_BLEND);
-	glEnable(GL_CULL_FACE);
+	RGL_Enable(GL_BLEND);
+	RGL_Enable(GL_CULL_FACE);
 
 	if (info->flags & MF_FUZZY)
 		glColor4f(0, 0, 0, 0.5f);
@@ -1431,8 +1295,8 @@ void MD2_RenderModel_2D(md2_model_c *md, const image_c *skin_img, int frame,
 			SYS_ASSERT(tri->first + v_idx >= 0);
 			SYS_ASSERT(tri->first + v_idx < md->num_points);
 
-			const md2_point_c *point = &md->points[tri->first + v_idx];
-			const md2_vertex_c *vert = &frame_ptr->vertices[point->vert_idx];
+			const md_point_c *point = &md->points[tri->first + v_idx];
+			const md_vertex_c *vert = &frame_ptr->vertices[point->vert_idx];
 
 			glTexCoord2f(point->skin_s * im_right, point->skin_t * im_top);
 		
@@ -1454,9 +1318,9 @@ void MD2_RenderModel_2D(md2_model_c *md, const image_c *skin_img, int frame,
 		glEnd();
 	}
 
-	glDisable(GL_BLEND);
-	glDisable(GL_TEXTURE_2D);
-	glDisable(GL_CULL_FACE);
+	RGL_Disable(GL_BLEND);
+	RGL_Disable(GL_TEXTURE_2D);
+	RGL_Disable(GL_CULL_FACE);
 }
 
 //--- editor settings ---
@@ -0,0 +1,216 @@
+//----------------------------------------------------------------------------
+//  MDL/2/3 Model Batched Drawing
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2002-2023  The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+//
+// The old code worked out every corner of every triangle on its own,
+// once per pass, even though most frame vertices are shared by several
+// triangles.  Here each frame vertex is lerped and transformed exactly
+// once per instance, in plain loops over whole arrays which the
+// compiler is free to vectorise, and the normals and their colours
+// are worked out once per table entry instead of once per corner.
+//
+
+#include "i_defs.h"
+#include "i_defs_gl.h"
+
+#include "r_mdcommon.h"
+#include "r_gldefs.h"
+#include "r_shader.h"
+#include "r_units.h"
+
+#include <vector>
+
+
+// scratch space, valid until the next model is drawn
+static std::vector<float> md_pos_x;
+static std::vector<float> md_pos_y;
+static std::vector<float> md_pos_z;
+
+static std::vector<short> md_normal_idx;
+
+static vec3_t md_rot_normals[MD_NUM_NORMALS];
+
+static float md_colors[MD_NUM_NORMALS][3];
+
+
+void MD_LerpFrames(const md_transform_t *T, const md_vertex_c *verts1,
+				   const md_vertex_c *verts2, int num_verts, float lerp)
+{
+	if ((int)md_pos_x.size() < num_verts)
+	{
+		md_pos_x.resize(num_verts);
+		md_pos_y.resize(num_verts);
+		md_pos_z.resize(num_verts);
+
+		md_normal_idx.resize(num_verts);
+	}
+
+	// fold the scaling, mlook and rotation into a single matrix
+	float sx = T->xy_scale;
+	float sy = T->mirror ? -T->xy_scale : T->xy_scale;
+	float sz = T->z_scale;
+
+	float m00 = sx * T->kx_mat.x * T->rx_mat.x;
+	float m01 = sy * T->rx_mat.y;
+	float m02 = sz * T->kx_mat.y * T->rx_mat.x;
+
+	float m10 = sx * T->kx_mat.x * T->ry_mat.x;
+	float m11 = sy * T->ry_mat.y;
+	float m12 = sz * T->kx_mat.y * T->ry_mat.x;
+
+	float m20 = sx * T->kz_mat.x;
+	float m22 = sz * T->kz_mat.y;
+
+	float *px = md_pos_x.data();
+	float *py = md_pos_y.data();
+	float *pz = md_pos_z.data();
+
+	float lerp1 = 1.0f - lerp;
+
+	for (int i = 0; i < num_verts; i++)
+	{
+		float x1 = verts1[i].x * lerp1 + verts2[i].x * lerp;
+		float y1 = verts1[i].y * lerp1 + verts2[i].y * lerp;
+		float z1 = verts1[i].z * lerp1 + verts2[i].z * lerp + T->bias;
+
+		px[i] = T->x + x1 * m00 + y1 * m01 + z1 * m02;
+		py[i] = T->y + x1 * m10 + y1 * m11 + z1 * m12;
+		pz[i] = T->z + x1 * m20 + z1 * m22;
+	}
+
+	// the normals come from the nearest frame
+	const md_vertex_c *n_verts = (lerp < 0.5) ? verts1 : verts2;
+
+	short *n_idx = md_normal_idx.data();
+
+	for (int i = 0; i < num_verts; i++)
+		n_idx[i] = n_verts[i].normal_idx;
+}
+
+
+const vec3_t *MD_RotateNormals(const md_transform_t *T, const short *used_normals)
+{
+	for (; *used_normals >= 0; used_normals++)
+	{
+		short n = *used_normals;
+
+		float nx1 = md_normals[n].x;
+		float ny1 = md_normals[n].y;
+		float nz1 = md_normals[n].z;
+
+		float nx2 = nx1 * T->kx_mat.x + nz1 * T->kx_mat.y;
+		float nz2 = nx1 * T->kz_mat.x + nz1 * T->kz_mat.y;
+		float ny2 = ny1;
+
+		md_rot_normals[n].x = nx2 * T->rx_mat.x + ny2 * T->rx_mat.y;
+		md_rot_normals[n].y = nx2 * T->ry_mat.x + ny2 * T->ry_mat.y;
+		md_rot_normals[n].z = nz2;
+	}
+
+	return md_rot_normals;
+}
+
+
+void MD_ColorNormals(const short *used_normals, const multi_color_c *colors,
+					 bool additive)
+{
+	float r_mul = ren_red_mul / 255.0f;
+	float g_mul = ren_grn_mul / 255.0f;
+	float b_mul = ren_blu_mul / 255.0f;
+
+	for (; *used_normals >= 0; used_normals++)
+	{
+		short n = *used_normals;
+
+		float *rgb = md_colors[n];
+
+		if (! colors)
+		{
+			rgb[0] = rgb[1] = rgb[2] = 0;
+			continue;
+		}
+
+		const multi_color_c *col = &colors[n];
+
+		if (! additive)
+		{
+			rgb[0] = col->mod_R * r_mul;
+			rgb[1] = col->mod_G * g_mul;
+			rgb[2] = col->mod_B * b_mul;
+		}
+		else
+		{
+			rgb[0] = col->add_R * r_mul;
+			rgb[1] = col->add_G * g_mul;
+			rgb[2] = col->add_B * b_mul;
+		}
+	}
+}
+
+
+void MD_EmitVertices(local_gl_vert_t *dest, const md_point_c *points,
+					 int num_points, const vec2_t& tex_mul, const vec2_t& tex_add,
+					 float alpha)
+{
+	const float *px = md_pos_x.data();
+	const float *py = md_pos_y.data();
+	const float *pz = md_pos_z.data();
+
+	const short *n_idx = md_normal_idx.data();
+
+	for (int i = 0; i < num_points; i++, dest++)
+	{
+		const md_point_c *point = &points[i];
+
+		int v = point->vert_idx;
+		int n = n_idx[v];
+
+		dest->pos.x = px[v];
+		dest->pos.y = py[v];
+		dest->pos.z = pz[v];
+
+		dest->normal = md_rot_normals[n];
+
+		dest->texc[0].x = point->skin_s * tex_mul.x + tex_add.x;
+		dest->texc[0].y = point->skin_t * tex_mul.y + tex_add.y;
+
+		dest->rgba[0] = md_colors[n][0];
+		dest->rgba[1] = md_colors[n][1];
+		dest->rgba[2] = md_colors[n][2];
+		dest->rgba[3] = alpha;
+	}
+}
+
+
+void MD_EmitColors(local_gl_vert_t *dest, const md_point_c *points,
+				   int num_points, float alpha)
+{
+	const short *n_idx = md_normal_idx.data();
+
+	for (int i = 0; i < num_points; i++, dest++)
+	{
+		int n = n_idx[points[i].vert_idx];
+
+		dest->rgba[0] = md_colors[n][0];
+		dest->rgba[1] = md_colors[n][1];
+		dest->rgba[2] = md_colors[n][2];
+		dest->rgba[3] = alpha;
+	}
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
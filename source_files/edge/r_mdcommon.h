@@ -298,6 +298,76 @@ const u8_t md_colormap[256][3] =
 	{255, 243, 147}, {255, 247, 199}, {255, 255, 255}, {159,  91,  83}
 };
 
+
+/* ---- batched drawing ---- */
+
+struct local_gl_vert_s;
+class multi_color_c;
+
+// a vertex of one frame, the same for MD2, MD3 and MDL
+struct md_vertex_c
+{
+	float x, y, z;
+
+	short normal_idx;
+};
+
+// a corner of a triangle.  The points of triangle N are always
+// 3*N to 3*N+2, so there is one GL vertex per point.
+struct md_point_c
+{
+	float skin_s, skin_t;
+
+	// index into frame's vertex array
+	int vert_idx;
+};
+
+// where and how a model instance is placed in the world
+typedef struct
+{
+	float x, y, z;
+
+	// scaling
+	float xy_scale;
+	float  z_scale;
+	float bias;
+
+	// mlook vectors
+	vec2_t kx_mat;
+	vec2_t kz_mat;
+
+	// rotation vectors
+	vec2_t rx_mat;
+	vec2_t ry_mat;
+
+	// flip the model for a mirror
+	bool mirror;
+}
+md_transform_t;
+
+//
+// Drawing a model instance goes like this: MD_LerpFrames() once,
+// MD_RotateNormals() once (its table is also used for lighting),
+// then for each pass MD_ColorNormals() followed by MD_EmitVertices()
+// for the first pass drawn and MD_EmitColors() for the others.
+// The results are kept in scratch buffers until the next model.
+//
+void MD_LerpFrames(const md_transform_t *T, const md_vertex_c *verts1,
+				   const md_vertex_c *verts2, int num_verts, float lerp);
+
+const vec3_t *MD_RotateNormals(const md_transform_t *T, const short *used_normals);
+
+// colors can be NULL, which makes every normal black (fuzzy models)
+void MD_ColorNormals(const short *used_normals, const multi_color_c *colors,
+					 bool additive);
+
+void MD_EmitVertices(struct local_gl_vert_s *dest, const md_point_c *points,
+					 int num_points, const vec2_t& tex_mul, const vec2_t& tex_add,
+					 float alpha);
+
+void MD_EmitColors(struct local_gl_vert_s *dest, const md_point_c *points,
+				   int num_points, float alpha);
+
 #endif /* __R_MD_COMMON_H__ */
 
 //--- editor settings ---
@@ -100,6 +100,11 @@ void R_InitShaderTables();
 void R_Render(int x, int y, int w, int h, mobj_t *camera,
               bool full_height, float expand_w);
 
+// Only walks the BSP for the given view (no GL calls), returning
+// the number of visible subsectors.
+int R_CollectScene(int x, int y, int w, int h, mobj_t *camera,
+                   bool full_height, float expand_w);
+
 // Called by startup code.
 void R_Init(void);
 // Called by shutdown code
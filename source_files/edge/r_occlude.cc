@@ -22,193 +22,185 @@
 
 #include "r_occlude.h"
 
+#include <algorithm>
+#include <vector>
+
 
 // #define DEBUG_OCC  1
 
 
-typedef struct angle_range_s
+typedef struct
 {
 	angle_t low, high;
-
-	struct angle_range_s *next;
-	struct angle_range_s *prev;
 }
 angle_range_t;
 
 
-static angle_range_t *occbuf_head = NULL;
-static angle_range_t *occbuf_tail = NULL;
+// The blocked angles, as a sorted array of disjoint ranges.  This is
+// exact, and is searched with a binary search.
+static std::vector<angle_range_t> occ_ranges;
+
 
-static angle_range_t *free_range_chickens = NULL;
+// A coarse bitmap of the whole circle, one bit per OCC_BIN_BITS of
+// angle, where a set bit means the whole bin is blocked.  It is used
+// to answer most tests with a few word-wide operations, only falling
+// back to the range array for bins that are only partly blocked.
+#define OCC_BIN_SHIFT  16
+#define OCC_NUM_BINS   (1 << (32 - OCC_BIN_SHIFT))
+#define OCC_NUM_WORDS  (OCC_NUM_BINS / 32)
+
+static u32_t occ_bins[OCC_NUM_WORDS];
 
 
 #ifdef DEBUG_OCC
 static void ValidateBuffer(void)
 {
-	if (! occbuf_head)
+	for (size_t i = 0; i < occ_ranges.size(); i++)
 	{
-		SYS_ASSERT(! occbuf_tail);
-		return;
-	}
-
-	for (angle_range_t *AR = occbuf_head; AR; AR = AR->next)
-	{
-		SYS_ASSERT(AR->low <= AR->high);
+		SYS_ASSERT(occ_ranges[i].low <= occ_ranges[i].high);
 
-		if (AR->next)
-		{
-			SYS_ASSERT(AR->next->prev == AR);
-			SYS_ASSERT(AR->next->low > AR->high);
-		}
-		else
-		{
-			SYS_ASSERT(AR == occbuf_tail);
-		}
-
-		if (AR->prev)
-		{
-			SYS_ASSERT(AR->prev->next == AR);
-		}
-		else
-		{
-			SYS_ASSERT(AR == occbuf_head);
-		}
+		if (i > 0)
+			SYS_ASSERT(occ_ranges[i].low > occ_ranges[i-1].high);
 	}
 }
 #endif // DEBUG_OCC
 
 
-void RGL_1DOcclusionClear(void)
+// mask of bits [first, last] within a single word
+static inline u32_t BinMask(int first, int last)
 {
-	// Clear all angles in the whole buffer
-	// )i.e. mark them as open / non-blocking).
+	u32_t hi = (last == 31) ? 0xFFFFFFFF : ((1U << (last + 1)) - 1);
 
-	if (occbuf_head)
-	{
-		occbuf_tail->next = free_range_chickens;
+	return hi & ~((1U << first) - 1);
+}
 
-		free_range_chickens = occbuf_head;
+static void SetBins(int first, int last)
+{
+	int w1 = first >> 5;
+	int w2 = last  >> 5;
 
-		occbuf_head = NULL;
-		occbuf_tail = NULL;
+	if (w1 == w2)
+	{
+		occ_bins[w1] |= BinMask(first & 31, last & 31);
+		return;
 	}
 
-#ifdef DEBUG_OCC
-	ValidateBuffer();
-#endif
+	occ_bins[w1] |= BinMask(first & 31, 31);
+
+	for (int w = w1 + 1; w < w2; w++)
+		occ_bins[w] = 0xFFFFFFFF;
+
+	occ_bins[w2] |= BinMask(0, last & 31);
 }
 
-static inline angle_range_t *GetNewRange(angle_t low, angle_t high)
+static bool TestBins(int first, int last)
 {
-	angle_range_t *R;
+	int w1 = first >> 5;
+	int w2 = last  >> 5;
 
-	if (free_range_chickens)
+	if (w1 == w2)
 	{
-		R = free_range_chickens;
-
-		free_range_chickens = R->next;
+		u32_t mask = BinMask(first & 31, last & 31);
+		return (occ_bins[w1] & mask) == mask;
 	}
-	else
-		R = new angle_range_t;
 
-	R->low  = low;
-	R->high = high;
+	u32_t mask = BinMask(first & 31, 31);
+
+	if ((occ_bins[w1] & mask) != mask)
+		return false;
+
+	for (int w = w1 + 1; w < w2; w++)
+		if (occ_bins[w] != 0xFFFFFFFF)
+			return false;
+
+	mask = BinMask(0, last & 31);
 
-	return R;
+	return (occ_bins[w2] & mask) == mask;
 }
 
-static inline void LinkBefore(angle_range_t *X, angle_range_t *N)
+// mark the bins lying completely inside the range
+static inline void SetFullBins(angle_t low, angle_t high)
 {
-	// X = eXisting range
-	// N = New range
+	int first = (int)(low >> OCC_BIN_SHIFT);
+	int last  = (int)(high >> OCC_BIN_SHIFT);
 
-	N->next = X;
-	N->prev = X->prev;
+	const angle_t bin_mask = (1U << OCC_BIN_SHIFT) - 1;
 
-	X->prev = N;
+	if ((low & bin_mask) != 0)
+		first++;
 
-	if (N->prev)
-		N->prev->next = N;
-	else
-		occbuf_head = N;
+	if ((high & bin_mask) != bin_mask)
+		last--;
+
+	if (first <= last)
+		SetBins(first, last);
 }
 
-static inline void LinkInTail(angle_range_t *N)
-{
-	N->next = NULL;
-	N->prev = occbuf_tail;
 
-	if (occbuf_tail)
-		occbuf_tail->next = N;
-	else
-		occbuf_head = N;
+// occlusion statistics for the current frame
+occlusion_stats_t occ_stats;
 
-	occbuf_tail = N;
-}
 
-static inline void RemoveRange(angle_range_t *R)
+void RGL_1DOcclusionClear(void)
 {
-	if (R->next)
-		R->next->prev = R->prev;
-	else
-		occbuf_tail = R->prev;
+	// Clear all angles in the whole buffer
+	// (i.e. mark them as open / non-blocking).
 
-	if (R->prev)
-		R->prev->next = R->next;
-	else
-		occbuf_head = R->next;
+	occ_ranges.clear();
 
-	// add it to the quick-alloc list
-	R->next = free_range_chickens;
-	R->prev = NULL;
+	memset(occ_bins, 0, sizeof(occ_bins));
+
+	memset(&occ_stats, 0, sizeof(occ_stats));
+}
 
-	free_range_chickens = R;
+// returns the first range which is not completely below `low'
+static inline std::vector<angle_range_t>::iterator FindRange(angle_t low)
+{
+	return std::lower_bound(occ_ranges.begin(), occ_ranges.end(), low,
+		[](const angle_range_t& R, angle_t a) { return R.high < a; });
 }
 
 static void DoSet(angle_t low, angle_t high)
 {
-	for (angle_range_t *AR = occbuf_head; AR; AR = AR->next)
-	{
-		if (high < AR->low)
-		{
-			LinkBefore(AR, GetNewRange(low, high));
-			return;
-		}
+	auto AR = FindRange(low);
 
-		if (low > AR->high)
-			continue;
+	if (AR == occ_ranges.end() || high < AR->low)
+	{
+		angle_range_t N = { low, high };
 
+		AR = occ_ranges.insert(AR, N);
+	}
+	else
+	{
 		// the new range overlaps the old range.
 		//
-		// The above test (i.e. low > AR->high) guarantees that if
-		// we reduce AR->low, it cannot touch the previous range.
-		//
-		// However by increasing AR->high we may touch or overlap
-		// some subsequent ranges in the list.  When that happens,
-		// we must remove them (and adjust the current range).
+		// Since AR is the first range with AR->high >= low, reducing
+		// AR->low cannot touch the previous range.  However increasing
+		// AR->high may overlap some subsequent ranges, and these need
+		// to be merged in.
 
 		AR->low  = MIN(AR->low, low);
 		AR->high = MAX(AR->high, high);
 
-#ifdef DEBUG_OCC
-		if (AR->prev)
+		auto last = AR + 1;
+
+		while (last != occ_ranges.end() && AR->high >= last->low)
 		{
-			SYS_ASSERT(AR->low > AR->prev->high);
+			AR->high = MAX(AR->high, last->high);
+			last++;
 		}
-#endif
-		while (AR->next && AR->high >= AR->next->low)
-		{
-			AR->high = MAX(AR->high, AR->next->high);
 
-			RemoveRange(AR->next);
-		}
+		// AR may be invalidated by the erase, so keep an index
+		size_t idx = AR - occ_ranges.begin();
 
-		return;
-	}
+		occ_ranges.erase(AR + 1, last);
 
-	// the new range is greater than all existing ranges
+		AR = occ_ranges.begin() + idx;
+	}
 
-	LinkInTail(GetNewRange(low, high));
+	// marking the whole merged range means that bins where two
+	// walls meet get filled in too.
+	SetFullBins(AR->low, AR->high);
 }
 
 void RGL_1DOcclusionSet(angle_t low, angle_t high)
@@ -230,16 +222,16 @@ void RGL_1DOcclusionSet(angle_t low, angle_t high)
 
 static inline bool DoTest(angle_t low, angle_t high)
 {
-	for (angle_range_t *AR = occbuf_head; AR; AR = AR->next)
-	{
-		if (AR->low <= low && high <= AR->high)
-			return true;
+	// quick check: all bins touched by the range fully blocked?
+	if (TestBins((int)(low >> OCC_BIN_SHIFT), (int)(high >> OCC_BIN_SHIFT)))
+		return true;
 
-		if (AR->high > low)
-			break;
-	}
+	auto AR = FindRange(low);
+
+	if (AR == occ_ranges.end())
+		return false;
 
-	return false;
+	return (AR->low <= low && high <= AR->high);
 }
 
 bool RGL_1DOcclusionTest(angle_t low, angle_t high)
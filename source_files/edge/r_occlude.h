@@ -19,6 +19,18 @@
 #ifndef __RGL_OCCLUDE_H__
 #define __RGL_OCCLUDE_H__
 
+// per-frame statistics, reset by RGL_1DOcclusionClear()
+typedef struct
+{
+	int nodes_checked;
+	int nodes_culled;   // BSP subtrees skipped by RGL_CheckBBox
+	int subs_visited;
+	int segs_culled;    // segs hidden behind the occlusion buffer
+}
+occlusion_stats_t;
+
+extern occlusion_stats_t occ_stats;
+
 void RGL_1DOcclusionClear(void);
 void RGL_1DOcclusionSet(angle_t low, angle_t high);
 bool RGL_1DOcclusionTest(angle_t low, angle_t high);
@@ -27,7 +27,8 @@
 #include "i_defs_gl.h"
 
 #include <math.h>
-#include <unordered_set>
+#include <algorithm>
+#include <vector>
 
 #include "dm_data.h"
 #include "dm_defs.h"
@@ -39,6 +40,7 @@
 #include "r_misc.h"
 #include "r_modes.h"
 #include "r_gldefs.h"
+#include "r_glstate.h"
 #include "r_colormap.h"
 #include "r_effects.h"
 #include "r_image.h"
@@ -82,7 +84,7 @@ unsigned int root_node;
 int detail_level = 1;
 int use_dlights = 0;
 
-std::unordered_set<abstract_shader_c *> seen_dlights;
+int seen_dlight_count = 0;
 
 int swirl_pass = 0;
 bool thick_liquid = false;
@@ -380,12 +382,12 @@ static bool MIR_SegOnPortal(seg_t *seg)
 
 static void MIR_SetClippers()
 {
-	glDisable(GL_CLIP_PLANE0);
-	glDisable(GL_CLIP_PLANE1);
-	glDisable(GL_CLIP_PLANE2);
-	glDisable(GL_CLIP_PLANE3);
-	glDisable(GL_CLIP_PLANE4);
-	glDisable(GL_CLIP_PLANE5);
+	RGL_Disable(GL_CLIP_PLANE0);
+	RGL_Disable(GL_CLIP_PLANE1);
+	RGL_Disable(GL_CLIP_PLANE2);
+	RGL_Disable(GL_CLIP_PLANE3);
+	RGL_Disable(GL_CLIP_PLANE4);
+	RGL_Disable(GL_CLIP_PLANE5);
 
 	if (num_active_mirrors == 0)
 		return;
@@ -402,8 +404,8 @@ static void MIR_SetClippers()
 	ClipPlaneEyeAngle(left_p,  inner.def->left);
 	ClipPlaneEyeAngle(right_p, inner.def->right + ANG180);
 
-  	glEnable(GL_CLIP_PLANE0);
-   	glEnable(GL_CLIP_PLANE1);
+  	RGL_Enable(GL_CLIP_PLANE0);
+   	RGL_Enable(GL_CLIP_PLANE1);
 
 	glClipPlane(GL_CLIP_PLANE0, left_p);
   	glClipPlane(GL_CLIP_PLANE1, right_p);
@@ -436,7 +438,7 @@ static void MIR_SetClippers()
 
 		ClipPlaneHorizontalLine(front_p, v2, v1);
 
-		glEnable(GL_CLIP_PLANE2 + i);
+		RGL_Enable(GL_CLIP_PLANE2 + i);
 
 		glClipPlane(GL_CLIP_PLANE2 + i, front_p);
 	}
@@ -692,10 +694,32 @@ typedef struct
 	vec3_t normal;
 
 	bool mid_masked;
+
+	// texture coords from the wall geometry cache, or NULL
+	const vec2_t *texc;
 }
 wall_coord_data_t;
 
 
+static inline void WallTexCoord(const wall_coord_data_t *data,
+		const vec3_t *pos, vec2_t *texc)
+{
+	float along;
+
+	if (fabs(data->div.dx) > fabs(data->div.dy))
+	{
+		along = (pos->x - data->div.x) / data->div.dx;
+	}
+	else
+	{
+		along = (pos->y - data->div.y) / data->div.dy;
+	}
+
+	texc->x = data->tx0 + along  * data->tx_mul;
+	texc->y = data->ty0 + pos->z * data->ty_mul;
+}
+
+
 static void WallCoordFunc(void *d, int v_idx,
 		vec3_t *pos, float *rgb, vec2_t *texc,
 		vec3_t *normal, vec3_t *lit_pos)
@@ -718,19 +742,10 @@ static void WallCoordFunc(void *d, int v_idx,
 		rgb[2] = data->B;		
 	}
 
-	float along;
-
-	if (fabs(data->div.dx) > fabs(data->div.dy))
-	{
-		along = (pos->x - data->div.x) / data->div.dx;
-	}
+	if (data->texc)
+		*texc = data->texc[v_idx];
 	else
-	{
-		along = (pos->y - data->div.y) / data->div.dy;
-	}
-
-	texc->x = data->tx0 + along  * data->tx_mul;
-	texc->y = data->ty0 + pos->z * data->ty_mul;
+		WallTexCoord(data, pos, texc);
 
 	if (swirl_pass > 0)
 		CalcTurbulentTexCoords(texc, pos);
@@ -960,6 +975,339 @@ typedef enum
 wall_tile_flag_e;
 
 
+//
+// Makes the corners of a wall part, from bottom left going clockwise.
+// Returns the number of vertices (at most MAX_EDGE_VERT * 2).
+//
+static int BuildWallVertices(vec3_t *vertices,
+		float x1, float y1, float lz1, float lz2,
+		float x2, float y2, float rz1, float rz2, bool greet)
+{
+	// -AJA- 2007/08/07: ugly code here ensures polygon edges
+	//       match up with adjacent linedefs (otherwise small
+	//       gaps can appear which look bad).
+
+	float  left_h[MAX_EDGE_VERT]; int  left_num=2;
+	float right_h[MAX_EDGE_VERT]; int right_num=2;
+
+	left_h[0]  = lz1; left_h[1]  = lz2;
+	right_h[0] = rz1; right_h[1] = rz2;
+
+	if (greet)
+	{
+		GreetNeighbourSector(left_h,  left_num,  cur_seg->nb_sec[0]);
+		GreetNeighbourSector(right_h, right_num, cur_seg->nb_sec[1]);
+
+#if DEBUG_GREET_NEIGHBOUR
+		SYS_ASSERT(left_num  <= MAX_EDGE_VERT);
+		SYS_ASSERT(right_num <= MAX_EDGE_VERT);
+
+		for (int k = 0; k < MAX_EDGE_VERT; k++)
+		{
+			if (k+1 < left_num)
+			{
+				SYS_ASSERT(left_h[k]  <= left_h[k+1]);
+			}
+			if (k+1 < right_num)
+			{
+				SYS_ASSERT(right_h[k] <= right_h[k+1]);
+			}
+		}
+#endif
+	}
+
+	int v_count = 0;
+
+	for (int LI = 0; LI < left_num; LI++)
+	{
+		vertices[v_count].x = x1;
+		vertices[v_count].y = y1;
+		vertices[v_count].z = left_h[LI];
+
+		MIR_Height(vertices[v_count].z);
+
+		v_count++;
+	}
+
+	for (int RI = right_num-1; RI >= 0; RI--)
+	{
+		vertices[v_count].x = x2;
+		vertices[v_count].y = y2;
+		vertices[v_count].z = right_h[RI];
+
+		MIR_Height(vertices[v_count].z);
+
+		v_count++;
+	}
+
+	return v_count;
+}
+
+
+//
+// Wall geometry cache
+//
+// The corners of a wall part and their texture coordinates only change
+// when a sector moves, a sidedef is scrolled or scaled, or a texture is
+// changed, so they are kept for each seg in a level buffer.  The code
+// making such changes calls RGL_InvalidateSectorWalls() or
+// RGL_InvalidateLineWalls(), which drop the parts depending on it.
+// Lighting is still done by the colormap shaders when drawing.
+//
+
+typedef struct
+{
+	// which part of the seg this is: its drawfloor and its place in the
+	// ComputeWallTiles() order (negative for flood planes)
+	const extrafloor_t *ef;
+	int tile;
+
+	// what it was made for, a mismatch means it must be remade
+	const surface_t *surf;
+	const image_c *image;
+	bool greet;
+
+	// range in wall_geom_verts and wall_geom_texcs
+	int first, v_count, room;
+
+	// flood planes only: how the area is divided
+	short piece_row, piece_col;
+}
+wall_geom_part_t;
+
+static std::vector<std::vector<wall_geom_part_t>> wall_geoms;
+
+static std::vector<vec3_t> wall_geom_verts;
+static std::vector<vec2_t> wall_geom_texcs;
+
+// room taken by parts which were dropped or outgrown
+static int wall_geom_dead;
+
+// segs to drop when a sector changes (indexed by sector number),
+// or when a line changes (indexed by numsectors + line number)
+static std::vector<int> wall_dep_first;
+static std::vector<int> wall_deps;
+
+// place of the current tile in the ComputeWallTiles() order
+static int cur_wall_tile;
+
+static void BuildWallGeometry(void)
+{
+	wall_geoms.clear();
+	wall_geoms.resize(numsegs);
+
+	wall_geom_verts.clear();
+	wall_geom_texcs.clear();
+	wall_geom_dead = 0;
+
+	// the walls on each side of a sector
+	std::vector<std::vector<int>> sec_walls(numsectors);
+
+	for (int i = 0; i < numsegs; i++)
+	{
+		const seg_t *seg = &segs[i];
+
+		if (seg->miniseg || ! seg->linedef)
+			continue;
+
+		sec_walls[seg->frontsector - sectors].push_back(i);
+
+		if (seg->backsector && seg->backsector != seg->frontsector)
+			sec_walls[seg->backsector - sectors].push_back(i);
+	}
+
+	std::vector<std::pair<int, int>> deps;
+
+	for (int i = 0; i < numsegs; i++)
+	{
+		const seg_t *seg = &segs[i];
+
+		if (seg->miniseg || ! seg->linedef)
+			continue;
+
+		deps.push_back({ numsectors + (int)(seg->linedef - lines), i });
+
+		// heights of the sectors at either end (GreetNeighbourSector)
+		for (int v = 0; v < 2; v++)
+		{
+			const vertex_seclist_t *seclist = seg->nb_sec[v];
+
+			if (! seclist)
+				continue;
+
+			for (int k = 0; k < seclist->num; k++)
+				deps.push_back({ seclist->sec[k], i });
+		}
+	}
+
+	for (int n = 0; n < numsectors; n++)
+	{
+		const sector_t *sec = &sectors[n];
+
+		for (int i : sec_walls[n])
+			deps.push_back({ n, i });
+
+		// Boom deep water clips to the heights of its control sector
+		if (sec->heightsec)
+		{
+			for (int i : sec_walls[n])
+				deps.push_back({ (int)(sec->heightsec - sectors), i });
+		}
+
+		// extrafloors take their heights from this sector, and the
+		// texture of their sides from the control line
+		for (const extrafloor_t *ef = sec->control_floors; ef; ef = ef->ctrl_next)
+		{
+			for (int i : sec_walls[ef->sector - sectors])
+			{
+				deps.push_back({ n, i });
+
+				if (ef->ef_line)
+					deps.push_back({ numsectors + (int)(ef->ef_line - lines), i });
+			}
+		}
+	}
+
+	std::sort(deps.begin(), deps.end());
+	deps.erase(std::unique(deps.begin(), deps.end()), deps.end());
+
+	wall_dep_first.assign(numsectors + numlines + 1, 0);
+	wall_deps.resize(deps.size());
+
+	for (size_t k = 0; k < deps.size(); k++)
+	{
+		wall_dep_first[deps[k].first + 1]++;
+		wall_deps[k] = deps[k].second;
+	}
+
+	for (int k = 0; k < numsectors + numlines; k++)
+		wall_dep_first[k + 1] += wall_dep_first[k];
+}
+
+static void DropWallGeometry(int seg_idx)
+{
+	std::vector<wall_geom_part_t>& parts = wall_geoms[seg_idx];
+
+	for (const wall_geom_part_t& part : parts)
+		wall_geom_dead += part.room;
+
+	parts.clear();
+}
+
+static void DropWallDeps(int key)
+{
+	if (wall_dep_first.empty())
+		return;
+
+	for (int k = wall_dep_first[key]; k < wall_dep_first[key + 1]; k++)
+		DropWallGeometry(wall_deps[k]);
+}
+
+//
+// RGL_InvalidateSectorWalls
+//
+// Must be called when the heights of a sector change.
+//
+void RGL_InvalidateSectorWalls(const sector_t *sec)
+{
+	DropWallDeps((int)(sec - sectors));
+}
+
+//
+// RGL_InvalidateLineWalls
+//
+// Must be called when the textures, offsets or scaling of either
+// side of a line change.
+//
+void RGL_InvalidateLineWalls(const line_t *ld)
+{
+	DropWallDeps(numsectors + (int)(ld - lines));
+}
+
+//
+// Finds the cached part for a tile of cur_seg.  When it is
+// not cached (v_count is zero), it must be filled in by the caller.
+//
+static wall_geom_part_t * GetWallGeometry(const drawfloor_t *dfloor, int tile,
+		const surface_t *surf, const image_c *image, bool greet)
+{
+	if ((int)wall_geoms.size() != numsegs)
+		BuildWallGeometry();
+
+	// get back the room of dropped parts, once there is a lot of it
+	if (wall_geom_dead > 65536 && wall_geom_dead * 2 > (int)wall_geom_verts.size())
+	{
+		for (int i = 0; i < numsegs; i++)
+			wall_geoms[i].clear();
+
+		wall_geom_verts.clear();
+		wall_geom_texcs.clear();
+		wall_geom_dead = 0;
+	}
+
+	std::vector<wall_geom_part_t>& parts = wall_geoms[cur_seg - segs];
+
+	for (wall_geom_part_t& part : parts)
+	{
+		if (part.ef != dfloor->ef || part.tile != tile)
+			continue;
+
+		// a different tile now (e.g. a fog wall came or went)
+		if (part.surf != surf || part.image != image || part.greet != greet)
+		{
+			part.surf  = surf;
+			part.image = image;
+			part.greet = greet;
+			part.v_count = 0;
+		}
+
+		return &part;
+	}
+
+	wall_geom_part_t part;
+
+	part.ef    = dfloor->ef;
+	part.tile  = tile;
+	part.surf  = surf;
+	part.image = image;
+	part.greet = greet;
+	part.first = part.v_count = part.room = 0;
+	part.piece_row = part.piece_col = 0;
+
+	parts.push_back(part);
+
+	return &parts.back();
+}
+
+static void ReserveWallGeometry(wall_geom_part_t *geom, int v_count)
+{
+	if (v_count > geom->room)
+	{
+		wall_geom_dead += geom->room;
+
+		geom->first = (int)wall_geom_verts.size();
+		geom->room  = v_count;
+
+		wall_geom_verts.resize(geom->first + v_count);
+		wall_geom_texcs.resize(geom->first + v_count);
+	}
+
+	geom->v_count = v_count;
+}
+
+static void StoreWallGeometry(wall_geom_part_t *geom, const wall_coord_data_t *data)
+{
+	ReserveWallGeometry(geom, data->v_count);
+
+	for (int i = 0; i < data->v_count; i++)
+	{
+		wall_geom_verts[geom->first + i] = data->vert[i];
+
+		WallTexCoord(data, &data->vert[i], &wall_geom_texcs[geom->first + i]);
+	}
+}
+
+
 static void DrawWallPart(drawfloor_t *dfloor,
 		                 float x1, float y1, float lz1, float lz2,
 						 float x2, float y2, float rz1, float rz2,
@@ -967,7 +1315,8 @@ static void DrawWallPart(drawfloor_t *dfloor,
 						 const image_c *image,
 						 bool mid_masked, bool opaque,
    						 float tex_x1, float tex_x2,
-						 region_properties_t *props = NULL)
+						 region_properties_t *props = NULL,
+						 bool cache_geom = false)
 {
 	// Note: tex_x1 and tex_x2 are in world coordinates.
 	//       top, bottom and tex_top_h as well.
@@ -993,6 +1342,13 @@ static void DrawWallPart(drawfloor_t *dfloor,
 	if ((trans < 0.99f || image->opacity >= OPAC_Masked) == solid_mode)
 		return;
 
+	// swirling changes the texture coords, and mirrors the corners
+	if (num_active_mirrors > 0 || (surf->image &&
+		surf->image->liquid_type > LIQ_None && swirling_flats > SWIRL_SMMU))
+	{
+		cache_geom = false;
+	}
+
 
 	// must determine bbox _before_ mirror flipping
 	float v_bbox[4];
@@ -1049,64 +1405,23 @@ static void DrawWallPart(drawfloor_t *dfloor,
 #endif
 
 
-	// -AJA- 2007/08/07: ugly code here ensures polygon edges
-	//       match up with adjacent linedefs (otherwise small
-	//       gaps can appear which look bad).
+	bool greet = solid_mode && !mid_masked;
 
-	float  left_h[MAX_EDGE_VERT]; int  left_num=2;
-	float right_h[MAX_EDGE_VERT]; int right_num=2;
+	// the corners are in the cache, unless it changed
+	wall_geom_part_t *geom = NULL;
 
-	left_h[0]  = lz1; left_h[1]  = lz2;
-	right_h[0] = rz1; right_h[1] = rz2;
-
-	if (solid_mode && !mid_masked)
-	{
-		GreetNeighbourSector(left_h,  left_num,  cur_seg->nb_sec[0]);
-		GreetNeighbourSector(right_h, right_num, cur_seg->nb_sec[1]);
-
-#if DEBUG_GREET_NEIGHBOUR
-		SYS_ASSERT(left_num  <= MAX_EDGE_VERT);
-		SYS_ASSERT(right_num <= MAX_EDGE_VERT);
-
-		for (int k = 0; k < MAX_EDGE_VERT; k++)
-		{
-			if (k+1 < left_num)
-			{
-				SYS_ASSERT(left_h[k]  <= left_h[k+1]);
-			}
-			if (k+1 < right_num)
-			{
-				SYS_ASSERT(right_h[k] <= right_h[k+1]);
-			}
-		}
-#endif
-	}
+	if (cache_geom)
+		geom = GetWallGeometry(dfloor, cur_wall_tile, surf, image, greet);
 
 	vec3_t vertices[MAX_EDGE_VERT * 2];
 
-	int v_count = 0;
-
-	for (int LI = 0; LI < left_num; LI++)
-	{
-		vertices[v_count].x = x1;
-		vertices[v_count].y = y1;
-		vertices[v_count].z = left_h[LI];
-
-		MIR_Height(vertices[v_count].z);
-
-		v_count++;
-	}
-
-	for (int RI = right_num-1; RI >= 0; RI--)
-	{
-		vertices[v_count].x = x2;
-		vertices[v_count].y = y2;
-		vertices[v_count].z = right_h[RI];
-
-		MIR_Height(vertices[v_count].z);
+	int v_count;
 
-		v_count++;
-	}
+	if (geom && geom->v_count > 0)
+		v_count = geom->v_count;
+	else
+		v_count = BuildWallVertices(vertices, x1, y1, lz1, lz2,
+									x2, y2, rz1, rz2, greet);
 
 
 	int blending;
@@ -1129,6 +1444,7 @@ static void DrawWallPart(drawfloor_t *dfloor,
 
 	data.v_count = v_count;
 	data.vert = vertices;
+	data.texc = NULL;
 
 	data.R = data.G = data.B = 1.0f;
 
@@ -1151,6 +1467,15 @@ static void DrawWallPart(drawfloor_t *dfloor,
 	data.trans = trans;
 	data.mid_masked = mid_masked;
 
+	if (geom)
+	{
+		if (geom->v_count == 0)
+			StoreWallGeometry(geom, &data);
+
+		data.vert = &wall_geom_verts[geom->first];
+		data.texc = &wall_geom_texcs[geom->first];
+	}
+
 	if (surf->image && surf->image->liquid_type == LIQ_Thick)
 		thick_liquid = true;
 	else
@@ -1375,6 +1700,8 @@ static void DrawTile(seg_t *seg, drawfloor_t *dfloor,
 {
 	// tex_z = texturing top, in world coordinates
 
+	cur_wall_tile++;
+
 	const image_c *image = surf->image;
 
 	if (! image)
@@ -1440,12 +1767,18 @@ static void DrawTile(seg_t *seg, drawfloor_t *dfloor,
 		rz2 += seg->sidedef->sector->props.special->ceiling_bob;
 	}
 
+	// the sector surfaces (used for vertex slopes) can scroll
+	bool cache_geom = (flags & WTILF_IsExtra) ||
+		surf == &seg->sidedef->top    ||
+		surf == &seg->sidedef->middle ||
+		surf == &seg->sidedef->bottom;
+
 	DrawWallPart(dfloor,
 		x1,y1, lz1,lz2,
 		x2,y2, rz1,rz2, tex_top_h,
 		surf, image, (flags & WTILF_MidMask) ? true : false, 
 		opaque, tex_x1, tex_x2, (flags & WTILF_MidMask) ?
-		&seg->sidedef->sector->props : NULL);
+		&seg->sidedef->sector->props : NULL, cache_geom);
 }
 
 
@@ -1808,7 +2141,10 @@ static void ComputeWallTiles(seg_t *seg, drawfloor_t *dfloor, int sidenum, float
 typedef struct
 {
 	int v_count;
-	vec3_t vert[2 * (MAX_FLOOD_VERT + 1)];
+	const vec3_t *vert;
+
+	// all the rows, v_count vertices each
+	const vec3_t *grid;
 
 	GLuint tex_id;
 	int pass;
@@ -1827,8 +2163,6 @@ typedef struct
 
 	int piece_row;
 	int piece_col;
-
-	float h1, dh;
 }
 flood_emu_data_t;
 
@@ -1875,26 +2209,11 @@ static void DLIT_Flood(mobj_t *mo, void *dataptr)
 
 	SYS_ASSERT(mo->dlight.shader);
 
-	float sx = cur_seg->v1->x;
-	float sy = cur_seg->v1->y;
-
-	float dx = cur_seg->v2->x - sx;
-	float dy = cur_seg->v2->y - sy;
-
 	int blending = BL_Add;
 
 	for (int row=0; row < data->piece_row; row++)
 	{
-		float z = data->h1 + data->dh * row / (float)data->piece_row;
-
-		for (int col=0; col <= data->piece_col; col++)
-		{
-			float x = sx + dx * col / (float)data->piece_col;
-			float y = sy + dy * col / (float)data->piece_col;
-
-			data->vert[col*2 + 0].Set(x, y, z);
-			data->vert[col*2 + 1].Set(x, y, z + data->dh / data->piece_row);
-		}
+		data->vert = data->grid + row * data->v_count;
 
 		mo->dlight.shader->WorldMix(GL_QUAD_STRIP, data->v_count,
 				data->tex_id, 1.0, &data->pass, blending, false,
@@ -1906,8 +2225,6 @@ static void DLIT_Flood(mobj_t *mo, void *dataptr)
 static void EmulateFloodPlane(const drawfloor_t *dfloor,
 	const sector_t *flood_ref, int face_dir, float h1, float h2)
 {
-	(void) dfloor;
-	
 	if (num_active_mirrors > 0)
 		return;
 
@@ -1956,67 +2273,86 @@ static void EmulateFloodPlane(const drawfloor_t *dfloor,
 	data.normal.Set(0, 0, face_dir);
 
 
-	// determine number of pieces to subdivide the area into.
-	// The more the better, upto a limit of 64 pieces, and
-	// also limiting the size of the pieces.
-
-	float piece_w = cur_seg->length;
-	float piece_h = h2 - h1;
+	float sx = cur_seg->v1->x;
+	float sy = cur_seg->v1->y;
 
-	int piece_col = 1;
-	int piece_row = 1;
+	// the grid of pieces is in the cache, unless it changed
+	wall_geom_part_t *geom = GetWallGeometry(dfloor, (face_dir > 0) ? -1 : -2,
+		surf, surf->image, false);
 
-	while (piece_w > 16 || piece_h > 16)
+	if (geom->v_count == 0)
 	{
-		if (piece_col * piece_row >= 64)
-			break;
+		// determine number of pieces to subdivide the area into.
+		// The more the better, upto a limit of 64 pieces, and
+		// also limiting the size of the pieces.
 
-		if (piece_col >= MAX_FLOOD_VERT && piece_row >= MAX_FLOOD_VERT)
-			break;
+		float piece_w = cur_seg->length;
+		float piece_h = h2 - h1;
 
-		if (piece_w >= piece_h && piece_col < MAX_FLOOD_VERT)
-		{
-			piece_w /= 2.0;
-			piece_col *= 2;
-		}
-		else
-		{
-			piece_h /= 2.0;
-			piece_row *= 2;
-		}
-	}
+		int piece_col = 1;
+		int piece_row = 1;
 
-	SYS_ASSERT(piece_col <= MAX_FLOOD_VERT);
+		while (piece_w > 16 || piece_h > 16)
+		{
+			if (piece_col * piece_row >= 64)
+				break;
 
-	float sx = cur_seg->v1->x;
-	float sy = cur_seg->v1->y;
+			if (piece_col >= MAX_FLOOD_VERT && piece_row >= MAX_FLOOD_VERT)
+				break;
 
-	float dx = cur_seg->v2->x - sx;
-	float dy = cur_seg->v2->y - sy;
-	float dh = h2 - h1;
+			if (piece_w >= piece_h && piece_col < MAX_FLOOD_VERT)
+			{
+				piece_w /= 2.0;
+				piece_col *= 2;
+			}
+			else
+			{
+				piece_h /= 2.0;
+				piece_row *= 2;
+			}
+		}
 
-	data.piece_row = piece_row;
-	data.piece_col = piece_col;
-	data.h1 = h1;
-	data.dh = dh;
+		SYS_ASSERT(piece_col <= MAX_FLOOD_VERT);
 
+		float dx = cur_seg->v2->x - sx;
+		float dy = cur_seg->v2->y - sy;
+		float dh = h2 - h1;
 
-	abstract_shader_c *cmap_shader = R_GetColormapShader(props, 0, cur_sub->sector);
+		geom->piece_row = piece_row;
+		geom->piece_col = piece_col;
 
-	data.v_count = (piece_col+1) * 2;
+		ReserveWallGeometry(geom, piece_row * (piece_col+1) * 2);
 
-	for (int row=0; row < piece_row; row++)
-	{
-		float z = h1 + dh * row / (float)piece_row;
+		vec3_t *vert = &wall_geom_verts[geom->first];
 
-		for (int col=0; col <= piece_col; col++)
+		for (int row=0; row < piece_row; row++)
 		{
-			float x = sx + dx * col / (float)piece_col;
-			float y = sy + dy * col / (float)piece_col;
+			float z = h1 + dh * row / (float)piece_row;
+
+			for (int col=0; col <= piece_col; col++)
+			{
+				float x = sx + dx * col / (float)piece_col;
+				float y = sy + dy * col / (float)piece_col;
+
+				vert[col*2 + 0].Set(x, y, z);
+				vert[col*2 + 1].Set(x, y, z + dh / piece_row);
+			}
 
-			data.vert[col*2 + 0].Set(x, y, z);
-			data.vert[col*2 + 1].Set(x, y, z + dh / piece_row);
+			vert += (piece_col+1) * 2;
 		}
+	}
+
+	data.piece_row = geom->piece_row;
+	data.piece_col = geom->piece_col;
+
+	data.v_count = (data.piece_col+1) * 2;
+	data.grid = &wall_geom_verts[geom->first];
+
+	abstract_shader_c *cmap_shader = R_GetColormapShader(props, 0, cur_sub->sector);
+
+	for (int row=0; row < data.piece_row; row++)
+	{
+		data.vert = data.grid + row * data.v_count;
 
 #if 0  // DEBUGGING AIDE
 		data.R = (64 + 190 * (row & 1)) / 255.0;
@@ -2032,8 +2368,8 @@ static void EmulateFloodPlane(const drawfloor_t *dfloor,
 	{
 		// Note: dynamic lights could have been handled in the row-by-row
 		//       loop above (after the cmap_shader).  However it is more
-		//       efficient to handle them here, and duplicate the striping
-		//       code in the DLIT_Flood function.
+		//       efficient to handle them here, going over the rows again
+		//       in the DLIT_Flood function.
 
 		float ex = cur_seg->v2->x;
 		float ey = cur_seg->v2->y;
@@ -2098,6 +2434,8 @@ static void RGL_DrawSeg(drawfloor_t *dfloor, seg_t *seg, bool mirror_sub = false
 	}
 
 
+	cur_wall_tile = 0;
+
 	ComputeWallTiles(seg, dfloor, seg->side, f_min, c_max, mirror_sub);
 
 
@@ -2282,6 +2620,7 @@ static void RGL_WalkSeg(drawsub_c *dsub, seg_t *seg)
 	// check if visible
 	if (span > (ANG1/4) && RGL_1DOcclusionTest(angle_R, angle_L))
 	{
+		occ_stats.segs_culled++;
 		return;
 	}
 #endif
@@ -2482,6 +2821,123 @@ bool RGL_CheckBBox(float *bspcoord)
 }
 
 
+//
+// Level geometry cache
+//
+// The polygon of a subsector's floor or ceiling only depends on the
+// seg vertices and the sector's slopes, none of which change during
+// a level, so it is built once and kept until the level ends.  The
+// plane height is added when drawing, which means moving floors and
+// ceilings never need to invalidate anything.
+//
+
+typedef struct
+{
+	float x, y;
+
+	// heights given by UDMF/vertex slopes (only when has_fz/has_cz)
+	float fz, cz;
+
+	// offsets given by the sector's floor and ceiling slopes
+	float f_dz, c_dz;
+
+	bool has_fz, has_cz;
+}
+plane_geom_vert_t;
+
+typedef struct
+{
+	// range in plane_geom_verts
+	int first, num_vert;
+
+	float bbox[4];
+}
+plane_geom_t;
+
+static std::vector<plane_geom_t> plane_geoms;
+static std::vector<plane_geom_vert_t> plane_geom_verts;
+
+static void BuildPlaneGeometry(void)
+{
+	plane_geoms.resize(numsubsectors);
+	plane_geom_verts.clear();
+
+	for (int i = 0; i < numsubsectors; i++)
+	{
+		subsector_t *sub = &subsectors[i];
+		plane_geom_t *geom = &plane_geoms[i];
+
+		geom->first = (int)plane_geom_verts.size();
+		geom->num_vert = 0;
+
+		M_ClearBox(geom->bbox);
+
+		int num_vert = 0;
+
+		for (seg_t *seg = sub->segs; seg; seg = seg->sub_next)
+			num_vert++;
+
+		// -AJA- make sure polygon has enough vertices.  Sometimes a subsector
+		// ends up with only 1 or 2 segs due to level problems (e.g. MAP22).
+		if (num_vert < 3)
+			continue;
+
+		sector_t *sec = sub->sector;
+
+		for (seg_t *seg = sub->segs; seg && geom->num_vert < MAX_PLVERT; seg = seg->sub_next)
+		{
+			plane_geom_vert_t pv;
+
+			pv.x = seg->v1->x;
+			pv.y = seg->v1->y;
+
+			M_AddToBox(geom->bbox, pv.x, pv.y);
+
+			pv.fz = seg->v1->zf;
+			pv.cz = seg->v1->zc;
+
+			pv.has_fz = (pv.fz < 32767.0f && pv.fz > -32768.0f);
+			pv.has_cz = (pv.cz < 32767.0f && pv.cz > -32768.0f);
+
+			pv.f_dz = sec->f_slope ? Slope_GetHeight(sec->f_slope, pv.x, pv.y) : 0;
+			pv.c_dz = sec->c_slope ? Slope_GetHeight(sec->c_slope, pv.x, pv.y) : 0;
+
+			plane_geom_verts.push_back(pv);
+
+			geom->num_vert++;
+		}
+	}
+}
+
+static inline const plane_geom_t * GetPlaneGeometry(const subsector_t *sub)
+{
+	if ((int)plane_geoms.size() != numsubsectors)
+		BuildPlaneGeometry();
+
+	return &plane_geoms[sub - subsectors];
+}
+
+//
+// RGL_ClearLevelGeometry
+//
+// Discards the cached level geometry, must be called whenever
+// the level data is freed or replaced.
+//
+void RGL_ClearLevelGeometry(void)
+{
+	plane_geoms.clear();
+	plane_geom_verts.clear();
+
+	wall_geoms.clear();
+	wall_geom_verts.clear();
+	wall_geom_texcs.clear();
+	wall_geom_dead = 0;
+
+	wall_dep_first.clear();
+	wall_deps.clear();
+}
+
+
 static void RGL_DrawPlane(drawfloor_t *dfloor, float h,
 						  surface_t *surf, int face_dir)
 {
@@ -2489,8 +2945,6 @@ static void RGL_DrawPlane(drawfloor_t *dfloor, float h,
 
 	MIR_Height(h);
 
-	int num_vert, i;
-
 	if (! surf->image)
 		return;
 
@@ -2549,70 +3003,49 @@ static void RGL_DrawPlane(drawfloor_t *dfloor, float h,
 		return;
 
 	
-	// count number of actual vertices
-	seg_t *seg;
-	for (seg=cur_sub->segs, num_vert=0; seg; seg=seg->sub_next, num_vert++)
-	{
-		/* no other code needed */
-	}
+	const plane_geom_t *geom = GetPlaneGeometry(cur_sub);
 
-	// -AJA- make sure polygon has enough vertices.  Sometimes a subsector
-	// ends up with only 1 or 2 segs due to level problems (e.g. MAP22).
-	if (num_vert < 3)
+	if (geom->num_vert < 3)
 		return;
 
-	if (num_vert > MAX_PLVERT)
-		num_vert = MAX_PLVERT;
+	// (bbox was computed before any mirror adjustment)
+	const float *v_bbox = geom->bbox;
 
 	vec3_t vertices[MAX_PLVERT];
 
-	float v_bbox[4];
+	int v_count = geom->num_vert;
 
-	M_ClearBox(v_bbox);
+	bool floor_vs = cur_sub->sector->floor_vertex_slope && face_dir > 0;
+	bool ceil_vs  = cur_sub->sector->ceil_vertex_slope  && face_dir < 0;
 
-	int v_count = 0;
-
-	for (seg=cur_sub->segs, i=0; seg && (i < MAX_PLVERT); 
-		 seg=seg->sub_next, i++)
+	for (int i = 0; i < v_count; i++)
 	{
-		if (v_count < MAX_PLVERT)
-		{
-			float x = seg->v1->x;
-			float y = seg->v1->y;
-			float z = h;
+		const plane_geom_vert_t *pv = &plane_geom_verts[geom->first + i];
 
-			// must do this before mirror adjustment
-			M_AddToBox(v_bbox, x, y);
+		float x = pv->x;
+		float y = pv->y;
+		float z = h;
 
-			if (cur_sub->sector->floor_vertex_slope && face_dir > 0)
-			{
-				// floor - check vertex heights
-				if (seg->v1->zf < 32767.0f && seg->v1->zf > -32768.0f)
-					z = seg->v1->zf;
-			}
-
-			if (cur_sub->sector->ceil_vertex_slope && face_dir < 0)
-			{
-				// ceiling - check vertex heights
-				if (seg->v1->zc < 32767.0f && seg->v1->zc > -32768.0f)
-					z = seg->v1->zc;
-			}
+		// floor - check vertex heights
+		if (floor_vs && pv->has_fz)
+			z = pv->fz;
 
-			if (slope)
-			{
-				z = orig_h + Slope_GetHeight(slope, x, y);
+		// ceiling - check vertex heights
+		if (ceil_vs && pv->has_cz)
+			z = pv->cz;
 
-				MIR_Height(z);
-			}
+		if (slope)
+		{
+			z = orig_h + ((face_dir > 0) ? pv->f_dz : pv->c_dz);
 
-			MIR_Coordinate(x, y);
+			MIR_Height(z);
+		}
 
-			vertices[v_count].x = x;
-			vertices[v_count].y = y;
-			vertices[v_count].z = z;
+		MIR_Coordinate(x, y);
 
-			v_count++;
-		}
+		vertices[i].x = x;
+		vertices[i].y = y;
+		vertices[i].z = z;
 	}
 
 
@@ -2774,6 +3207,8 @@ static void RGL_WalkSubsector(int num)
 	I_Debugf( "\nVISITING SUBSEC %d (sector %d)\n\n", num, sub->sector - sectors);
 #endif
 
+	occ_stats.subs_visited++;
+
 	drawsub_c *K = R_GetDrawSub();
 	K->Clear(sub);
 
@@ -2970,9 +3405,9 @@ static void RGL_DrawSubList(std::list<drawsub_c *> &dsubs, bool for_mirror = fal
 
 static void DrawMirrorPolygon(drawmirror_c *mir)
 {
-	glDisable(GL_TEXTURE_2D);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	RGL_Disable(GL_TEXTURE_2D);
+	RGL_Enable(GL_BLEND);
+	RGL_BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	float alpha = 0.15 + 0.10 * num_active_mirrors;
 
@@ -3015,7 +3450,7 @@ static void DrawMirrorPolygon(drawmirror_c *mir)
 
 	glEnd();
 
-	glDisable(GL_BLEND);
+	RGL_Disable(GL_BLEND);
 }
 
 static void DrawPortalPolygon(drawmirror_c *mir)
@@ -3032,15 +3467,15 @@ static void DrawPortalPolygon(drawmirror_c *mir)
 		return;
 	}
 
-	glDisable(GL_ALPHA_TEST);
-	glEnable(GL_TEXTURE_2D);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	RGL_Disable(GL_ALPHA_TEST);
+	RGL_Enable(GL_TEXTURE_2D);
+	RGL_Enable(GL_BLEND);
+	RGL_BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	// set texture
 	GLuint tex_id = W_ImageCache(surf->image);
 
-	glBindTexture(GL_TEXTURE_2D, tex_id);
+	RGL_BindTexture(GL_TEXTURE_2D, tex_id);
 
 	// set colour & alpha
 	float alpha = ld->special->translucency * surf->translucency;
@@ -3088,8 +3523,8 @@ static void DrawPortalPolygon(drawmirror_c *mir)
 
 	glEnd();
 
-	glDisable(GL_BLEND);
-	glDisable(GL_TEXTURE_2D);
+	RGL_Disable(GL_BLEND);
+	RGL_Disable(GL_TEXTURE_2D);
 }
 
 static void RGL_DrawMirror(drawmirror_c *mir)
@@ -3224,15 +3659,45 @@ static void RGL_WalkBSPNode(unsigned int bspnum)
 	
 	side = P_PointOnDivlineSide(viewx, viewy, &nd_div);
 
+	occ_stats.nodes_checked += 2;
+
 	// Recursively divide front space.
 	if (RGL_CheckBBox(node->bbox[side]))
 		RGL_WalkBSPNode(node->children[side]);
+	else
+		occ_stats.nodes_culled++;
 
 	// Recursively divide back space.
 	if (RGL_CheckBBox(node->bbox[side ^ 1]))
 		RGL_WalkBSPNode(node->children[side ^ 1]);
+	else
+		occ_stats.nodes_culled++;
+}
+
+//
+// RGL_CollectScene
+//
+// Walks the BSP tree for the current view and builds the frame
+// description: the list of drawsubs (with their drawsegs, drawthings,
+// drawfloors and drawmirrors taken from the pools in r_misc.cc) plus
+// the sky depth geometry.  No GL calls are made here, everything is
+// only submitted afterwards by RGL_RenderTrueBSP.
+//
+static void RGL_CollectScene(void)
+{
+	R2_ClearBSP();
+	RGL_1DOcclusionClear();
+
+	drawsubs.clear();
+
+	// needed for drawing the sky
+	RGL_BeginSky();
+
+	// walk the bsp tree
+	RGL_WalkBSPNode(root_node);
 }
 
+
 //
 // RGL_RenderTrueBSP
 //
@@ -3248,31 +3713,24 @@ static void RGL_RenderTrueBSP(void)
 
 	FUZZ_Update();
 
-	R2_ClearBSP();
-	RGL_1DOcclusionClear();
-
-	drawsubs.clear();
-
 	player_t *v_player = view_cam_mo->player;
 	
 	// handle powerup effects and BOOM colourmaps
 	RGL_RainbowEffect(v_player);
 
+	RGL_CollectScene();
+
 
 	RGL_SetupMatrices3D();
 
 	glClear(GL_DEPTH_BUFFER_BIT);
-	glEnable(GL_DEPTH_TEST);
-
-	// needed for drawing the sky
-	RGL_BeginSky();
-
-	// walk the bsp tree
-	RGL_WalkBSPNode(root_node);
+	RGL_Enable(GL_DEPTH_TEST);
 
 	RGL_FinishSky();
 
 	RGL_DrawSubList(drawsubs);
+
+	RGL_DrawParticles();
 	
 	//Lobo 2022:
 	//Allow changing the order of weapon model rendering to be
@@ -3293,7 +3751,7 @@ static void RGL_RenderTrueBSP(void)
 		DoWeaponModel();
 	}
 	
-	glDisable(GL_DEPTH_TEST);
+	RGL_Disable(GL_DEPTH_TEST);
 
 	// now draw 2D stuff like psprites, and add effects
 	RGL_SetupMatricesWorld2D();
@@ -3312,9 +3770,9 @@ static void RGL_RenderTrueBSP(void)
 	{
 		RGL_SetupMatrices3D();
 		glClear(GL_DEPTH_BUFFER_BIT);
-		glEnable(GL_DEPTH_TEST);
+		RGL_Enable(GL_DEPTH_TEST);
 		DoWeaponModel();
-		glDisable(GL_DEPTH_TEST);
+		RGL_Disable(GL_DEPTH_TEST);
 		RGL_SetupMatrices2D();
 	}
 
@@ -3454,8 +3912,8 @@ static void InitCamera(mobj_t *mo, bool full_height, float expand_w)
 }
 
 
-void R_Render(int x, int y, int w, int h, mobj_t *camera,
-              bool full_height, float expand_w)
+static void SetupView(int x, int y, int w, int h, mobj_t *camera,
+                      bool full_height, float expand_w)
 {
 	viewwindow_x = x;
 	viewwindow_y = y;
@@ -3470,11 +3928,36 @@ void R_Render(int x, int y, int w, int h, mobj_t *camera,
 	// Profiling
 	framecount++;
 	validcount++;
+}
+
 
-	seen_dlights.clear();
+void R_Render(int x, int y, int w, int h, mobj_t *camera,
+              bool full_height, float expand_w)
+{
+	SetupView(x, y, w, h, camera, full_height, expand_w);
+
+	seen_dlight_count = 0;
 	RGL_RenderTrueBSP();
 }
 
 
+//
+// R_CollectScene
+//
+// Performs only the scene collection part of R_Render (the BSP walk),
+// without touching the GL.  Returns the number of visible subsectors.
+// Used for measuring the cost of the walk on its own.
+//
+int R_CollectScene(int x, int y, int w, int h, mobj_t *camera,
+                   bool full_height, float expand_w)
+{
+	SetupView(x, y, w, h, camera, full_height, expand_w);
+
+	RGL_CollectScene();
+
+	return (int)drawsubs.size();
+}
+
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
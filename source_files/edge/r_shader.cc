@@ -24,6 +24,7 @@
 #include "image_data.h"
 
 #include "p_mobj.h"
+#include "p_pool.h"
 #include "r_defs.h"
 #include "r_gldefs.h"
 #include "r_image.h"   // W_ImageCache
@@ -154,7 +155,16 @@ static light_image_c *GetLightImage(const mobjtype_c *info, int DL)
 //  DYNAMIC LIGHTS
 //----------------------------------------------------------------------------
 
-class dynlight_shader_c : public abstract_shader_c
+// base for the shaders owned by a thing (mo->dlight.shader), which
+// are allocated from dlight_shader_pool.
+class pooled_shader_c : public abstract_shader_c
+{
+public:
+	static void *operator new(size_t size);
+	static void operator delete(void *ptr, size_t size);
+};
+
+class dynlight_shader_c : public pooled_shader_c
 {
 private:
 	mobj_t *mo;
@@ -396,7 +406,7 @@ abstract_shader_c *MakeDLightShader(mobj_t *mo)
 //  SECTOR GLOWS
 //----------------------------------------------------------------------------
 
-class plane_glow_c : public abstract_shader_c
+class plane_glow_c : public pooled_shader_c
 {
 private:
 	mobj_t *mo;
@@ -590,7 +600,7 @@ abstract_shader_c *MakePlaneGlow(mobj_t *mo)
 //  WALL GLOWS
 //----------------------------------------------------------------------------
 
-class wall_glow_c : public abstract_shader_c
+class wall_glow_c : public pooled_shader_c
 {
 private:
 	line_t *ld;
@@ -762,6 +772,26 @@ abstract_shader_c *MakeWallGlow(mobj_t *mo)
 }
 
 
+static constexpr size_t MaxSize(size_t a, size_t b)
+{
+	return (a > b) ? a : b;
+}
+
+slab_pool_c dlight_shader_pool("dlight_shader",
+	MaxSize(sizeof(dynlight_shader_c),
+	MaxSize(sizeof(plane_glow_c), sizeof(wall_glow_c))), 128);
+
+void *pooled_shader_c::operator new(size_t size)
+{
+	return dlight_shader_pool.Alloc(size);
+}
+
+void pooled_shader_c::operator delete(void *ptr, size_t size)
+{
+	dlight_shader_pool.Free(ptr, size);
+}
+
+
 //----------------------------------------------------------------------------
 //  LASER GLOWS
 //----------------------------------------------------------------------------
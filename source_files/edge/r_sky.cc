@@ -21,6 +21,8 @@
 
 #include <math.h>
 
+#include <vector>
+
 #include "image_data.h"
 
 #include "dm_state.h"
@@ -30,6 +32,7 @@
 #include "w_flat.h"
 #include "r_sky.h"
 #include "r_gldefs.h"
+#include "r_glstate.h"
 #include "r_sky.h"
 #include "r_units.h"
 #include "r_colormap.h"
@@ -227,12 +230,14 @@ static void DeleteSkyTexGroup(int SK)
 	{
 		if (fake_box[SK].tex[i] != 0)
 		{
-			glDeleteTextures(1, &fake_box[SK].tex[i]);
+			RGL_DeleteTextures(1, &fake_box[SK].tex[i]);
 			fake_box[SK].tex[i] = 0;
 		}
 	}
 }
 
+static void DeleteSkyCylinder(void);
+
 void DeleteSkyTextures(void)
 {
 	for (int SK = 0; SK < 2; SK++)
@@ -242,6 +247,8 @@ void DeleteSkyTextures(void)
 
 		DeleteSkyTexGroup(SK);
 	}
+
+	DeleteSkyCylinder();
 }
 
 static void RGL_SetupSkyMatrices(void)
@@ -297,19 +304,33 @@ static void RGL_RevertSkyMatrices(void)
 }
 
 
-void RGL_BeginSky(void)
+// Sky depth triangles collected during the BSP walk, they are
+// only sent to the GL by RGL_FinishSky.  This keeps the BSP walk
+// free of any GL calls.
+typedef struct
 {
-	need_to_draw_sky = false;
+	vec3_t pos;
+	vec3_t normal;
+}
+sky_depth_vert_t;
 
-	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
-	glDisable(GL_TEXTURE_2D);
+static std::vector<sky_depth_vert_t> sky_depth_verts;
 
-	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+static inline void AddSkyDepthVert(float x, float y, float z, const vec3_t& normal)
+{
+	sky_depth_vert_t v;
+
+	v.pos.Set(x, y, z);
+	v.normal = normal;
 
-	// Draw the entire sky using only one glBegin/glEnd clause.
-	// glEnd is called in RGL_FinishSky and this code assumes that only
-	// RGL_DrawSkyWall and RGL_DrawSkyPlane is doing OpenGL calls in between.
-	glBegin(GL_TRIANGLES);
+	sky_depth_verts.push_back(v);
+}
+
+void RGL_BeginSky(void)
+{
+	need_to_draw_sky = false;
+
+	sky_depth_verts.clear();
 }
 
 // The following cylindrical sky-drawing routines are adapted from SLADE's 3D Renderer
@@ -328,168 +349,121 @@ static void buildSkyCircle()
 	}
 }
 
+// The cylinder (plus its caps) only depends on the sky image, the
+// stretch mode and the far clip distance, so it is built once into
+// a static vertex buffer and redrawn from there each frame.
+typedef struct
+{
+	const image_c *image;
+	skystretch_e stretch;
+	float dist;
+}
+sky_mesh_key_t;
+
+static sky_mesh_key_t sky_mesh_key = { NULL, SKS_Unset, 0 };
+
+static std::vector<local_gl_vert_t> sky_mesh_verts;
+
+static GLuint sky_mesh_vbo = 0;
+
+// the first 8 vertices are the top and bottom caps
+#define SKY_CAP_VERTS  8
+
+static inline void AddSkyMeshVert(float x, float y, float z, float tx, float ty, float alpha)
+{
+	local_gl_vert_t v;
+
+	v.rgba[0] = v.rgba[1] = v.rgba[2] = 1.0f;
+	v.rgba[3] = alpha;
+
+	v.pos.Set(x, y, z);
+	v.texc[0].Set(tx, ty);
+	v.texc[1].Set(0, 0);
+	v.normal.Set(0, 0, 0);
+
+	sky_mesh_verts.push_back(v);
+}
+
 // -----------------------------------------------------------------------------
-// Renders a cylindrical 'slice' of the sky between [top] and [bottom] on the z
+// Adds a cylindrical 'slice' of the sky between [top] and [bottom] on the z
 // axis
 // -----------------------------------------------------------------------------
-static void renderSkySlice(float top, float bottom, float atop, float abottom, float dist, float tx, float ty)
+static void AddSkySlice(float top, float bottom, float atop, float abottom, float dist, float tx, float ty)
 {
 	float tc_x  = 0.0f;
 	float tc_y1 = (top + 1.0f) * (ty * 0.5f);
 	float tc_y2 = (bottom + 1.0f) * (ty * 0.5f);
 
-	if (current_sky_stretch == SKS_Mirror && bottom < -0.5f)
+	if (sky_mesh_key.stretch == SKS_Mirror && bottom < -0.5f)
 	{
 		tc_y1 = -tc_y1;
 		tc_y2 = -tc_y2;
 	}
 
-	glBegin(GL_QUADS);
-
-	// Go through circular points
-	for (unsigned a = 0; a < 31; a++)
+	// Go through circular points, the last one links back to the first
+	for (unsigned a = 0; a < 32; a++)
 	{
+		const vec2_t& p1 = sky_circle[a];
+		const vec2_t& p2 = sky_circle[(a + 1) & 31];
+
 		// Top
-		glColor4f(1.0f, 1.0f, 1.0f, atop);
-		glTexCoord2f(tc_x + tx, tc_y1);
-		glVertex3f(
-			(sky_circle[a + 1].x * dist),
-			- (sky_circle[a + 1].y * dist),
-			(top * dist));
-		glTexCoord2f(tc_x, tc_y1);
-		glVertex3f(
-			(sky_circle[a].x * dist),
-			- (sky_circle[a].y * dist),
-			(top * dist));
+		AddSkyMeshVert(p2.x * dist, - (p2.y * dist), top * dist, tc_x + tx, tc_y1, atop);
+		AddSkyMeshVert(p1.x * dist, - (p1.y * dist), top * dist, tc_x,      tc_y1, atop);
 
 		// Bottom
-		glColor4f(1.0f, 1.0f, 1.0f, abottom);
-		glTexCoord2f(tc_x, tc_y2);
-		glVertex3f(
-			(sky_circle[a].x * dist),
-			- (sky_circle[a].y * dist),
-			(bottom * dist));
-		glTexCoord2f(tc_x + tx, tc_y2);
-		glVertex3f(
-			(sky_circle[a + 1].x * dist),
-			- (sky_circle[a + 1].y * dist),
-			(bottom * dist));
+		AddSkyMeshVert(p1.x * dist, - (p1.y * dist), bottom * dist, tc_x,      tc_y2, abottom);
+		AddSkyMeshVert(p2.x * dist, - (p2.y * dist), bottom * dist, tc_x + tx, tc_y2, abottom);
 
 		tc_x += tx;
 	}
-
-	// Link last point -> first
-	// Top
-	glColor4f(1.0f, 1.0f, 1.0f, atop);
-	glTexCoord2f(tc_x + tx, tc_y1);
-	glVertex3f(
-		(sky_circle[0].x * dist),
-		- (sky_circle[0].y * dist),
-		(top * dist));
-	glTexCoord2f(tc_x, tc_y1);
-	glVertex3f(
-		(sky_circle[31].x * dist),
-		- (sky_circle[31].y * dist),
-		(top * dist));
-
-	// Bottom
-	glColor4f(1.0f, 1.0f, 1.0f, abottom);
-	glTexCoord2f(tc_x, tc_y2);
-	glVertex3f(
-		(sky_circle[31].x * dist),
-		- (sky_circle[31].y * dist),
-		(bottom * dist));
-	glTexCoord2f(tc_x + tx, tc_y2);
-	glVertex3f(
-		(sky_circle[0].x * dist),
-		- (sky_circle[0].y * dist),
-		(bottom * dist));
-
-	glEnd();
 }
 
-static void RGL_DrawSkyCylinder(void)
+static skystretch_e CurrentSkyStretch(void)
 {
-	GLuint sky = W_ImageCache(sky_image, false, ren_fx_colmap);
-
 	if (currmap->forced_skystretch > SKS_Unset)
-		current_sky_stretch = currmap->forced_skystretch;
+		return currmap->forced_skystretch;
 	else if (!level_flags.mlook)
-		current_sky_stretch = SKS_Vanilla;
+		return SKS_Vanilla;
 	else
-		current_sky_stretch = (skystretch_e)r_skystretch.d;
+		return (skystretch_e)r_skystretch.d;
+}
 
-	// Center skybox a bit below the camera view
-	RGL_SetupSkyMatrices();
+static void BuildSkyCylinder(void)
+{
+	buildSkyCircle();
 
-	glDisable(GL_TEXTURE_2D);
+	sky_mesh_verts.clear();
 
-	float dist = r_farclip.f * 2.0f;
+	float dist = sky_mesh_key.dist;
 	float cap_dist = dist * 2.0f; // Ensure the caps extend beyond the cylindrical projection
 		// Calculate some stuff based on sky height
 	float sky_h_ratio;
 	float solid_sky_h;
-	if (IM_HEIGHT(sky_image) > 128 && current_sky_stretch != SKS_Stretch)
+	if (IM_HEIGHT(sky_image) > 128 && sky_mesh_key.stretch != SKS_Stretch)
 		sky_h_ratio = (float)IM_HEIGHT(sky_image) / 256;
-	else if (current_sky_stretch == SKS_Vanilla)
+	else if (sky_mesh_key.stretch == SKS_Vanilla)
 		sky_h_ratio = 0.5f;
 	else
 		sky_h_ratio = 1.0f;
-	if (current_sky_stretch == SKS_Vanilla)
+	if (sky_mesh_key.stretch == SKS_Vanilla)
 		solid_sky_h = sky_h_ratio * 0.98f;
 	else
 		solid_sky_h = sky_h_ratio * 0.75f;
 	float cap_z = dist * sky_h_ratio;
 
-	rgbcol_t fc_to_use = currmap->outdoor_fog_color;
-	float fd_to_use = 0.01f * currmap->outdoor_fog_density;
-	// check for sector fog
-	if (fc_to_use == RGB_NO_VALUE)
-	{
-		fc_to_use = view_props->fog_color;
-		fd_to_use = view_props->fog_density;
-	}
+	// Top cap
+	AddSkyMeshVert(-cap_dist, -cap_dist, cap_z, 0, 0, 1.0f);
+	AddSkyMeshVert(-cap_dist,  cap_dist, cap_z, 0, 0, 1.0f);
+	AddSkyMeshVert( cap_dist,  cap_dist, cap_z, 0, 0, 1.0f);
+	AddSkyMeshVert( cap_dist, -cap_dist, cap_z, 0, 0, 1.0f);
 
-	if (!r_culling.d && fc_to_use != RGB_NO_VALUE)
-	{
-		GLfloat fc[4];
-		fc[0] = (float)RGB_RED(fc_to_use)/255.0f;
-		fc[1] = (float)RGB_GRN(fc_to_use)/255.0f; 
-		fc[2] = (float)RGB_BLU(fc_to_use)/255.0f;
-		fc[3] = 1.0f;
-		glClearColor(fc[0],fc[1],fc[2],fc[3]);
-		glFogi(GL_FOG_MODE, GL_EXP);
-		glFogfv(GL_FOG_COLOR, fc);
-		glFogf(GL_FOG_DENSITY, std::log1p(fd_to_use * 0.005f));
-		glEnable(GL_FOG);
-	}
-
-	// Render top cap
-	glColor4f(sky_cap_color[0],sky_cap_color[1],sky_cap_color[2],1.0);
-	glBegin(GL_QUADS);
-	glVertex3f(-cap_dist, -cap_dist, cap_z);
-	glVertex3f(-cap_dist, cap_dist, cap_z);
-	glVertex3f(cap_dist, cap_dist, cap_z);
-	glVertex3f(cap_dist, -cap_dist, cap_z);
-	glEnd();
-
-	// Render bottom cap
-	if (current_sky_stretch > SKS_Mirror)
-		glColor4f(cull_fog_color[0],cull_fog_color[1],cull_fog_color[2],1.0);
-	glBegin(GL_QUADS);
-	if (current_sky_stretch == SKS_Vanilla)
+	// Bottom cap
+	if (sky_mesh_key.stretch == SKS_Vanilla)
 		cap_z = 0;
-	glVertex3f(-cap_dist, -cap_dist, -cap_z);
-	glVertex3f(-cap_dist, cap_dist, -cap_z);
-	glVertex3f(cap_dist, cap_dist, -cap_z);
-	glVertex3f(cap_dist, -cap_dist, -cap_z);
-	glEnd();
-
-	// Render skybox sides
-	glEnable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, sky);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	AddSkyMeshVert(-cap_dist, -cap_dist, -cap_z, 0, 0, 1.0f);
+	AddSkyMeshVert(-cap_dist,  cap_dist, -cap_z, 0, 0, 1.0f);
+	AddSkyMeshVert( cap_dist,  cap_dist, -cap_z, 0, 0, 1.0f);
+	AddSkyMeshVert( cap_dist, -cap_dist, -cap_z, 0, 0, 1.0f);
 
 	// Check for odd sky sizes
 	float tx = 0.125f;
@@ -497,79 +471,197 @@ static void RGL_DrawSkyCylinder(void)
 	if (IM_WIDTH(sky_image) > 256)
 		tx = 0.125f / ((float)IM_WIDTH(sky_image) / 256.0f);
 
-	glEnable(GL_ALPHA_TEST);
-	glEnable(GL_BLEND);
-
-	if (current_sky_stretch == SKS_Mirror)
+	if (sky_mesh_key.stretch == SKS_Mirror)
 	{
 		if (IM_HEIGHT(sky_image) > 128)
 		{
-			renderSkySlice(sky_h_ratio, solid_sky_h, 0.0f, 1.0f, dist, tx, ty);   // Top Fade
-			renderSkySlice(solid_sky_h, 0.0f, 1.0f, 1.0f, dist, tx, ty);  // Top Solid
-			renderSkySlice(0.0f, -solid_sky_h, 1.0f, 1.0f, dist, tx, ty);  // Bottom Solid
-			renderSkySlice(-solid_sky_h, -sky_h_ratio, 1.0f, 0.0f, dist, tx, ty); // Bottom Fade
+			AddSkySlice(sky_h_ratio, solid_sky_h, 0.0f, 1.0f, dist, tx, ty);   // Top Fade
+			AddSkySlice(solid_sky_h, 0.0f, 1.0f, 1.0f, dist, tx, ty);  // Top Solid
+			AddSkySlice(0.0f, -solid_sky_h, 1.0f, 1.0f, dist, tx, ty);  // Bottom Solid
+			AddSkySlice(-solid_sky_h, -sky_h_ratio, 1.0f, 0.0f, dist, tx, ty); // Bottom Fade
 		}
 		else
 		{
-			renderSkySlice(1.0f, 0.75f, 0.0f, 1.0f, dist, tx, ty);   // Top Fade
-			renderSkySlice(0.75f, 0.0f, 1.0f, 1.0f, dist, tx, ty);  // Top Solid
-			renderSkySlice(0.0f, -0.75f, 1.0f, 1.0f, dist, tx, ty);  // Bottom Solid
-			renderSkySlice(-0.75f, -1.0f, 1.0f, 0.0f, dist, tx, ty); // Bottom Fade
+			AddSkySlice(1.0f, 0.75f, 0.0f, 1.0f, dist, tx, ty);   // Top Fade
+			AddSkySlice(0.75f, 0.0f, 1.0f, 1.0f, dist, tx, ty);  // Top Solid
+			AddSkySlice(0.0f, -0.75f, 1.0f, 1.0f, dist, tx, ty);  // Bottom Solid
+			AddSkySlice(-0.75f, -1.0f, 1.0f, 0.0f, dist, tx, ty); // Bottom Fade
 		}
 	}
-	else if (current_sky_stretch == SKS_Repeat)
+	else if (sky_mesh_key.stretch == SKS_Repeat)
 	{
 		if (IM_HEIGHT(sky_image) > 128)
 		{
-			renderSkySlice(sky_h_ratio, solid_sky_h, 0.0f, 1.0f, dist, tx, ty);   // Top Fade
-			renderSkySlice(solid_sky_h, -solid_sky_h, 1.0f, 1.0f, dist, tx, ty);  // Middle Solid
-			renderSkySlice(-solid_sky_h, -sky_h_ratio, 1.0f, 0.0f, dist, tx, ty); // Bottom Fade
+			AddSkySlice(sky_h_ratio, solid_sky_h, 0.0f, 1.0f, dist, tx, ty);   // Top Fade
+			AddSkySlice(solid_sky_h, -solid_sky_h, 1.0f, 1.0f, dist, tx, ty);  // Middle Solid
+			AddSkySlice(-solid_sky_h, -sky_h_ratio, 1.0f, 0.0f, dist, tx, ty); // Bottom Fade
 		}
 		else
 		{
-			renderSkySlice(1.0f, 0.75f, 0.0f, 1.0f, dist, tx, ty);   // Top Fade
-			renderSkySlice(0.75f, -0.75f, 1.0f, 1.0f, dist, tx, ty);  // Middle Solid
-			renderSkySlice(-0.75f, -1.0f, 1.0f, 0.0f, dist, tx, ty); // Bottom Fade
+			AddSkySlice(1.0f, 0.75f, 0.0f, 1.0f, dist, tx, ty);   // Top Fade
+			AddSkySlice(0.75f, -0.75f, 1.0f, 1.0f, dist, tx, ty);  // Middle Solid
+			AddSkySlice(-0.75f, -1.0f, 1.0f, 0.0f, dist, tx, ty); // Bottom Fade
 		}
 	}
-	else if (current_sky_stretch == SKS_Stretch)
+	else if (sky_mesh_key.stretch == SKS_Stretch)
 	{
 		if (IM_HEIGHT(sky_image) > 128)
 		{
 			ty = ((float)IM_HEIGHT(sky_image) / 256.0f);
-			renderSkySlice(sky_h_ratio, solid_sky_h, 0.0f, 1.0f, dist, tx, ty);   // Top Fade
-			renderSkySlice(solid_sky_h, -solid_sky_h, 1.0f, 1.0f, dist, tx, ty);  // Middle Solid
-			renderSkySlice(-solid_sky_h, -sky_h_ratio, 1.0f, 0.0f, dist, tx, ty); // Bottom Fade
+			AddSkySlice(sky_h_ratio, solid_sky_h, 0.0f, 1.0f, dist, tx, ty);   // Top Fade
+			AddSkySlice(solid_sky_h, -solid_sky_h, 1.0f, 1.0f, dist, tx, ty);  // Middle Solid
+			AddSkySlice(-solid_sky_h, -sky_h_ratio, 1.0f, 0.0f, dist, tx, ty); // Bottom Fade
 		}
 		else
 		{
 			ty = 1.0f;
-			renderSkySlice(1.0f, 0.75f, 0.0f, 1.0f, dist, tx, ty);   // Top Fade
-			renderSkySlice(0.75f, -0.75f, 1.0f, 1.0f, dist, tx, ty);  // Middle Solid
-			renderSkySlice(-0.75f, -1.0f, 1.0f, 0.0f, dist, tx, ty); // Bottom Fade
+			AddSkySlice(1.0f, 0.75f, 0.0f, 1.0f, dist, tx, ty);   // Top Fade
+			AddSkySlice(0.75f, -0.75f, 1.0f, 1.0f, dist, tx, ty);  // Middle Solid
+			AddSkySlice(-0.75f, -1.0f, 1.0f, 0.0f, dist, tx, ty); // Bottom Fade
 		}
 	}
 	else // Vanilla (or sane value if somehow this gets set out of expected range)
 	{
 		if (IM_HEIGHT(sky_image) > 128)
 		{
-			renderSkySlice(sky_h_ratio, solid_sky_h, 0.0f, 1.0f, dist/2, tx, ty);   // Top Fade
-			renderSkySlice(solid_sky_h, sky_h_ratio - solid_sky_h, 1.0f, 1.0f, dist/2, tx, ty);  // Middle Solid
-			renderSkySlice(sky_h_ratio - solid_sky_h, 0.0f, 1.0f, 0.0f, dist/2, tx, ty);   // Bottom Fade
+			AddSkySlice(sky_h_ratio, solid_sky_h, 0.0f, 1.0f, dist/2, tx, ty);   // Top Fade
+			AddSkySlice(solid_sky_h, sky_h_ratio - solid_sky_h, 1.0f, 1.0f, dist/2, tx, ty);  // Middle Solid
+			AddSkySlice(sky_h_ratio - solid_sky_h, 0.0f, 1.0f, 0.0f, dist/2, tx, ty);   // Bottom Fade
 		}
 		else
 		{
 			ty *= 1.5f;
-			renderSkySlice(1.0f, 0.98f, 0.0f, 1.0f, dist/3, tx, ty);   // Top Fade
-			renderSkySlice(0.98f, 0.35f, 1.0f, 1.0f, dist/3, tx, ty);  // Middle Solid
-			renderSkySlice(0.35f, 0.33f, 1.0f, 0.0f, dist/3, tx, ty);   // Bottom Fade
+			AddSkySlice(1.0f, 0.98f, 0.0f, 1.0f, dist/3, tx, ty);   // Top Fade
+			AddSkySlice(0.98f, 0.35f, 1.0f, 1.0f, dist/3, tx, ty);  // Middle Solid
+			AddSkySlice(0.35f, 0.33f, 1.0f, 0.0f, dist/3, tx, ty);   // Bottom Fade
 		}
 	}
 
-	glDisable(GL_BLEND);
-	glDisable(GL_ALPHA_TEST);
+	if (sky_mesh_vbo == 0)
+		glGenBuffers(1, &sky_mesh_vbo);
+
+	glBindBuffer(GL_ARRAY_BUFFER, sky_mesh_vbo);
+	glBufferData(GL_ARRAY_BUFFER, sky_mesh_verts.size() * sizeof(local_gl_vert_t),
+				 sky_mesh_verts.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+//
+// UpdateSkyCylinder
+//
+// Rebuilds the sky cylinder if the sky image, stretch mode or
+// far clip distance has changed since it was last built.
+//
+static void UpdateSkyCylinder(void)
+{
+	current_sky_stretch = CurrentSkyStretch();
+
+	float dist = r_farclip.f * 2.0f;
+
+	if (sky_mesh_vbo != 0 &&
+		sky_mesh_key.image   == sky_image &&
+		sky_mesh_key.stretch == current_sky_stretch &&
+		sky_mesh_key.dist    == dist)
+	{
+		return;
+	}
+
+	sky_mesh_key.image   = sky_image;
+	sky_mesh_key.stretch = current_sky_stretch;
+	sky_mesh_key.dist    = dist;
+
+	BuildSkyCylinder();
+}
+
+static void DeleteSkyCylinder(void)
+{
+	if (sky_mesh_vbo != 0)
+	{
+		glDeleteBuffers(1, &sky_mesh_vbo);
+		sky_mesh_vbo = 0;
+	}
+
+	sky_mesh_key.image = NULL;
+}
+
+static void RGL_DrawSkyCylinder(void)
+{
+	GLuint sky = W_ImageCache(sky_image, false, ren_fx_colmap);
+
+	UpdateSkyCylinder();
+
+	// Center skybox a bit below the camera view
+	RGL_SetupSkyMatrices();
+
+	RGL_Disable(GL_TEXTURE_2D);
+
+	rgbcol_t fc_to_use = currmap->outdoor_fog_color;
+	float fd_to_use = 0.01f * currmap->outdoor_fog_density;
+	// check for sector fog
+	if (fc_to_use == RGB_NO_VALUE)
+	{
+		fc_to_use = view_props->fog_color;
+		fd_to_use = view_props->fog_density;
+	}
+
+	if (!r_culling.d && fc_to_use != RGB_NO_VALUE)
+	{
+		GLfloat fc[4];
+		fc[0] = (float)RGB_RED(fc_to_use)/255.0f;
+		fc[1] = (float)RGB_GRN(fc_to_use)/255.0f; 
+		fc[2] = (float)RGB_BLU(fc_to_use)/255.0f;
+		fc[3] = 1.0f;
+		glClearColor(fc[0],fc[1],fc[2],fc[3]);
+		RGL_Fogi(GL_FOG_MODE, GL_EXP);
+		RGL_Fogfv(GL_FOG_COLOR, fc);
+		RGL_Fogf(GL_FOG_DENSITY, std::log1p(fd_to_use * 0.005f));
+		RGL_Enable(GL_FOG);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, sky_mesh_vbo);
+	glVertexPointer(3, GL_FLOAT, sizeof(local_gl_vert_t), BUFFER_OFFSET(offsetof(local_gl_vert_t, pos.x)));
+	glEnableClientState(GL_VERTEX_ARRAY);
+
+	// Render top cap
+	glColor4f(sky_cap_color[0],sky_cap_color[1],sky_cap_color[2],1.0);
+	glDrawArrays(GL_QUADS, 0, 4);
+
+	// Render bottom cap
+	if (current_sky_stretch > SKS_Mirror)
+		glColor4f(cull_fog_color[0],cull_fog_color[1],cull_fog_color[2],1.0);
+	glDrawArrays(GL_QUADS, 4, 4);
+
+	// Render skybox sides
+	RGL_Enable(GL_TEXTURE_2D);
+	RGL_BindTexture(GL_TEXTURE_2D, sky);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+	RGL_Enable(GL_ALPHA_TEST);
+	RGL_Enable(GL_BLEND);
+
+	glColorPointer(4, GL_FLOAT, sizeof(local_gl_vert_t), BUFFER_OFFSET(offsetof(local_gl_vert_t, rgba)));
+	glEnableClientState(GL_COLOR_ARRAY);
+	glClientActiveTexture(GL_TEXTURE0);
+	glTexCoordPointer(2, GL_FLOAT, sizeof(local_gl_vert_t), BUFFER_OFFSET(offsetof(local_gl_vert_t, texc[0])));
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+
+	int side_verts = (int)sky_mesh_verts.size() - SKY_CAP_VERTS;
+
+	glDrawArrays(GL_QUADS, SKY_CAP_VERTS, side_verts);
+
+	gl_stats.draw_calls += 3;
+	gl_stats.vertices   += (int)sky_mesh_verts.size();
+
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	RGL_Disable(GL_BLEND);
+	RGL_Disable(GL_ALPHA_TEST);
 	if (!r_culling.d && current_fog_rgb != RGB_NO_VALUE)
-		glDisable(GL_FOG);
+		RGL_Disable(GL_FOG);
 
 	RGL_RevertSkyMatrices();
 }
@@ -595,7 +687,7 @@ static void RGL_DrawSkyBox(void)
 		v1 = 1.0f - v0;
 	}
 
-	glEnable(GL_TEXTURE_2D);
+	RGL_Enable(GL_TEXTURE_2D);
 
 	float col[4];
 
@@ -626,14 +718,14 @@ static void RGL_DrawSkyBox(void)
 		fc[2] = (float)RGB_BLU(fc_to_use)/255.0f;
 		fc[3] = 1.0f;
 		glClearColor(fc[0],fc[1],fc[2],fc[3]);
-		glFogi(GL_FOG_MODE, GL_EXP);
-		glFogfv(GL_FOG_COLOR, fc);
-		glFogf(GL_FOG_DENSITY, std::log1p(fd_to_use * 0.01f));
-		glEnable(GL_FOG);
+		RGL_Fogi(GL_FOG_MODE, GL_EXP);
+		RGL_Fogfv(GL_FOG_COLOR, fc);
+		RGL_Fogf(GL_FOG_DENSITY, std::log1p(fd_to_use * 0.01f));
+		RGL_Enable(GL_FOG);
 	}
 
 	// top
-	glBindTexture(GL_TEXTURE_2D, fake_box[SK].tex[WSKY_Top]);
+	RGL_BindTexture(GL_TEXTURE_2D, fake_box[SK].tex[WSKY_Top]);
         glNormal3i(0, 0, -1);
 	#ifdef APPLE_SILICON
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -647,7 +739,7 @@ static void RGL_DrawSkyBox(void)
 	glEnd();
 
 	// bottom
-	glBindTexture(GL_TEXTURE_2D, fake_box[SK].tex[WSKY_Bottom]);
+	RGL_BindTexture(GL_TEXTURE_2D, fake_box[SK].tex[WSKY_Bottom]);
         glNormal3i(0, 0, +1);
 	#ifdef APPLE_SILICON
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -661,7 +753,7 @@ static void RGL_DrawSkyBox(void)
 	glEnd();
 
 	// north
-	glBindTexture(GL_TEXTURE_2D, fake_box[SK].tex[WSKY_North]);
+	RGL_BindTexture(GL_TEXTURE_2D, fake_box[SK].tex[WSKY_North]);
         glNormal3i(0, -1, 0);
 	#ifdef APPLE_SILICON
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -675,7 +767,7 @@ static void RGL_DrawSkyBox(void)
 	glEnd();
 
 	// east
-	glBindTexture(GL_TEXTURE_2D, fake_box[SK].tex[WSKY_East]);
+	RGL_BindTexture(GL_TEXTURE_2D, fake_box[SK].tex[WSKY_East]);
         glNormal3i(-1, 0, 0);
 	#ifdef APPLE_SILICON
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -689,7 +781,7 @@ static void RGL_DrawSkyBox(void)
 	glEnd();
 
 	// south
-	glBindTexture(GL_TEXTURE_2D, fake_box[SK].tex[WSKY_South]);
+	RGL_BindTexture(GL_TEXTURE_2D, fake_box[SK].tex[WSKY_South]);
         glNormal3i(0, +1, 0);
 	#ifdef APPLE_SILICON
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -703,7 +795,7 @@ static void RGL_DrawSkyBox(void)
 	glEnd();
 
 	// west
-	glBindTexture(GL_TEXTURE_2D, fake_box[SK].tex[WSKY_West]);
+	RGL_BindTexture(GL_TEXTURE_2D, fake_box[SK].tex[WSKY_West]);
         glNormal3i(+1, 0, 0);
 	#ifdef APPLE_SILICON
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -716,16 +808,33 @@ static void RGL_DrawSkyBox(void)
 	glTexCoord2f(v1, v0); glVertex3f(-dist,  dist, -dist);
 	glEnd();
 
-	glDisable(GL_TEXTURE_2D);
+	RGL_Disable(GL_TEXTURE_2D);
 	if (!r_culling.d && current_fog_rgb != RGB_NO_VALUE)
-		glDisable(GL_FOG);
+		RGL_Disable(GL_FOG);
 
 	RGL_RevertSkyMatrices();
 }
 
 void RGL_FinishSky(void)
 {
-	glEnd(); // End glBegin(GL_TRIANGLES) from RGL_BeginSky
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	RGL_Disable(GL_TEXTURE_2D);
+
+	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+
+	// Draw the entire sky depth using only one glBegin/glEnd clause.
+	if (! sky_depth_verts.empty())
+	{
+		glBegin(GL_TRIANGLES);
+
+		for (const sky_depth_vert_t& v : sky_depth_verts)
+		{
+			glNormal3fv(reinterpret_cast<const GLfloat *>(&v.normal));
+			glVertex3fv(reinterpret_cast<const GLfloat *>(&v.pos));
+		}
+
+		glEnd();
+	}
 
 	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 
@@ -734,10 +843,10 @@ void RGL_FinishSky(void)
 
 	// draw sky picture, but DON'T affect the depth buffering
 
-	glDepthMask(GL_FALSE);
+	RGL_DepthMask(GL_FALSE);
 
 	if (r_culling.d)
-		glDisable(GL_DEPTH_TEST);
+		RGL_Disable(GL_DEPTH_TEST);
 
 	if (! r_dumbsky.d)
 		glDepthFunc(GL_GREATER);
@@ -748,12 +857,12 @@ void RGL_FinishSky(void)
 		RGL_DrawSkyCylinder();
 
 	if (r_culling.d)
-		glEnable(GL_DEPTH_TEST);
+		RGL_Enable(GL_DEPTH_TEST);
 
 	glDepthFunc(GL_LEQUAL);
-	glDepthMask(GL_TRUE);
+	RGL_DepthMask(GL_TRUE);
 
-	glDisable(GL_TEXTURE_2D);
+	RGL_Disable(GL_TEXTURE_2D);
 }
 
 void RGL_DrawSkyPlane(subsector_t *sub, float h)
@@ -765,7 +874,8 @@ void RGL_DrawSkyPlane(subsector_t *sub, float h)
 
 	MIR_Height(h);
 
-	glNormal3f(0, 0, (viewz > h) ? 1.0f : -1.0f);
+	vec3_t normal;
+	normal.Set(0, 0, (viewz > h) ? 1.0f : -1.0f);
 
 	seg_t *seg = sub->segs;
 	if (!seg)
@@ -791,9 +901,9 @@ void RGL_DrawSkyPlane(subsector_t *sub, float h)
 		float y2 = seg->v1->y;
 		MIR_Coordinate(x2, y2);
 
-		glVertex3f(x0, y0, h);
-		glVertex3f(x1, y1, h);
-		glVertex3f(x2, y2, h);
+		AddSkyDepthVert(x0, y0, h, normal);
+		AddSkyDepthVert(x1, y1, h, normal);
+		AddSkyDepthVert(x2, y2, h, normal);
 
 		x1 = x2;
 		y1 = y2;
@@ -820,15 +930,16 @@ void RGL_DrawSkyWall(seg_t *seg, float h1, float h2)
 	MIR_Height(h1);
 	MIR_Height(h2);
 
-	glNormal3f(y2 - y1, x1 - x2, 0);
+	vec3_t normal;
+	normal.Set(y2 - y1, x1 - x2, 0);
 
-	glVertex3f(x1, y1, h1);
-	glVertex3f(x1, y1, h2);
-	glVertex3f(x2, y2, h2);
+	AddSkyDepthVert(x1, y1, h1, normal);
+	AddSkyDepthVert(x1, y1, h2, normal);
+	AddSkyDepthVert(x2, y2, h2, normal);
 
-	glVertex3f(x2, y2, h1);
-	glVertex3f(x2, y2, h2);
-	glVertex3f(x1, y1, h1);
+	AddSkyDepthVert(x2, y2, h1, normal);
+	AddSkyDepthVert(x2, y2, h2, normal);
+	AddSkyDepthVert(x1, y1, h1, normal);
 }
 
 
@@ -915,9 +1026,24 @@ int RGL_UpdateSkyBoxTextures(void)
 }
 
 
+//
+// RGL_PreCacheSky
+//
+// Uploads the sky texture(s) and builds the sky cylinder ahead of
+// the first frame.
+//
 void RGL_PreCacheSky(void)
 {
 	buildSkyCircle();
+
+	if (! sky_image)
+		return;
+
+	if (RGL_UpdateSkyBoxTextures() < 0)
+	{
+		W_ImageCache(sky_image, false, ren_fx_colmap);
+		UpdateSkyCylinder();
+	}
 }
 
 //--- editor settings ---
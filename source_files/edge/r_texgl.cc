@@ -29,6 +29,7 @@
 #include "m_misc.h"
 #include "p_local.h"
 #include "r_gldefs.h"
+#include "r_glstate.h"
 #include "r_image.h"
 #include "r_sky.h"
 #include "r_texgl.h"
@@ -138,7 +139,7 @@ GLuint R_UploadTexture(epi::image_data_c *img, int flags, int max_pix)
 	GLuint id;
 
 	glGenTextures(1, &id);
-	glBindTexture(GL_TEXTURE_2D, id);
+	RGL_BindTexture(GL_TEXTURE_2D, id);
 
 	int tmode = GL_REPEAT;
 
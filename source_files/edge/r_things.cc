@@ -27,6 +27,7 @@
 #include "i_defs_gl.h"
 
 #include <math.h>
+#include <vector>
 
 #include "math_color.h"
 #include "image_data.h"
@@ -38,11 +39,13 @@
 #include "dm_state.h"
 #include "g_game.h" //currmap
 #include "p_local.h"
+#include "p_particle.h"
 #include "r_colormap.h"
 #include "r_defs.h"
 #include "r_draw.h"
 #include "r_effects.h"
 #include "r_gldefs.h"
+#include "r_glstate.h"
 #include "r_image.h"
 #include "r_mdl.h"
 #include "r_md2.h"
@@ -241,7 +244,7 @@ static void RGL_DrawPSprite(pspdef_t * psp, int which,
 
 
 	// clip psprite to view window
-	glEnable(GL_SCISSOR_TEST);
+	RGL_Enable(GL_SCISSOR_TEST);
 
 	glScissor(viewwindow_x, viewwindow_y, viewwindow_w, viewwindow_h);
 
@@ -435,7 +438,7 @@ static void RGL_DrawPSprite(pspdef_t * psp, int which,
 
 	RGL_FinishUnits();
 
-	glDisable(GL_SCISSOR_TEST);
+	RGL_Disable(GL_SCISSOR_TEST);
 }
 
 static const rgbcol_t crosshair_colors[8] =
@@ -490,13 +493,13 @@ static void DrawStdCrossHair(void)
 	float w = I_ROUND(SCREENWIDTH * r_crosssize.f / 640.0f);
 
 
-	glEnable(GL_TEXTURE_2D);
-	glEnable(GL_BLEND);
+	RGL_Enable(GL_TEXTURE_2D);
+	RGL_Enable(GL_BLEND);
 
-	glBindTexture(GL_TEXTURE_2D, tex_id);
+	RGL_BindTexture(GL_TEXTURE_2D, tex_id);
 
 	// additive blending
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+	RGL_BlendFunc(GL_SRC_ALPHA, GL_ONE);
 
 	glColor3f(r, g, b);
 
@@ -509,10 +512,10 @@ static void DrawStdCrossHair(void)
 
 	glEnd();
 
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	RGL_BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-	glDisable(GL_TEXTURE_2D);
-	glDisable(GL_BLEND);
+	RGL_Disable(GL_TEXTURE_2D);
+	RGL_Disable(GL_BLEND);
 }
 
 
@@ -1220,11 +1223,11 @@ static void RGL_DrawModel(drawthing_t *dthing)
 
 	modeldef_c *md = W_GetModel(mo->state->sprite);
 
-	const image_c *skin_img = md->skins[mo->model_skin];
+	const image_c *skin_img = md->skins[mo->cold->model_skin];
 
 	if (! skin_img && md->md2_model)
 	{
-//I_Debugf("Render model: no skin %d\n", mo->model_skin);
+//I_Debugf("Render model: no skin %d\n", mo->cold->model_skin);
 		skin_img = W_ImageForDummySkin();
 	}
 
@@ -1251,9 +1254,9 @@ static void RGL_DrawModel(drawthing_t *dthing)
 	int last_frame = mo->state->frame;
 	float lerp = 0.0;
 
-	if (mo->model_last_frame >= 0)
+	if (mo->cold->model_last_frame >= 0)
 	{
-		last_frame = mo->model_last_frame;
+		last_frame = mo->cold->model_last_frame;
 
 		SYS_ASSERT(mo->state->tics > 1);
 
@@ -1566,112 +1569,245 @@ void RGL_DrawThing(drawfloor_t *dfloor, drawthing_t *dthing)
 }
 
 
-void RGL_DrawSortThings(drawfloor_t *dfloor)
+//
+// RGL_DrawParticles
+//
+// Draws the lightweight particles (see p_particle.h) as sprites facing
+// the camera.  They are not in the subsector lists, so they are drawn
+// once the world is done, leaving the clipping to the depth buffer, and
+// the units are sorted by texture so they go out in a few batches.
+//
+// Lighting is only sampled once per particle, and dynamic lights are
+// ignored.
+//
+void RGL_DrawParticles(void)
 {
-	//
-	// As part my move to strip out Z_Zone usage and replace 
-	// it with array classes and more standard new and delete 
-	// calls, I've removed the QSORT() here and the array. 
-	// My main reason for doing that is that since I have to 
-	// modify the code here anyway, it is prudent to re-evaluate
-	// their usage. 
-	//
-	// The QSORT() mechanism used does an
-	// allocation each time it is used and this is called
-	// for each floor drawn in each subsector drawn, it is
-	// reasonable to assume that removing it will give
-	// something of speed improvement. 
-	//
-	// This comes at a cost since optimisation is always 
-	// a balance between speed and size: drawthing_t now has 
-	// to hold 4 additional pointers. Two for the binary tree 
-	// (order building) and two for the the final linked list 
-	// (avoiding recursive function calls that the parsing the 
-	// binary tree would require).
-	//
-	// -ACB- 2004/08/17
-	//
-	
-	drawthing_t *head_dt;
-	
-	// Check we have something to draw
-	head_dt = dfloor->things;
-	if (!head_dt)
+	const particle_list_t& P = particles;
+
+	if (P.count == 0)
 		return;
 
-	drawthing_t *curr_dt, *dt, *next_dt;
-	float cmp_val;
-		
-	head_dt->rd_l = head_dt->rd_r = head_dt->rd_prev = head_dt->rd_next = NULL;
-	
-	dt = NULL;	// Warning removal: This will always have been set
-	
-	curr_dt = head_dt->next;
-	while(curr_dt)
+	// the particles only move on real tics
+	float back = (time_stop_active || erraticism_active) ? 0 : (1.0f - particle_lerp);
+
+	vec3_t normal;
+	normal.Set(-viewcos, -viewsin, 0);
+
+	RGL_StartUnits(true);
+
+	for (int i = 0; i < P.count; i++)
 	{
-		curr_dt->rd_l = curr_dt->rd_r = NULL;
-		
-		// Parse the tree to find our place
-		next_dt = head_dt;
-		do
+		float mx = P.x[i] - P.mom_x[i] * back;
+		float my = P.y[i] - P.mom_y[i] * back;
+		float mz = P.z[i] - P.mom_z[i] * back;
+
+		float tr_x = mx - viewx;
+		float tr_y = my - viewy;
+
+		float tz = tr_x * viewcos + tr_y * viewsin;
+
+		if (tz < MINZ || tz > r_farclip.f)
+			continue;
+
+		float tx = tr_x * viewsin - tr_y * viewcos;
+
+		if (fabs(tx) / 32 > tz)
+			continue;
+
+		const mobjtype_c *info = P.info[i];
+		const state_t *st = &states[P.state[i]];
+
+		float trans = PERCENT_2_FLOAT(info->translucency);
+
+		if (trans <= 0)
+			continue;
+
+		bool flip = false;
+		const image_c *image = R2_GetOtherSprite(st->sprite, st->frame, &flip);
+
+		if (! image)
+			continue;
+
+		float side_offset = IM_OFFSETX(image);
+		float top_offset  = IM_OFFSETY(image);
+
+		if (flip)
+			side_offset = -side_offset;
+
+		float xscale = info->scale * info->aspect;
+
+		float pos1 = (IM_WIDTH(image) / -2.0f - side_offset) * xscale;
+		float pos2 = (IM_WIDTH(image) / +2.0f - side_offset) * xscale;
+
+		float sprite_h = IM_HEIGHT(image) * info->scale;
+		float gzb;
+
+		switch (info->yalign)
 		{
-			dt = next_dt;
-			
-			cmp_val = dt->tz - curr_dt->tz;
-			if (cmp_val == 0.0f)
+			case SPYA_TopDown:
+				gzb = mz + info->height + top_offset * info->scale - sprite_h;
+				break;
+
+			case SPYA_Middle:
+				gzb = mz + info->height * 0.5 + top_offset * info->scale - sprite_h * 0.5;
+				break;
+
+			case SPYA_BottomUp: default:
+				gzb = mz + top_offset * info->scale;
+				break;
+		}
+
+		// keep it out of the floor, like the soft clipping of things
+		if (sprite_kludge == 0 && gzb < P.floor_h[i])
+			gzb = P.floor_h[i];
+
+		float gzt = gzb + sprite_h;
+
+		float x1 = mx + pos1 * viewsin;
+		float y1 = my - pos1 * viewcos;
+		float x2 = mx + pos2 * viewsin;
+		float y2 = my - pos2 * viewcos;
+
+		float tex_x1 = 0.001f;
+		float tex_x2 = IM_RIGHT(image) - 0.001f;
+
+		if (flip)
+			std::swap(tex_x1, tex_x2);
+
+		float tex_y2 = IM_TOP(image);
+
+		sector_t *sec = P.subsector[i]->sector;
+
+		multi_color_c col;
+		col.Clear();
+
+		abstract_shader_c *shader = R_GetColormapShader(sec->p, st->bright, sec);
+
+		shader->Sample(&col, mx, my, (gzb + gzt) * 0.5f);
+
+		int blending = BL_Masked;
+
+		if (trans >= 0.11f && image->opacity != OPAC_Complex)
+			blending = BL_Less;
+
+		if (trans < 0.99 || image->opacity == OPAC_Complex)
+			blending |= BL_Alpha;
+
+		if (info->hyperflags & HF_NOZBUFFER)
+			blending |= BL_NoZBuf;
+
+		rgbcol_t fc_to_use = sec->props.fog_color;
+		float    fd_to_use = sec->props.fog_density;
+
+		// check for DDFLEVL fog
+		if (fc_to_use == RGB_NO_VALUE)
+		{
+			if (IS_SKY(sec->ceil))
 			{
-				// Resolve Z fight by letting the mobj pointer values settle it
-				int offset = dt->mo - curr_dt->mo;
-				cmp_val = (float)offset;
+				fc_to_use = currmap->outdoor_fog_color;
+				fd_to_use = 0.01f * currmap->outdoor_fog_density;
 			}
-						
-			if (cmp_val < 0.0f)
-				next_dt = dt->rd_l;				
 			else
-				next_dt = dt->rd_r;
+			{
+				fc_to_use = currmap->indoor_fog_color;
+				fd_to_use = 0.01f * currmap->indoor_fog_density;
+			}
 		}
-		while (next_dt);
-		
-		// Update our place 
-		if (cmp_val < 0.0f)
-		{ 
-			// Update the binary tree
-			dt->rd_l = curr_dt;
-
-			// Update the linked list (Insert behind node)
-			if (dt->rd_prev) 
-				dt->rd_prev->rd_next = curr_dt; 
-			
-			curr_dt->rd_prev = dt->rd_prev;
-			curr_dt->rd_next = dt; 
 
-			dt->rd_prev = curr_dt;		
-		}
-		else
+		GLuint tex_id = W_ImageCache(image, false,
+						  ren_fx_colmap ? ren_fx_colmap : info->palremap);
+
+		local_gl_vert_t *glvert = RGL_BeginUnit(GL_POLYGON, 4,
+				GL_MODULATE, tex_id, ENV_NONE, 0,
+				0, blending, fc_to_use, fd_to_use);
+
+		glvert[0].pos.Set(x1, y1, gzb);
+		glvert[1].pos.Set(x1, y1, gzt);
+		glvert[2].pos.Set(x2, y2, gzt);
+		glvert[3].pos.Set(x2, y2, gzb);
+
+		glvert[0].texc[0].Set(tex_x1, 0);
+		glvert[1].texc[0].Set(tex_x1, tex_y2);
+		glvert[2].texc[0].Set(tex_x2, tex_y2);
+		glvert[3].texc[0].Set(tex_x2, 0);
+
+		for (int v = 0; v < 4; v++)
 		{
-			// Update the binary tree
-			dt->rd_r = curr_dt; 
+			local_gl_vert_t *dest = glvert + v;
 
-			// Update the linked list (Insert infront of node)
-			if (dt->rd_next) 
-				dt->rd_next->rd_prev = curr_dt; 
-			
-			curr_dt->rd_next = dt->rd_next;
-			curr_dt->rd_prev = dt; 
+			dest->normal = normal;
 
-			dt->rd_next = curr_dt;	
+			dest->rgba[0] = MIN(col.mod_R, 255) / 255.0f;
+			dest->rgba[1] = MIN(col.mod_G, 255) / 255.0f;
+			dest->rgba[2] = MIN(col.mod_B, 255) / 255.0f;
+			dest->rgba[3] = trans;
 		}
-		
-		curr_dt = curr_dt->next;
+
+		RGL_EndUnit(4);
 	}
-	
-	// Find the first to draw
-	while(head_dt->rd_prev)
-		head_dt = head_dt->rd_prev;
+
+	RGL_FinishUnits();
+}
+
+
+//
+// DepthSortKey
+//
+// Maps a depth onto a key where larger depths sort first.  The
+// float's bits are reordered so that unsigned integer comparison
+// agrees with float comparison, no precision is lost.
+//
+static inline uint64_t DepthSortKey(float tz)
+{
+	uint32_t bits;
+	memcpy(&bits, &tz, sizeof(bits));
+
+	if (bits & 0x80000000)
+		bits = ~bits;
+	else
+		bits |= 0x80000000;
+
+	return (uint64_t)(~bits) << 32;
+}
+
+
+void RGL_DrawSortThings(drawfloor_t *dfloor)
+{
+	//
+	// Things are drawn far to near.  This used to insert each thing
+	// into an (unbalanced) binary tree, which degenerated into a
+	// linked list in crowded rooms.  Now each thing gets a depth key
+	// and the keys are radix sorted, which is linear in the number of
+	// things.  Ties keep the order of the drawfloor's list.
+	//
+	static std::vector<drawthing_t *> sort_things;
+	static std::vector<draw_sort_key_t> sort_keys;
+
+	// Check we have something to draw
+	if (! dfloor->things)
+		return;
+
+	sort_things.clear();
+
+	for (drawthing_t *dt = dfloor->things; dt; dt = dt->next)
+		sort_things.push_back(dt);
+
+	int count = (int)sort_things.size();
+
+	if ((int)sort_keys.size() < count)
+		sort_keys.resize(count);
+
+	for (int i = 0; i < count; i++)
+	{
+		sort_keys[i].key   = DepthSortKey(sort_things[i]->tz);
+		sort_keys[i].index = i;
+	}
+
+	RGL_RadixSort(sort_keys.data(), count);
 
 	// Draw...
-	for (dt=head_dt; dt; dt=dt->rd_next)
-		RGL_DrawThing(dfloor, dt);
+	for (int i = 0; i < count; i++)
+		RGL_DrawThing(dfloor, sort_things[sort_keys[i].index]);
 }
 
 
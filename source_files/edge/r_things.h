@@ -32,6 +32,7 @@
 
 void RGL_WalkThing(drawsub_c *dsub, mobj_t *mo);
 void RGL_DrawSortThings(drawfloor_t *dfloor);
+void RGL_DrawParticles(void);
 
 void RGL_DrawWeaponSprites(player_t * p);
 void RGL_DrawWeaponModel(player_t * p);
@@ -31,6 +31,7 @@
 #include "e_player.h"
 #include "m_argv.h"
 #include "r_gldefs.h"
+#include "r_glstate.h"
 #include "r_units.h"
 
 #include "r_misc.h"
@@ -58,9 +59,20 @@ DEF_CVAR(r_dumbmulti,     "0", 0)
 DEF_CVAR(r_dumbcombine,   "0", 0)
 DEF_CVAR(r_dumbclamp,     DUMB_CLAMP, 0)
 
+// when set, each flush uploads the batched vertices into a streamed
+// VBO and draws runs of identical state with one call, instead of
+// sending every vertex with immediate mode.
+DEF_CVAR(r_unitvbo,       "1", CVAR_ARCHIVE)
 
-#define MAX_L_VERT  65545
-#define MAX_L_UNIT  1024
+
+// the unit arena starts at the INIT sizes and grows (doubling) up to
+// the MAX sizes, so that normally a batch is only flushed when the
+// caller finishes it rather than half-way through a pass.
+#define INIT_L_VERT  65536
+#define INIT_L_UNIT  1024
+
+#define MAX_L_VERT  (INIT_L_VERT * 8)
+#define MAX_L_UNIT  (INIT_L_UNIT * 64)
 
 #define DUMMY_CLAMP  789
 
@@ -94,11 +106,18 @@ typedef struct local_gl_unit_s
 local_gl_unit_t;
 
 
-static local_gl_vert_t local_verts[MAX_L_VERT];
-static local_gl_unit_t local_units[MAX_L_UNIT];
+static std::vector<local_gl_vert_t> local_verts;
+static std::vector<local_gl_unit_t> local_units;
 
 static std::vector<local_gl_unit_t *> local_unit_map;
 
+// streaming vertex buffer, orphaned and refilled on every flush
+static GLuint units_vbo = 0;
+
+// scratch space for glMultiDrawArrays
+static std::vector<GLint>   run_firsts;
+static std::vector<GLsizei> run_counts;
+
 static int cur_vert;
 static int cur_unit;
 
@@ -116,6 +135,9 @@ GLfloat cull_fog_color[4];
 //
 void RGL_InitUnits(void)
 {
+	local_verts.resize(INIT_L_VERT);
+	local_units.resize(INIT_L_UNIT);
+
 	// Run the soft init code
 	RGL_SoftInitUnits();
 }
@@ -145,7 +167,7 @@ void RGL_StartUnits(bool sort_em)
 
 	batch_sort = sort_em;
 
-	local_unit_map.resize(MAX_L_UNIT);
+	local_unit_map.resize(local_units.size());
 }
 
 //
@@ -182,13 +204,31 @@ local_gl_vert_t *RGL_BeginUnit(GLuint shape, int max_vert,
 
 	SYS_ASSERT((blending & BL_CULL_BOTH) != BL_CULL_BOTH);
 
-	// check we have enough space left
-	if (cur_vert + max_vert > MAX_L_VERT || cur_unit >= MAX_L_UNIT)
+	SYS_ASSERT(max_vert <= MAX_L_VERT);
+
+	// check we have enough space left, growing the arena when it
+	// is still below its limit and flushing otherwise.
+	if (cur_vert + max_vert > (int)local_verts.size() &&
+		local_verts.size() < MAX_L_VERT)
+	{
+		size_t want = MAX(local_verts.size() * 2, (size_t)(cur_vert + max_vert));
+
+		local_verts.resize(MIN(want, (size_t)MAX_L_VERT));
+	}
+
+	if (cur_unit >= (int)local_units.size() &&
+		local_units.size() < MAX_L_UNIT)
+	{
+		local_units.resize(local_units.size() * 2);
+	}
+
+	if (cur_vert + max_vert > (int)local_verts.size() ||
+		cur_unit >= (int)local_units.size())
 	{
 		RGL_DrawUnits();
 	}
 
-	unit = local_units + cur_unit;
+	unit = &local_units[cur_unit];
 
 	if (env1 == ENV_NONE) tex1 = 0;
 	if (env2 == ENV_NONE) tex2 = 0;
@@ -206,7 +246,7 @@ local_gl_vert_t *RGL_BeginUnit(GLuint shape, int max_vert,
 	unit->fog_color = fog_color;
 	unit->fog_density = fog_density;
 
-	return local_verts + cur_vert;
+	return &local_verts[cur_vert];
 }
 
 //
@@ -218,7 +258,7 @@ void RGL_EndUnit(int actual_vert)
 
 	SYS_ASSERT(actual_vert > 0);
 
-	unit = local_units + cur_unit;
+	unit = &local_units[cur_unit];
 
 	unit->count = actual_vert;
 
@@ -235,33 +275,126 @@ void RGL_EndUnit(int actual_vert)
 	cur_vert += actual_vert;
 	cur_unit++;
 
-	SYS_ASSERT(cur_vert <= MAX_L_VERT);
-	SYS_ASSERT(cur_unit <= MAX_L_UNIT);
+	SYS_ASSERT(cur_vert <= (int)local_verts.size());
+	SYS_ASSERT(cur_unit <= (int)local_units.size());
+}
+
+
+//
+// RGL_RadixSort
+//
+// Stable LSD radix sort of packed keys into ascending order, one
+// byte per pass.  Bytes which are the same in every key are skipped,
+// so the usual small keys only need a few passes.
+//
+void RGL_RadixSort(draw_sort_key_t *keys, int count)
+{
+	static std::vector<draw_sort_key_t> radix_temp;
+
+	if (count < 2)
+		return;
+
+	if ((int)radix_temp.size() < count)
+		radix_temp.resize(count);
+
+	draw_sort_key_t *src = keys;
+	draw_sort_key_t *dest = radix_temp.data();
+
+	int counts[256];
+
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		memset(counts, 0, sizeof(counts));
+
+		for (int i = 0; i < count; i++)
+			counts[(src[i].key >> shift) & 0xFF]++;
+
+		// all keys share this byte?
+		if (counts[(src[0].key >> shift) & 0xFF] == count)
+			continue;
+
+		int total = 0;
+
+		for (int b = 0; b < 256; b++)
+		{
+			int n = counts[b];
+			counts[b] = total;
+			total += n;
+		}
+
+		for (int i = 0; i < count; i++)
+			dest[counts[(src[i].key >> shift) & 0xFF]++] = src[i];
+
+		std::swap(src, dest);
+	}
+
+	if (src != keys)
+		memcpy(keys, src, count * sizeof(draw_sort_key_t));
 }
 
 
-struct Compare_Unit_pred
+static inline uint64_t EnvSortBits(GLuint env)
 {
-	inline bool operator() (const local_gl_unit_t *A, const local_gl_unit_t *B) const
+	switch (env)
 	{
-		if (A->pass != B->pass)
-			return A->pass < B->pass;
+		case ENV_NONE:     return 0;
+		case GL_MODULATE:  return 1;
+		case GL_DECAL:     return 2;
+		case GL_ADD:       return 3;
+		case GL_REPLACE:   return 4;
+		case uint32_t(ENV_SKIP_RGB): return 5;
+
+		default: return 7;
+	}
+}
+
+//
+// UnitSortKey
+//
+// Packs the render state of a unit into a key which orders units by
+// pass, then textures, then environments and blending.  Fields too
+// wide for their bits only group less tightly, since runs are still
+// checked with SameUnitState.  Returns false if the pass number does
+// not fit, as passes must be drawn in order.
+//
+static bool UnitSortKey(const local_gl_unit_t *unit, uint64_t *key)
+{
+	if (unit->pass < 0 || unit->pass > 0xFFFF)
+		return false;
 
-		if (A->tex[0] != B->tex[0])
-			return A->tex[0] < B->tex[0];
+	*key = ((uint64_t)unit->pass << 48) |
+		   ((uint64_t)(unit->tex[0] & 0xFFFF) << 32) |
+		   ((uint64_t)(unit->tex[1] & 0xFFFF) << 16) |
+		   (EnvSortBits(unit->env[0]) << 13) |
+		   (EnvSortBits(unit->env[1]) << 10) |
+		   (uint64_t)(unit->blending & 0x3FF);
 
-		if (A->tex[1] != B->tex[1])
-			return A->tex[1] < B->tex[1];
+	return true;
+}
+
+static void SortUnits(void)
+{
+	static std::vector<draw_sort_key_t> unit_keys;
 
-		if (A->env[0] != B->env[0])
-			return A->env[0] < B->env[0];
+	if ((int)unit_keys.size() < cur_unit)
+		unit_keys.resize(local_units.size());
 
-		if (A->env[1] != B->env[1])
-			return A->env[1] < B->env[1];
+	for (int i=0; i < cur_unit; i++)
+	{
+		unit_keys[i].index = i;
 
-		return A->blending < B->blending;
+		if (! UnitSortKey(&local_units[i], &unit_keys[i].key))
+		{
+			// absurd pass number, keep the original order
+			return;
+		}
 	}
-};
+
+	RGL_RadixSort(unit_keys.data(), cur_unit);
+
+	for (int i=0; i < cur_unit; i++)
+		local_unit_map[i] = & local_units[unit_keys[i].index];
+}
 
 static void EnableCustomEnv(GLuint env, bool enable)
 {
@@ -270,15 +403,15 @@ static void EnableCustomEnv(GLuint env, bool enable)
 		case uint32_t(ENV_SKIP_RGB):
 			if (enable)
 			{
-				glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
-				glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_REPLACE);
-				glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_PREVIOUS);
+				RGL_TexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
+				RGL_TexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_REPLACE);
+				RGL_TexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_PREVIOUS);
 			}
 			else
 			{
 				/* no need to modify TEXTURE_ENV_MODE */
-				glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
-				glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE);
+				RGL_TexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
+				RGL_TexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE);
 			}
 			break;
 
@@ -303,6 +436,115 @@ static inline void RGL_SendRawVector(const local_gl_vert_t *V)
 	glVertex3fv(reinterpret_cast<const GLfloat *>(&V->pos));
 }
 
+//
+// Returns true when two units can be drawn with the same GL state,
+// i.e. as part of a single draw call.
+//
+static inline bool SameUnitState(const local_gl_unit_t *A, const local_gl_unit_t *B)
+{
+	if (A->shape != B->shape || A->pass != B->pass || A->blending != B->blending)
+		return false;
+
+	if (A->tex[0] != B->tex[0] || A->tex[1] != B->tex[1] ||
+		A->env[0] != B->env[0] || A->env[1] != B->env[1])
+		return false;
+
+	if (A->fog_color != B->fog_color || !AlmostEquals(A->fog_density, B->fog_density))
+		return false;
+
+	// the alpha test reference comes from the first vertex
+	if ((A->blending & BL_Less) &&
+		local_verts[A->first].rgba[3] != local_verts[B->first].rgba[3])
+		return false;
+
+	return true;
+}
+
+static void UploadUnitVerts(void)
+{
+	if (units_vbo == 0)
+		glGenBuffers(1, &units_vbo);
+
+	glBindBuffer(GL_ARRAY_BUFFER, units_vbo);
+
+	// new storage each flush (orphaning the old), so the driver need
+	// not wait for the last flush to be consumed.  Only the vertices
+	// in use are sent, not the whole arena.
+	glBufferData(GL_ARRAY_BUFFER, cur_vert * sizeof(local_gl_vert_t), local_verts.data(), GL_STREAM_DRAW);
+
+	glVertexPointer(3, GL_FLOAT, sizeof(local_gl_vert_t), BUFFER_OFFSET(offsetof(local_gl_vert_t, pos.x)));
+	glColorPointer (4, GL_FLOAT, sizeof(local_gl_vert_t), BUFFER_OFFSET(offsetof(local_gl_vert_t, rgba)));
+	glNormalPointer(GL_FLOAT, sizeof(local_gl_vert_t), BUFFER_OFFSET(offsetof(local_gl_vert_t, normal.x)));
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+	glEnableClientState(GL_NORMAL_ARRAY);
+
+	for (int t=1; t >= 0; t--)
+	{
+		glClientActiveTexture(GL_TEXTURE0 + t);
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glTexCoordPointer(2, GL_FLOAT, sizeof(local_gl_vert_t), BUFFER_OFFSET(offsetof(local_gl_vert_t, texc) + t * sizeof(vec2_t)));
+	}
+}
+
+static void ReleaseUnitVerts(void)
+{
+	for (int t=1; t >= 0; t--)
+	{
+		glClientActiveTexture(GL_TEXTURE0 + t);
+		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	}
+
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_NORMAL_ARRAY);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+//
+// Draws the units [start, end) of the sorted unit map, which all
+// share the same state, using the vertices in the VBO.
+//
+static void DrawUnitRun(int start, int end)
+{
+	GLenum shape = local_unit_map[start]->shape;
+
+	if (end - start == 1)
+	{
+		const local_gl_unit_t *unit = local_unit_map[start];
+
+		glDrawArrays(shape, unit->first, unit->count);
+		return;
+	}
+
+	run_firsts.clear();
+	run_counts.clear();
+
+	for (int k = start; k < end; k++)
+	{
+		const local_gl_unit_t *unit = local_unit_map[k];
+
+		// merge units which directly follow each other in the vertex
+		// array, which is only valid for the independent primitives.
+		if (! run_firsts.empty() &&
+			(shape == GL_TRIANGLES || shape == GL_QUADS || shape == GL_LINES) &&
+			run_firsts.back() + run_counts.back() == unit->first)
+		{
+			run_counts.back() += unit->count;
+			continue;
+		}
+
+		run_firsts.push_back(unit->first);
+		run_counts.push_back(unit->count);
+	}
+
+	if (run_firsts.size() == 1)
+		glDrawArrays(shape, run_firsts[0], run_counts[0]);
+	else
+		glMultiDrawArrays(shape, run_firsts.data(), run_counts.data(), (GLsizei)run_firsts.size());
+}
+
 //
 // RGL_DrawUnits
 //
@@ -314,6 +556,9 @@ void RGL_DrawUnits(void)
 	if (cur_unit == 0)
 		return;
 
+	gl_stats.units    += cur_unit;
+	gl_stats.vertices += cur_vert;
+
 	GLuint active_tex[2] = { 0, 0 };
 	GLuint active_env[2] = { 0, 0 };
 
@@ -323,28 +568,34 @@ void RGL_DrawUnits(void)
 	rgbcol_t active_fog_rgb = RGB_NO_VALUE;
 	float active_fog_density = 0;
 
+	if ((int)local_unit_map.size() < cur_unit)
+		local_unit_map.resize(local_units.size());
+
 	for (int i=0; i < cur_unit; i++)
 		local_unit_map[i] = & local_units[i];
 
 	if (batch_sort)
-	{
-		std::sort(local_unit_map.begin(),
-				  local_unit_map.begin() + cur_unit,
-				  Compare_Unit_pred());
-	}
+		SortUnits();
 
 
-	glDisable(GL_TEXTURE_2D);
-	glDisable(GL_ALPHA_TEST);
-	glDisable(GL_BLEND);
+	// glMaterial has no vertex array equivalent, so that combination
+	// still goes through immediate mode.
+	bool use_vbo = r_unitvbo.d && (r_colormaterial.d || ! r_colorlighting.d);
 
-	glAlphaFunc(GL_GREATER, 0);
+	if (use_vbo)
+		UploadUnitVerts();
 
-	glPolygonOffset(0, 0);
+	RGL_Disable(GL_TEXTURE_2D);
+	RGL_Disable(GL_ALPHA_TEST);
+	RGL_Disable(GL_BLEND);
+
+	RGL_AlphaFunc(GL_GREATER, 0);
+
+	RGL_PolygonOffset(0, 0);
 
 	if (r_culling.d)
 	{
-		GLfloat fogColor[3];
+		GLfloat fogColor[4] = { 0, 0, 0, 1.0f };
 		switch (r_cullfog.d)
 		{
 			case 0:
@@ -375,21 +626,32 @@ void RGL_DrawUnits(void)
 				break;
 		}
 		glClearColor(fogColor[0],fogColor[1],fogColor[2],1.0f);
-		glFogi(GL_FOG_MODE, GL_LINEAR);
-		glFogfv(GL_FOG_COLOR, fogColor);
-		glFogf(GL_FOG_START, r_farclip.f - 750.0f);
-		glFogf(GL_FOG_END, r_farclip.f - 250.0f);
-		glEnable(GL_FOG);
+		RGL_Fogi(GL_FOG_MODE, GL_LINEAR);
+		RGL_Fogfv(GL_FOG_COLOR, fogColor);
+		RGL_Fogf(GL_FOG_START, r_farclip.f - 750.0f);
+		RGL_Fogf(GL_FOG_END, r_farclip.f - 250.0f);
+		RGL_Enable(GL_FOG);
 	}
 	else
-		glFogi(GL_FOG_MODE, GL_EXP); // if needed
+		RGL_Fogi(GL_FOG_MODE, GL_EXP); // if needed
 
-	for (int j=0; j < cur_unit; j++)
+	int run_end;
+
+	for (int j=0; j < cur_unit; j = run_end)
 	{
 		local_gl_unit_t *unit = local_unit_map[j];
 
 		SYS_ASSERT(unit->count > 0);
 
+		// find the run of units which can share a single draw call
+		run_end = j + 1;
+
+		if (use_vbo)
+		{
+			while (run_end < cur_unit && SameUnitState(unit, local_unit_map[run_end]))
+				run_end++;
+		}
+
 		// detect changes in texture/alpha/blending state
 
 		if (!r_culling.d && unit->fog_color != RGB_NO_VALUE)
@@ -403,26 +665,26 @@ void RGL_DrawUnits(void)
 				fc[2] = (float)RGB_BLU(active_fog_rgb)/255.0f;
 				fc[3] = 1.0f;
 				glClearColor(fc[0], fc[1], fc[2], 1.0f);
-				glFogfv(GL_FOG_COLOR, fc);
+				RGL_Fogfv(GL_FOG_COLOR, fc);
 			}
 			if (!AlmostEquals(unit->fog_density, active_fog_density))
 			{
 				active_fog_density = unit->fog_density;
-				glFogf(GL_FOG_DENSITY, std::log1p(active_fog_density));
+				RGL_Fogf(GL_FOG_DENSITY, std::log1p(active_fog_density));
 			}
 			if (active_fog_density > 0.00009f)
-				glEnable(GL_FOG);
+				RGL_Enable(GL_FOG);
 			else
-				glDisable(GL_FOG);
+				RGL_Disable(GL_FOG);
 		}
 		else if (!r_culling.d)
-			glDisable(GL_FOG);
+			RGL_Disable(GL_FOG);
 
 		if (active_pass != unit->pass)
 		{
 			active_pass = unit->pass;
 
-			glPolygonOffset(0, -active_pass);
+			RGL_PolygonOffset(0, -active_pass);
 		}
 
 		if ((active_blending ^ unit->blending) & (BL_Masked | BL_Less))
@@ -432,47 +694,47 @@ void RGL_DrawUnits(void)
 				// glAlphaFunc is updated below, because the alpha
 				// value can change from unit to unit while the
 				// BL_Less flag remains set.
-				glEnable(GL_ALPHA_TEST);
+				RGL_Enable(GL_ALPHA_TEST);
 			}
 			else if (unit->blending & BL_Masked)
 			{
-				glEnable(GL_ALPHA_TEST);
-				glAlphaFunc(GL_GREATER, 0);
+				RGL_Enable(GL_ALPHA_TEST);
+				RGL_AlphaFunc(GL_GREATER, 0);
 			}
 			else
-				glDisable(GL_ALPHA_TEST);
+				RGL_Disable(GL_ALPHA_TEST);
 		}
 
 		if ((active_blending ^ unit->blending) & (BL_Alpha | BL_Add))
 		{
 			if (unit->blending & BL_Add)
 			{
-				glEnable(GL_BLEND);
-				glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+				RGL_Enable(GL_BLEND);
+				RGL_BlendFunc(GL_SRC_ALPHA, GL_ONE);
 			}
 			else if (unit->blending & BL_Alpha)
 			{
-				glEnable(GL_BLEND);
-				glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+				RGL_Enable(GL_BLEND);
+				RGL_BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 			}
 			else
-				glDisable(GL_BLEND);
+				RGL_Disable(GL_BLEND);
 		}
 
 		if ((active_blending ^ unit->blending) & BL_CULL_BOTH)
 		{
 			if (unit->blending & BL_CULL_BOTH)
 			{
-				glEnable(GL_CULL_FACE);
-				glCullFace((unit->blending & BL_CullFront) ? GL_FRONT : GL_BACK);
+				RGL_Enable(GL_CULL_FACE);
+				RGL_CullFace((unit->blending & BL_CullFront) ? GL_FRONT : GL_BACK);
 			}
 			else
-				glDisable(GL_CULL_FACE);
+				RGL_Disable(GL_CULL_FACE);
 		}
 
 		if ((active_blending ^ unit->blending) & BL_NoZBuf)
 		{
-			glDepthMask((unit->blending & BL_NoZBuf) ? GL_FALSE : GL_TRUE);
+			RGL_DepthMask((unit->blending & BL_NoZBuf) ? GL_FALSE : GL_TRUE);
 		}
 
 		active_blending = unit->blending;
@@ -481,33 +743,33 @@ void RGL_DrawUnits(void)
 		{
 			// NOTE: assumes alpha is constant over whole polygon
 			float a = local_verts[unit->first].rgba[3];
-			glAlphaFunc(GL_GREATER, a * 0.66f);
+			RGL_AlphaFunc(GL_GREATER, a * 0.66f);
 		}
 
 		for (int t=1; t >= 0; t--)
 		{
 			if (active_tex[t] != unit->tex[t] || active_env[t] != unit->env[t])
 			{
-				glActiveTexture(GL_TEXTURE0 + t);
+				RGL_ActiveTexture(GL_TEXTURE0 + t);
 			}
 
 			if (r_culling.d)
 			{ 
 				if (unit->pass > 0)
-					glDisable(GL_FOG);
+					RGL_Disable(GL_FOG);
 				else
-					glEnable(GL_FOG);
+					RGL_Enable(GL_FOG);
 			}
 
 			if (active_tex[t] != unit->tex[t])
 			{
 				if (unit->tex[t] == 0)
-					glDisable(GL_TEXTURE_2D);
+					RGL_Disable(GL_TEXTURE_2D);
 				else if (active_tex[t] == 0)
-					glEnable(GL_TEXTURE_2D);
+					RGL_Enable(GL_TEXTURE_2D);
 
 				if (unit->tex[t] != 0)
-					glBindTexture(GL_TEXTURE_2D, unit->tex[t]);
+					RGL_BindTexture(GL_TEXTURE_2D, unit->tex[t]);
 
 				active_tex[t] = unit->tex[t];
 			}
@@ -526,7 +788,7 @@ void RGL_DrawUnits(void)
 					EnableCustomEnv(unit->env[t], true);
 				}
 				else if (unit->env[t] != ENV_NONE)
-					glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, unit->env[t]);
+					RGL_TexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, unit->env[t]);
 
 				active_env[t] = unit->env[t];
 			}
@@ -542,49 +804,61 @@ void RGL_DrawUnits(void)
 				r_dumbclamp.d ? GL_CLAMP : GL_CLAMP_TO_EDGE);
 		}
 
-		glBegin(unit->shape);
-
-		for (int v_idx=0; v_idx < unit->count; v_idx++)
+		if (use_vbo)
 		{
-			RGL_SendRawVector(local_verts + unit->first + v_idx);
+			DrawUnitRun(j, run_end);
 		}
+		else
+		{
+			glBegin(unit->shape);
 
-		glEnd();	
+			for (int v_idx=0; v_idx < unit->count; v_idx++)
+			{
+				RGL_SendRawVector(&local_verts[unit->first + v_idx]);
+			}
+
+			glEnd();
+		}
+
+		gl_stats.draw_calls++;
 
 		// restore the clamping mode
 		if (old_clamp != DUMMY_CLAMP)
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, old_clamp);
 	}
 
+	if (use_vbo)
+		ReleaseUnitVerts();
+
 	// all done
 	cur_vert = cur_unit = 0;
 
-	glPolygonOffset(0, 0);
+	RGL_PolygonOffset(0, 0);
 
 	for (int t=1; t >=0; t--)
 	{
-		glActiveTexture(GL_TEXTURE0 + t);
+		RGL_ActiveTexture(GL_TEXTURE0 + t);
 
 		if (active_env[t] >= CUSTOM_ENV_BEGIN &&
 			active_env[t] <= CUSTOM_ENV_END)
 		{
 			EnableCustomEnv(active_env[t], false);
 		}
-		glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-		glDisable(GL_TEXTURE_2D);
+		RGL_TexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+		RGL_Disable(GL_TEXTURE_2D);
 	}
 
-	glDisable(GL_FOG);
+	RGL_Disable(GL_FOG);
 
-	glDepthMask(GL_TRUE);
-	glCullFace(GL_BACK);
+	RGL_DepthMask(GL_TRUE);
+	RGL_CullFace(GL_BACK);
 
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glAlphaFunc(GL_GREATER, 0);
+	RGL_BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	RGL_AlphaFunc(GL_GREATER, 0);
 
-	glDisable(GL_ALPHA_TEST);
-	glDisable(GL_BLEND);
-	glDisable(GL_CULL_FACE);
+	RGL_Disable(GL_ALPHA_TEST);
+	RGL_Disable(GL_BLEND);
+	RGL_Disable(GL_CULL_FACE);
 }
 
 
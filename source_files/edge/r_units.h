@@ -91,6 +91,16 @@ local_gl_vert_t *RGL_BeginUnit(GLuint shape, int max_vert,
 							   rgbcol_t fog_color = RGB_NO_VALUE, float fog_density = 0);
 void RGL_EndUnit(int actual_vert);
 
+// a packed sort key and the index of the item it belongs to
+typedef struct draw_sort_key_s
+{
+	uint64_t key;
+	int index;
+}
+draw_sort_key_t;
+
+void RGL_RadixSort(draw_sort_key_t *keys, int count);
+
 
 #endif /* __R_UNITS_H__ */
 
@@ -27,7 +27,12 @@
 
 #include "types.h"
 #include "endianess.h"
+#include "file.h"
+#include "filesystem.h"
 #include "image_data.h"
+#include "math_md5.h"
+#include "path.h"
+#include "str_util.h"
 
 #include "ec_voxelib.h"
 
@@ -35,6 +40,7 @@
 #include "g_game.h" // currmap
 #include "r_voxel.h"
 #include "r_gldefs.h"
+#include "r_glstate.h"
 #include "r_colormap.h"
 #include "r_effects.h"
 #include "r_image.h"
@@ -45,7 +51,9 @@
 #include "r_units.h"
 #include "p_blockmap.h"
 #include "r_texgl.h"
+#include "version.h"
 
+#include <map>
 #include <vector>
 
 extern float P_ApproxDistance(float dx, float dy, float dz);
@@ -63,22 +71,6 @@ struct vxl_vertex_c
 	float nx, ny, nz; // normals
 };
 
-std::vector<vxl_vertex_c> voxel_verts;
-
-void ec_voxelib_callback(u32_t v0, u32_t v1, u32_t v2, void *udata)
-{
-	GLVoxelMesh *mesh = (GLVoxelMesh *)udata;
-	voxel_verts.push_back({mesh->vertices[v0].y, -mesh->vertices[v0].x, mesh->vertices[v0].z,
-	mesh->vertices[v0].s, mesh->vertices[v0].t,
-	mesh->vertices[v0].nx, mesh->vertices[v0].ny, mesh->vertices[v0].nz});
-	voxel_verts.push_back({mesh->vertices[v1].y, -mesh->vertices[v1].x, mesh->vertices[v1].z,
-	mesh->vertices[v1].s, mesh->vertices[v1].t,
-	mesh->vertices[v1].nx, mesh->vertices[v1].ny, mesh->vertices[v1].nz});
-	voxel_verts.push_back({mesh->vertices[v2].y, -mesh->vertices[v2].x, mesh->vertices[v2].z,
-	mesh->vertices[v2].s, mesh->vertices[v2].t,
-	mesh->vertices[v2].nx, mesh->vertices[v2].ny, mesh->vertices[v2].nz});
-};
-
 struct vxl_frame_c
 {
 	vxl_vertex_c *vertices;
@@ -147,59 +139,458 @@ public:
 
 /*============== LOADING CODE ====================*/
 
+#define VXL_CACHE_MAGIC  "EDGEVXM1"
+
+// skins bigger than this in a cache file are taken as damage
+#define VXL_CACHE_MAXSKIN  4096
+
+// the result of meshing a voxel file, before anything is given to GL
+typedef struct
+{
+	std::vector<vxl_vertex_c> verts;
+
+	int skin_width;
+	int skin_height;
+
+	// RGBA pixels
+	std::vector<u32_t> skin;
+}
+vxl_mesh_t;
+
+typedef struct
+{
+	GLVoxelMesh *glvmesh;
+
+	std::vector<vxl_vertex_c> *verts;
+}
+vxl_triangle_data_t;
+
+// meshes made by VXL_PrepareModels, waiting for VXL_LoadModel
+static std::map<std::string, vxl_mesh_t *> prepared_meshes;
+
+
+static void ec_voxelib_callback(u32_t v0, u32_t v1, u32_t v2, void *udata)
+{
+	vxl_triangle_data_t *data = (vxl_triangle_data_t *)udata;
+
+	const u32_t idx[3] = { v0, v1, v2 };
+
+	for (int k = 0; k < 3; k++)
+	{
+		const VVoxVertexEx& v = data->glvmesh->vertices[idx[k]];
+
+		data->verts->push_back({ v.y, -v.x, v.z, v.s, v.t, v.nx, v.ny, v.nz });
+	}
+}
+
+
+static void VXL_DefaultPalette(uint8_t *pal)
+{
+	for (int cidx = 0; cidx < 256; ++cidx)
+	{
+		pal[cidx*3+0] = playpal_data[0][cidx][0];
+		pal[cidx*3+1] = playpal_data[0][cidx][1];
+		pal[cidx*3+2] = playpal_data[0][cidx][2];
+	}
+}
+
+
+//
+// The mesh depends on the voxel data, the palette (for voxels without
+// one of their own) and the meshing code, hence the engine version.
+//
+static std::string VXL_MeshKey(const byte *data, int length, const uint8_t *pal)
+{
+	std::vector<byte> buffer(data, data + length);
+
+	buffer.insert(buffer.end(), pal, pal + 768);
+
+	epi::md5hash_c md5(buffer.data(), (unsigned int)buffer.size());
+
+	std::string key;
+
+	for (int i = 0 ; i < 16 ; i++)
+		key += epi::STR_Format("%02x", md5.hash[i]);
+
+	return key;
+}
+
+
+static std::filesystem::path VXL_CacheFilename(const std::string& key)
+{
+	std::string name = "vxl-";
+
+	name += key;
+	name += "-";
+	name += edgeversion.s;
+	name += ".vxm";
+
+	return epi::PATH_Join(cache_dir, name);
+}
+
+
+static bool VXL_ReadS32(epi::file_c *F, int *value)
+{
+	s32_t raw;
+
+	if (F->Read(&raw, 4) != 4)
+		return false;
+
+	*value = EPI_LE_S32(raw);
+	return true;
+}
+
+
+static void VXL_WriteS32(epi::file_c *F, int value)
+{
+	s32_t raw = EPI_LE_S32(value);
+
+	F->Write(&raw, 4);
+}
+
+
+//
+// Returns false if the file is missing or damaged.  The file is only
+// ever read on the machine which wrote it, so the floats and pixels
+// are kept in native order.
+//
+static bool VXL_LoadMeshCache(const std::filesystem::path& filename, vxl_mesh_t *mesh)
+{
+	if (cache_dir.empty() || ! epi::FS_Access(filename, epi::file_c::ACCESS_READ))
+		return false;
+
+	epi::file_c *F = epi::FS_Open(filename, epi::file_c::ACCESS_READ | epi::file_c::ACCESS_BINARY);
+	if (F == NULL)
+		return false;
+
+	char magic[8];
+	int  num_verts, width, height;
+
+	bool ok = (F->Read(magic, 8) == 8) &&
+		(memcmp(magic, VXL_CACHE_MAGIC, 8) == 0) &&
+		VXL_ReadS32(F, &num_verts) &&
+		VXL_ReadS32(F, &width) &&
+		VXL_ReadS32(F, &height);
+
+	ok = ok && num_verts >= 0 && (num_verts % 3) == 0 &&
+		width  > 0 && width  <= VXL_CACHE_MAXSKIN &&
+		height > 0 && height <= VXL_CACHE_MAXSKIN;
+
+	ok = ok && F->GetLength() == 20 + num_verts * (int)sizeof(vxl_vertex_c) + width * height * 4;
+
+	if (ok)
+	{
+		mesh->verts.resize(num_verts);
+		mesh->skin.resize(width * height);
+
+		mesh->skin_width  = width;
+		mesh->skin_height = height;
+
+		unsigned int vert_size = num_verts * sizeof(vxl_vertex_c);
+		unsigned int skin_size = width * height * 4;
+
+		ok = (F->Read(mesh->verts.data(), vert_size) == vert_size) &&
+			(F->Read(mesh->skin.data(), skin_size) == skin_size);
+	}
+
+	delete F;
+
+	return ok;
+}
+
+
+static void VXL_SaveMeshCache(const std::filesystem::path& filename, const vxl_mesh_t *mesh)
+{
+	if (cache_dir.empty())
+		return;
+
+	epi::file_c *F = epi::FS_Open(filename, epi::file_c::ACCESS_WRITE | epi::file_c::ACCESS_BINARY);
+	if (F == NULL)
+	{
+		I_Warning("Unable to write voxel cache file: %s\n", filename.u8string().c_str());
+		return;
+	}
+
+	F->Write(VXL_CACHE_MAGIC, 8);
+
+	VXL_WriteS32(F, (int)mesh->verts.size());
+	VXL_WriteS32(F, mesh->skin_width);
+	VXL_WriteS32(F, mesh->skin_height);
+
+	F->Write(mesh->verts.data(), (unsigned int)(mesh->verts.size() * sizeof(vxl_vertex_c)));
+	F->Write(mesh->skin.data(),  (unsigned int)(mesh->skin.size() * 4));
+
+	delete F;
+
+	epi::FS_Sync();
+}
+
+
+//
+// voxelib expects its fatal error hook never to return.  Meshes may
+// be built on an I_RunParallel worker, where I_Error cannot be used,
+// so the message is thrown back to VXL_BuildMesh instead and the
+// caller reports it from the main thread.
+//
+class voxlib_error_c
+{
+public:
+	std::string message;
+
+public:
+	voxlib_error_c(const char *msg) : message(msg)
+	{ }
+};
+
+static void VXL_FatalHook(const char *msg)
+{
+	throw voxlib_error_c(msg);
+}
+
+static void VXL_MessageHook(VoxLibMsg type, const char *msg)
+{
+	I_Debugf("voxelib%s: %s\n", (type == VoxLibMsg_Error) ? " error" : "", msg);
+}
+
+static void VXL_InstallHooks(void)
+{
+	voxlib_fatal   = VXL_FatalHook;
+	voxlib_message = VXL_MessageHook;
+}
+
+
+//
+// Runs the voxelib pipeline.  Apart from debug messages this does not
+// touch any engine state, so several meshes can be built at once on
+// different threads.  Returns false if the voxel data could not be
+// loaded.
+//
+static bool VXL_DoBuildMesh(const byte *data, int length, const uint8_t *pal, vxl_mesh_t *mesh)
+{
+	VoxMemByteStream mst;
+	VoxelData vox;
+	VoxByteStream *xst = vox_InitMemoryStream(&mst, data, length);
+
+	if (!vox_loadModel(*xst, vox, pal))
+		return false;
+
+	bool doHollowFill = true;
+	bool fixTJunctions = false;
+	const uint32_t BreakIndex = 123456789;
+	int optLevel = 4;
+
+	vox.optimise(doHollowFill);
+
+	vox.cz = 0.0f; // otherwise loaded voxel will have (0,0,0) at its center
+	VoxelMesh vmesh;
+	vmesh.createFrom(vox, optLevel);
+	vox.clear();
+
+	GLVoxelMesh glvmesh;
+	glvmesh.create(vmesh, fixTJunctions, BreakIndex);
+	vmesh.clear();
+
+	vxl_triangle_data_t tri_data;
+
+	tri_data.glvmesh = &glvmesh;
+	tri_data.verts   = &mesh->verts;
+
+	glvmesh.createTriangles(&ec_voxelib_callback, (void *)&tri_data);
+
+	mesh->skin_width  = glvmesh.imgWidth;
+	mesh->skin_height = glvmesh.imgHeight;
+
+	const u32_t *pixels = glvmesh.img.ptr();
+
+	mesh->skin.assign(pixels, pixels + mesh->skin_width * mesh->skin_height);
+
+	glvmesh.clear();
+
+	return true;
+}
+
+// as above, but when voxelib hits a fatal error the reason is stored
+// in 'error'.
+static bool VXL_BuildMesh(const byte *data, int length, const uint8_t *pal,
+						  vxl_mesh_t *mesh, std::string& error)
+{
+	try
+	{
+		return VXL_DoBuildMesh(data, length, pal, mesh);
+	}
+	catch (const voxlib_error_c& err)
+	{
+		error = err.message;
+		return false;
+	}
+}
+
+
+typedef struct
+{
+	std::vector<byte *> data;
+	std::vector<int> length;
+	std::vector<vxl_mesh_t *> mesh;
+	std::vector<byte> ok;
+	std::vector<std::string> error;
+
+	uint8_t pal[768];
+}
+vxl_prepare_job_t;
+
+static void VXL_PrepareWorker(int index, void *ptr)
+{
+	vxl_prepare_job_t *job = (vxl_prepare_job_t *)ptr;
+
+	job->ok[index] = VXL_BuildMesh(job->data[index], job->length[index], job->pal,
+		                           job->mesh[index], job->error[index]) ? 1 : 0;
+}
+
+
+void VXL_PrepareModels(const std::vector<epi::file_c *>& files)
+{
+	vxl_prepare_job_t job;
+
+	VXL_InstallHooks();
+
+	VXL_DefaultPalette(job.pal);
+
+	std::vector<std::string> keys;
+
+	for (epi::file_c *f : files)
+	{
+		int length = f->GetLength();
+
+		if (length < 4)
+			continue;
+
+		byte *data = f->LoadIntoMemory();
+
+		if (! data)
+			continue;
+
+		std::string key = VXL_MeshKey(data, length, job.pal);
+
+		bool seen = prepared_meshes.find(key) != prepared_meshes.end();
+
+		for (const std::string& other : keys)
+			if (other == key)
+				seen = true;
+
+		// cached meshes are cheap, VXL_LoadModel will read them
+		if (seen || epi::FS_Access(VXL_CacheFilename(key), epi::file_c::ACCESS_READ))
+		{
+			delete[] data;
+			continue;
+		}
+
+		keys.push_back(key);
+
+		job.data.push_back(data);
+		job.length.push_back(length);
+		job.mesh.push_back(new vxl_mesh_t);
+		job.ok.push_back(0);
+		job.error.push_back(std::string());
+	}
+
+	if (keys.empty())
+		return;
+
+	I_Debugf("VXL_PrepareModels: meshing %d voxel models\n", (int)keys.size());
+
+	I_RunParallel((int)keys.size(), VXL_PrepareWorker, &job);
+
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		delete[] job.data[i];
+
+		if (! job.error[i].empty())
+			I_Error("VXL_PrepareModels: Failed to load voxel model: %s\n", job.error[i].c_str());
+
+		// other failures are left for VXL_LoadModel to report
+		if (! job.ok[i])
+		{
+			delete job.mesh[i];
+			continue;
+		}
+
+		VXL_SaveMeshCache(VXL_CacheFilename(keys[i]), job.mesh[i]);
+
+		prepared_meshes[keys[i]] = job.mesh[i];
+	}
+}
+
+
 vxl_model_c *VXL_LoadModel(epi::file_c *f, const char *name)
 {
 	int i;
 
-	voxel_verts.clear();
-
 	if (f->GetLength() < 4)
 	{
 		I_Error("VXL_LoadModel: Unable to load model!\n");
 		return nullptr; // Not reached
 	}
 
+	int length = f->GetLength();
+
 	u8_t *vox_data = f->LoadIntoMemory();
 
-	VoxMemByteStream mst;
-	VoxelData vox;
-    VoxByteStream *xst = vox_InitMemoryStream(&mst, vox_data, f->GetLength());
+	if (! vox_data)
+	{
+		I_Error("VXL_LoadModel: Unable to load model!\n");
+		return nullptr; // Not reached
+	}
 
 	uint8_t defpal[768];
-    for (int cidx = 0; cidx < 256; ++cidx) 
-	{
-      defpal[cidx*3+0] = playpal_data[0][cidx][0];
-      defpal[cidx*3+1] = playpal_data[0][cidx][1];
-      defpal[cidx*3+2] = playpal_data[0][cidx][2];
-    }
 
-    if (!vox_loadModel(*xst, vox, defpal)) 
+	VXL_DefaultPalette(defpal);
+
+	std::string key = VXL_MeshKey(vox_data, length, defpal);
+
+	vxl_mesh_t *mesh;
+
+	auto prep = prepared_meshes.find(key);
+
+	if (prep != prepared_meshes.end())
 	{
-		I_Error("VXL_LoadModel: Failed to load voxel model!\n");
-		return nullptr; // not reached
+		mesh = prep->second;
+		prepared_meshes.erase(prep);
 	}
+	else
+	{
+		std::filesystem::path cache_name = VXL_CacheFilename(key);
 
-	bool doHollowFill = true;
-    bool fixTJunctions = false;
-    const uint32_t BreakIndex = 123456789;
-    int optLevel = 4;
+		mesh = new vxl_mesh_t;
 
-	vox.optimise(doHollowFill);
+		if (VXL_LoadMeshCache(cache_name, mesh))
+		{
+			I_Debugf("VXL_LoadModel: using cached mesh: %s\n", cache_name.u8string().c_str());
+		}
+		else
+		{
+			mesh->verts.clear();
 
-	vox.cz = 0.0f; // otherwise loaded voxel will have (0,0,0) at its center
-    VoxelMesh vmesh;
-    vmesh.createFrom(vox, optLevel);
-    vox.clear();
+			std::string error;
 
-	GLVoxelMesh glvmesh;
-    glvmesh.create(vmesh, fixTJunctions, BreakIndex);
-    vmesh.clear();
+			VXL_InstallHooks();
 
-	// Populate voxel_verts vector
-	glvmesh.createTriangles(&ec_voxelib_callback, (void *)&glvmesh);
+			if (! VXL_BuildMesh(vox_data, length, defpal, mesh, error))
+			{
+				if (! error.empty())
+					I_Error("VXL_LoadModel: Failed to load voxel model: %s\n", error.c_str());
+
+				I_Error("VXL_LoadModel: Failed to load voxel model!\n");
+				return nullptr; // not reached
+			}
+
+			VXL_SaveMeshCache(cache_name, mesh);
+		}
+	}
+
+	delete[] vox_data;
 
 	int num_frames = 1;
-	int num_verts = voxel_verts.size();
+	int num_verts = (int)mesh->verts.size();
 	int num_tris = num_verts / 3;
 	int num_points = num_verts;
 
@@ -214,18 +605,18 @@ vxl_model_c *VXL_LoadModel(epi::file_c *f, const char *name)
 		md->nm_colors[i].Clear();
 	}
 
-	md->skin_width = glvmesh.imgWidth;
-	md->skin_height = glvmesh.imgHeight;
+	md->skin_width = mesh->skin_width;
+	md->skin_height = mesh->skin_height;
 	md->im_right = (float)md->skin_width / (float)W_MakeValidSize(md->skin_width);
 	md->im_top = (float)md->skin_height / (float)W_MakeValidSize(md->skin_height);
 
 	/* PARSE SKIN */
 
 	epi::image_data_c *tmp_img = new epi::image_data_c(md->skin_width, md->skin_height, 4);
-	tmp_img->pixels = (u8_t *)glvmesh.img.ptr();
+	tmp_img->pixels = (u8_t *)mesh->skin.data();
 	md->skin_id = R_UploadTexture(tmp_img, UPL_MipMap);
 	tmp_img->pixels = nullptr;
-	delete tmp_img; // pixels are cleaned up later with glvmesh closure
+	delete tmp_img; // pixels are cleaned up with the mesh
 
 	I_Debugf("  frames:%d  points:%d  tris: %d\n",
 			num_frames, num_tris * 3, num_tris);
@@ -249,7 +640,7 @@ vxl_model_c *VXL_LoadModel(epi::file_c *f, const char *name)
 
 		for (int j=0; j < 3; j++, point++)
 		{
-			vxl_vertex_c vert = voxel_verts[(i*3) + j];
+			vxl_vertex_c vert = mesh->verts[(i*3) + j];
 			point->vert_idx = i * 3 + j;
 			point->skin_s   = vert.s;
 			point->skin_t   = vert.t;
@@ -262,10 +653,10 @@ vxl_model_c *VXL_LoadModel(epi::file_c *f, const char *name)
 	SYS_ASSERT(point == md->points + md->num_points);
 
 	md->frame->vertices = new vxl_vertex_c[md->verts_per_frame];
-	std::copy(voxel_verts.begin(), voxel_verts.end(), md->frame->vertices);
+	std::copy(mesh->verts.begin(), mesh->verts.end(), md->frame->vertices);
+
+	delete mesh;
 
-	glvmesh.clear();
-	voxel_verts.clear();
 	glGenBuffers(1, &md->vbo);
 	if (md->vbo == 0)
 		I_Error("VXL_LoadModel: Failed to bind VBO!\n");
@@ -625,14 +1016,14 @@ void VXL_RenderModel(vxl_model_c *md, bool is_weapon,
 		fc[2] = (float)RGB_BLU(fc_to_use)/255.0f;
 		fc[3] = 1.0f;
 		glClearColor(fc[0], fc[1], fc[2], 1.0f);
-		glFogi(GL_FOG_MODE, GL_EXP);
-		glFogfv(GL_FOG_COLOR, fc);
-		glFogf(GL_FOG_DENSITY, std::log1p(fd_to_use));
-		glEnable(GL_FOG);
+		RGL_Fogi(GL_FOG_MODE, GL_EXP);
+		RGL_Fogfv(GL_FOG_COLOR, fc);
+		RGL_Fogf(GL_FOG_DENSITY, std::log1p(fd_to_use));
+		RGL_Enable(GL_FOG);
 	}
 	else if (r_culling.d)
 	{
-		GLfloat fogColor[3];
+		GLfloat fogColor[4] = { 0, 0, 0, 1.0f };
 		if (need_to_draw_sky)
 		{
 			switch (r_cullfog.d)
@@ -672,21 +1063,21 @@ void VXL_RenderModel(vxl_model_c *md, bool is_weapon,
 			fogColor[2] = 0;
 		}
 		glClearColor(fogColor[0],fogColor[1],fogColor[2],1.0f);
-		glFogi(GL_FOG_MODE, GL_LINEAR);
-		glFogfv(GL_FOG_COLOR, fogColor);
-		glFogf(GL_FOG_START, r_farclip.f - 750.0f);
-		glFogf(GL_FOG_END, r_farclip.f - 250.0f);
-		glEnable(GL_FOG);
+		RGL_Fogi(GL_FOG_MODE, GL_LINEAR);
+		RGL_Fogfv(GL_FOG_COLOR, fogColor);
+		RGL_Fogf(GL_FOG_START, r_farclip.f - 750.0f);
+		RGL_Fogf(GL_FOG_END, r_farclip.f - 250.0f);
+		RGL_Enable(GL_FOG);
 	}
 	else
-		glDisable(GL_FOG);
+		RGL_Disable(GL_FOG);
 	for (int pass = 0; pass < num_pass; pass++)
 	{
 		if (pass == 1)
 		{
 			blending &= ~BL_Alpha;
 			blending |=  BL_Add;
-			glDisable(GL_FOG);
+			RGL_Disable(GL_FOG);
 		}
 
 		data.is_additive = (pass > 0 && pass == num_pass-1);
@@ -703,78 +1094,78 @@ void VXL_RenderModel(vxl_model_c *md, bool is_weapon,
 				continue;
 		}
 
-		glPolygonOffset(0, -pass);
+		RGL_PolygonOffset(0, -pass);
 
 		if (blending & (BL_Masked | BL_Less))
 		{
 			if (blending & BL_Less)
 			{
-				glEnable(GL_ALPHA_TEST);
+				RGL_Enable(GL_ALPHA_TEST);
 			}
 			else if (blending & BL_Masked)
 			{
-				glEnable(GL_ALPHA_TEST);
-				glAlphaFunc(GL_GREATER, 0);
+				RGL_Enable(GL_ALPHA_TEST);
+				RGL_AlphaFunc(GL_GREATER, 0);
 			}
 			else
-				glDisable(GL_ALPHA_TEST);
+				RGL_Disable(GL_ALPHA_TEST);
 		}
 
 		if (blending & (BL_Alpha | BL_Add))
 		{
 			if (blending & BL_Add)
 			{
-				glEnable(GL_BLEND);
-				glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+				RGL_Enable(GL_BLEND);
+				RGL_BlendFunc(GL_SRC_ALPHA, GL_ONE);
 			}
 			else if (blending & BL_Alpha)
 			{
-				glEnable(GL_BLEND);
-				glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+				RGL_Enable(GL_BLEND);
+				RGL_BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 			}
 			else
-				glDisable(GL_BLEND);
+				RGL_Disable(GL_BLEND);
 		}
 
 		if (blending & BL_CULL_BOTH)
 		{
 			if (blending & BL_CULL_BOTH)
 			{
-				glEnable(GL_CULL_FACE);
-				glCullFace((blending & BL_CullFront) ? GL_FRONT : GL_BACK);
+				RGL_Enable(GL_CULL_FACE);
+				RGL_CullFace((blending & BL_CullFront) ? GL_FRONT : GL_BACK);
 			}
 			else
-				glDisable(GL_CULL_FACE);
+				RGL_Disable(GL_CULL_FACE);
 		}
 
 		if (blending & BL_NoZBuf)
 		{
-			glDepthMask((blending & BL_NoZBuf) ? GL_FALSE : GL_TRUE);
+			RGL_DepthMask((blending & BL_NoZBuf) ? GL_FALSE : GL_TRUE);
 		}
 
 		if (blending & BL_Less)
 		{
 			// NOTE: assumes alpha is constant over whole model
-			glAlphaFunc(GL_GREATER, trans * 0.66f);
+			RGL_AlphaFunc(GL_GREATER, trans * 0.66f);
 		}
 
-		glActiveTexture(GL_TEXTURE1);
-		glDisable(GL_TEXTURE_2D);
-		glActiveTexture(GL_TEXTURE0);
-		glEnable(GL_TEXTURE_2D);
-		glBindTexture(GL_TEXTURE_2D, skin_tex);
+		RGL_ActiveTexture(GL_TEXTURE1);
+		RGL_Disable(GL_TEXTURE_2D);
+		RGL_ActiveTexture(GL_TEXTURE0);
+		RGL_Enable(GL_TEXTURE_2D);
+		RGL_BindTexture(GL_TEXTURE_2D, skin_tex);
 
 		if (data.is_additive)
 		{
-			glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
-			glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_REPLACE);
-			glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_PREVIOUS);
+			RGL_TexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
+			RGL_TexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_REPLACE);
+			RGL_TexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_PREVIOUS);
 		}
 		else
 		{
-			glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-			glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
-			glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE);
+			RGL_TexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+			RGL_TexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
+			RGL_TexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE);
 		}
 
 		GLint old_clamp = 789;
@@ -819,23 +1210,26 @@ void VXL_RenderModel(vxl_model_c *md, bool is_weapon,
 
 		glDrawArrays(GL_TRIANGLES, 0, md->num_tris * 3);
 
+		gl_stats.draw_calls++;
+		gl_stats.vertices += md->num_tris * 3;
+
 		// restore the clamping mode
 		if (old_clamp != 789)
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, old_clamp);
 	}
-	glPolygonOffset(0, 0);
+	RGL_PolygonOffset(0, 0);
 
-	glDisable(GL_TEXTURE_2D);
+	RGL_Disable(GL_TEXTURE_2D);
 
-	glDepthMask(GL_TRUE);
-	glCullFace(GL_BACK);
+	RGL_DepthMask(GL_TRUE);
+	RGL_CullFace(GL_BACK);
 
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glAlphaFunc(GL_GREATER, 0);
+	RGL_BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	RGL_AlphaFunc(GL_GREATER, 0);
 
-	glDisable(GL_ALPHA_TEST);
-	glDisable(GL_BLEND);
-	glDisable(GL_CULL_FACE);
+	RGL_Disable(GL_ALPHA_TEST);
+	RGL_Disable(GL_BLEND);
+	RGL_Disable(GL_CULL_FACE);
 }
 
 
@@ -857,11 +1251,11 @@ void VXL_RenderModel_2D(vxl_model_c *md, float x, float y,
 	xscale = yscale * info->model_scale * info->model_aspect;
 	yscale = yscale * info->model_scale;
 
-	glEnable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, skin_tex);
+	RGL_Enable(GL_TEXTURE_2D);
+	RGL_BindTexture(GL_TEXTURE_2D, skin_tex);
  
-	glEnable(GL_BLEND);
-	glEnable(GL_CULL_FACE);
+	RGL_Enable(GL_BLEND);
+	RGL_Enable(GL_CULL_FACE);
 
 	if (info->flags & MF_FUZZY)
 		glColor4f(0, 0, 0, 0.5f);
@@ -902,9 +1296,9 @@ void VXL_RenderModel_2D(vxl_model_c *md, float x, float y,
 		glEnd();
 	}
 
-	glDisable(GL_BLEND);
-	glDisable(GL_TEXTURE_2D);
-	glDisable(GL_CULL_FACE);
+	RGL_Disable(GL_BLEND);
+	RGL_Disable(GL_TEXTURE_2D);
+	RGL_Disable(GL_CULL_FACE);
 }
 
 //--- editor settings ---
@@ -21,6 +21,8 @@
 
 #include "file.h"
 
+#include <vector>
+
 #include "r_defs.h"
 #include "p_mobj.h"
 
@@ -31,6 +33,11 @@ class vxl_model_c;
 
 vxl_model_c *VXL_LoadModel(epi::file_c *f, const char *name);
 
+// meshes the given voxel files on several threads (unless their
+// meshes are cached already), for the VXL_LoadModel calls to come.
+// The files are read to the end but not closed.
+void VXL_PrepareModels(const std::vector<epi::file_c *>& files);
+
 void VXL_RenderModel(vxl_model_c *md, bool is_weapon,
 		             float x, float y, float z, mobj_t *mo,
 					 region_properties_t *props,
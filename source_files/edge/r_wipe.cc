@@ -30,6 +30,7 @@
 
 #include "m_random.h"
 #include "r_gldefs.h"
+#include "r_glstate.h"
 #include "r_wipe.h"
 #include "r_image.h"
 #include "r_modes.h"
@@ -168,7 +169,7 @@ void RGL_StopWipe(void)
 
 	if (cur_wipe_tex != 0)
 	{
-		glDeleteTextures(1, &cur_wipe_tex);
+		RGL_DeleteTextures(1, &cur_wipe_tex);
 		cur_wipe_tex = 0;
 	}
 }
@@ -178,10 +179,10 @@ void RGL_StopWipe(void)
 
 static void RGL_Wipe_Fading(float how_far)
 {
-	glEnable(GL_TEXTURE_2D);
-	glEnable(GL_BLEND);
+	RGL_Enable(GL_TEXTURE_2D);
+	RGL_Enable(GL_BLEND);
 
-	glBindTexture(GL_TEXTURE_2D, cur_wipe_tex);
+	RGL_BindTexture(GL_TEXTURE_2D, cur_wipe_tex);
 	glColor4f(1.0f, 1.0f, 1.0f, 1.0f - how_far);
 
 	glBegin(GL_QUADS);
@@ -197,19 +198,19 @@ static void RGL_Wipe_Fading(float how_far)
 
 	glEnd();
 
-	glDisable(GL_BLEND);
-	glDisable(GL_TEXTURE_2D);
+	RGL_Disable(GL_BLEND);
+	RGL_Disable(GL_TEXTURE_2D);
 }
 
 static void RGL_Wipe_Pixelfade(float how_far)
 {
-	glEnable(GL_TEXTURE_2D);
-	glDisable(GL_BLEND);
-	glEnable(GL_ALPHA_TEST);
+	RGL_Enable(GL_TEXTURE_2D);
+	RGL_Disable(GL_BLEND);
+	RGL_Enable(GL_ALPHA_TEST);
 
-	glAlphaFunc(GL_GEQUAL, how_far);
+	RGL_AlphaFunc(GL_GEQUAL, how_far);
 
-	glBindTexture(GL_TEXTURE_2D, cur_wipe_tex);
+	RGL_BindTexture(GL_TEXTURE_2D, cur_wipe_tex);
 	glColor3f(1.0f, 1.0f, 1.0f);
 
 	glBegin(GL_QUADS);
@@ -225,19 +226,19 @@ static void RGL_Wipe_Pixelfade(float how_far)
 
 	glEnd();
 
-	glDisable(GL_ALPHA_TEST);
-	glDisable(GL_BLEND);
-	glDisable(GL_TEXTURE_2D);
+	RGL_Disable(GL_ALPHA_TEST);
+	RGL_Disable(GL_BLEND);
+	RGL_Disable(GL_TEXTURE_2D);
 
-	glAlphaFunc(GL_GREATER, 0);
+	RGL_AlphaFunc(GL_GREATER, 0);
 }
 
 static void RGL_Wipe_Melt(void)
 {
-	glEnable(GL_TEXTURE_2D);
-	glEnable(GL_BLEND);
+	RGL_Enable(GL_TEXTURE_2D);
+	RGL_Enable(GL_BLEND);
 
-	glBindTexture(GL_TEXTURE_2D, cur_wipe_tex);
+	RGL_BindTexture(GL_TEXTURE_2D, cur_wipe_tex);
 	glColor3f(1.0f, 1.0f, 1.0f);
 
 	glBegin(GL_QUAD_STRIP);
@@ -260,8 +261,8 @@ static void RGL_Wipe_Melt(void)
 
 	glEnd();
 
-	glDisable(GL_BLEND);
-	glDisable(GL_TEXTURE_2D);
+	RGL_Disable(GL_BLEND);
+	RGL_Disable(GL_TEXTURE_2D);
 }
 
 static void RGL_Wipe_Slide(float how_far, float dx, float dy)
@@ -269,10 +270,10 @@ static void RGL_Wipe_Slide(float how_far, float dx, float dy)
 	dx *= how_far;
 	dy *= how_far;
 
-	glEnable(GL_TEXTURE_2D);
-	glEnable(GL_BLEND);
+	RGL_Enable(GL_TEXTURE_2D);
+	RGL_Enable(GL_BLEND);
 
-	glBindTexture(GL_TEXTURE_2D, cur_wipe_tex);
+	RGL_BindTexture(GL_TEXTURE_2D, cur_wipe_tex);
 	glColor3f(1.0f, 1.0f, 1.0f);
 
 	glBegin(GL_QUADS);
@@ -288,8 +289,8 @@ static void RGL_Wipe_Slide(float how_far, float dx, float dy)
 
 	glEnd();
 
-	glDisable(GL_BLEND);
-	glDisable(GL_TEXTURE_2D);
+	RGL_Disable(GL_BLEND);
+	RGL_Disable(GL_TEXTURE_2D);
 }
 
 static void RGL_Wipe_Doors(float how_far)
@@ -297,10 +298,10 @@ static void RGL_Wipe_Doors(float how_far)
 	float dx = cos(how_far * M_PI / 2) * (SCREENWIDTH/2);
 	float dy = sin(how_far * M_PI / 2) * (SCREENHEIGHT/3);
 
-	glEnable(GL_TEXTURE_2D);
-	glEnable(GL_BLEND);
+	RGL_Enable(GL_TEXTURE_2D);
+	RGL_Enable(GL_BLEND);
 
-	glBindTexture(GL_TEXTURE_2D, cur_wipe_tex);
+	RGL_BindTexture(GL_TEXTURE_2D, cur_wipe_tex);
 	glColor3f(1.0f, 1.0f, 1.0f);
 
 	for (int column = 0; column < 5; column++)
@@ -339,8 +340,8 @@ static void RGL_Wipe_Doors(float how_far)
 		}
 	}
 
-	glDisable(GL_BLEND);
-	glDisable(GL_TEXTURE_2D);
+	RGL_Disable(GL_BLEND);
+	RGL_Disable(GL_TEXTURE_2D);
 }
 
 bool RGL_DoWipe(void)
@@ -38,6 +38,7 @@
 #include "rad_trig.h"
 #include "rad_act.h"
 #include "r_defs.h"
+#include "r_gldefs.h"
 #include "r_sky.h"
 #include "s_sound.h"
 #include "s_music.h"
@@ -424,14 +425,14 @@ void RAD_ActSpawnThing(rad_trigger_t *R, void *param)
 
 	mo->tag = t->tag;
 
-	mo->spawnpoint.x = t->x;
-	mo->spawnpoint.y = t->y;
-	mo->spawnpoint.z = t->z;
-	mo->spawnpoint.angle = t->angle;
-	mo->spawnpoint.vertangle = M_ATan(t->slope);
-	mo->spawnpoint.info = minfo;
-	mo->spawnpoint.flags = t->ambush ? MF_AMBUSH : 0;
-	mo->spawnpoint.tag = t->tag;
+	mo->cold->spawnpoint.x = t->x;
+	mo->cold->spawnpoint.y = t->y;
+	mo->cold->spawnpoint.z = t->z;
+	mo->cold->spawnpoint.angle = t->angle;
+	mo->cold->spawnpoint.vertangle = M_ATan(t->slope);
+	mo->cold->spawnpoint.info = minfo;
+	mo->cold->spawnpoint.flags = t->ambush ? MF_AMBUSH : 0;
+	mo->cold->spawnpoint.tag = t->tag;
 
 	if (t->ambush)
 		mo->flags |= MF_AMBUSH;
@@ -556,12 +557,10 @@ void RAD_ActDamageMonsters(rad_trigger_t *R, void *param)
 
 	player_t *player = GetWhoDunnit(R);
 
-	for (mo = mobjlisthead; mo != NULL; mo = next)
+	// when the type is known, only visit things of that type
+	for (mo = info ? P_MobjsOfType(info) : mobjlisthead; mo != NULL; mo = next)
 	{
-		next = mo->next;
-
-		if (info && mo->info != info)
-			continue;
+		next = info ? mo->typenext : mo->next;
 
 		if (tag && (mo->tag != tag))
 			continue;
@@ -604,12 +603,10 @@ void RAD_ActThingEvent(rad_trigger_t *R, void *param)
 	mobj_t *mo;
 	mobj_t *next;
 
-	for (mo = mobjlisthead; mo != NULL; mo = next)
+	// when the type is known, only visit things of that type
+	for (mo = info ? P_MobjsOfType(info) : mobjlisthead; mo != NULL; mo = next)
 	{
-		next = mo->next;
-
-		if (info && (mo->info != info))
-			continue;
+		next = info ? mo->typenext : mo->next;
 
 		if (tag && (mo->tag != tag))
 			continue;
@@ -815,6 +812,8 @@ void RAD_ActChangeTex(rad_trigger_t *R, void *param)
 		default:
 			break;
 		}
+
+		RGL_InvalidateLineWalls(&lines[i]);
 	}
 }
 
@@ -847,6 +846,8 @@ static void MoveOneSector(sector_t *sec, s_movesector_t *t)
 		return;
 
 	P_SolidSectorMove(sec, t->is_ceiling, dh);
+
+	RGL_InvalidateSectorWalls(sec);
 }
 
 void RAD_ActMoveSector(rad_trigger_t *R, void *param)
@@ -1147,34 +1148,29 @@ void RAD_ActWaitUntilDead(rad_trigger_t *R, void *param)
 	R->wud_tag = wud->tag;
 	R->wud_count = 0;
 
-	// find all matching monsters
-	mobj_t *mo;
-	mobj_t *next;
-
-	for (mo = mobjlisthead; mo != NULL; mo = next)
+	// find all matching monsters, checking the names once per type
+	for (auto& it : P_AllMobjTypes())
 	{
-		next = mo->next;
-
-		if (! mo->info)
+		if (! WUD_Match(wud, it.first->name.c_str()))
 			continue;
 
-		if (mo->health <= 0)
-			continue;
-
-		if (! WUD_Match(wud, mo->info->name.c_str()))
-			continue;
+		for (mobj_t *mo = it.second; mo != NULL; mo = mo->typenext)
+		{
+			if (mo->health <= 0)
+				continue;
 
-		if (! RAD_WithinRadius(mo, R->info))
-			continue;
+			if (! RAD_WithinRadius(mo, R->info))
+				continue;
 
-		// mark the monster
-		mo->hyperflags |= HF_WAIT_UNTIL_DEAD;
-		if (mo->wud_tags.empty())
-			mo->wud_tags = epi::STR_Format("%d", wud->tag);
-		else
-			mo->wud_tags = epi::STR_Format("%s,%d", mo->wud_tags.c_str(), wud->tag);
+			// mark the monster
+			mo->hyperflags |= HF_WAIT_UNTIL_DEAD;
+			if (mo->cold->wud_tags.empty())
+				mo->cold->wud_tags = epi::STR_Format("%d", wud->tag);
+			else
+				mo->cold->wud_tags = epi::STR_Format("%s,%d", mo->cold->wud_tags.c_str(), wud->tag);
 
-		R->wud_count++;
+			R->wud_count++;
+		}
 	}
 
 	if (R->wud_count == 0)
@@ -1396,7 +1392,7 @@ void P_ActReplace(struct mobj_s *mo, const mobjtype_c *newThing)
 
 	//P_UnsetThingPosition(mo);
 	{
-		mo->info = newThing;
+		P_SetMobjInfo(mo, newThing);
 
 		mo->radius = mo->info->radius;
 		mo->height = mo->info->height;
@@ -1421,8 +1417,8 @@ void P_ActReplace(struct mobj_s *mo, const mobjtype_c *newThing)
 
 		mo->vis_target    = PERCENT_2_FLOAT(mo->info->translucency);
 		mo->currentattack = NULL;
-		mo->model_skin    = mo->info->model_skin;
-		mo->model_last_frame = -1;
+		mo->cold->model_skin    = mo->info->model_skin;
+		mo->cold->model_last_frame = -1;
 
 		// handle dynamic lights
 		{
@@ -1494,13 +1490,11 @@ void RAD_ActReplaceThing(rad_trigger_t *R, void *param)
 	mobj_t *mo;
 	mobj_t *next;
 
-	for (mo = mobjlisthead; mo != NULL; mo = next)
+	// when the type is known, only visit things of that type.
+	// Note that P_ActReplace() moves the thing to another type list.
+	for (mo = oldThing ? P_MobjsOfType(oldThing) : mobjlisthead; mo != NULL; mo = next)
 	{
-		next = mo->next;
-
-		if (oldThing && mo->info != oldThing)
-			continue;
-
+		next = oldThing ? mo->typenext : mo->next;
 
 		if (! RAD_WithinRadius(mo, R->info))
 			continue;
@@ -1510,5 +1504,70 @@ void RAD_ActReplaceThing(rad_trigger_t *R, void *param)
 		 
 }
 
+
+//
+// Collects the images, sounds and thing types which the RTS scripts
+// for the given map can use, so that W_PrecacheLevel() can load them
+// before the level starts, rather than on first use.  This is done
+// before the triggers are spawned, hence the scripts are checked.
+//
+void RAD_GatherLevelAssets(const char *map_name,
+                           std::vector<const image_c *>& images,
+                           std::vector<sfx_t *>& sounds,
+                           std::vector<const mobjtype_c *>& things)
+{
+	for (rad_script_t *scr = r_scripts ; scr ; scr = scr->next)
+	{
+		// same test as RAD_SpawnTriggers
+		if (strcmp(map_name, scr->mapid) != 0 && strcmp(scr->mapid, "ALL") != 0)
+			continue;
+
+		for (rts_state_t *st = scr->first_state ; st ; st = st->next)
+		{
+			const image_c *image = NULL;
+
+			if (st->action == RAD_ActPlaySound)
+			{
+				s_sound_t *ambient = (s_sound_t *) st->param;
+
+				sounds.push_back(ambient->sfx);
+			}
+			else if (st->action == RAD_ActTip)
+			{
+				s_tip_t *tip = (s_tip_t *) st->param;
+
+				if (tip->tip_graphic)
+					image = W_ImageLookup(tip->tip_graphic, INS_Graphic, ILF_Null);
+			}
+			else if (st->action == RAD_ActChangeTex)
+			{
+				s_changetex_t *ctex = (s_changetex_t *) st->param;
+
+				if (ctex->what >= CHTEX_Floor)
+					image = W_ImageLookup(ctex->texname, INS_Flat, ILF_Null);
+				else
+					image = W_ImageLookup(ctex->texname, INS_Texture, ILF_Null);
+			}
+			else if (st->action == RAD_ActSpawnThing)
+			{
+				s_thing_t *t = (s_thing_t *) st->param;
+
+				const mobjtype_c *minfo;
+
+				if (t->thing_name)
+					minfo = mobjtypes.Lookup(t->thing_name);
+				else
+					minfo = mobjtypes.Lookup(t->thing_type);
+
+				if (minfo)
+					things.push_back(minfo);
+			}
+
+			if (image)
+				images.push_back(image);
+		}
+	}
+}
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
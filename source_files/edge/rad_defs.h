@@ -668,6 +668,13 @@ typedef struct rad_trigger_s
 
 	// prevent repeating scripts from clogging the console
 	const char *last_con_message = nullptr;
+
+	// position in active_triggers when the trigger grid was built,
+	// used to run the triggers of a tic in list order.
+	int list_pos = 0;
+
+	// last RAD_RunTriggers() pass which queued this trigger
+	int visit_mark = 0;
 }
 rad_trigger_t;
 
@@ -34,6 +34,11 @@
 
 #include "i_defs.h"
 
+#include <float.h>
+
+#include <algorithm>
+#include <vector>
+
 #include "file.h"
 #include "filesystem.h"
 #include "str_util.h"
@@ -68,6 +73,26 @@ rad_script_t *r_scripts = NULL;
 // Dynamic Triggers.  These only exist for the current level.
 rad_trigger_t *active_triggers = NULL;
 
+// Trigger grid.  Triggers with a bounded area are bucketed by the
+// cells their area covers, so each tic only those near a player need
+// to be visited.  Triggers which must be checked every tic regardless
+// (immediate, unbounded) are kept in a separate list, and so are
+// triggers which became "awake" by being independent-and-activated
+// or counting a repeat delay.
+#define RTS_GRID_UNIT   512.0f
+#define RTS_GRID_MAX    256
+
+static std::vector< std::vector<rad_trigger_t *> > trig_grid;
+
+static float trig_grid_x, trig_grid_y;
+static float trig_grid_unit = RTS_GRID_UNIT;
+static int   trig_grid_w, trig_grid_h;
+
+static std::vector<rad_trigger_t *> unbounded_triggers;
+static std::vector<rad_trigger_t *> awake_triggers;
+
+static int trig_visit_mark = 0;
+
 class rts_menu_c
 {
 private:
@@ -556,12 +581,12 @@ static bool RAD_CheckBossTrig(rad_trigger_t *trig, s_ondeath_t *cond)
 		}
 	}
 
+	if (seen_monsters.count(cond->cached_info) == 0) return false; // Never on map?
+
 	// scan the remaining mobjs to see if all bosses are dead
-	for (mo=mobjlisthead; mo != NULL; mo=mo->next)
+	for (mo=P_MobjsOfType(cond->cached_info); mo != NULL; mo=mo->typenext)
 	{
-		if (seen_monsters.count(cond->cached_info) == 0) return false; // Never on map?
-
-		if (mo->info == cond->cached_info && mo->health > 0)
+		if (mo->health > 0)
 		{
 			count++;
 
@@ -660,8 +685,195 @@ bool RAD_CheckReachedTrigger(mobj_t * thing)
 	return true;
 }
 
+static bool TriggerIsUnbounded(const rad_trigger_t *trig)
+{
+	return trig->info->tagged_immediate ||
+		trig->info->rad_x < 0 || trig->info->rad_y < 0;
+}
+
+
+static bool TriggerIsAwake(const rad_trigger_t *trig)
+{
+	return (trig->info->tagged_independent && trig->activated) ||
+		trig->repeat_delay > 0;
+}
+
+
+static void TriggerGridCell(float x, float y, int *cx, int *cy)
+{
+	*cx = (int)floor((x - trig_grid_x) / trig_grid_unit);
+	*cy = (int)floor((y - trig_grid_y) / trig_grid_unit);
+
+	*cx = CLAMP(0, *cx, trig_grid_w - 1);
+	*cy = CLAMP(0, *cy, trig_grid_h - 1);
+}
+
+
+static void RemoveFromList(std::vector<rad_trigger_t *>& list, rad_trigger_t *trig)
+{
+	auto it = std::find(list.begin(), list.end(), trig);
+
+	if (it != list.end())
+		list.erase(it);
+}
+
+
+static void RemoveFromTriggerGrid(rad_trigger_t *trig)
+{
+	RemoveFromList(awake_triggers, trig);
+
+	if (TriggerIsUnbounded(trig))
+	{
+		RemoveFromList(unbounded_triggers, trig);
+		return;
+	}
+
+	if (trig_grid.empty())
+		return;
+
+	int x1, y1, x2, y2;
+
+	TriggerGridCell(trig->info->x - trig->info->rad_x, trig->info->y - trig->info->rad_y, &x1, &y1);
+	TriggerGridCell(trig->info->x + trig->info->rad_x, trig->info->y + trig->info->rad_y, &x2, &y2);
+
+	for (int cy = y1 ; cy <= y2 ; cy++)
+	for (int cx = x1 ; cx <= x2 ; cx++)
+		RemoveFromList(trig_grid[cy * trig_grid_w + cx], trig);
+}
+
+
+static void ClearTriggerGrid(void)
+{
+	trig_grid.clear();
+	unbounded_triggers.clear();
+	awake_triggers.clear();
+
+	trig_grid_w = trig_grid_h = 0;
+}
+
+
+//
+// RAD_BuildTriggerGrid
+//
+// Must be called whenever active_triggers has been (re)created, i.e.
+// after spawning the triggers for a level and after loading a game.
+//
+void RAD_BuildTriggerGrid(void)
+{
+	ClearTriggerGrid();
+
+	float min_x =  FLT_MAX, min_y =  FLT_MAX;
+	float max_x = -FLT_MAX, max_y = -FLT_MAX;
+
+	int pos = 0;
+
+	for (rad_trigger_t *trig = active_triggers ; trig ; trig = trig->next, pos++)
+	{
+		trig->list_pos   = pos;
+		trig->visit_mark = 0;
+
+		if (TriggerIsAwake(trig))
+			awake_triggers.push_back(trig);
+
+		if (TriggerIsUnbounded(trig))
+		{
+			unbounded_triggers.push_back(trig);
+			continue;
+		}
+
+		min_x = MIN(min_x, trig->info->x - trig->info->rad_x);
+		min_y = MIN(min_y, trig->info->y - trig->info->rad_y);
+		max_x = MAX(max_x, trig->info->x + trig->info->rad_x);
+		max_y = MAX(max_y, trig->info->y + trig->info->rad_y);
+	}
+
+	if (min_x > max_x)  // no bounded triggers
+		return;
+
+	// keep the grid a sane size on huge (or sparse) maps
+	trig_grid_unit = MAX(RTS_GRID_UNIT, MAX(max_x - min_x, max_y - min_y) / RTS_GRID_MAX);
+
+	trig_grid_x = min_x;
+	trig_grid_y = min_y;
+	trig_grid_w = 1 + (int)((max_x - min_x) / trig_grid_unit);
+	trig_grid_h = 1 + (int)((max_y - min_y) / trig_grid_unit);
+
+	trig_grid.resize(trig_grid_w * trig_grid_h);
+
+	for (rad_trigger_t *trig = active_triggers ; trig ; trig = trig->next)
+	{
+		if (TriggerIsUnbounded(trig))
+			continue;
+
+		int x1, y1, x2, y2;
+
+		TriggerGridCell(trig->info->x - trig->info->rad_x, trig->info->y - trig->info->rad_y, &x1, &y1);
+		TriggerGridCell(trig->info->x + trig->info->rad_x, trig->info->y + trig->info->rad_y, &x2, &y2);
+
+		for (int cy = y1 ; cy <= y2 ; cy++)
+		for (int cx = x1 ; cx <= x2 ; cx++)
+			trig_grid[cy * trig_grid_w + cx].push_back(trig);
+	}
+}
+
+
+static void QueueTrigger(std::vector<rad_trigger_t *>& queue, rad_trigger_t *trig)
+{
+	if (trig->visit_mark == trig_visit_mark)
+		return;
+
+	trig->visit_mark = trig_visit_mark;
+	queue.push_back(trig);
+}
+
+
+//
+// Collects the triggers which may do something this tic: unbounded
+// and awake triggers, plus the bounded ones in grid cells touched by
+// a living player.  A bounded trigger with no player in its area
+// never gets past the radius check, so skipping it changes nothing.
+// The result is sorted into active_triggers order.
+//
+static void CollectTriggers(std::vector<rad_trigger_t *>& queue)
+{
+	trig_visit_mark++;
+
+	for (auto trig : unbounded_triggers)
+		QueueTrigger(queue, trig);
+
+	for (auto trig : awake_triggers)
+		QueueTrigger(queue, trig);
+
+	if (! trig_grid.empty())
+	{
+		for (int pnum = 0; pnum < MAXPLAYERS; pnum++)
+		{
+			player_t *p = players[pnum];
+
+			if (! p || ! p->mo || p->playerstate == PST_DEAD)
+				continue;
+
+			int x1, y1, x2, y2;
+
+			TriggerGridCell(p->mo->x - p->mo->radius, p->mo->y - p->mo->radius, &x1, &y1);
+			TriggerGridCell(p->mo->x + p->mo->radius, p->mo->y + p->mo->radius, &x2, &y2);
+
+			for (int cy = y1 ; cy <= y2 ; cy++)
+			for (int cx = x1 ; cx <= x2 ; cx++)
+				for (auto trig : trig_grid[cy * trig_grid_w + cx])
+					QueueTrigger(queue, trig);
+		}
+	}
+
+	std::sort(queue.begin(), queue.end(),
+		[](const rad_trigger_t *A, const rad_trigger_t *B) { return A->list_pos < B->list_pos; });
+}
+
+
 static void DoRemoveTrigger(rad_trigger_t *trig)
 {
+	RemoveFromTriggerGrid(trig);
+
 	// handle tag linkage
 	if (trig->tag_next)
 		trig->tag_next->tag_prev = trig->tag_prev;
@@ -688,12 +900,16 @@ static void DoRemoveTrigger(rad_trigger_t *trig)
 //
 void RAD_RunTriggers(void)
 {
-	rad_trigger_t *trig, *next;
+	static std::vector<rad_trigger_t *> queue;
+
+	queue.clear();
+
+	CollectTriggers(queue);
 
 	// Start looking through the trigger list.
-	for (trig=active_triggers; trig; trig=next)
+	for (size_t i = 0 ; i < queue.size() ; i++)
 	{
-		next = trig->next;
+		rad_trigger_t *trig = queue[i];
 
 		// stop running all triggers when an RTS menu becomes active
 		if (rts_menuactive)
@@ -829,7 +1045,15 @@ void RAD_RunTriggers(void)
 		}
 
 		DoRemoveTrigger(trig);
+		queue[i] = NULL;
 	}
+
+	// update which triggers need to be visited every tic
+	awake_triggers.clear();
+
+	for (auto trig : queue)
+		if (trig && TriggerIsAwake(trig))
+			awake_triggers.push_back(trig);
 }
 
 void RAD_MonsterIsDead(mobj_t *mo)
@@ -842,7 +1066,7 @@ void RAD_MonsterIsDead(mobj_t *mo)
 
 		for (trig = active_triggers ; trig ; trig = trig->next)
 		{
-			for (auto tag : epi::STR_SepStringVector(mo->wud_tags, ','))
+			for (auto tag : epi::STR_SepStringVector(mo->cold->wud_tags, ','))
 			{
 				if (trig->wud_tag == atoi(tag.c_str()))
 					trig->wud_count--;
@@ -942,6 +1166,8 @@ void RAD_SpawnTriggers(const char *map_name)
 
 		active_triggers = trig;
 	}
+
+	RAD_BuildTriggerGrid();
 }
 
 
@@ -970,6 +1196,8 @@ static void RAD_ClearCachedInfo(void)
 
 void RAD_ClearTriggers(void)
 {
+	ClearTriggerGrid();
+
 	// remove all dynamic triggers
 	while (active_triggers)
 	{
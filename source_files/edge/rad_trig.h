@@ -22,6 +22,8 @@
 #include "e_event.h"
 #include "rad_defs.h"
 
+class image_c;
+
 #define DEBUG_RTS  0
 
 extern rad_script_t *r_scripts;
@@ -38,6 +40,7 @@ void RAD_ReadScript(const std::string& _data, const std::string& source);
 void RAD_SpawnTriggers(const char *map_name);
 void RAD_ClearTriggers(void);
 void RAD_GroupTriggerTags(rad_trigger_t *trig);
+void RAD_BuildTriggerGrid(void);
 
 // For UMAPINFO bossaction "clear" directive
 void RAD_ClearWUDsByMap(const std::string& mapname);
@@ -62,6 +65,12 @@ void RAD_FinishMenu(int result);
 // Path support
 bool RAD_CheckReachedTrigger(mobj_t * thing);
 
+// level precaching
+void RAD_GatherLevelAssets(const char *map_name,
+                           std::vector<const image_c *>& images,
+                           std::vector<sfx_t *>& sounds,
+                           std::vector<const mobjtype_c *>& things);
+
 #endif  /* __RAD_TRIG__ */
 
 //--- editor settings ---
@@ -24,7 +24,9 @@
 //----------------------------------------------------------------------------
 
 #include "i_defs.h"
+#include "i_sdlinc.h"
 
+#include <unordered_map>
 #include <vector>
 
 #include "file.h"
@@ -37,12 +39,14 @@
 #include "sfx.h"
 
 #include "s_sound.h"
+#include "s_blit.h"
 #include "s_cache.h"
 #include "s_ogg.h"
 #include "s_mp3.h"
 #include "s_wav.h"
 
 #include "dm_state.h"  // game_dir
+#include "i_system.h"
 #include "m_argv.h"
 #include "m_misc.h"
 #include "m_random.h"
@@ -56,7 +60,47 @@ extern int dev_freq;
 extern bool var_pc_speaker_mode;
 
 
-static std::vector<epi::sound_data_c *> fx_cache;
+static std::unordered_map<sfxdef_c *, epi::sound_data_c *> fx_cache;
+
+
+// compressed sounds at least this big are decoded in the background
+// when first played, instead of holding up the game.
+#define STREAM_MIN_LENGTH  (96 * 1024)
+
+// frames decoded in one go by a background decoder
+#define STREAM_CHUNK  4096
+
+// sounds read into memory at once by S_CachePreload
+#define PRELOAD_BATCH  64
+
+typedef struct
+{
+	sfxdef_c *def;
+	epi::sound_data_c *buf;
+
+	// the undecoded file or lump
+	byte *data;
+	int length;
+
+	epi::sound_format_e fmt;
+}
+sfx_load_t;
+
+typedef struct
+{
+	epi::sound_data_c *buf;
+
+	sfx_stream_c *stream;
+	byte *data;
+
+	SDL_Thread *thread;
+
+	SDL_atomic_t done;
+	SDL_atomic_t stop;
+}
+sfx_decoder_t;
+
+static std::vector<sfx_decoder_t *> decoders;
 
 
 static void Load_Silence(epi::sound_data_c *buf)
@@ -127,18 +171,44 @@ void S_FlushData(epi::sound_data_c *fx)
 	fx->Free();
 }
 
+static void FinishDecoder(sfx_decoder_t *D)
+{
+	SDL_WaitThread(D->thread, NULL);
+
+	delete D->stream;
+	delete[] D->data;
+
+	// from now on it can have reverb etc like any other sound
+	D->buf->is_sfx = true;
+
+	delete D;
+}
+
 void S_CacheClearAll(void)
 {
-	for (int i = 0; i < (int)fx_cache.size(); i++)
-		delete fx_cache[i];
+	for (sfx_decoder_t *D : decoders)
+	{
+		SDL_AtomicSet(&D->stop, 1);
+		FinishDecoder(D);
+	}
+
+	decoders.clear();
+
+	for (auto& entry : fx_cache)
+		delete entry.second;
 
-	fx_cache.erase(fx_cache.begin(), fx_cache.end());
+	fx_cache.clear();
 }
 
 
-static bool DoCacheLoad(sfxdef_c *def, epi::sound_data_c *buf)
+//
+// Opens the file or lump of the sound, and reads it into memory.
+// This must happen on the main thread.
+//
+static bool ReadSoundData(sfx_load_t *L)
 {
-	// open the file or lump, and read it into memory
+	sfxdef_c *def = L->def;
+
 	epi::file_c *F;
 	epi::sound_format_e fmt = epi::FMT_Unknown;
 
@@ -237,9 +307,28 @@ static bool DoCacheLoad(sfxdef_c *def, epi::sound_data_c *buf)
 		fmt = epi::Sound_DetectFormat(data, length);
 	}
 
+	L->data   = data;
+	L->length = length;
+	L->fmt    = fmt;
+
+	return true;
+}
+
+
+//
+// Decodes the data read by ReadSoundData() into the buffer, and
+// frees it.  This is safe to do on any thread.
+//
+static bool DecodeSoundData(sfx_load_t *L)
+{
+	epi::sound_data_c *buf = L->buf;
+
+	byte *data = L->data;
+	int length = L->length;
+
 	bool OK = false;
 	
-	switch (fmt)
+	switch (L->fmt)
 	{
 		case epi::FMT_WAV:
 			OK = Load_WAV(buf, data, length, false);
@@ -275,45 +364,291 @@ static bool DoCacheLoad(sfxdef_c *def, epi::sound_data_c *buf)
 	if (OK)
 		buf->is_sfx = true;
 
+	delete[] data;
+
+	L->data = NULL;
+
 	return OK;
 }
 
-epi::sound_data_c *S_CacheLoad(sfxdef_c *def)
+
+//----------------------------------------------------------------------------
+
+static int DecoderThread(void *ptr)
 {
-	bool pc_speaker_skip = false;
+	sfx_decoder_t *D = (sfx_decoder_t *) ptr;
 
-	if (var_pc_speaker_mode)
+	epi::sound_data_c *buf = D->buf;
+
+	int channels = D->stream->channels;
+
+	s16_t *chunk = new s16_t[STREAM_CHUNK * channels];
+
+	int pos = 0;
+
+	while (pos < buf->length && ! SDL_AtomicGet(&D->stop))
+	{
+		int got = D->stream->Read(chunk, MIN(STREAM_CHUNK, buf->length - pos));
+
+		if (got <= 0)
+			break;
+
+		if (channels == 1)
+		{
+			memcpy(buf->data_L + pos, chunk, got * sizeof(s16_t));
+		}
+		else
+		{
+			for (int i = 0; i < got; i++)
+			{
+				buf->data_L[pos + i] = chunk[i * 2];
+				buf->data_R[pos + i] = chunk[i * 2 + 1];
+			}
+		}
+
+		pos += got;
+	}
+
+	delete[] chunk;
+
+	SDL_AtomicSet(&D->done, 1);
+
+	return 0;
+}
+
+
+//
+// For a long compressed sound, sets up the buffer at its full
+// (silent) length and decodes into it on a background thread, so the
+// sound can start playing right away.  The decoder easily keeps ahead
+// of the playback.  Returns false if the sound should be decoded
+// normally instead.
+//
+static bool StartDecoder(sfx_load_t *L)
+{
+	if (L->length < STREAM_MIN_LENGTH)
+		return false;
+
+	sfx_stream_c *stream = NULL;
+
+	if (L->fmt == epi::FMT_OGG)
+		stream = S_OpenOGGStream(L->data, L->length);
+	else if (L->fmt == epi::FMT_MP3)
+		stream = S_OpenMP3Stream(L->data, L->length);
+
+	if (! stream)
+		return false;
+
+	epi::sound_data_c *buf = L->buf;
+
+	buf->freq = stream->freq;
+	buf->Allocate(stream->total, (stream->channels > 1) ? epi::SBUF_Stereo : epi::SBUF_Mono);
+
+	memset(buf->data_L, 0, buf->length * sizeof(s16_t));
+
+	if (buf->data_R != buf->data_L)
+		memset(buf->data_R, 0, buf->length * sizeof(s16_t));
+
+	// the mixer plays it without reverb etc until it is complete
+	buf->is_sfx = false;
+
+	sfx_decoder_t *D = new sfx_decoder_t;
+
+	D->buf    = buf;
+	D->stream = stream;
+	D->data   = L->data;
+
+	SDL_AtomicSet(&D->done, 0);
+	SDL_AtomicSet(&D->stop, 0);
+
+	D->thread = SDL_CreateThread(DecoderThread, "edge_sfx", D);
+
+	if (! D->thread)
+	{
+		delete stream;
+		delete D;
+
+		buf->Free();
+		return false;
+	}
+
+	decoders.push_back(D);
+
+	// the decoder owns the data now
+	L->data = NULL;
+
+	I_Debugf("SFX Loader: decoding '%s' in the background\n", L->def->name.c_str());
+
+	return true;
+}
+
+
+static bool BufferIsPlaying(const epi::sound_data_c *buf)
+{
+	for (int i = 0; i < num_chan; i++)
 	{
-		if (def->pc_speaker_sound.empty())
-			pc_speaker_skip = true;
+		const mix_channel_c *chan = mix_chan[i];
+
+		if (chan && chan->state == CHAN_Playing && chan->data == buf)
+			return true;
 	}
 
-	for (int i = 0; i < (int)fx_cache.size(); i++)
+	return false;
+}
+
+
+void S_CacheUpdate(void)
+{
+	for (size_t i = 0; i < decoders.size(); )
 	{
-		if (fx_cache[i]->priv_data == (void*)def)
+		sfx_decoder_t *D = decoders[i];
+
+		// keep it dry while a channel is still playing it, since
+		// the mixer switches to the effect buffer for SFX.
+		if (! SDL_AtomicGet(&D->done) || BufferIsPlaying(D->buf))
 		{
-			fx_cache[i]->ref_count++;
-			return fx_cache[i];
+			i++;
+			continue;
 		}
+
+		FinishDecoder(D);
+
+		decoders.erase(decoders.begin() + i);
 	}
+}
 
-	// create data structure
-	epi::sound_data_c *buf = new epi::sound_data_c();
 
-	fx_cache.push_back(buf);
+//----------------------------------------------------------------------------
+
+static inline bool PCSpeakerSkip(const sfxdef_c *def)
+{
+	return var_pc_speaker_mode && def->pc_speaker_sound.empty();
+}
+
+
+static epi::sound_data_c *NewCacheEntry(sfxdef_c *def)
+{
+	epi::sound_data_c *buf = new epi::sound_data_c();
 
 	buf->priv_data = def;
+	buf->ref_count = 0;
+
+	fx_cache[def] = buf;
+
+	return buf;
+}
+
+
+epi::sound_data_c *S_CacheLoad(sfxdef_c *def)
+{
+	auto find = fx_cache.find(def);
+
+	if (find != fx_cache.end())
+	{
+		find->second->ref_count++;
+		return find->second;
+	}
+
+	// create data structure
+	epi::sound_data_c *buf = NewCacheEntry(def);
+
 	buf->ref_count = 1;
 
-	if (pc_speaker_skip)
+	if (PCSpeakerSkip(def))
+	{
+		Load_Silence(buf);
+		return buf;
+	}
+
+	sfx_load_t L;
+
+	L.def  = def;
+	L.buf  = buf;
+	L.data = NULL;
+
+	if (! ReadSoundData(&L))
+	{
+		Load_Silence(buf);
+		return buf;
+	}
+
+	if (StartDecoder(&L))
+		return buf;
+
+	if (! DecodeSoundData(&L))
 		Load_Silence(buf);
-	else
-		if (! DoCacheLoad(def, buf))
-			Load_Silence(buf);	
 
 	return buf;
 }
 
+
+typedef struct
+{
+	std::vector<sfx_load_t> loads;
+	std::vector<int> result;
+}
+sfx_preload_job_t;
+
+static void PreloadWorker(int index, void *data)
+{
+	sfx_preload_job_t *job = (sfx_preload_job_t *) data;
+
+	job->result[index] = DecodeSoundData(&job->loads[index]) ? 1 : 0;
+}
+
+
+void S_CachePreload(const std::vector<sfxdef_c *>& defs)
+{
+	int total = 0;
+
+	for (size_t start = 0; start < defs.size(); start += PRELOAD_BATCH)
+	{
+		size_t end = MIN(defs.size(), start + PRELOAD_BATCH);
+
+		sfx_preload_job_t job;
+
+		// the reads happen here, one by one
+		for (size_t i = start; i < end; i++)
+		{
+			sfxdef_c *def = defs[i];
+
+			if (fx_cache.find(def) != fx_cache.end())
+				continue;
+
+			epi::sound_data_c *buf = NewCacheEntry(def);
+
+			sfx_load_t L;
+
+			L.def  = def;
+			L.buf  = buf;
+			L.data = NULL;
+
+			if (PCSpeakerSkip(def) || ! ReadSoundData(&L))
+			{
+				Load_Silence(buf);
+				continue;
+			}
+
+			job.loads.push_back(L);
+			job.result.push_back(0);
+		}
+
+		int count = (int)job.loads.size();
+
+		I_RunParallel(count, PreloadWorker, &job);
+
+		for (int i = 0; i < count; i++)
+		{
+			if (! job.result[i])
+				Load_Silence(job.loads[i].buf);
+		}
+
+		total += count;
+	}
+
+	I_Debugf("S_CachePreload: decoded %d sounds\n", total);
+}
+
 void S_CacheRelease(epi::sound_data_c *data)
 {
 	SYS_ASSERT(data->ref_count >= 1);
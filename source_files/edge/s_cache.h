@@ -28,8 +28,33 @@
 
 #include "sound_data.h"
 
+#include <vector>
+
 class sfxdef_c;
 
+
+// A decoder which gives out a sound a piece at a time, so that a
+// long sound can start playing before all of it is decoded.
+class sfx_stream_c
+{
+public:
+	int freq;
+	int channels;  // 1 or 2
+
+	// total number of frames
+	int total;
+
+public:
+	sfx_stream_c() : freq(0), channels(0), total(0) { }
+	virtual ~sfx_stream_c() { }
+
+	// decodes up to 'frames' frames (interleaved when stereo) and
+	// returns how many were decoded, zero at the end or on error.
+	// This runs on a background thread and must not print anything.
+	virtual int Read(s16_t *dest, int frames) = 0;
+};
+
+
 void S_CacheInit(void);
 // setup the sound cache system.
 
@@ -43,6 +68,14 @@ epi::sound_data_c *S_CacheLoad(sfxdef_c *def);
 // been loaded, then it is simply returned (increasing the
 // reference count).  Returns NULL if the lump doesn't exist.
 
+void S_CachePreload(const std::vector<sfxdef_c *>& defs);
+// load a set of sounds into the cache, decoding them on several
+// threads.  Sounds which are already cached are skipped.
+
+void S_CacheUpdate(void);
+// check on the sounds being decoded in the background.
+// Call once per tic.
+
 void S_CacheRelease(epi::sound_data_c *data);
 // we are finished with this data.  The cache system may
 // free the memory when the number of references drops to 0.
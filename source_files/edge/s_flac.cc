@@ -58,13 +58,13 @@ private:
 
 	drflac *flac_track; // I had to make it rhyme
 
-	byte *flac_data; // Passed in from s_music; must be deleted on close
+	epi::file_c *flac_file; // Passed in from s_music; must be deleted on close
 
 	s16_t *mono_buffer;
 
 public:
 
-	bool OpenMemory(byte *data, int length);
+	bool OpenFile(epi::file_c *F);
 
 	virtual void Close(void);
 
@@ -85,8 +85,30 @@ private:
 };
 
 //----------------------------------------------------------------------------
+//
+// flacplayer file operations
+//
 
-flacplayer_c::flacplayer_c() : status(NOT_LOADED)
+static size_t flacplayer_fileread(void *pUserData, void *pBufferOut, size_t bytesToRead)
+{
+	epi::file_c *F = (epi::file_c *)pUserData;
+
+	return F->Read(pBufferOut, (unsigned int)bytesToRead);
+}
+
+static drflac_bool32 flacplayer_fileseek(void *pUserData, int offset, drflac_seek_origin origin)
+{
+	epi::file_c *F = (epi::file_c *)pUserData;
+
+	int seekpoint = (origin == drflac_seek_origin_start) ?
+		epi::file_c::SEEKPOINT_START : epi::file_c::SEEKPOINT_CURRENT;
+
+	return F->Seek(offset, seekpoint) ? DRFLAC_TRUE : DRFLAC_FALSE;
+}
+
+//----------------------------------------------------------------------------
+
+flacplayer_c::flacplayer_c() : status(NOT_LOADED), flac_file(nullptr)
 {
 	mono_buffer = new s16_t[FLAC_FRAMES * 2];
 }
@@ -152,20 +174,25 @@ bool flacplayer_c::StreamIntoBuffer(epi::sound_data_c *buf)
     return (true);
 }
 
-bool flacplayer_c::OpenMemory(byte *data, int length)
+//
+// Reads the stream from the given file as it plays.  This may run on
+// a background thread, so failures only go to the debug file.
+//
+bool flacplayer_c::OpenFile(epi::file_c *F)
 {
-	SYS_ASSERT(data);
+	SYS_ASSERT(F);
 
-	flac_track = drflac_open_memory(data, length, nullptr);
+	flac_track = drflac_open(flacplayer_fileread, flacplayer_fileseek, F, nullptr);
 
 	if (!flac_track)
 	{
-		I_Warning("S_PlayFLACMusic: Error opening song!\n");
+		I_Debugf("S_OpenFLACMusic: Error opening song!\n");
+		delete F;
 		return false;
 	}
 
-	// data is only released when the player is closed
-	flac_data = data;
+	// file is only released when the player is closed
+	flac_file = F;
 
 	PostOpenInit();
 	return true;
@@ -181,7 +208,9 @@ void flacplayer_c::Close()
 		Stop();
 		
 	drflac_close(flac_track);
-	delete[] flac_data;
+
+	delete flac_file;
+	flac_file = nullptr;
 
 	// reset player gain
 	mus_player_gain = 1.0f;
@@ -267,20 +296,17 @@ void flacplayer_c::Ticker()
 
 //----------------------------------------------------------------------------
 
-abstract_music_c * S_PlayFLACMusic(byte *data, int length, bool looping)
+abstract_music_c * S_OpenFLACMusic(epi::file_c *F)
 {
 	flacplayer_c *player = new flacplayer_c();
 
-	if (! player->OpenMemory(data, length))
+	if (! player->OpenFile(F))
 	{
-		delete[] data;
 		delete player;
 		return nullptr;
 	}
 
-	// data is freed when Close() is called on the player; must be retained until then
-
-	player->Play(looping);
+	// file is closed when Close() is called on the player; must be retained until then
 
 	return player;
 }
@@ -23,9 +23,13 @@
 
 #include "sound_data.h"
 
+namespace epi { class file_c; }
+
 /* FUNCTIONS */
 
-abstract_music_c * S_PlayFLACMusic(byte *data, int length, bool looping);
+// takes over the file, returns NULL if it cannot be opened.
+// The player is loaded but not playing.
+abstract_music_c * S_OpenFLACMusic(epi::file_c *F);
 
 #endif  /* __VGMPLAYER_H__ */
 
@@ -54,13 +54,13 @@ private:
 	bool looping;
 	bool is_stereo;
 
-	byte *mp3_data = nullptr;
+	epi::file_c *mp3_file = nullptr;
 	drmp3 *mp3_dec = nullptr;
 
 	s16_t *mono_buffer;
 
 public:
-	bool OpenMemory(byte *data, int length);
+	bool OpenFile(epi::file_c *F);
 
 	virtual void Close(void);
 
@@ -78,6 +78,28 @@ private:
 	bool StreamIntoBuffer(epi::sound_data_c *buf);
 };
 
+//----------------------------------------------------------------------------
+//
+// mp3player file operations
+//
+
+static size_t mp3player_fileread(void *pUserData, void *pBufferOut, size_t bytesToRead)
+{
+	epi::file_c *F = (epi::file_c *)pUserData;
+
+	return F->Read(pBufferOut, (unsigned int)bytesToRead);
+}
+
+static drmp3_bool32 mp3player_fileseek(void *pUserData, int offset, drmp3_seek_origin origin)
+{
+	epi::file_c *F = (epi::file_c *)pUserData;
+
+	int seekpoint = (origin == drmp3_seek_origin_start) ?
+		epi::file_c::SEEKPOINT_START : epi::file_c::SEEKPOINT_CURRENT;
+
+	return F->Seek(offset, seekpoint) ? DRMP3_TRUE : DRMP3_FALSE;
+}
+
 //----------------------------------------------------------------------------
 
 mp3player_c::mp3player_c() : status(NOT_LOADED)
@@ -151,24 +173,36 @@ bool mp3player_c::StreamIntoBuffer(epi::sound_data_c *buf)
     return (true);
 }
 
-bool mp3player_c::OpenMemory(byte *data, int length)
+//
+// Reads the stream from the given file as it plays.  This may run on
+// a background thread, so failures only go to the debug file.
+//
+bool mp3player_c::OpenFile(epi::file_c *F)
 {
 	if (status != NOT_LOADED)
 		Close();
 
-	mp3_dec = new drmp3;
+	mp3_file = F;
+	mp3_dec  = new drmp3;
 
-    if (!drmp3_init_memory(mp3_dec, data, length, nullptr))
+    if (!drmp3_init(mp3_dec, mp3player_fileread, mp3player_fileseek, mp3_file, nullptr))
     {
-		I_Warning("mp3player_c: Could not open MP3 file.\n");
+		I_Debugf("mp3player_c: Could not open MP3 file.\n");
 		delete mp3_dec;
+		mp3_dec = nullptr;
+		delete mp3_file;
+		mp3_file = nullptr;
 		return false;
     }
 
 	if (mp3_dec->channels > 2)
 	{
-		I_Warning("mp3player_c: MP3 has too many channels: %d\n", mp3_dec->channels);
+		I_Debugf("mp3player_c: MP3 has too many channels: %d\n", mp3_dec->channels);
 		drmp3_uninit(mp3_dec);
+		delete mp3_dec;
+		mp3_dec = nullptr;
+		delete mp3_file;
+		mp3_file = nullptr;
 		return false;
 	}
 
@@ -190,8 +224,8 @@ void mp3player_c::Close()
 	delete mp3_dec;
 	mp3_dec = nullptr;
 
-	delete[] mp3_data;
-	mp3_data = nullptr;
+	delete mp3_file;
+	mp3_file = nullptr;
 
 	// reset player gain
 	mus_player_gain = 1.0f;
@@ -273,19 +307,16 @@ void mp3player_c::Ticker()
 
 //----------------------------------------------------------------------------
 
-abstract_music_c * S_PlayMP3Music(byte *data, int length, bool looping)
+abstract_music_c * S_OpenMP3Music(epi::file_c *F)
 {
 	mp3player_c *player = new mp3player_c();
 
-	if (! player->OpenMemory(data, length))
+	if (! player->OpenFile(F))
 	{
-		delete[] data;
 		delete player;
 		return NULL;
 	}
 
-	player->Play(looping);
-
 	return player;
 }
 
@@ -337,5 +368,58 @@ bool S_LoadMP3Sound(epi::sound_data_c *buf, const byte *data, int length)
 	return true;
 }
 
+
+//----------------------------------------------------------------------------
+
+class mp3_sfx_stream_c : public sfx_stream_c
+{
+public:
+	drmp3 mp3;
+
+	bool opened;
+
+public:
+	 mp3_sfx_stream_c() : opened(false) { }
+	~mp3_sfx_stream_c()
+	{
+		if (opened)
+			drmp3_uninit(&mp3);
+	}
+
+	int Read(s16_t *dest, int frames)
+	{
+		return (int)drmp3_read_pcm_frames_s16(&mp3, frames, dest);
+	}
+};
+
+
+sfx_stream_c *S_OpenMP3Stream(const byte *data, int length)
+{
+	mp3_sfx_stream_c *stream = new mp3_sfx_stream_c;
+
+	if (! drmp3_init_memory(&stream->mp3, data, length, nullptr))
+	{
+		delete stream;
+		return NULL;
+	}
+
+	stream->opened = true;
+
+	// this only scans the frame headers
+	drmp3_uint64 framecount = drmp3_get_pcm_frame_count(&stream->mp3);
+
+	if (stream->mp3.channels > 2 || framecount <= 0 || framecount > INT_MAX)
+	{
+		delete stream;
+		return NULL;
+	}
+
+	stream->freq     = stream->mp3.sampleRate;
+	stream->channels = stream->mp3.channels;
+	stream->total    = (int)framecount;
+
+	return stream;
+}
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
@@ -25,12 +25,21 @@
 
 #include "sound_data.h"
 
+namespace epi { class file_c; }
+class sfx_stream_c;
+
 /* FUNCTIONS */
 
-abstract_music_c * S_PlayMP3Music(byte *data, int length, bool looping);
+// takes over the file, returns NULL if it cannot be opened.
+// The player is loaded but not playing.
+abstract_music_c * S_OpenMP3Music(epi::file_c *F);
 
 bool S_LoadMP3Sound(epi::sound_data_c *buf, const byte *data, int length);
 
+// returns NULL if the data is not a usable MP3 sound.
+// The data must stay around until the stream is deleted.
+sfx_stream_c * S_OpenMP3Stream(const byte *data, int length);
+
 #endif  /* __MP3PLAYER_H__ */
 
 //--- editor settings ---
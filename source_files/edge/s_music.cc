@@ -20,6 +20,7 @@
 //
 
 #include "i_defs.h"
+#include "i_sdlinc.h"
 
 #include <stdlib.h>
 
@@ -57,6 +58,133 @@ int  entry_playing = -1;
 static bool entry_looped;
 bool var_pc_speaker_mode = false;
 
+// bytes read from the start of a lump to detect its format
+#define MUSIC_HEADER_LEN  4096
+
+// a streamed song being opened in the background
+typedef struct
+{
+	epi::file_c *F;
+	epi::sound_format_e fmt;
+
+	abstract_music_c *player;
+
+	SDL_Thread *thread;
+	SDL_atomic_t done;
+}
+music_open_t;
+
+static music_open_t *music_opening = NULL;
+
+
+static bool IsStreamedFormat(epi::sound_format_e fmt)
+{
+	return (fmt == epi::FMT_OGG || fmt == epi::FMT_MP3 || fmt == epi::FMT_FLAC);
+}
+
+
+//
+// Returns the player for a streamed format, loaded but not playing.
+// This may run on a background thread.
+//
+static abstract_music_c *OpenStreamedMusic(epi::file_c *F, epi::sound_format_e fmt)
+{
+	switch (fmt)
+	{
+		case epi::FMT_OGG:  return S_OpenOGGMusic(F);
+		case epi::FMT_MP3:  return S_OpenMP3Music(F);
+		case epi::FMT_FLAC: return S_OpenFLACMusic(F);
+
+		default:
+			delete F;
+			return NULL;
+	}
+}
+
+
+static int MusicOpenThread(void *ptr)
+{
+	music_open_t *job = (music_open_t *) ptr;
+
+	job->player = OpenStreamedMusic(job->F, job->fmt);
+
+	SDL_AtomicSet(&job->done, 1);
+
+	return 0;
+}
+
+
+static void StartPlaying(abstract_music_c *player)
+{
+	if (! player)
+	{
+		I_Warning("S_ChangeMusic: could not open music entry [%d]\n", entry_playing);
+		return;
+	}
+
+	music_player = player;
+	music_player->Play(entry_looped);
+}
+
+
+//
+// Waits for the background open to finish.  The song is played
+// if wanted, otherwise it is thrown away.
+//
+static void FinishMusicOpen(bool play)
+{
+	SDL_WaitThread(music_opening->thread, NULL);
+
+	abstract_music_c *player = music_opening->player;
+
+	delete music_opening;
+	music_opening = NULL;
+
+	if (! play)
+	{
+		delete player;
+		return;
+	}
+
+	StartPlaying(player);
+
+	// the game may have been paused while the song was opening
+	if (music_player && paused)
+		music_player->Pause();
+}
+
+
+//
+// OGG, MP3 and FLAC music is read from the file as it plays, instead
+// of being loaded into memory first.  When the file has its own handle
+// (not a lump or packed entry sharing one with the main thread), the
+// open itself is done in the background, so level changes don't wait
+// for it.
+//
+static void StartStreamedMusic(epi::file_c *F, epi::sound_format_e fmt)
+{
+	if (dynamic_cast<epi::ansi_file_c *>(F) != NULL)
+	{
+		music_opening = new music_open_t;
+
+		music_opening->F      = F;
+		music_opening->fmt    = fmt;
+		music_opening->player = NULL;
+
+		SDL_AtomicSet(&music_opening->done, 0);
+
+		music_opening->thread = SDL_CreateThread(MusicOpenThread, "edge_music", music_opening);
+
+		if (music_opening->thread)
+			return;
+
+		delete music_opening;
+		music_opening = NULL;
+	}
+
+	StartPlaying(OpenStreamedMusic(F, fmt));
+}
+
 
 void S_ChangeMusic(int entrynum, bool loop)
 {
@@ -87,7 +215,7 @@ void S_ChangeMusic(int entrynum, bool loop)
 		return;
 	}
 
-	// open the file or lump, and read it into memory
+	// open the file or lump
 	epi::file_c *F;
 
 	switch (play->infotype)
@@ -135,18 +263,10 @@ void S_ChangeMusic(int entrynum, bool loop)
 	}
 
 	int length = F->GetLength();
-	byte *data = F->LoadIntoMemory();
 
-	if (! data)
-	{
-		delete F;
-		I_Warning("S_ChangeMusic: Error loading data.\n");
-		return;
-	}
 	if (length < 4)
 	{
 		delete F;
-		delete data;
 		I_Printf("S_ChangeMusic: ignored short data (%d bytes)\n", length);
 		return;
 	}
@@ -161,8 +281,17 @@ void S_ChangeMusic(int entrynum, bool loop)
 	{
 		if (play->infotype == MUSINF_LUMP)
 		{
-			// lumps must use auto-detection based on their contents
-			fmt = epi::Sound_DetectFormat(data, length);
+			// lumps must use auto-detection based on their contents.
+			// The start is enough to spot the streamed formats.
+			byte *header = F->LoadIntoMemory(MUSIC_HEADER_LEN);
+
+			if (header)
+			{
+				fmt = epi::Sound_DetectFormat(header, MIN(length, MUSIC_HEADER_LEN));
+				delete[] header;
+			}
+
+			F->Seek(0, epi::file_c::SEEKPOINT_START);
 		}
 		else
 		{
@@ -171,25 +300,29 @@ void S_ChangeMusic(int entrynum, bool loop)
 		}
 	}
 
-	// NOTE: players are responsible for freeing 'data'
+	if (IsStreamedFormat(fmt))
+	{
+		StartStreamedMusic(F, fmt);
+		return;
+	}
 
-	switch (fmt)
+	byte *data = F->LoadIntoMemory();
+
+	if (! data)
 	{
-		case epi::FMT_OGG:
-			delete F;
-			music_player = S_PlayOGGMusic(data, length, loop);
-			break;
+		delete F;
+		I_Warning("S_ChangeMusic: Error loading data.\n");
+		return;
+	}
 
-		case epi::FMT_MP3:
-			delete F;
-			music_player = S_PlayMP3Music(data, length, loop);
-			break;
+	// redo the detection with all of the lump
+	if (play->infotype == MUSINF_LUMP && fmt != epi::FMT_IMF)
+		fmt = epi::Sound_DetectFormat(data, length);
 
-		case epi::FMT_FLAC:
-			delete F;
-			music_player = S_PlayFLACMusic(data, length, loop);
-			break;
+	// NOTE: players are responsible for freeing 'data'
 
+	switch (fmt)
+	{
 		case epi::FMT_M4P:
 			delete F;
 			music_player = S_PlayM4PMusic(data, length, loop);
@@ -252,6 +385,9 @@ void S_StopMusic(void)
 {
 	// You can't stop the rock!! This does...
 
+	if (music_opening)
+		FinishMusicOpen(false);
+
 	if (music_player)
 	{
 		music_player->Stop();
@@ -266,6 +402,9 @@ void S_StopMusic(void)
 
 void S_MusicTicker(void)
 {
+	if (music_opening && SDL_AtomicGet(&music_opening->done))
+		FinishMusicOpen(true);
+
 	if (music_player)
 		music_player->Ticker();
 }
@@ -71,14 +71,14 @@ private:
 	bool looping;
 	bool is_stereo;
 
-	datalump_t *ogg_lump = nullptr;
+	epi::file_c *ogg_file = nullptr;
 	OggVorbis_File ogg_stream;
 	vorbis_info *vorbis_inf = nullptr;
 
 	s16_t *mono_buffer;
 
 public:
-	bool OpenMemory(byte *data, int length);
+	bool OpenFile(epi::file_c *F);
 
 	virtual void Close(void);
 
@@ -95,6 +95,8 @@ private:
 
 	void PostOpenInit(void);
 
+	bool Rewind(void);
+
 	bool StreamIntoBuffer(epi::sound_data_c *buf);
 };
 
@@ -158,6 +160,33 @@ long oggplayer_memtell(void *datasource)
 	return d->pos;
 }
 
+//----------------------------------------------------------------------------
+//
+// oggplayer file operations
+//
+
+size_t oggplayer_fileread(void *ptr, size_t size, size_t nmemb, void *datasource)
+{
+	epi::file_c *F = (epi::file_c *)datasource;
+
+	return F->Read(ptr, size * nmemb) / size;
+}
+
+static ov_callbacks FileCallbacks(void)
+{
+	ov_callbacks CB;
+
+	// no seeking: vorbisfile would scan the whole stream when opening
+	// it, and going backwards in a packed (EPK) entry means inflating
+	// it again from the start.  Rewind() handles looping instead.
+	CB.read_func  = oggplayer_fileread;
+	CB.seek_func  = NULL;
+	CB.close_func = oggplayer_memclose;
+	CB.tell_func  = NULL;
+
+	return CB;
+}
+
 //----------------------------------------------------------------------------
 
 oggplayer_c::oggplayer_c() : status(NOT_LOADED), vorbis_inf(NULL)
@@ -254,10 +283,9 @@ bool oggplayer_c::StreamIntoBuffer(epi::sound_data_c *buf)
 
 		if (got_size == 0)  /* EOF */
 		{
-			if (! looping)
+			if (! looping || ! Rewind())
 				break;
 
-			ov_raw_seek(&ogg_stream, 0);
 			continue; // try again
 		}
 
@@ -284,35 +312,25 @@ bool oggplayer_c::StreamIntoBuffer(epi::sound_data_c *buf)
     return (samples > 0);
 }
 
-bool oggplayer_c::OpenMemory(byte *data, int length)
+//
+// Reads the stream from the given file as it plays.  This may run on
+// a background thread, so failures only go to the debug file.
+//
+bool oggplayer_c::OpenFile(epi::file_c *F)
 {
 	if (status != NOT_LOADED)
 		Close();
 
-	ogg_lump = new datalump_t;
-
-	ogg_lump->data = data;
-	ogg_lump->size = length;
-	ogg_lump->pos  = 0;
-
-	ov_callbacks CB;
-
-	CB.read_func  = oggplayer_memread;
-	CB.seek_func  = oggplayer_memseek;
-	CB.close_func = oggplayer_memclose;
-	CB.tell_func  = oggplayer_memtell;
+	ogg_file = F;
 
-    int result = ov_open_callbacks((void*)ogg_lump, &ogg_stream, NULL, 0, CB);
+    int result = ov_open_callbacks((void*)ogg_file, &ogg_stream, NULL, 0, FileCallbacks());
 
     if (result < 0)
     {
-		std::string err_msg("[oggplayer_c::OpenMemory] Failed: ");
-
-		err_msg += GetError(result);
-		I_Warning("%s\n", err_msg.c_str());
+		I_Debugf("[oggplayer_c::OpenFile] Failed: %s\n", GetError(result));
 		ov_clear(&ogg_stream);
-		ogg_lump->data = nullptr; // this is deleted after the function returns false
-		delete ogg_lump;
+		delete ogg_file;
+		ogg_file = nullptr;
 		return false;
     }
 
@@ -321,6 +339,23 @@ bool oggplayer_c::OpenMemory(byte *data, int length)
 }
 
 
+bool oggplayer_c::Rewind()
+{
+	ov_clear(&ogg_stream);
+
+	if (! ogg_file->Seek(0, epi::file_c::SEEKPOINT_START))
+		return false;
+
+	if (ov_open_callbacks((void*)ogg_file, &ogg_stream, NULL, 0, FileCallbacks()) < 0)
+		return false;
+
+    vorbis_inf = ov_info(&ogg_stream, -1);
+	SYS_ASSERT(vorbis_inf);
+
+	return true;
+}
+
+
 void oggplayer_c::Close()
 {
 	if (status == NOT_LOADED)
@@ -331,9 +366,8 @@ void oggplayer_c::Close()
 
 	ov_clear(&ogg_stream);
 
-	delete[] ogg_lump->data;
-	delete ogg_lump;
-	ogg_lump = nullptr;
+	delete ogg_file;
+	ogg_file = nullptr;
 
 	// Reset player gain
 	mus_player_gain = 1.0f;
@@ -412,19 +446,16 @@ void oggplayer_c::Ticker()
 
 //----------------------------------------------------------------------------
 
-abstract_music_c * S_PlayOGGMusic(byte *data, int length, bool looping)
+abstract_music_c * S_OpenOGGMusic(epi::file_c *F)
 {
 	oggplayer_c *player = new oggplayer_c();
 
-	if (! player->OpenMemory(data, length))
+	if (! player->OpenFile(F))
 	{
-		delete[] data;
 		delete player;
 		return NULL;
 	}
 
-	player->Play(looping);
-
 	return player;
 }
 
@@ -514,16 +545,98 @@ bool S_LoadOGGSound(epi::sound_data_c *buf, const byte *data, int length)
 		gather.CommitChunk(got_size);
 	}
 
-	if (! gather.Finalise(buf, is_stereo))
-		I_Error("OGG SFX Loader: no samples!\n");
-
 	ov_clear(&ogg_stream);
 
-	// free the data
-	delete[] data;
+	if (! gather.Finalise(buf, is_stereo))
+	{
+		I_Warning("OGG SFX Loader: no samples!\n");
+		return false;
+	}
 
 	return true;
 }
 
+
+//----------------------------------------------------------------------------
+
+class ogg_sfx_stream_c : public sfx_stream_c
+{
+public:
+	datalump_t ogg_lump;
+	OggVorbis_File ogg_stream;
+
+	bool opened;
+
+public:
+	 ogg_sfx_stream_c() : opened(false) { }
+	~ogg_sfx_stream_c()
+	{
+		if (opened)
+			ov_clear(&ogg_stream);
+	}
+
+	int Read(s16_t *dest, int frames)
+	{
+		int ogg_endian = (EPI_BYTEORDER == EPI_LIL_ENDIAN) ? 0 : 1;
+		int frame_size = channels * sizeof(s16_t);
+
+		for (;;)
+		{
+			int section;
+			int got_size = ov_read(&ogg_stream, (char *)dest, frames * frame_size,
+					ogg_endian, sizeof(s16_t), 1 /* signed data */, &section);
+
+			if (got_size == OV_HOLE)  // ignore corruption
+				continue;
+
+			if (got_size <= 0)  // EOF or ERROR
+				return 0;
+
+			return got_size / frame_size;
+		}
+	}
+};
+
+
+sfx_stream_c *S_OpenOGGStream(const byte *data, int length)
+{
+	ogg_sfx_stream_c *stream = new ogg_sfx_stream_c;
+
+	stream->ogg_lump.data = data;
+	stream->ogg_lump.size = length;
+	stream->ogg_lump.pos  = 0;
+
+	ov_callbacks CB;
+
+	CB.read_func  = oggplayer_memread;
+	CB.seek_func  = oggplayer_memseek;
+	CB.close_func = oggplayer_memclose;
+	CB.tell_func  = oggplayer_memtell;
+
+	if (ov_open_callbacks((void*)&stream->ogg_lump, &stream->ogg_stream, NULL, 0, CB) < 0)
+	{
+		delete stream;
+		return NULL;
+	}
+
+	stream->opened = true;
+
+	vorbis_info *vorbis_inf = ov_info(&stream->ogg_stream, -1);
+
+	ogg_int64_t total = ov_pcm_total(&stream->ogg_stream, -1);
+
+	if (! vorbis_inf || vorbis_inf->channels > 2 || total <= 0 || total > INT_MAX)
+	{
+		delete stream;
+		return NULL;
+	}
+
+	stream->freq     = vorbis_inf->rate;
+	stream->channels = vorbis_inf->channels;
+	stream->total    = (int)total;
+
+	return stream;
+}
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
@@ -25,12 +25,21 @@
 
 #include "sound_data.h"
 
+namespace epi { class file_c; }
+class sfx_stream_c;
+
 /* FUNCTIONS */
 
-abstract_music_c * S_PlayOGGMusic(byte *data, int length, bool looping);
+// takes over the file, returns NULL if it cannot be opened.
+// The player is loaded but not playing.
+abstract_music_c * S_OpenOGGMusic(epi::file_c *F);
 
 bool S_LoadOGGSound(epi::sound_data_c *buf, const byte *data, int length);
 
+// returns NULL if the data is not a usable OGG sound.
+// The data must stay around until the stream is deleted.
+sfx_stream_c * S_OpenOGGStream(const byte *data, int length);
+
 #endif  /* __OGGPLAYER_H__ */
 
 //--- editor settings ---
@@ -450,16 +450,20 @@ void S_StartFX(sfx_t *sfx, int category, position_c *pos, int flags)
 	if (! buf)
 		return;	
 
-	if (vacuum_sfx)
-		buf->Mix_Vacuum();
-	else if (submerged_sfx)
-		buf->Mix_Submerged();
-	else
+	// sounds still being decoded (and silence) are played dry
+	if (buf->is_sfx)
 	{
-		if (ddf_reverb)
-			buf->Mix_Reverb(dynamic_reverb, room_area, outdoor_reverb, ddf_reverb_type, ddf_reverb_ratio, ddf_reverb_delay);
+		if (vacuum_sfx)
+			buf->Mix_Vacuum();
+		else if (submerged_sfx)
+			buf->Mix_Submerged();
 		else
-			buf->Mix_Reverb(dynamic_reverb, room_area, outdoor_reverb, 0, 0, 0);
+		{
+			if (ddf_reverb)
+				buf->Mix_Reverb(dynamic_reverb, room_area, outdoor_reverb, ddf_reverb_type, ddf_reverb_ratio, ddf_reverb_delay);
+			else
+				buf->Mix_Reverb(dynamic_reverb, room_area, outdoor_reverb, 0, 0, 0);
+		}
 	}
 
 	I_LockAudio();
@@ -548,6 +552,8 @@ void S_SoundTicker(void)
 		{
 			S_UpdateSounds(NULL, 0);
 		}
+
+		S_CacheUpdate();
 	}
 	I_UnlockAudio();
 }
@@ -572,11 +578,39 @@ void S_PrecacheSounds(void)
 	if (var_cache_sfx)
 	{
 		E_ProgressMessage("Precaching SFX...");
+
+		std::vector<sfxdef_c *> defs;
+
 		for (int i =0; i < sfxdefs.GetSize(); i++)
+			defs.push_back(sfxdefs[i]);
+
+		S_CachePreload(defs);
+	}
+}
+
+void S_PrecacheSoundList(const std::vector<struct sfx_s *>& sounds)
+{
+	// already loaded everything at startup
+	if (nosound || var_cache_sfx)
+		return;
+
+	std::vector<sfxdef_c *> defs;
+
+	for (struct sfx_s *sfx : sounds)
+	{
+		if (! sfx)
+			continue;
+
+		for (int k = 0; k < sfx->num; k++)
 		{
-			S_CacheLoad(sfxdefs[i]);
+			int num = sfx->sounds[k];
+
+			if (num >= 0 && num < sfxdefs.GetSize())
+				defs.push_back(sfxdefs[num]);
 		}
 	}
+
+	S_CachePreload(defs);
 }
 
 void S_ResumeAudioDevice()
@@ -26,6 +26,8 @@
 #ifndef __S_SOUND_H__
 #define __S_SOUND_H__
 
+#include <vector>
+
 // Forward declarations
 struct position_c;
 struct mobj_s;
@@ -107,6 +109,10 @@ void S_ChangeChannelNum(void);
 
 void S_PrecacheSounds(void);
 
+// loads the given sounds (all of their wildcard variants) into the
+// cache, so they don't need to be loaded when first played.
+void S_PrecacheSoundList(const std::vector<struct sfx_s *>& sounds);
+
 #endif /* __S_SOUND_H__ */
 
 //--- editor settings ---
@@ -546,6 +546,9 @@ void SV_LineFinaliseElems(void)
 
 		(*SMI)->line->slider_move = (*SMI);
 	}
+
+	// the sound zones get rebuilt from the loaded doors
+	P_ClearSoundZones();
 }
 
 
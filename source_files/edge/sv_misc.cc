@@ -643,6 +643,8 @@ void SV_TriggerCreateElems(int num_elems)
 
 void SV_TriggerFinaliseElems(void)
 {
+	RAD_BuildTriggerGrid();
+
 	/* Lobo: avoids a CTD when we have conflicting same named RTS scripts
 	rad_trigger_t *cur;
 
@@ -55,6 +55,9 @@ bool SR_MobjGetState(void *storage, int index, void *extra);
 bool SR_MobjGetSpawnPoint(void *storage, int index, void *extra);
 bool SR_MobjGetAttack(void *storage, int index, void *extra);
 bool SR_MobjGetWUDs(void *storage, int index, void *extra);
+bool SR_MobjGetColdType(void *storage, int index, void *extra);
+bool SR_MobjGetColdInt(void *storage, int index, void *extra);
+bool SR_MobjGetColdSpawnPoint(void *storage, int index, void *extra);
 
 void SR_MobjPutPlayer(void *storage, int index, void *extra);
 void SR_MobjPutMobj(void *storage, int index, void *extra);
@@ -63,6 +66,9 @@ void SR_MobjPutState(void *storage, int index, void *extra);
 void SR_MobjPutSpawnPoint(void *storage, int index, void *extra);
 void SR_MobjPutAttack(void *storage, int index, void *extra);
 void SR_MobjPutWUDs(void *storage, int index, void *extra);
+void SR_MobjPutColdType(void *storage, int index, void *extra);
+void SR_MobjPutColdInt(void *storage, int index, void *extra);
+void SR_MobjPutColdSpawnPoint(void *storage, int index, void *extra);
 
 //----------------------------------------------------------------------------
 //
@@ -88,7 +94,7 @@ static savefield_t sv_fields_mobj[] =
 	SF(speed, "speed", 1, SVT_FLOAT, SR_GetFloat, SR_PutFloat),
 	SF(fuse, "fuse", 1, SVT_INT, SR_GetInt, SR_PutInt),
 	SF(morphtimeout, "morphtimeout", 1, SVT_INT, SR_GetInt, SR_PutInt),
-	SF(preBecome, "preBecome", 1, SVT_STRING, SR_MobjGetType, SR_MobjPutType),
+	SF(cold, "preBecome", 1, SVT_STRING, SR_MobjGetColdType, SR_MobjPutColdType),
 	SF(info, "info", 1, SVT_STRING, SR_MobjGetType, SR_MobjPutType),
 	SF(state, "state", 1, SVT_STRING, SR_MobjGetState, SR_MobjPutState),
 	SF(next_state, "next_state", 1, SVT_STRING, SR_MobjGetState, SR_MobjPutState),
@@ -100,14 +106,14 @@ static savefield_t sv_fields_mobj[] =
 	SF(movecount, "movecount", 1, SVT_INT, SR_GetInt, SR_PutInt),
 	SF(reactiontime, "reactiontime", 1, SVT_INT, SR_GetInt, SR_PutInt),
 	SF(threshold, "threshold", 1, SVT_INT, SR_GetInt, SR_PutInt),
-	SF(model_skin, "model_skin", 1, SVT_INT, SR_GetInt, SR_PutInt),
+	SF(cold, "model_skin", 1, SVT_INT, SR_MobjGetColdInt, SR_MobjPutColdInt),
 	SF(tag, "tag", 1, SVT_INT, SR_GetInt, SR_PutInt),
-	SF(wud_tags, "wud_tags", 1, SVT_STRING, SR_MobjGetWUDs, SR_MobjPutWUDs),
+	SF(cold, "wud_tags", 1, SVT_STRING, SR_MobjGetWUDs, SR_MobjPutWUDs),
 	SF(side, "side", 1, SVT_INT, SR_GetInt, SR_PutInt),
 	SF(player, "player", 1, SVT_INDEX("players"), 
 		SR_MobjGetPlayer, SR_MobjPutPlayer),
-	SF(spawnpoint, "spawnpoint", 1, SVT_STRUCT("spawnpoint_t"), 
-		SR_MobjGetSpawnPoint, SR_MobjPutSpawnPoint),
+	SF(cold, "spawnpoint", 1, SVT_STRUCT("spawnpoint_t"), 
+		SR_MobjGetColdSpawnPoint, SR_MobjPutColdSpawnPoint),
 	SF(origheight, "origheight", 1, SVT_FLOAT, SR_GetFloat, SR_PutFloat),
 	SF(visibility, "visibility", 1, SVT_FLOAT, SR_GetFloat, SR_PutFloat),
 	SF(vis_target, "vis_target", 1, SVT_FLOAT, SR_GetFloat, SR_PutFloat),
@@ -339,8 +345,7 @@ void SV_MobjCreateElems(int num_elems)
 		cur->info  = NULL;
 		cur->state = cur->next_state = states+1;
 
-		cur->model_skin = 1;
-		cur->model_last_frame = -1;
+		cur->cold = new mobj_cold_t;
 	}
 }
 
@@ -372,6 +377,9 @@ void SV_MobjFinaliseElems(void)
 		if (seen_monsters.count(mo->info) == 0)
 			seen_monsters.insert(mo->info);
 	}
+
+	P_LinkAllMobjTypes();
+	P_LinkAllThinkers();
 }
 
 
@@ -602,9 +610,52 @@ void SR_MobjPutAttack(void *storage, int index, void *extra)
 	SV_PutString((info == NULL) ? NULL : info->name.c_str());
 }
 
+//
+// The rarely used fields live in the mobj_cold_t.  Their entries use
+// the 'cold' pointer as the storage, and get to the field through it.
+//
+static mobj_cold_t *ColdPart(void *storage)
+{
+	mobj_cold_t *cold = *(mobj_cold_t **)storage;
+
+	SYS_ASSERT(cold);
+	return cold;
+}
+
+bool SR_MobjGetColdType(void *storage, int index, void *extra)
+{
+	return SR_MobjGetType(&ColdPart(storage)->preBecome, index, extra);
+}
+
+void SR_MobjPutColdType(void *storage, int index, void *extra)
+{
+	SR_MobjPutType(&ColdPart(storage)->preBecome, index, extra);
+}
+
+bool SR_MobjGetColdInt(void *storage, int index, void *extra)
+{
+	// only model_skin so far
+	return SR_GetInt(&ColdPart(storage)->model_skin, index, extra);
+}
+
+void SR_MobjPutColdInt(void *storage, int index, void *extra)
+{
+	SR_PutInt(&ColdPart(storage)->model_skin, index, extra);
+}
+
+bool SR_MobjGetColdSpawnPoint(void *storage, int index, void *extra)
+{
+	return SR_MobjGetSpawnPoint(&ColdPart(storage)->spawnpoint, index, extra);
+}
+
+void SR_MobjPutColdSpawnPoint(void *storage, int index, void *extra)
+{
+	SR_MobjPutSpawnPoint(&ColdPart(storage)->spawnpoint, index, extra);
+}
+
 bool SR_MobjGetWUDs(void *storage, int index, void *extra)
 {
-	std::string *dest = (std::string *)storage;
+	std::string *dest = &ColdPart(storage)->wud_tags;
 
 	SYS_ASSERT(index == 0);
 
@@ -625,7 +676,7 @@ bool SR_MobjGetWUDs(void *storage, int index, void *extra)
 
 void SR_MobjPutWUDs(void *storage, int index, void *extra)
 {
-	std::string *src = (std::string *)storage;
+	std::string *src = &ColdPart(storage)->wud_tags;
 
 	SYS_ASSERT(index == 0);
 
@@ -41,6 +41,8 @@ void SV_BeginSave(void)
 {
 	L_WriteDebug("SV_BeginSave...\n");
 
+	// sleeping things are behind on their tics
+	P_WakeAllMobjs();
 	P_ClearAllStaleRefs();
 }
 
@@ -1466,15 +1466,13 @@ static void MO_count(coal::vm_c *vm, int argc)
 		thingid = (int)*num;
 
 
-	mobj_t *mo;
-
-	int index = 0;
 	double thingcount = 0;
 
-	for (mo=mobjlisthead; mo; mo=mo->next, index++)
+	// several types can share a number, so check all types present
+	for (auto& it : P_AllMobjTypes())
 	{
-		if (mo->info->number == thingid && mo->health > 0)
-			thingcount ++;
+		if (it.first->number == thingid)
+			thingcount += P_CountAliveMobjsOfType(it.first);
 	}
 	
 	vm->ReturnFloat(thingcount);
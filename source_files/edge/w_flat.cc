@@ -34,12 +34,15 @@
 
 #include "e_search.h"
 #include "dm_state.h"
+#include "g_game.h"
 #include "dm_defs.h"
 #include "m_argv.h"
 #include "m_misc.h"
 #include "p_local.h"
+#include "rad_trig.h"
 #include "r_image.h"
 #include "r_sky.h"
+#include "s_sound.h"
 #include "w_flat.h"
 #include "w_model.h"
 #include "w_sprite.h"
@@ -361,86 +364,205 @@ void W_InitPicAnims(void)
 }
 
 
-void W_PrecacheTextures(void)
+// upper limit on the frames of one animation which get precached
+#define MAX_ANIM_PRECACHE  64
+
+static void AddLevelImage(std::vector<const image_c *>& images, const image_c *image)
 {
-	// maximum possible images
-	int max_image = 1 + 3 * numsides + 2 * numsectors;
-	int count = 0;
+	if (! image || image == skyflatimage)
+		return;
+
+	images.push_back(image);
+
+	// the other frames of an animated texture or flat
+	const image_c *frame = image->anim.next;
+
+	for (int k = 0 ; frame && frame != image && k < MAX_ANIM_PRECACHE ; k++)
+	{
+		images.push_back(frame);
+		frame = frame->anim.next;
+	}
+}
 
-	const image_c ** images = new const image_c* [max_image];
 
+void W_PrecacheTextures(std::vector<const image_c *>& images)
+{
 	// Sky texture is always present.
-	images[count++] = sky_image;
+	if (sky_image)
+		images.push_back(sky_image);
 
 	// add in sidedefs
 	for (int i=0; i < numsides; i++)
 	{
-		if (sides[i].top.image)
-			images[count++] = sides[i].top.image;
-
-		if (sides[i].middle.image)
-			images[count++] = sides[i].middle.image;
-
-		if (sides[i].bottom.image)
-			images[count++] = sides[i].bottom.image;
+		AddLevelImage(images, sides[i].top.image);
+		AddLevelImage(images, sides[i].middle.image);
+		AddLevelImage(images, sides[i].bottom.image);
 	}
 
-	SYS_ASSERT(count <= max_image);
-
 	// add in planes
 	for (int i=0; i < numsectors; i++)
 	{
-		if (sectors[i].floor.image)
-			images[count++] = sectors[i].floor.image;
-
-		if (sectors[i].ceil.image)
-			images[count++] = sectors[i].ceil.image;
+		AddLevelImage(images, sectors[i].floor.image);
+		AddLevelImage(images, sectors[i].ceil.image);
 	}
+}
 
-	SYS_ASSERT(count <= max_image);
 
-	// Sort the images, so we can ignore the duplicates
+static void AddAttackSounds(std::vector<sfx_t *>& sounds, const atkdef_c *atk)
+{
+	if (! atk)
+		return;
+
+	sounds.push_back(atk->initsound);
+	sounds.push_back(atk->sound);
+}
 
-#define CMP(a, b)  (a < b)
-	QSORT(const image_c *, images, count, CUTOFF);
-#undef CMP
 
-	for (int i=0; i < count; i++)
+static void AddThingSounds(std::vector<sfx_t *>& sounds, const mobjtype_c *info)
+{
+	sounds.push_back(info->seesound);
+	sounds.push_back(info->attacksound);
+	sounds.push_back(info->painsound);
+	sounds.push_back(info->deathsound);
+	sounds.push_back(info->overkill_sound);
+	sounds.push_back(info->activesound);
+	sounds.push_back(info->walksound);
+	sounds.push_back(info->jump_sound);
+	sounds.push_back(info->noway_sound);
+	sounds.push_back(info->oof_sound);
+	sounds.push_back(info->fallpain_sound);
+	sounds.push_back(info->gasp_sound);
+	sounds.push_back(info->secretsound);
+	sounds.push_back(info->falling_sound);
+	sounds.push_back(info->rip_sound);
+
+	AddAttackSounds(sounds, info->closecombat);
+	AddAttackSounds(sounds, info->rangeattack);
+	AddAttackSounds(sounds, info->spareattack);
+}
+
+
+//
+// Collects the sounds which the things in the level (and those
+// which RTS scripts may spawn), and the weapons the players are
+// holding, can make.
+//
+static void GatherLevelSounds(std::vector<sfx_t *>& sounds,
+							  const std::vector<const mobjtype_c *>& extra_types)
+{
+	const mobjtype_c *last_info = NULL;
+
+	for (mobj_t * mo = mobjlisthead ; mo ; mo = mo->next)
 	{
-		SYS_ASSERT(images[i]);
+		const mobjtype_c *info = mo->info;
 
-		if (i+1 < count && images[i] == images[i + 1])
+		if (info == last_info)
 			continue;
 
-		if (images[i] == skyflatimage)
+		last_info = info;
+
+		AddThingSounds(sounds, info);
+	}
+
+	for (const mobjtype_c *info : extra_types)
+		AddThingSounds(sounds, info);
+
+	for (int pnum = 0 ; pnum < MAXPLAYERS ; pnum++)
+	{
+		player_t *p = players[pnum];
+
+		if (! p)
 			continue;
 
-		W_ImagePreCache(images[i]);
+		for (int w = 0 ; w < MAXWEAPONS ; w++)
+		{
+			const weapondef_c *info = p->weapons[w].info;
+
+			if (! p->weapons[w].owned || ! info)
+				continue;
+
+			sounds.push_back(info->idle);
+			sounds.push_back(info->engaged);
+			sounds.push_back(info->hit);
+			sounds.push_back(info->start);
+			sounds.push_back(info->sound1);
+			sounds.push_back(info->sound2);
+			sounds.push_back(info->sound3);
+
+			for (int a = 0 ; a < 4 ; a++)
+				AddAttackSounds(sounds, info->attack[a]);
+		}
 	}
 
-	delete[] images;
+	std::sort(sounds.begin(), sounds.end());
+	sounds.erase(std::unique(sounds.begin(), sounds.end()), sounds.end());
+
+	if (! sounds.empty() && sounds[0] == sfx_None)
+		sounds.erase(sounds.begin());
 }
 
 
 //
 // W_PrecacheLevel
 //
-// Preloads all relevant graphics for the level.
+// Preloads all relevant graphics (and sounds) for the level.
 //
 // -AJA- 2001/06/18: Reworked for image system.
-//                   
+//
+// The images are gathered into one list first, so their decoding
+// can be spread over several threads (see W_ImagePreCacheList).
+// Images, sounds and things used by the level's RTS scripts are
+// included too.
+//
 void W_PrecacheLevel(void)
 {
+	std::vector<const image_c *> images;
+	std::vector<sfx_t *> sounds;
+	std::vector<const mobjtype_c *> rts_things;
+	std::vector<const image_c *> rts_images;
+
+	u32_t t_start = I_GetMicros();
+
+	RAD_GatherLevelAssets(currmap->name.c_str(), rts_images, sounds, rts_things);
+
 	if (r_precache_sprite.d)
-		W_PrecacheSprites();
+		W_PrecacheSprites(images, rts_things);
 
 	if (r_precache_tex.d)
-		W_PrecacheTextures();
+	{
+		W_PrecacheTextures(images);
+
+		for (const image_c *image : rts_images)
+			AddLevelImage(images, image);
+	}
+
+	u32_t t_gather = I_GetMicros();
 
 	if (r_precache_model.d)
-		W_PrecacheModels();
+		W_PrecacheModels(images);
+
+	u32_t t_models = I_GetMicros();
+
+	int num_images = W_ImagePreCacheList(images);
+
+	u32_t t_images = I_GetMicros();
 
 	RGL_PreCacheSky();
+
+	u32_t t_sky = I_GetMicros();
+
+	GatherLevelSounds(sounds, rts_things);
+	S_PrecacheSoundList(sounds);
+
+	u32_t t_sounds = I_GetMicros();
+
+	I_Debugf("W_PrecacheLevel: gather %1.1f ms, models %1.1f ms, "
+			 "images %d in %1.1f ms, sky %1.1f ms, sounds %d in %1.1f ms\n",
+			 (t_gather - t_start)  / 1000.0f,
+			 (t_models - t_gather) / 1000.0f, num_images,
+			 (t_images - t_models) / 1000.0f,
+			 (t_sky    - t_images) / 1000.0f, (int)sounds.size(),
+			 (t_sounds - t_sky)    / 1000.0f);
 }
 
 //--- editor settings ---
@@ -135,6 +135,85 @@ static void FindModelFrameNames(mdl_model_c *md, int model_num)
 				missing, ddf_model_names[model_num].c_str());
 }
 
+//
+// Opens the KVX/KV6/VXL file for the given model, or returns NULL.
+//
+static epi::file_c *OpenVoxelFile(const std::string& basename, bool *pack_file)
+{
+	// This only needs to be checked once for lumps; all voxel formats use this name
+	std::string lumpname = epi::STR_Format("%sVXL", basename.c_str());
+	std::string packname;
+
+	int lump_num = W_CheckFileNumForName(lumpname.c_str());
+	int pack_num = -1;
+
+	std::string vxlname = epi::STR_Format("%s.vxl", basename.c_str());
+	int vxl_num = W_CheckPackForName(vxlname);
+	if (vxl_num > pack_num) pack_num = vxl_num;
+	std::string kv6name = epi::STR_Format("%s.kv6", basename.c_str());
+	int kv6_num = W_CheckPackForName(kv6name);
+	if (kv6_num > pack_num) pack_num = kv6_num;
+	std::string kvxname = epi::STR_Format("%s.kvx", basename.c_str());
+	int kvx_num = W_CheckPackForName(kvxname);
+	if (kvx_num > pack_num) pack_num = kvx_num;
+
+	if (pack_num == vxl_num)
+		packname = vxlname;
+	else if (pack_num == kv6_num)
+		packname = kv6name;
+	else if (pack_num == kvx_num)
+		packname = kvxname;
+	else
+		packname = "";
+
+	epi::file_c *f = nullptr;
+
+	if (lump_num > -1 || pack_num > -1)
+	{
+		if (pack_num > lump_num)
+		{
+			f = W_OpenPackFile(packname);
+			if (f)
+			{
+				I_Debugf("Loading voxel model from pack file : %s\n", packname.c_str());
+				*pack_file = true;
+			}
+		}
+		else
+		{
+			I_Debugf("Loading voxel model from lump : %s\n", lumpname.c_str());
+			f = W_OpenLump(lumpname.c_str());
+		}
+	}
+
+	return f;
+}
+
+//
+// Checks for an MD3, MD2 or MDL file, which are used before voxels.
+//
+static bool HaveMeshModel(const std::string& basename)
+{
+	static const char *kinds[3][2] =
+	{
+		{ "MD3", "md3" }, { "MD2", "md2" }, { "MDL", "mdl" }
+	};
+
+	for (int k = 0; k < 3; k++)
+	{
+		std::string lumpname = epi::STR_Format("%s%s", basename.c_str(), kinds[k][0]);
+
+		if (W_CheckFileNumForName(lumpname.c_str()) > -1)
+			return true;
+
+		if (W_CheckPackForName(epi::STR_Format("%s.%s", basename.c_str(), kinds[k][1])) > -1 ||
+			W_CheckPackForName(epi::STR_Format("%s%s.%s", basename.c_str(), kinds[k][0], kinds[k][1])) > -1)
+			return true;
+	}
+
+	return false;
+}
+
 modeldef_c *LoadModelFromLump(int model_num)
 {
 	std::string basename = ddf_model_names[model_num];
@@ -252,50 +331,9 @@ modeldef_c *LoadModelFromLump(int model_num)
 
 	if (!f)
 	{
-		// This only needs to be checked once for lumps; all voxel formats use this name
-		lumpname = epi::STR_Format("%sVXL", basename.c_str());
-		lump_num = W_CheckFileNumForName(lumpname.c_str());
-		pack_num = -1;
-
-		std::string vxlname = epi::STR_Format("%s.vxl", basename.c_str());
-		int vxl_num = W_CheckPackForName(vxlname);
-		if (vxl_num > pack_num) pack_num = vxl_num;
-		std::string kv6name = epi::STR_Format("%s.kv6", basename.c_str());
-		int kv6_num = W_CheckPackForName(kv6name);
-		if (kv6_num > pack_num) pack_num = kv6_num;
-		std::string kvxname = epi::STR_Format("%s.kvx", basename.c_str());
-		int kvx_num = W_CheckPackForName(kvxname);
-		if (kvx_num > pack_num) pack_num = kvx_num;
-
-		if (pack_num == vxl_num)
-			packname = vxlname;
-		else if (pack_num == kv6_num)
-			packname = kv6name;
-		else if (pack_num == kvx_num)
-			packname = kvxname;
-		else
-			packname = "";
-
-		if (lump_num > -1 || pack_num > -1)
-		{
-			if (pack_num > lump_num)
-			{
-				f = W_OpenPackFile(packname);
-				if (f)
-				{
-					I_Debugf("Loading voxel model from pack file : %s\n", packname.c_str());
-					def->vxl_model = VXL_LoadModel(f, basename.c_str());
-					pack_file = true;
-				}
-			}
-			else
-			{
-				I_Debugf("Loading voxel model from lump : %s\n", lumpname.c_str());
-				f = W_OpenLump(lumpname.c_str());
-				if (f)
-					def->vxl_model = VXL_LoadModel(f, basename.c_str());
-			}
-		}
+		f = OpenVoxelFile(basename, &pack_file);
+		if (f)
+			def->vxl_model = VXL_LoadModel(f, basename.c_str());
 	}
 
 	if (! f)
@@ -384,7 +422,11 @@ modeldef_c *W_GetModel(int model_num)
 }
 
 
-void W_PrecacheModels(void)
+//
+// Loads the models in the level, and adds their skins to the
+// list of images to precache.
+//
+void W_PrecacheModels(std::vector<const image_c *>& images)
 {
 	if (nummodels <= 0)
 		return;
@@ -440,6 +482,35 @@ void W_PrecacheModels(void)
 		}
 	}
 
+	// mesh the voxel models which are not loaded yet all at once
+	std::vector<epi::file_c *> voxel_files;
+
+	for (int i = 1 ; i < nummodels ; i++)
+	{
+		if (! model_present[i] || models[i])
+			continue;
+
+		const std::string& basename = ddf_model_names[i];
+
+		if (HaveMeshModel(basename))
+			continue;
+
+		bool pack_file = false;
+
+		epi::file_c *f = OpenVoxelFile(basename, &pack_file);
+
+		if (f)
+			voxel_files.push_back(f);
+	}
+
+	if (! voxel_files.empty())
+	{
+		VXL_PrepareModels(voxel_files);
+
+		for (epi::file_c *f : voxel_files)
+			delete f;
+	}
+
 	for (int i = 1 ; i < nummodels ; i++)  // ignore SPR_NULL
 	{
 		if (model_present[i])
@@ -452,7 +523,7 @@ void W_PrecacheModels(void)
 			for (int n = 0 ; n < 10 ; n++)
 			{
 				if (def && def->skins[n])
-					W_ImagePreCache(def->skins[n]);
+					images.push_back(def->skins[n]);
 			}
 		}
 	}
@@ -50,7 +50,7 @@ public:
 
 void W_InitModels(void);
 
-void W_PrecacheModels(void);
+void W_PrecacheModels(std::vector<const image_c *>& images);
 
 modeldef_c *W_GetModel(int model_num);
 
@@ -730,23 +730,57 @@ spriteframe_c *W_GetSpriteFrame(int spr_num, int framenum)
 }
 
 
-void W_PrecacheSprites(void)
+static void MarkStateSprites(byte *sprite_present, const state_group_t& group)
+{
+	for (const state_range_t& range : group)
+	{
+		for (int st = range.first ; st <= range.last ; st++)
+		{
+			if (st <= 0 || st >= num_states)
+				continue;
+
+			int sprite = states[st].sprite;
+
+			if (sprite >= 1 && sprite < numsprites && ! (states[st].flags & SFF_Model))
+				sprite_present[sprite] = 1;
+		}
+	}
+}
+
+
+//
+// Adds the images of every sprite which the things in the level can
+// show (any of their states, not just the current one) to the list.
+// The 'extra_types' are things which may be spawned later, e.g. by
+// RTS scripts.
+//
+void W_PrecacheSprites(std::vector<const image_c *>& images,
+                       const std::vector<const mobjtype_c *>& extra_types)
 {
 	SYS_ASSERT(numsprites > 1);
 
 	byte *sprite_present = new byte[numsprites];
 	memset(sprite_present, 0, numsprites);
 
+	const mobjtype_c *last_info = NULL;  // an optimisation
+
 	for (mobj_t * mo = mobjlisthead ; mo ; mo = mo->next)
 	{
 		SYS_ASSERT(mo->state);
 
-		if (mo->state->sprite < 1 || mo->state->sprite >= numsprites)
-			continue;
+		if (mo->state->sprite >= 1 && mo->state->sprite < numsprites)
+			sprite_present[mo->state->sprite] = 1;
 
-		sprite_present[mo->state->sprite] = 1;
+		if (mo->info != last_info)
+		{
+			MarkStateSprites(sprite_present, mo->info->state_grp);
+			last_info = mo->info;
+		}
 	}
 
+	for (const mobjtype_c *info : extra_types)
+		MarkStateSprites(sprite_present, info->state_grp);
+
 	for (int i = 1 ; i < numsprites ; i++)  // ignore SPR_NULL
 	{
 		spritedef_c *def = sprites[i];
@@ -780,7 +814,7 @@ void W_PrecacheSprites(void)
 				if (cur_image == NULL || cur_image == last_image)
 					continue;
 
-				W_ImagePreCache(cur_image);
+				images.push_back(cur_image);
 
 				last_image = cur_image;
 			}
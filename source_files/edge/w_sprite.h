@@ -79,7 +79,8 @@ public:
 void W_InitSprites(void);
 
 bool W_CheckSpritesExist(const state_group_t& group);
-void W_PrecacheSprites(void);
+void W_PrecacheSprites(std::vector<const image_c *>& images,
+                       const std::vector<const mobjtype_c *>& extra_types);
 
 spriteframe_c *W_GetSpriteFrame(int spr_num, int framenum);
 